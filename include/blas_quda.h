@@ -79,6 +79,9 @@ namespace quda {
 
   // CPU variants
 
+  void zeroCpu(cpuColorSpinorField &a);
+  void copyCpu(cpuColorSpinorField &dst, const cpuColorSpinorField &src);
+
   double axpyNormCpu(const double &a, const cpuColorSpinorField &x, cpuColorSpinorField &y);
   double normCpu(const cpuColorSpinorField &b);
   double reDotProductCpu(const cpuColorSpinorField &a, const cpuColorSpinorField &b);
@@ -130,6 +133,200 @@ namespace quda {
   double3 HeavyQuarkResidualNormCpu(cpuColorSpinorField &x, cpuColorSpinorField &r);
   double3 xpyHeavyQuarkResidualNormCpu(cpuColorSpinorField &x, cpuColorSpinorField &y, cpuColorSpinorField &r);
 
+  Complex axpyCGNormCpu(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y);
+  void tripleCGUpdateCpu(const double &alpha, const double &beta, cpuColorSpinorField &q,
+			 cpuColorSpinorField &r, cpuColorSpinorField &x, cpuColorSpinorField &p);
+  double3 tripleCGReductionCpu(cpuColorSpinorField &x, cpuColorSpinorField &y, cpuColorSpinorField &z);
+
+  /**
+     Location-agnostic overloads of the above, so that code that is
+     templated on the field type (e.g., the solvers) can be written
+     once for both device and host fields.
+  */
+  namespace blas {
+
+    inline void zero(cudaColorSpinorField &a) { zeroCuda(a); }
+    inline void zero(cpuColorSpinorField &a) { zeroCpu(a); }
+
+    inline void copy(cudaColorSpinorField &dst, const cudaColorSpinorField &src) { copyCuda(dst, src); }
+    inline void copy(cpuColorSpinorField &dst, const cpuColorSpinorField &src) { copyCpu(dst, src); }
+
+    inline double norm2(const cudaColorSpinorField &b) { return normCuda(b); }
+    inline double norm2(const cpuColorSpinorField &b) { return normCpu(b); }
+
+    inline double reDotProduct(cudaColorSpinorField &a, cudaColorSpinorField &b) { return reDotProductCuda(a, b); }
+    inline double reDotProduct(cpuColorSpinorField &a, cpuColorSpinorField &b) { return reDotProductCpu(a, b); }
+
+    inline double xmyNorm(cudaColorSpinorField &a, cudaColorSpinorField &b) { return xmyNormCuda(a, b); }
+    inline double xmyNorm(cpuColorSpinorField &a, cpuColorSpinorField &b) { return xmyNormCpu(a, b); }
+
+    inline void xpy(cudaColorSpinorField &x, cudaColorSpinorField &y) { xpyCuda(x, y); }
+    inline void xpy(cpuColorSpinorField &x, cpuColorSpinorField &y) { xpyCpu(x, y); }
+
+    inline void mxpy(cudaColorSpinorField &x, cudaColorSpinorField &y) { mxpyCuda(x, y); }
+    inline void mxpy(cpuColorSpinorField &x, cpuColorSpinorField &y) { mxpyCpu(x, y); }
+
+    inline Complex cDotProduct(cudaColorSpinorField &a, cudaColorSpinorField &b) { return cDotProductCuda(a, b); }
+    inline Complex cDotProduct(cpuColorSpinorField &a, cpuColorSpinorField &b) { return cDotProductCpu(a, b); }
+
+    inline double3 cDotProductNormA(cudaColorSpinorField &a, cudaColorSpinorField &b)
+    { return cDotProductNormACuda(a, b); }
+    inline double3 cDotProductNormA(cpuColorSpinorField &a, cpuColorSpinorField &b)
+    { return cDotProductNormACpu(a, b); }
+
+    inline double3 cDotProductNormB(cudaColorSpinorField &a, cudaColorSpinorField &b)
+    { return cDotProductNormBCuda(a, b); }
+    inline double3 cDotProductNormB(cpuColorSpinorField &a, cpuColorSpinorField &b)
+    { return cDotProductNormBCpu(a, b); }
+
+    inline double3 HeavyQuarkResidualNorm(cudaColorSpinorField &x, cudaColorSpinorField &r)
+    { return HeavyQuarkResidualNormCuda(x, r); }
+    inline double3 HeavyQuarkResidualNorm(cpuColorSpinorField &x, cpuColorSpinorField &r)
+    { return HeavyQuarkResidualNormCpu(x, r); }
+
+    inline double3 xpyHeavyQuarkResidualNorm(cudaColorSpinorField &x, cudaColorSpinorField &y,
+					     cudaColorSpinorField &r)
+    { return xpyHeavyQuarkResidualNormCuda(x, y, r); }
+    inline double3 xpyHeavyQuarkResidualNorm(cpuColorSpinorField &x, cpuColorSpinorField &y,
+					     cpuColorSpinorField &r)
+    { return xpyHeavyQuarkResidualNormCpu(x, y, r); }
+
+    inline double3 tripleCGReduction(cudaColorSpinorField &x, cudaColorSpinorField &y, cudaColorSpinorField &z)
+    { return tripleCGReductionCuda(x, y, z); }
+    inline double3 tripleCGReduction(cpuColorSpinorField &x, cpuColorSpinorField &y, cpuColorSpinorField &z)
+    { return tripleCGReductionCpu(x, y, z); }
+
+    inline double axpyNorm(const double &a, cudaColorSpinorField &x, cudaColorSpinorField &y)
+    { return axpyNormCuda(a, x, y); }
+    inline double axpyNorm(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y)
+    { return axpyNormCpu(a, x, y); }
+
+    inline void axpby(const double &a, cudaColorSpinorField &x, const double &b, cudaColorSpinorField &y)
+    { axpbyCuda(a, x, b, y); }
+    inline void axpby(const double &a, cpuColorSpinorField &x, const double &b, cpuColorSpinorField &y)
+    { axpbyCpu(a, x, b, y); }
+
+    inline void axpy(const double &a, cudaColorSpinorField &x, cudaColorSpinorField &y) { axpyCuda(a, x, y); }
+    inline void axpy(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y) { axpyCpu(a, x, y); }
+
+    inline void ax(const double &a, cudaColorSpinorField &x) { axCuda(a, x); }
+    inline void ax(const double &a, cpuColorSpinorField &x) { axCpu(a, x); }
+
+    inline void xpay(cudaColorSpinorField &x, const double &a, cudaColorSpinorField &y) { xpayCuda(x, a, y); }
+    inline void xpay(cpuColorSpinorField &x, const double &a, cpuColorSpinorField &y) { xpayCpu(x, a, y); }
+
+    inline void axpyZpbx(const double &a, cudaColorSpinorField &x, cudaColorSpinorField &y,
+			 cudaColorSpinorField &z, const double &b) { axpyZpbxCuda(a, x, y, z, b); }
+    inline void axpyZpbx(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y,
+			 cpuColorSpinorField &z, const double &b) { axpyZpbxCpu(a, x, y, z, b); }
+
+    inline void axpyBzpcx(const double &a, cudaColorSpinorField &x, cudaColorSpinorField &y,
+			  const double &b, cudaColorSpinorField &z, const double &c)
+    { axpyBzpcxCuda(a, x, y, b, z, c); }
+    inline void axpyBzpcx(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y,
+			  const double &b, cpuColorSpinorField &z, const double &c)
+    { axpyBzpcxCpu(a, x, y, b, z, c); }
+
+    inline void caxpby(const Complex &a, cudaColorSpinorField &x, const Complex &b, cudaColorSpinorField &y)
+    { caxpbyCuda(a, x, b, y); }
+    inline void caxpby(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y)
+    { caxpbyCpu(a, x, b, y); }
+
+    inline void caxpy(const Complex &a, cudaColorSpinorField &x, cudaColorSpinorField &y) { caxpyCuda(a, x, y); }
+    inline void caxpy(const Complex &a, cpuColorSpinorField &x, cpuColorSpinorField &y) { caxpyCpu(a, x, y); }
+
+    inline void cxpaypbz(cudaColorSpinorField &x, const Complex &b, cudaColorSpinorField &y,
+			 const Complex &c, cudaColorSpinorField &z) { cxpaypbzCuda(x, b, y, c, z); }
+    inline void cxpaypbz(cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y,
+			 const Complex &c, cpuColorSpinorField &z) { cxpaypbzCpu(x, b, y, c, z); }
+
+    inline void caxpbypzYmbw(const Complex &a, cudaColorSpinorField &x, const Complex &b, cudaColorSpinorField &y,
+			     cudaColorSpinorField &z, cudaColorSpinorField &w) { caxpbypzYmbwCuda(a, x, b, y, z, w); }
+    inline void caxpbypzYmbw(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y,
+			     cpuColorSpinorField &z, cpuColorSpinorField &w) { caxpbypzYmbwCpu(a, x, b, y, z, w); }
+
+    inline Complex xpaycDotzy(cudaColorSpinorField &x, const double &a, cudaColorSpinorField &y,
+			      cudaColorSpinorField &z) { return xpaycDotzyCuda(x, a, y, z); }
+    inline Complex xpaycDotzy(cpuColorSpinorField &x, const double &a, cpuColorSpinorField &y,
+			      cpuColorSpinorField &z) { return xpaycDotzyCpu(x, a, y, z); }
+
+    inline double3 caxpbypzYmbwcDotProductUYNormY(const Complex &a, cudaColorSpinorField &x, const Complex &b,
+						  cudaColorSpinorField &y, cudaColorSpinorField &z,
+						  cudaColorSpinorField &w, cudaColorSpinorField &u)
+    { return caxpbypzYmbwcDotProductUYNormYCuda(a, x, b, y, z, w, u); }
+    inline double3 caxpbypzYmbwcDotProductUYNormY(const Complex &a, cpuColorSpinorField &x, const Complex &b,
+						  cpuColorSpinorField &y, cpuColorSpinorField &z,
+						  cpuColorSpinorField &w, cpuColorSpinorField &u)
+    { return caxpbypzYmbwcDotProductUYNormYCpu(a, x, b, y, z, w, u); }
+
+    inline void cabxpyAx(const double &a, const Complex &b, cudaColorSpinorField &x, cudaColorSpinorField &y)
+    { cabxpyAxCuda(a, b, x, y); }
+    inline void cabxpyAx(const double &a, const Complex &b, cpuColorSpinorField &x, cpuColorSpinorField &y)
+    { cabxpyAxCpu(a, b, x, y); }
+
+    inline double caxpyNorm(const Complex &a, cudaColorSpinorField &x, cudaColorSpinorField &y)
+    { return caxpyNormCuda(a, x, y); }
+    inline double caxpyNorm(const Complex &a, cpuColorSpinorField &x, cpuColorSpinorField &y)
+    { return caxpyNormCpu(a, x, y); }
+
+    inline void caxpyXmaz(const Complex &a, cudaColorSpinorField &x, cudaColorSpinorField &y, cudaColorSpinorField &z)
+    { caxpyXmazCuda(a, x, y, z); }
+    inline void caxpyXmaz(const Complex &a, cpuColorSpinorField &x, cpuColorSpinorField &y, cpuColorSpinorField &z)
+    { caxpyXmazCpu(a, x, y, z); }
+
+    inline double caxpyXmazNormX(const Complex &a, cudaColorSpinorField &x, cudaColorSpinorField &y,
+				 cudaColorSpinorField &z) { return caxpyXmazNormXCuda(a, x, y, z); }
+    inline double caxpyXmazNormX(const Complex &a, cpuColorSpinorField &x, cpuColorSpinorField &y,
+				 cpuColorSpinorField &z) { return caxpyXmazNormXCpu(a, x, y, z); }
+
+    inline double cabxpyAxNorm(const double &a, const Complex &b, cudaColorSpinorField &x, cudaColorSpinorField &y)
+    { return cabxpyAxNormCuda(a, b, x, y); }
+    inline double cabxpyAxNorm(const double &a, const Complex &b, cpuColorSpinorField &x, cpuColorSpinorField &y)
+    { return cabxpyAxNormCpu(a, b, x, y); }
+
+    inline void caxpbypz(const Complex &a, cudaColorSpinorField &x, const Complex &b, cudaColorSpinorField &y,
+			 cudaColorSpinorField &z) { caxpbypzCuda(a, x, b, y, z); }
+    inline void caxpbypz(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y,
+			 cpuColorSpinorField &z) { caxpbypzCpu(a, x, b, y, z); }
+
+    inline void caxpbypczpw(const Complex &a, cudaColorSpinorField &x, const Complex &b, cudaColorSpinorField &y,
+			    const Complex &c, cudaColorSpinorField &z, cudaColorSpinorField &w)
+    { caxpbypczpwCuda(a, x, b, y, c, z, w); }
+    inline void caxpbypczpw(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y,
+			    const Complex &c, cpuColorSpinorField &z, cpuColorSpinorField &w)
+    { caxpbypczpwCpu(a, x, b, y, c, z, w); }
+
+    inline Complex caxpyDotzy(const Complex &a, cudaColorSpinorField &x, cudaColorSpinorField &y,
+			      cudaColorSpinorField &z) { return caxpyDotzyCuda(a, x, y, z); }
+    inline Complex caxpyDotzy(const Complex &a, cpuColorSpinorField &x, cpuColorSpinorField &y,
+			      cpuColorSpinorField &z) { return caxpyDotzyCpu(a, x, y, z); }
+
+    inline Complex axpyCGNorm(const double &a, cudaColorSpinorField &x, cudaColorSpinorField &y)
+    { return axpyCGNormCuda(a, x, y); }
+    inline Complex axpyCGNorm(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y)
+    { return axpyCGNormCpu(a, x, y); }
+
+    inline void tripleCGUpdate(const double &a, const double &b, cudaColorSpinorField &x,
+			       cudaColorSpinorField &y, cudaColorSpinorField &z, cudaColorSpinorField &w)
+    { tripleCGUpdateCuda(a, b, x, y, z, w); }
+    inline void tripleCGUpdate(const double &a, const double &b, cpuColorSpinorField &x,
+			       cpuColorSpinorField &y, cpuColorSpinorField &z, cpuColorSpinorField &w)
+    { tripleCGUpdateCpu(a, b, x, y, z, w); }
+
+    // y += sum_i a[i] x[i], three vectors at a time
+    template <typename Field>
+    void caxpyBlock(const Complex *a, Field *x[], int n, Field &y) {
+      for (int i=0; i<n-2; i+=3) 
+	caxpbypczpw(a[i], *x[i], a[i+1], *x[i+1], a[i+2], *x[i+2], y); 
+  
+      if (n%3 != 0) { // need to update the remainder
+	if ((n - 3*(n/3)) % 2 == 0) caxpbypz(a[n-2], *x[n-2], a[n-1], *x[n-1], y);
+	else caxpy(a[n-1], *x[n-1], y);
+      }
+    }
+
+  } // namespace blas
+
 } // namespace quda
 
 #endif // _QUDA_BLAS_H
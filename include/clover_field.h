@@ -113,7 +113,8 @@ namespace quda {
     friend struct FullClover;
   };
 
-  // this is a place holder for a future host-side clover object
+  // host-side clover field, either referencing an external array or
+  // allocated (e.g., in packed order for the host Dirac operators)
   class cpuCloverField : public CloverField {
 
   private:
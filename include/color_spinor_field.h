@@ -96,10 +96,13 @@ namespace quda {
 	  QUDA_FLOAT2_FIELD_ORDER : QUDA_FLOAT4_FIELD_ORDER; 
       }
 
-    void setPrecision(QudaPrecision precision) {
+    void setPrecision(QudaPrecision precision, QudaFieldLocation location=QUDA_CUDA_FIELD_LOCATION) {
       this->precision = precision;
-      fieldOrder = (precision == QUDA_DOUBLE_PRECISION || nSpin == 1) ? 
-	QUDA_FLOAT2_FIELD_ORDER : QUDA_FLOAT4_FIELD_ORDER; 
+      // host field orders do not depend on the precision
+      if (location == QUDA_CUDA_FIELD_LOCATION) {
+	fieldOrder = (precision == QUDA_DOUBLE_PRECISION || nSpin == 1) ? 
+	  QUDA_FLOAT2_FIELD_ORDER : QUDA_FLOAT4_FIELD_ORDER; 
+      }
     }
 
     void print() {
@@ -383,6 +386,7 @@ namespace quda {
   public:
     //cpuColorSpinorField();
     cpuColorSpinorField(const cpuColorSpinorField&);
+    cpuColorSpinorField(const ColorSpinorField&, const ColorSpinorParam&);
     cpuColorSpinorField(const ColorSpinorField&);
     cpuColorSpinorField(const ColorSpinorParam&);
     virtual ~cpuColorSpinorField();
@@ -391,8 +395,8 @@ namespace quda {
     cpuColorSpinorField& operator=(const cpuColorSpinorField&);
     cpuColorSpinorField& operator=(const cudaColorSpinorField&);
 
-    //cpuColorSpinorField& Even() const;
-    //cpuColorSpinorField& Odd() const;
+    cpuColorSpinorField& Even() const;
+    cpuColorSpinorField& Odd() const;
 
     void Source(const QudaSourceType sourceType, const int st=0, const int s=0, const int c=0);
     static int Compare(const cpuColorSpinorField &a, const cpuColorSpinorField &b, const int resolution=1);
@@ -342,10 +342,12 @@ template <typename Float, int Ns, int Nc>
 struct SpaceSpinorColorOrder {
   typedef typename mapper<Float>::type RegType;
   Float *field;
+  float *norm; // per-site norm, only used for half precision
   int volumeCB;
   int stride;
-  SpaceSpinorColorOrder(const ColorSpinorField &a, Float *field_=0) 
-  : field(field_ ? field_ : (Float*)a.V()), volumeCB(a.VolumeCB()), stride(a.Stride())
+  SpaceSpinorColorOrder(const ColorSpinorField &a, Float *field_=0, float *norm_=0)
+  : field(field_ ? field_ : (Float*)a.V()), norm(norm_ ? norm_ : (float*)a.Norm()),
+    volumeCB(a.VolumeCB()), stride(a.Stride())
   { if (volumeCB != stride) errorQuda("Stride must equal volume for this field order"); }
   virtual ~SpaceSpinorColorOrder() { ; }
 
@@ -354,7 +356,8 @@ struct SpaceSpinorColorOrder {
     for (int s=0; s<Ns; s++) {
       for (int c=0; c<Nc; c++) {
 	for (int z=0; z<2; z++) {
-	  v[(s*Nc+c)*2+z] = field[((x*Ns + s)*Nc + c)*2 + z];
+	  copy(v[(s*Nc+c)*2+z], field[((x*Ns + s)*Nc + c)*2 + z]);
+	  if (sizeof(Float)==sizeof(short)) v[(s*Nc+c)*2+z] *= norm[x];
 	}
       }
     }
@@ -362,10 +365,20 @@ struct SpaceSpinorColorOrder {
 
   __device__ __host__ inline void save(const RegType v[Ns*Nc*2], int x) {
     if (x >= volumeCB) return;
+    RegType scale = 0.0;
+    if (sizeof(Float)==sizeof(short)) {
+      for (int i=0; i<2*Ns*Nc; i++) scale = fabs(v[i]) > scale ? fabs(v[i]) : scale;
+      norm[x] = scale;
+      if (scale == 0.0) scale = 1.0; // a zero site is stored as zeros
+    }
+
     for (int s=0; s<Ns; s++) {
       for (int c=0; c<Nc; c++) {
 	for (int z=0; z<2; z++) {
-	  field[((x*Ns + s)*Nc + c)*2 + z] = v[(s*Nc+c)*2+z];
+	  if (sizeof(Float)==sizeof(short))
+	    copy(field[((x*Ns + s)*Nc + c)*2 + z], v[(s*Nc+c)*2+z] / scale);
+	  else
+	    copy(field[((x*Ns + s)*Nc + c)*2 + z], v[(s*Nc+c)*2+z]);
 	}
       }
     }
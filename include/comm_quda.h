@@ -49,7 +49,10 @@ extern "C" {
   void comm_allreduce(double* data);
   void comm_allreduce_max(double* data);
   void comm_allreduce_array(double* data, size_t size);
+  void comm_allreduce_max_array(double* data, size_t size);
   void comm_allreduce_int(int* data);
+  MsgHandle *comm_allreduce_async(double* data, size_t size);
+  void comm_allreduce_wait(MsgHandle *mh);
   void comm_broadcast(void *data, size_t nbytes);
   void comm_barrier(void);
   void comm_abort(int status);
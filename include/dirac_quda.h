@@ -36,12 +36,17 @@ namespace quda {
     cudaColorSpinorField *tmp1;
     cudaColorSpinorField *tmp2; // used by Wilson-like kernels only
 
+    cpuGaugeField *cpuGauge; // used by the host operators only
+    cpuGaugeField *cpuFatGauge;  // used by the host staggered operators only
+    cpuGaugeField *cpuLongGauge; // used by the host staggered operators only
+    cpuCloverField *cpuClover;   // used by the host clover operators only
+
     int commDim[QUDA_MAX_DIM]; // whether to do comms or not
 
   DiracParam() 
     : type(QUDA_INVALID_DIRAC), kappa(0.0), m5(0.0), matpcType(QUDA_MATPC_INVALID),
       dagger(QUDA_DAG_INVALID), gauge(0), clover(0), mu(0.0), epsilon(0.0),
-      tmp1(0), tmp2(0)
+      tmp1(0), tmp2(0), cpuGauge(0), cpuFatGauge(0), cpuLongGauge(0), cpuClover(0)
     {
 
     }
@@ -387,15 +392,365 @@ namespace quda {
 			     const QudaSolutionType) const;
   };
 
+  /**
+     Abstract base class for the host Dirac operators.  These mirror
+     the device operators above, but act on cpuColorSpinorFields
+     (with QUDA_SPACE_SPIN_COLOR_FIELD_ORDER and the DeGrand-Rossi
+     gamma basis) using a QDP-ordered cpuGaugeField, so that the
+     solvers can be run on a host without a GPU.
+  */
+  class cpuDirac {
+
+    friend class DiracMatrix;
+    friend class DiracM;
+    friend class DiracMdagM;
+    friend class DiracMdag;
+
+  protected:
+    const cpuGaugeField &gauge;
+    double kappa;
+    double mass;
+    MatPCType matpcType;
+    mutable DagType dagger; // mutable to simplify implementation of Mdag
+    mutable unsigned long long flops;
+    mutable cpuColorSpinorField *tmp1;
+    mutable cpuColorSpinorField *tmp2;
+
+    bool newTmp(cpuColorSpinorField **, const cpuColorSpinorField &) const;
+    void deleteTmp(cpuColorSpinorField **, const bool &reset) const;
+
+    int commDim[QUDA_MAX_DIM]; // whether do comms or not
+
+  public:
+    cpuDirac(const DiracParam &param);
+    cpuDirac(const cpuDirac &dirac);
+    virtual ~cpuDirac();
+
+    virtual void checkParitySpinor(const cpuColorSpinorField &, const cpuColorSpinorField &) const;
+    virtual void checkFullSpinor(const cpuColorSpinorField &, const cpuColorSpinorField &) const;
+    void checkSpinorAlias(const cpuColorSpinorField &, const cpuColorSpinorField &) const;
+
+    virtual void Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+			const QudaParity parity) const = 0;
+    virtual void DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+			    const QudaParity parity, const cpuColorSpinorField &x,
+			    const double &k) const = 0;
+    virtual void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const = 0;
+    virtual void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const = 0;
+    void Mdag(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    // multi-RHS versions of the above, applied to nRhs fields at once;
+    // by default the right-hand sides are simply applied one at a time
+    virtual void DslashBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs, const QudaParity parity) const;
+    virtual void DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs, const QudaParity parity,
+				 cpuColorSpinorField **x, const double &k) const;
+    virtual void MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const;
+    virtual void MdagMBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const;
+    void MdagBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const;
+
+    // required methods to use e-o preconditioning for solving full system
+    virtual void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+			 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+			 const QudaSolutionType) const = 0;
+    virtual void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+			     const QudaSolutionType) const = 0;
+    void setMass(double mass){ this->mass = mass;}
+    // host Dirac operator factory
+    static cpuDirac* create(const DiracParam &param);
+
+    unsigned long long Flops() const { unsigned long long rtn = flops; flops = 0; return rtn; }
+  };
+
+  // Full Wilson (host)
+  class cpuDiracWilson : public cpuDirac {
+
+  public:
+    cpuDiracWilson(const DiracParam &param);
+    cpuDiracWilson(const cpuDiracWilson &dirac);
+    virtual ~cpuDiracWilson();
+
+    virtual void Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+			const QudaParity parity) const;
+    virtual void DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+			    const QudaParity parity, const cpuColorSpinorField &x, const double &k) const;
+    virtual void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    virtual void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    // multi-RHS versions, sharing the link loads across the right-hand sides
+    virtual void DslashBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs, const QudaParity parity) const;
+    virtual void DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs, const QudaParity parity,
+				 cpuColorSpinorField **x, const double &k) const;
+    virtual void MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const;
+    virtual void MdagMBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const;
+
+    virtual void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+			 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+			 const QudaSolutionType) const;
+    virtual void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+			     const QudaSolutionType) const;
+  };
+
+  // Even-odd preconditioned Wilson (host)
+  class cpuDiracWilsonPC : public cpuDiracWilson {
+
+  public:
+    cpuDiracWilsonPC(const DiracParam &param);
+    cpuDiracWilsonPC(const cpuDiracWilsonPC &dirac);
+    virtual ~cpuDiracWilsonPC();
+
+    void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    void MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const;
+
+    void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+		 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+		 const QudaSolutionType) const;
+    void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+		     const QudaSolutionType) const;
+  };
+
+  // Full clover (host)
+  class cpuDiracClover : public cpuDiracWilson {
+
+  protected:
+    const cpuCloverField &clover;
+
+  public:
+    cpuDiracClover(const DiracParam &param);
+    cpuDiracClover(const cpuDiracClover &dirac);
+    virtual ~cpuDiracClover();
+
+    void checkParitySpinor(const cpuColorSpinorField &, const cpuColorSpinorField &) const;
+
+    // applies clover term alone
+    void Clover(cpuColorSpinorField &out, const cpuColorSpinorField &in, const QudaParity parity) const;
+
+    // apply the operator (A + k D)
+    virtual void DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+			    const QudaParity parity, const cpuColorSpinorField &x, const double &k) const;
+    virtual void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    virtual void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    virtual void DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs, const QudaParity parity,
+				 cpuColorSpinorField **x, const double &k) const;
+
+    virtual void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+			 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+			 const QudaSolutionType) const;
+    virtual void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+			     const QudaSolutionType) const;
+  };
+
+  // Even-odd preconditioned clover (host)
+  class cpuDiracCloverPC : public cpuDiracClover {
+
+  public:
+    cpuDiracCloverPC(const DiracParam &param);
+    cpuDiracCloverPC(const cpuDiracCloverPC &dirac);
+    virtual ~cpuDiracCloverPC();
+
+    // applies the clover term inverse
+    void CloverInv(cpuColorSpinorField &out, const cpuColorSpinorField &in, const QudaParity parity) const;
+
+    // apply hopping term, then clover: (A_ee^-1 D_eo) or (A_oo^-1 D_oe),
+    // and likewise for dagger: (A_ee^-1 D^dagger_eo) or (A_oo^-1 D^dagger_oe)
+    void Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in, const QudaParity parity) const;
+
+    // out = x + k A_pp^-1 D_p\bar{p}
+    void DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, const QudaParity parity, 
+		    const cpuColorSpinorField &x, const double &k) const;
+
+    void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    void CloverInvBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs, const QudaParity parity) const;
+    void DslashBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs, const QudaParity parity) const;
+    void DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs, const QudaParity parity,
+			 cpuColorSpinorField **x, const double &k) const;
+    void MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const;
+
+    void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+		 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+		 const QudaSolutionType) const;
+    void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+		     const QudaSolutionType) const;
+  };
+
+  // Full domain wall (host)
+  class cpuDiracDomainWall : public cpuDiracWilson {
+
+  protected:
+    double m5;
+    double kappa5;
+
+  public:
+    cpuDiracDomainWall(const DiracParam &param);
+    cpuDiracDomainWall(const cpuDiracDomainWall &dirac);
+    virtual ~cpuDiracDomainWall();
+
+    void Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+		const QudaParity parity) const;
+    void DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+		    const QudaParity parity, const cpuColorSpinorField &x, const double &k) const;
+    virtual void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    virtual void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    // no multi-RHS kernels for this operator, so apply the right-hand sides one at a time
+    void DslashBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+		     const QudaParity parity) const { cpuDirac::DslashBlock(out, in, nRhs, parity); }
+    void DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+			 const QudaParity parity, cpuColorSpinorField **x, const double &k) const
+    { cpuDirac::DslashXpayBlock(out, in, nRhs, parity, x, k); }
+    void MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+    { cpuDirac::MBlock(out, in, nRhs); }
+    void MdagMBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+    { cpuDirac::MdagMBlock(out, in, nRhs); }
+
+    virtual void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+			 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+			 const QudaSolutionType) const;
+    virtual void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+			     const QudaSolutionType) const;
+  };
+
+  // 5d Even-odd preconditioned domain wall (host)
+  class cpuDiracDomainWallPC : public cpuDiracDomainWall {
+
+  public:
+    cpuDiracDomainWallPC(const DiracParam &param);
+    cpuDiracDomainWallPC(const cpuDiracDomainWallPC &dirac);
+    virtual ~cpuDiracDomainWallPC();
+
+    void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+		 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+		 const QudaSolutionType) const;
+    void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+		     const QudaSolutionType) const;
+  };
+
+  // Full twisted mass (host); only the single-flavor twists are supported
+  class cpuDiracTwistedMass : public cpuDiracWilson {
+
+  protected:
+    double mu;
+    void twistedApply(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+		      const QudaTwistGamma5Type twistType) const;
+    double flavorMu(const cpuColorSpinorField &in) const;
+
+  public:
+    cpuDiracTwistedMass(const DiracParam &param);
+    cpuDiracTwistedMass(const cpuDiracTwistedMass &dirac);
+    virtual ~cpuDiracTwistedMass();
+
+    void Twist(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    virtual void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    virtual void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    // as for domain wall, the right-hand sides are applied one at a time
+    void DslashBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+		     const QudaParity parity) const { cpuDirac::DslashBlock(out, in, nRhs, parity); }
+    void DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+			 const QudaParity parity, cpuColorSpinorField **x, const double &k) const
+    { cpuDirac::DslashXpayBlock(out, in, nRhs, parity, x, k); }
+    void MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+    { cpuDirac::MBlock(out, in, nRhs); }
+    void MdagMBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+    { cpuDirac::MdagMBlock(out, in, nRhs); }
+
+    virtual void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+			 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+			 const QudaSolutionType) const;
+    virtual void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+			     const QudaSolutionType) const;
+  };
+
+  // Even-odd preconditioned twisted mass (host)
+  class cpuDiracTwistedMassPC : public cpuDiracTwistedMass {
+
+  public:
+    cpuDiracTwistedMassPC(const DiracParam &param);
+    cpuDiracTwistedMassPC(const cpuDiracTwistedMassPC &dirac);
+    virtual ~cpuDiracTwistedMassPC();
+
+    void TwistInv(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    virtual void Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+			const QudaParity parity) const;
+    virtual void DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+			    const QudaParity parity, const cpuColorSpinorField &x, const double &k) const;
+    void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+		 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+		 const QudaSolutionType) const;
+    void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+		     const QudaSolutionType) const;
+  };
+
+  // Full staggered (host)
+  class cpuDiracStaggered : public cpuDirac {
+
+  protected:
+    const cpuGaugeField &fatGauge;
+    const cpuGaugeField &longGauge;
+
+  public:
+    cpuDiracStaggered(const DiracParam &param);
+    cpuDiracStaggered(const cpuDiracStaggered &dirac);
+    virtual ~cpuDiracStaggered();
+
+    virtual void checkParitySpinor(const cpuColorSpinorField &, const cpuColorSpinorField &) const;
+  
+    virtual void Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+			const QudaParity parity) const;
+    virtual void DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+			    const QudaParity parity, const cpuColorSpinorField &x, const double &k) const;
+    virtual void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    virtual void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    virtual void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+			 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+			 const QudaSolutionType) const;
+    virtual void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+			     const QudaSolutionType) const;
+  };
+
+  // Even-odd preconditioned staggered (host)
+  class cpuDiracStaggeredPC : public cpuDiracStaggered {
+
+  public:
+    cpuDiracStaggeredPC(const DiracParam &param);
+    cpuDiracStaggeredPC(const cpuDiracStaggeredPC &dirac);
+    virtual ~cpuDiracStaggeredPC();
+
+    virtual void M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+    virtual void MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const;
+
+    virtual void prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+			 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+			 const QudaSolutionType) const;
+    virtual void reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+			     const QudaSolutionType) const;
+  };
+
   // Functor base class for applying a given Dirac matrix (M, MdagM, etc.)
+  // Exactly one of the device and host operators is set.
   class DiracMatrix {
 
   protected:
     const Dirac *dirac;
+    const cpuDirac *hostDirac;
 
   public:
-  DiracMatrix(const Dirac &d) : dirac(&d) { }
-  DiracMatrix(const Dirac *d) : dirac(d) { }
+  DiracMatrix(const Dirac &d) : dirac(&d), hostDirac(0) { }
+  DiracMatrix(const Dirac *d) : dirac(d), hostDirac(0) { }
+  DiracMatrix(const cpuDirac &d) : dirac(0), hostDirac(&d) { }
+  DiracMatrix(const cpuDirac *d) : dirac(0), hostDirac(d) { }
     virtual ~DiracMatrix() = 0;
 
     virtual void operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in) const = 0;
@@ -404,9 +759,22 @@ namespace quda {
     virtual void operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in,
 			    cudaColorSpinorField &Tmp1, cudaColorSpinorField &Tmp2) const = 0;
 
-    unsigned long long flops() const { return dirac->Flops(); }
+    virtual void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in) const = 0;
+    virtual void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+			    cpuColorSpinorField &tmp) const = 0;
+    virtual void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+			    cpuColorSpinorField &Tmp1, cpuColorSpinorField &Tmp2) const = 0;
+
+    // apply the operator to nRhs fields at once (the device operators
+    // have no multi-RHS kernels, so these apply one field at a time)
+    virtual void operator()(cudaColorSpinorField **out, cudaColorSpinorField **in, const int nRhs) const = 0;
+    virtual void operator()(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const = 0;
+
+    unsigned long long flops() const { return dirac ? dirac->Flops() : hostDirac->Flops(); }
+
+    std::string Type() const { return dirac ? typeid(*dirac).name() : typeid(*hostDirac).name(); }
 
-    std::string Type() const { return typeid(*dirac).name(); }
+    QudaFieldLocation Location() const { return dirac ? QUDA_CUDA_FIELD_LOCATION : QUDA_CPU_FIELD_LOCATION; }
   };
 
   inline DiracMatrix::~DiracMatrix()
@@ -419,6 +787,8 @@ namespace quda {
   public:
   DiracM(const Dirac &d) : DiracMatrix(d) { }
   DiracM(const Dirac *d) : DiracMatrix(d) { }
+  DiracM(const cpuDirac &d) : DiracMatrix(d) { }
+  DiracM(const cpuDirac *d) : DiracMatrix(d) { }
 
     void operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in) const
     {
@@ -441,6 +811,38 @@ namespace quda {
       dirac->tmp2 = NULL;
       dirac->tmp1 = NULL;
     }
+
+    void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+    {
+      hostDirac->M(out, in);
+    }
+
+    void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in, cpuColorSpinorField &tmp) const
+    {
+      hostDirac->tmp1 = &tmp;
+      hostDirac->M(out, in);
+      hostDirac->tmp1 = NULL;
+    }
+
+    void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+		    cpuColorSpinorField &Tmp1, cpuColorSpinorField &Tmp2) const
+    {
+      hostDirac->tmp1 = &Tmp1;
+      hostDirac->tmp2 = &Tmp2;
+      hostDirac->M(out, in);
+      hostDirac->tmp2 = NULL;
+      hostDirac->tmp1 = NULL;
+    }
+
+    void operator()(cudaColorSpinorField **out, cudaColorSpinorField **in, const int nRhs) const
+    {
+      for (int r=0; r<nRhs; r++) dirac->M(*out[r], *in[r]);
+    }
+
+    void operator()(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+    {
+      hostDirac->MBlock(out, in, nRhs);
+    }
   };
 
   class DiracMdagM : public DiracMatrix {
@@ -448,6 +850,8 @@ namespace quda {
   public:
     DiracMdagM(const Dirac &d) : DiracMatrix(d), shift(0.0) { }
     DiracMdagM(const Dirac *d) : DiracMatrix(d), shift(0.0) { }
+    DiracMdagM(const cpuDirac &d) : DiracMatrix(d), shift(0.0) { }
+    DiracMdagM(const cpuDirac *d) : DiracMatrix(d), shift(0.0) { }
 
     //! Shift term added onto operator (M^dag M + shift)
     double shift;
@@ -476,6 +880,45 @@ namespace quda {
       dirac->tmp2 = NULL;
       dirac->tmp1 = NULL;
     }
+
+    void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+    {
+      hostDirac->MdagM(out, in);
+      if (shift != 0.0) axpyCpu(shift, in, out);
+    }
+
+    void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in, cpuColorSpinorField &tmp) const
+    {
+      hostDirac->tmp1 = &tmp;
+      hostDirac->MdagM(out, in);
+      if (shift != 0.0) axpyCpu(shift, in, out);
+      hostDirac->tmp1 = NULL;
+    }
+
+    void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+		    cpuColorSpinorField &Tmp1, cpuColorSpinorField &Tmp2) const
+    {
+      hostDirac->tmp1 = &Tmp1;
+      hostDirac->tmp2 = &Tmp2;
+      hostDirac->MdagM(out, in);
+      if (shift != 0.0) axpyCpu(shift, in, out);
+      hostDirac->tmp2 = NULL;
+      hostDirac->tmp1 = NULL;
+    }
+
+    void operator()(cudaColorSpinorField **out, cudaColorSpinorField **in, const int nRhs) const
+    {
+      for (int r=0; r<nRhs; r++) {
+	dirac->MdagM(*out[r], *in[r]);
+	if (shift != 0.0) axpyCuda(shift, *in[r], *out[r]);
+      }
+    }
+
+    void operator()(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+    {
+      hostDirac->MdagMBlock(out, in, nRhs);
+      if (shift != 0.0) for (int r=0; r<nRhs; r++) axpyCpu(shift, *in[r], *out[r]);
+    }
   };
 
   class DiracMdag : public DiracMatrix {
@@ -483,6 +926,8 @@ namespace quda {
   public:
   DiracMdag(const Dirac &d) : DiracMatrix(d) { }
   DiracMdag(const Dirac *d) : DiracMatrix(d) { }
+  DiracMdag(const cpuDirac &d) : DiracMatrix(d) { }
+  DiracMdag(const cpuDirac *d) : DiracMatrix(d) { }
 
     void operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in) const
     {
@@ -505,6 +950,38 @@ namespace quda {
       dirac->tmp2 = NULL;
       dirac->tmp1 = NULL;
     }
+
+    void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+    {
+      hostDirac->Mdag(out, in);
+    }
+
+    void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in, cpuColorSpinorField &tmp) const
+    {
+      hostDirac->tmp1 = &tmp;
+      hostDirac->Mdag(out, in);
+      hostDirac->tmp1 = NULL;
+    }
+
+    void operator()(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+		    cpuColorSpinorField &Tmp1, cpuColorSpinorField &Tmp2) const
+    {
+      hostDirac->tmp1 = &Tmp1;
+      hostDirac->tmp2 = &Tmp2;
+      hostDirac->Mdag(out, in);
+      hostDirac->tmp2 = NULL;
+      hostDirac->tmp1 = NULL;
+    }
+
+    void operator()(cudaColorSpinorField **out, cudaColorSpinorField **in, const int nRhs) const
+    {
+      for (int r=0; r<nRhs; r++) dirac->Mdag(*out[r], *in[r]);
+    }
+
+    void operator()(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+    {
+      hostDirac->MdagBlock(out, in, nRhs);
+    }
   };
 
 } // namespace quda
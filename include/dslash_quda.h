@@ -49,6 +49,16 @@ namespace quda {
 			const int oddBit, const int daggerBit, const cudaColorSpinorField *x,
 			const double &k, const int *commDim, TimeProfile &profile);
 
+  // plain Wilson Dslash on the host
+  void wilsonDslashCpu(cpuColorSpinorField *out, const cpuGaugeField &gauge, const cpuColorSpinorField *in,
+		       const int parity, const int dagger, const cpuColorSpinorField *x,
+		       const double &k, const int *commDim);
+
+  // multi-RHS Wilson Dslash on the host: applied to nRhs fields at once, sharing the link loads
+  void wilsonDslashCpu(cpuColorSpinorField **out, const cpuGaugeField &gauge, cpuColorSpinorField **in,
+		       const int nRhs, const int parity, const int dagger, cpuColorSpinorField **x,
+		       const double &k, const int *commDim);
+
   // clover Dslash
   void cloverDslashCuda(cudaColorSpinorField *out, const cudaGaugeField &gauge, 
 			const FullClover cloverInv, const cudaColorSpinorField *in, 
@@ -65,17 +75,36 @@ namespace quda {
   void cloverCuda(cudaColorSpinorField *out, const cudaGaugeField &gauge, const FullClover clover, 
 		  const cudaColorSpinorField *in, const int oddBit);
 
+  // solo clover term on the host (out = A in, or out = x + k A in if x is set)
+  void cloverCpu(cpuColorSpinorField *out, const cpuCloverField &clover, const cpuColorSpinorField *in,
+		 const int parity, const bool inverse, const cpuColorSpinorField *x, const double &k);
+
+  // multi-RHS version of the above, sharing the clover loads across the nRhs fields
+  void cloverCpu(cpuColorSpinorField **out, const cpuCloverField &clover, cpuColorSpinorField **in,
+		 const int nRhs, const int parity, const bool inverse, cpuColorSpinorField **x,
+		 const double &k);
+
   // domain wall Dslash  
   void domainWallDslashCuda(cudaColorSpinorField *out, const cudaGaugeField &gauge, const cudaColorSpinorField *in, 
 			    const int parity, const int dagger, const cudaColorSpinorField *x, 
 			    const double &m_f, const double &k, const int *commDim, TimeProfile &profile);
 
+  // domain wall Dslash on the host
+  void domainWallDslashCpu(cpuColorSpinorField *out, const cpuGaugeField &gauge, const cpuColorSpinorField *in, 
+			   const int parity, const int dagger, const cpuColorSpinorField *x, 
+			   const double &m_f, const double &k, const int *commDim);
+
   // staggered Dslash    
   void staggeredDslashCuda(cudaColorSpinorField *out, const cudaGaugeField &fatGauge, const cudaGaugeField &longGauge,
 			   const cudaColorSpinorField *in, const int parity, const int dagger, 
 			   const cudaColorSpinorField *x, const double &k, 
 			   const int *commDim, TimeProfile &profile);
 
+  // staggered Dslash on the host (out = D in, or out = k x - D in if x is set)
+  void staggeredDslashCpu(cpuColorSpinorField *out, const cpuGaugeField &fatGauge, const cpuGaugeField &longGauge,
+			  const cpuColorSpinorField *in, const int parity, const int dagger, 
+			  const cpuColorSpinorField *x, const double &k, const int *commDim);
+
   // twisted mass Dslash  
   void twistedMassDslashCuda(cudaColorSpinorField *out, const cudaGaugeField &gauge, const   cudaColorSpinorField *in, 
 			     const int parity, const int dagger, const cudaColorSpinorField *x, const QudaTwistDslashType type,
@@ -86,6 +115,11 @@ namespace quda {
                        const double &kappa, const double &mu, const double &epsilon, 
                        const QudaTwistGamma5Type);
 
+  // solo twist term on the host for a single flavor (out = T in, or out = x + k T in if x is set)
+  void twistGamma5Cpu(cpuColorSpinorField *out, const cpuColorSpinorField *in, const int dagger,
+		      const double &kappa, const double &mu, const QudaTwistGamma5Type twist,
+		      const cpuColorSpinorField *x, const double &k);
+
   // face packing routines
   void packFace(void *ghost_buf, cudaColorSpinorField &in, const int dagger, const int parity, const cudaStream_t &stream);
 
@@ -84,6 +84,7 @@ extern "C" {
     QUDA_BICGSTAB_INVERTER,
     QUDA_GCR_INVERTER,
     QUDA_MR_INVERTER,
+    QUDA_SSTEP_CG_INVERTER,
     QUDA_INVALID_INVERTER = QUDA_INVALID_ENUM
   } QudaInverterType;
 
@@ -2,9 +2,11 @@
 #define _FACE_QUDA_H
 
 #include <map>
+#include <vector>
 #include <quda_internal.h>
 #include <color_spinor_field.h>
 #include <comm_quda.h>
+#include <repro_sum.h>
 
 namespace quda {
   class FaceBuffer {
@@ -44,6 +46,13 @@ namespace quda {
     MsgHandle* mh_recv_back[QUDA_MAX_DIM];
     MsgHandle* mh_send_fwd[QUDA_MAX_DIM];
     MsgHandle* mh_send_back[QUDA_MAX_DIM];
+
+    // Message handles of a host spinor exchange, and whether they are still in flight
+    MsgHandle* mh_cpu_recv_fwd[QUDA_MAX_DIM];
+    MsgHandle* mh_cpu_recv_back[QUDA_MAX_DIM];
+    MsgHandle* mh_cpu_send_fwd[QUDA_MAX_DIM];
+    MsgHandle* mh_cpu_send_back[QUDA_MAX_DIM];
+    bool cpuPending[QUDA_MAX_DIM];
    
     int Ninternal; // number of internal degrees of freedom (12 for spin projected Wilson, 6 for staggered)
     QudaPrecision precision;
@@ -99,6 +108,27 @@ namespace quda {
     void scatter(quda::cudaColorSpinorField &out, int dagger, int dir);
     
     void exchangeCpuSpinor(quda::cpuColorSpinorField &in, int parity, int dagger);
+
+    /**
+       Pack the ghost zone of a host spinor field and start its
+       exchange, which is completed dimension by dimension with
+       exchangeCpuSpinorQuery() or exchangeCpuSpinorWait().  The ghost
+       buffers of the field must not be read before then.
+       @param in The field whose ghost zone we are exchanging
+       @param parity The parity of this field
+       @param dagger Whether the operator for which we are applying is the Hermitian conjugate or not
+     */
+    void exchangeCpuSpinorStart(quda::cpuColorSpinorField &in, int parity, int dagger);
+
+    /**
+       @param dim The dimension to test
+       @return Whether the ghost zones of dimension dim have arrived (the
+       exchange in this dimension is then complete)
+     */
+    int exchangeCpuSpinorQuery(int dim);
+
+    /** Wait for the ghost zones of dimension dim to arrive */
+    void exchangeCpuSpinorWait(int dim);
     
     void exchangeLink(void** ghost_link, void** link_sendbuf, QudaFieldLocation location);
     
@@ -109,6 +139,55 @@ namespace quda {
 void reduceMaxDouble(double &);
 void reduceDouble(double &);
 void reduceDoubleArray(double *, const int len);
+MsgHandle *reduceDoubleArrayAsync(double *, const int len);
+void reduceDoubleArrayWait(MsgHandle *);
+
+/**
+   Whether reductions are reproducible, set by the environment
+   variable QUDA_REPRODUCIBLE_REDUCE.  The host blas then sums exactly
+   over the sites and over all nodes, so that its results do not
+   depend on the partitioning of the lattice, and reduceDouble() and
+   reduceDoubleArray() sum exactly over the nodes.  Reproducible sums
+   are never deferred: ReduceBatch and reduceDoubleArrayAsync() then
+   reduce immediately.  The setting is read on the first call, which
+   initQuda makes before any host kernel runs.
+*/
+bool reduceReproducible();
+
+/** Sum accumulators over all nodes exactly, and round the results */
+void reduceReproArray(quda::ReproSum *sum, double *result, const int len);
+
+namespace quda {
+
+  /**
+     Batches global reductions.  While a ReduceBatch exists the
+     reductions done by the blas functions are node local; the
+     results registered with add() are then summed over all nodes
+     together by flush() with a single allreduce, instead of one
+     allreduce each.  Only independent results may be batched, and
+     batches must not be nested.  When reductions are reproducible
+     the blas functions reduce globally as usual and flush() does
+     nothing.
+   */
+  class ReduceBatch {
+
+  private:
+    bool reduceState; // globalReduce when the batch was opened
+    std::vector< std::pair<double*, int> > sums;
+
+  public:
+    ReduceBatch();
+    virtual ~ReduceBatch();
+
+    void add(double &sum) { sums.push_back(std::make_pair(&sum, 1)); }
+    void add(Complex &sum) { sums.push_back(std::make_pair(reinterpret_cast<double*>(&sum), 2)); }
+    void add(double3 &sum) { sums.push_back(std::make_pair(&sum.x, 3)); }
+
+    /** Sum the registered results over all nodes, in place */
+    void flush();
+  };
+
+}
 int commDim(int);
 int commCoords(int);
 int commDimPartitioned(int dir);
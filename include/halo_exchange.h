@@ -0,0 +1,168 @@
+#ifndef _HALO_EXCHANGE_H
+#define _HALO_EXCHANGE_H
+
+#include <quda_internal.h>
+#include <comm_quda.h>
+
+namespace quda {
+
+  /**
+     Describes a host field stored on an extended lattice, i.e., one
+     whose local sites are surrounded by a halo of R[d] layers on
+     either side in each dimension.
+   */
+  struct HaloParam {
+    int X[4];         // local lattice dimensions, excluding the halo
+    int R[4];         // halo depth in each dimension
+    size_t siteBytes; // bytes per site in each array
+    int nArray;       // number of arrays holding the field, e.g., 4 for QDP ordered links
+    int parity;       // parity of the stored sites, or -1 if both parities are stored
+    bool corners;     // whether to fill the halo sites that lie outside more than one dimension
+
+    HaloParam() : siteBytes(0), nArray(1), parity(-1), corners(true) {
+      for (int d=0; d<4; d++) X[d] = R[d] = 0;
+    }
+
+    bool operator==(const HaloParam &p) const {
+      for (int d=0; d<4; d++) if (X[d] != p.X[d] || R[d] != p.R[d]) return false;
+      return siteBytes == p.siteBytes && nArray == p.nArray && parity == p.parity && corners == p.corners;
+    }
+  };
+
+  /**
+     Fills the halo of host fields on an extended lattice of dimensions
+     E[d] = X[d] + 2*R[d].  Sites are stored in even-odd order, at
+     lex/2 + parity*volumeEx/2 (or at lex/2 for single-parity fields),
+     where lex is the lexicographic index of the extended coordinates
+     and the parity is that of their sum.
+
+     The halo of each dimension is sent as one message per direction,
+     through buffers and persistent message handles that are set up
+     once per geometry and reused for every exchange.  Dimensions that
+     are not partitioned are filled periodically from the local sites.
+     With corners, the message of dimension d includes the halos of the
+     dimensions below d, so exchanging the dimensions in turn also
+     fills the diagonal neighbors; without, the messages span the
+     local sites only and all dimensions may be in flight at once.
+   */
+  class HaloExchange {
+
+  private:
+    HaloParam param;
+    int E[4];
+    size_t volumeEx;
+    size_t bytes[4]; // bytes per message in each dimension
+
+    void *sendBuf[4][2]; // indexed by [dim][0 = backwards, 1 = forwards]
+    void *recvBuf[4][2];
+    MsgHandle *mhSend[4][2];
+    MsgHandle *mhRecv[4][2];
+    bool pending[4];
+
+    enum TransferType { HALO_COUNT, HALO_PACK, HALO_UNPACK };
+
+    /**
+       Walk the R[dim] layers of dimension dim starting at extended
+       coordinate begin, copying them to or from buf in message order.
+       @return The number of bytes covered
+     */
+    size_t transfer(void **field, int dim, int begin, char *buf, TransferType type) const;
+
+  public:
+    HaloExchange(const HaloParam &param);
+    virtual ~HaloExchange();
+
+    const HaloParam& Param() const { return param; }
+
+    /** Pack the layers of dimension dim and start sending them to the neighbors */
+    void start(void **field, int dim);
+
+    /** @return Whether the halo of dimension dim has arrived */
+    int query(int dim);
+
+    /** Wait for the halo of dimension dim and unpack it into the field */
+    void wait(void **field, int dim);
+
+    /**
+       Fill the halo of the field in all dimensions
+       @param field The arrays holding the field
+       @param partitionedOnly Whether to leave the halo of dimensions that are not partitioned untouched
+     */
+    void exchange(void **field, bool partitionedOnly=false);
+
+    /**
+       Return an exchange for the given parameters, setting it up if
+       it has not been requested before.  Exchanges are cached until
+       freeCache() is called.
+     */
+    static HaloExchange& Get(const HaloParam &param);
+    static void freeCache();
+  };
+
+  class cpuColorSpinorField;
+
+  /**
+     Exchanges the ghost zone of a single parity host spinor field for
+     the host dslash.  Each face is packed into a send buffer owned by
+     the exchange and received into a ghost buffer owned by it, through
+     message handles that are declared once and reused for every
+     exchange.  Dimensions without messages are given the periodic
+     copy of the local faces, i.e., the send buffers.  The ghost zones
+     are laid out as by cpuColorSpinorField::packGhost().
+   */
+  class SpinorGhostExchange {
+
+  private:
+    int X[4];       // local lattice dimensions
+    int Ls;
+    int nFace;
+    int nSpin;
+    QudaPrecision precision;
+    int slot;       // distinguishes the exchanges of fields that are in flight together
+    size_t bytes[4]; // bytes per message in each dimension
+
+    void *sendBuf[4][2]; // indexed by [dim][0 = backwards, 1 = forwards]
+    void *recvBuf[4][2];
+    MsgHandle *mhSend[4][2];
+    MsgHandle *mhRecv[4][2];
+    bool pending[4];
+
+    void *fwd[4];  // the ghost zone of each dimension
+    void *back[4];
+
+  public:
+    SpinorGhostExchange(const int *X, const int nFace, const int nSpin, const QudaPrecision precision,
+			const int Ls, const int slot);
+    virtual ~SpinorGhostExchange();
+
+    /**
+       Pack the faces of the dimensions with comm[d] set and start
+       sending them to the neighbors.
+       @param in The field whose ghost zone is exchanged
+       @param parity The parity of the field
+     */
+    void start(cpuColorSpinorField &in, const int parity, const int dagger, const int *comm);
+
+    /** @return Whether the ghost zone of dimension dim has arrived (the exchange is then complete) */
+    int query(int dim);
+
+    /** Wait for the ghost zone of dimension dim */
+    void wait(int dim);
+
+    void* const* Fwd() const { return fwd; }
+    void* const* Back() const { return back; }
+
+    /**
+       Return an exchange for fields of the given geometry, setting it
+       up if it has not been requested before.  Exchanges are cached
+       until freeCache() is called.
+       @param slot Index of the exchange, for fields whose ghost zones are needed at the same time
+     */
+    static SpinorGhostExchange& Get(const int *X, const int nFace, const int nSpin, const QudaPrecision precision,
+				    const int Ls=1, const int slot=0);
+    static void freeCache();
+  };
+
+} // namespace quda
+
+#endif // _HALO_EXCHANGE_H
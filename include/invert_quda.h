@@ -6,6 +6,8 @@
 #include <dirac_quda.h>
 #include <color_spinor_field.h>
 
+#include <vector>
+
 namespace quda {
 
   /**
@@ -178,6 +180,7 @@ namespace quda {
     virtual ~Solver() { ; }
 
     virtual void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in) = 0;
+    virtual void operator()(cpuColorSpinorField &out, cpuColorSpinorField &in) = 0;
 
     // solver factory
     static Solver* create(SolverParam &param, DiracMatrix &mat, DiracMatrix &matSloppy,
@@ -207,11 +210,88 @@ namespace quda {
     const DiracMatrix &mat;
     const DiracMatrix &matSloppy;
 
+    template <typename Field> void solve(Field &out, Field &in);
+
+    /**
+       Pipelined CG, used when param.pipeline is set, which overlaps
+       the global sum of each iteration with the operator application
+    */
+    template <typename Field> void solvePipelined(Field &out, Field &in);
+
   public:
     CG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
     virtual ~CG();
 
     void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in);
+    void operator()(cpuColorSpinorField &out, cpuColorSpinorField &in);
+  };
+
+  /**
+     Cholesky factorization A = L L^dagger of the Hermitian m x m
+     matrix A (row major), for the small dense systems of the block
+     solvers.  Returns false if A is not numerically positive
+     definite.
+  */
+  bool cholesky(std::vector<Complex> &L, const std::vector<Complex> &A, const int m);
+
+  /**
+     Solve (L L^dagger) X = B in place for the m x n matrix B (row
+     major), with L from cholesky().
+  */
+  void choleskySolve(std::vector<Complex> &B, const std::vector<Complex> &L, const int m, const int n);
+
+  /**
+     Block conjugate gradient (O'Leary) for several right-hand sides of
+     the same Hermitian positive-definite system.  The sources share a
+     single Krylov space and the operator is applied to the whole block
+     of search directions at once.  Converged right-hand sides are
+     removed from the block, and if the remaining search directions
+     become linearly dependent the unconverged systems are finished
+     one at a time with CG.
+   */
+  class BlockCG : public Solver {
+
+  private:
+    DiracMatrix &mat; // non-const, since it is handed on to CG if the block solve breaks down
+    DiracMatrix &matSloppy;
+
+    template <typename Field> void solve(Field **out, Field **in, const int nRhs);
+
+  public:
+    BlockCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~BlockCG();
+
+    void operator()(cudaColorSpinorField **out, cudaColorSpinorField **in, const int nRhs);
+    void operator()(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs);
+
+    void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in);
+    void operator()(cpuColorSpinorField &out, cpuColorSpinorField &in);
+  };
+
+  /**
+     Communication-avoiding s-step CG (Chronopoulos and Gear).  Each
+     step builds the s Krylov vectors r, A r, ..., A^{s-1} r with
+     matrix powers and makes them A-conjugate to the previous block;
+     all the inner products a step needs come from one Gram-matrix
+     reduction, so there are s times fewer global sums than in CG.
+     The block size s is param.Nkrylov.  The monomial basis becomes
+     ill-conditioned as s grows, so s of 4 or less is recommended
+     with a single or half precision sloppy operator.
+   */
+  class SStepCG : public Solver {
+
+  private:
+    const DiracMatrix &mat;
+    const DiracMatrix &matSloppy;
+
+    template <typename Field> void solve(Field &out, Field &in);
+
+  public:
+    SStepCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~SStepCG();
+
+    void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in);
+    void operator()(cpuColorSpinorField &out, cpuColorSpinorField &in);
   };
 
   class BiCGstab : public Solver {
@@ -221,16 +301,21 @@ namespace quda {
     const DiracMatrix &matSloppy;
     const DiracMatrix &matPrecon;
 
-    // pointers to fields to avoid multiple creation overhead
-    cudaColorSpinorField *yp, *rp, *pp, *vp, *tmpp, *tp;
+    // pointers to fields to avoid multiple creation overhead (these
+    // are either all device or all host fields)
+    ColorSpinorField *yp, *rp, *pp, *vp, *tmpp, *tp;
     bool init;
 
+    void freeFields();
+    template <typename Field> void solve(Field &out, Field &in);
+
   public:
     BiCGstab(DiracMatrix &mat, DiracMatrix &matSloppy, DiracMatrix &matPrecon,
 	     SolverParam &param, TimeProfile &profile);
     virtual ~BiCGstab();
 
     void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in);
+    void operator()(cpuColorSpinorField &out, cpuColorSpinorField &in);
   };
 
   class GCR : public Solver {
@@ -243,29 +328,36 @@ namespace quda {
     Solver *K;
     SolverParam Kparam; // parameters for preconditioner solve
 
+    template <typename Field> void solve(Field &out, Field &in);
+
   public:
     GCR(DiracMatrix &mat, DiracMatrix &matSloppy, DiracMatrix &matPrecon,
 	SolverParam &param, TimeProfile &profile);
     virtual ~GCR();
 
     void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in);
+    void operator()(cpuColorSpinorField &out, cpuColorSpinorField &in);
   };
 
   class MR : public Solver {
 
   private:
     const DiracMatrix &mat;
-    cudaColorSpinorField *rp;
-    cudaColorSpinorField *Arp;
-    cudaColorSpinorField *tmpp;
+    ColorSpinorField *rp;
+    ColorSpinorField *Arp;
+    ColorSpinorField *tmpp;
     bool init;
     bool allocate_r;
 
+    void freeFields();
+    template <typename Field> void solve(Field &out, Field &in);
+
   public:
     MR(DiracMatrix &mat, SolverParam &param, TimeProfile &profile);
     virtual ~MR();
 
     void operator()(cudaColorSpinorField &out, cudaColorSpinorField &in);
+    void operator()(cpuColorSpinorField &out, cpuColorSpinorField &in);
   };
 
   // multigrid solver
@@ -293,6 +385,7 @@ namespace quda {
     virtual ~MultiShiftSolver() { ; }
 
     virtual void operator()(cudaColorSpinorField **out, cudaColorSpinorField &in) = 0;
+    virtual void operator()(cpuColorSpinorField **out, cpuColorSpinorField &in) = 0;
   };
 
   class MultiShiftCG : public MultiShiftSolver {
@@ -301,11 +394,14 @@ namespace quda {
     const DiracMatrix &mat;
     const DiracMatrix &matSloppy;
 
+    template <typename Field> void solve(Field **out, Field &in);
+
   public:
     MultiShiftCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
     virtual ~MultiShiftCG();
 
     void operator()(cudaColorSpinorField **out, cudaColorSpinorField &in);
+    void operator()(cpuColorSpinorField **out, cpuColorSpinorField &in);
   };
 
   /**
@@ -338,6 +434,55 @@ namespace quda {
 		    cudaColorSpinorField **q, int N);
   };
 
+  /**
+     A resident version of MinResExt for a stream of related solves,
+     e.g., those for one pseudofermion along an HMC trajectory.  The
+     basis is orthonormalised incrementally as solutions are added,
+     and the products q_i = A p_i and the projected matrix G_ij =
+     p_i^dagger A p_j are kept, so that adding a solution costs one
+     application of the operator and forming a guess costs none.
+     When the basis is full, the oldest vector is discarded.  If the
+     operator changes, refresh() restores the exact minimisation at
+     the cost of Dim() applications; without it the stale q and G
+     still give an approximate guess.
+  */
+  class ChronoBasis {
+
+  protected:
+    const int maxDim;
+    std::vector<cudaColorSpinorField*> p; // the orthonormal basis
+    std::vector<cudaColorSpinorField*> q; // A p
+    std::vector< std::vector<Complex> > G; // p^dagger A p
+
+  public:
+    ChronoBasis(int maxDim);
+    virtual ~ChronoBasis();
+
+    /** @return The number of vectors in the basis */
+    int Dim() const { return p.size(); }
+
+    /**
+       Recompute q and G after the operator has changed (e.g., the
+       gauge field has been updated), costing one application of the
+       operator per basis vector.  The basis itself is kept.
+       param mat The new operator
+    */
+    void refresh(const DiracMatrix &mat);
+
+    /**
+       param x The guess minimising the residual of A x = b over the basis
+       param b The source vector, which is preserved
+    */
+    void guess(cudaColorSpinorField &x, cudaColorSpinorField &b);
+
+    /**
+       Add the component of x orthogonal to the basis.
+       param x The solution vector to add
+       param mat The operator of the solve
+    */
+    void add(cudaColorSpinorField &x, const DiracMatrix &mat);
+  };
+
 } // namespace quda
 
 #endif // _INVERT_QUDA_H
@@ -0,0 +1,122 @@
+#ifndef _LATTICE_GEOMETRY_H
+#define _LATTICE_GEOMETRY_H
+
+#include <quda_internal.h>
+
+namespace quda {
+
+  /**
+     Precomputed nearest-neighbor tables for a 4-d even-odd
+     checkerboarded lattice, used by the host operators so that the
+     coordinate arithmetic is done once per geometry rather than once
+     per site and direction.
+
+     Sites are addressed by their checkerboard index cb within a
+     parity, and directions are numbered dir = 2*mu (forwards) and
+     dir = 2*mu+1 (backwards).  A table entry n >= 0 is the
+     checkerboard index of the neighbor (whose parity is flipped if
+     the hop distance is odd).  In dimensions flagged in ghostDim, a
+     hop that crosses the boundary instead gives n < 0, with
+     -(n+1) = depth*faceVolumeCB[mu] + face/2, where depth counts the
+     ghost layers away from the boundary (0 = adjacent) and face is
+     the lexicographic index over the three remaining dimensions.  Use
+     Ghost() to turn this into an offset into a ghost buffer holding
+     nFace layers.
+   */
+  class LatticeGeometry {
+
+  private:
+    int x[4];
+    int volume;
+    int volumeCB;
+    int faceVolumeCB[4];
+    int nFace; // largest hop distance that is tabulated
+    int ghostDim[4]; // whether hops in this dimension leave the local lattice
+
+    int *table[2]; // distance one and distance nFace tables
+
+    int *faceSites[2][4]; // sites of each parity within nFace of a boundary in each ghost dimension
+    int nFaceSites[2][4];
+
+    void computeTable(int *table, int distance);
+    void computeFaceSites();
+
+  public:
+    LatticeGeometry(const int *X, const int nFace=1, const int *ghostDim=0);
+    virtual ~LatticeGeometry();
+
+    const int* X() const { return x; }
+    int X(int d) const { return x[d]; }
+    int Volume() const { return volume; }
+    int VolumeCB() const { return volumeCB; }
+    int FaceVolumeCB(int d) const { return faceVolumeCB[d]; }
+    int Nface() const { return nFace; }
+    bool GhostDim(int d) const { return ghostDim[d]; }
+
+    /**
+       @param parity Parity of the site we are hopping from
+       @param dir Direction of the hop (0-7)
+       @param distance Hop distance (1 or nFace)
+       @return Neighbor table indexed by the checkerboard index
+     */
+    const int* Neighbor(int parity, int dir, int distance=1) const {
+      const int *t = table[distance == 1 ? 0 : 1];
+      return t + (parity*8 + dir)*volumeCB;
+    }
+
+    /**
+       Full-lattice index (parity*volumeCB + cb) of the unit-hop
+       neighbor of the full-lattice index i.  Only valid in
+       dimensions without a ghost zone.
+     */
+    int FullNeighbor(int i, int dir) const {
+      const int parity = (i >= volumeCB);
+      return (1-parity)*volumeCB + table[0][(parity*8 + dir)*volumeCB + i - parity*volumeCB];
+    }
+
+    /**
+       @param n Table entry
+       @param dir Direction of the hop that gave this entry
+       @param nFace_ Number of layers held in the ghost buffer being indexed
+       @return Checkerboard offset into the ghost buffer
+     */
+    int Ghost(int n, int dir, int nFace_) const {
+      const int mu = dir/2;
+      const int g = -n - 1;
+      const int depth = g / faceVolumeCB[mu];
+      const int face = g - depth*faceVolumeCB[mu];
+      const int layer = (dir % 2 == 0) ? depth : nFace_ - 1 - depth;
+      return layer*faceVolumeCB[mu] + face;
+    }
+
+    static bool isGhost(int n) { return n < 0; }
+
+    /**
+       Sites with a neighbor (up to distance nFace) in the ghost zone
+       of dimension mu, i.e., those on which the exterior part of an
+       operator acts.  This is empty if mu has no ghost zone.
+       @param parity Parity of the sites
+       @param mu Dimension
+       @param n Number of sites returned
+       @return Checkerboard indices of the sites, in increasing order
+     */
+    const int* FaceSites(int parity, int mu, int &n) const {
+      n = nFaceSites[parity][mu];
+      return faceSites[parity][mu];
+    }
+
+    /** @return Lattice coordinates of the checkerboard site cb */
+    void Coords(int *coord, int cb, int parity) const;
+
+    /**
+       Return a geometry for the given parameters, building it if it
+       has not been requested before.  Geometries are cached until
+       freeCache() is called.
+     */
+    static const LatticeGeometry& Get(const int *X, const int nFace=1, const int *ghostDim=0);
+    static void freeCache();
+  };
+
+} // namespace quda
+
+#endif // _LATTICE_GEOMETRY_H
@@ -38,6 +38,13 @@
  */
 #define QUDA_MAX_MULTI_SHIFT 32
 
+/**
+ * @def QUDA_MAX_CHRONO
+ * @brief Maximum number of resident chronological bases, one per
+ *        stream of related solves, kept by the inverter.
+ */
+#define QUDA_MAX_CHRONO 12
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,6 +57,7 @@ extern "C" {
   typedef struct QudaGaugeParam_s {
 
     QudaFieldLocation location; /**< The location of the gauge field */
+    QudaFieldLocation solver_location; /**< The location of the solver using this gauge field (host copies are kept for QUDA_CPU_FIELD_LOCATION) */
 
     int X[4];             /**< The local space-time dimensions (without checkboarding) */
 
@@ -96,6 +104,7 @@ extern "C" {
 
     QudaFieldLocation input_location; /**< The location of the input field */
     QudaFieldLocation output_location; /**< The location of the output field */
+    QudaFieldLocation solver_location; /**< The location where the solver is run */
 
     QudaDslashType dslash_type; /**< The Dirac Dslash type that is being used */
     QudaInverterType inv_type; /**< Which linear solver to use */
@@ -164,6 +173,19 @@ extern "C" {
     QudaCloverFieldOrder clover_order;     /**< The order of the input clover field */
     QudaUseInitGuess use_init_guess;       /**< Whether to use an initial guess in the solver or not */
 
+    /** Whether to form the initial guess from the resident chronological basis chrono_index (overrides use_init_guess) */
+    int chrono_use_resident;
+    /** Whether to add the solution to the resident chronological basis chrono_index */
+    int chrono_make_resident;
+    /** Maximum number of vectors kept in the chronological basis */
+    int chrono_max_dim;
+    /** Whether to recompute the products A p of the chronological basis when the gauge field or the mass
+        parameters change, at the cost of one operator application per basis vector.  Otherwise the stale
+        products are kept, which costs nothing but makes the guess only an approximate minimizer. */
+    int chrono_refresh;
+    /** Which resident chronological basis to use, e.g., one per pseudofermion (0 <= chrono_index < QUDA_MAX_CHRONO) */
+    int chrono_index;
+
     QudaVerbosity verbosity;               /**< The verbosity setting to use in the solver */
 
     int sp_pad;                            /**< The padding to use for the fermion fields */
@@ -177,7 +199,7 @@ extern "C" {
 
     QudaTune tune;                          /**< Enable auto-tuning? (default = QUDA_TUNE_YES) */
 
-    /** Maximum size of Krylov space used by solver */
+    /** Maximum size of Krylov space used by solver (the block size s for the s-step CG) */
     int gcrNkrylov;
 
     /*
@@ -325,6 +347,19 @@ extern "C" {
    */
   void initQuda(int device);
 
+  /**
+   * Initialize the library without a device, for running the host
+   * solvers only.  No device is selected and no device memory, streams
+   * or events are set up, and only the host copies of the gauge and
+   * clover fields are kept.  Only loadGaugeQuda(), loadCloverQuda(),
+   * invertQuda(), invertBlockQuda(), MatQuda() and MatDagMatQuda() may
+   * then be used, with solver_location = QUDA_CPU_FIELD_LOCATION and
+   * host input fields.  The library must still be linked against the
+   * CUDA runtime, but makes no device calls.  Call either this or
+   * initQuda(), not both.
+   */
+  void initQudaHost();
+
   /**
    * Finalize the library.
    */
@@ -405,6 +440,63 @@ extern "C" {
    */
   void invertQuda(void *h_x, void *h_b, QudaInvertParam *param);
 
+  /**
+   * Create a solver context that keeps the Dirac operators, the
+   * solver and the device source and solution fields alive between
+   * solves, for repeated calls to invertContextQuda() with the same
+   * operator.  The operators are rebuilt automatically if the gauge
+   * or clover field is reloaded.  Only supported with solver_location
+   * = QUDA_CUDA_FIELD_LOCATION.
+   * @param param  Contains all metadata regarding host and device
+   *               storage and solver parameters
+   * @return Handle to the solver context
+   */
+  void* newInvertContextQuda(QudaInvertParam *param);
+
+  /**
+   * Perform the solve using a context created by
+   * newInvertContextQuda().  The operator, solver type and field
+   * layout in param must match those the context was created with;
+   * the tolerances, iteration limit and initial-guess setting may
+   * change between calls.
+   * @param context  Handle returned by newInvertContextQuda()
+   * @param h_x      Solution spinor field
+   * @param h_b      Source spinor field
+   * @param param    Contains all metadata regarding host and device
+   *                 storage and solver parameters
+   */
+  void invertContextQuda(void *context, void *h_x, void *h_b, QudaInvertParam *param);
+
+  /**
+   * Free a solver context created by newInvertContextQuda().
+   * @param context  Handle returned by newInvertContextQuda()
+   */
+  void destroyInvertContextQuda(void *context);
+
+  /**
+   * Free a resident chronological basis built up by solves with
+   * chrono_make_resident set, e.g., at the start of a new trajectory.
+   * @param index  The chrono_index of the basis to free, or -1 to
+   *               free them all
+   */
+  void flushChronoQuda(int index);
+
+  /**
+   * Solve for a batch of sources with the same operator using block
+   * CG.  The operator setup is done once for the batch, and the
+   * sources share a single Krylov space.  Requires inv_type =
+   * QUDA_CG_INVERTER and a NORMOP or NORMOP_PC solve_type.  On
+   * return, true_res is the largest relative residual and
+   * true_res_offset[i] is the residual of source i (for the first
+   * QUDA_MAX_MULTI_SHIFT sources).
+   * @param h_x    Array of solution spinor fields
+   * @param h_b    Array of source spinor fields
+   * @param nrhs   Number of sources
+   * @param param  Contains all metadata regarding host and device
+   *               storage and solver parameters
+   */
+  void invertBlockQuda(void **h_x, void **h_b, int nrhs, QudaInvertParam *param);
+
   /**
    * Solve for multiple shifts (e.g., masses).
    * @param _hp_x    Array of solution spinor fields
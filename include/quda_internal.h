@@ -5,6 +5,8 @@
 #include <cuda_runtime.h>
 #include <sys/time.h>
 #include <string>
+#include <vector>
+#include <map>
 #include <complex>
 
 #if ((defined(QMP_COMMS) || defined(MPI_COMMS)) && !defined(MULTI_GPU))
@@ -176,8 +178,41 @@ namespace quda {
     static std::string pname[];
 
     bool switchOff;
-    
-    TimeProfile(std::string fname) : fname(fname), switchOff(false) { ; }
+
+    /**
+       A named region of code, e.g., a solver.  Regions nest in the
+       region that was open when they were started, and accumulate the
+       time of the categories that are stopped while they are open.
+     */
+    struct Region {
+      std::string name;
+      int parent; /**< Index of the enclosing region, or -1 at the top level */
+      Timer timer;
+      double time[QUDA_PROFILE_COUNT];
+      int count[QUDA_PROFILE_COUNT];
+
+      Region(const std::string &name, int parent);
+    };
+
+    std::vector<Region> region;
+    std::map<std::pair<int, std::string>, int> child; /**< Index of each region, keyed by its parent and name */
+    int current; /**< Index of the innermost open region, or -1 */
+
+    /**< An interval recorded for the trace, in seconds since the epoch */
+    struct Event {
+      std::string name;
+      double start;
+      double duration;
+      bool nested; /**< Whether the interval nests with the others, rather than overlapping them */
+    };
+
+    std::vector<Event> trace;
+    static bool tracing; /**< Whether the intervals are recorded, i.e., QUDA_PROFILE_OUTPUT is set */
+
+    TimeProfile(std::string fname);
+    TimeProfile(const TimeProfile &p);
+    TimeProfile& operator=(const TimeProfile &p);
+    virtual ~TimeProfile();
 
     /**< Print out the profile information */
     void Print();
@@ -194,10 +229,12 @@ namespace quda {
 
     void Stop(QudaProfileType idx) { 
       profile[idx].Stop(); 
+      if (current >= 0 || tracing) Record(idx);
 
       // switch off total timer if we need to
       if (switchOff && idx != QUDA_PROFILE_TOTAL) {
 	profile[QUDA_PROFILE_TOTAL].Stop(); 
+	if (current >= 0 || tracing) Record(QUDA_PROFILE_TOTAL);
 	switchOff = false;
       }
     }
@@ -206,6 +243,66 @@ namespace quda {
       return profile[idx].last;
     }
 
+    /**< Open a region nested in the current one */
+    void StartRegion(const std::string &name);
+
+    /**< Close the current region, which must be the one given */
+    void StopRegion(const std::string &name);
+
+    /**
+       Account for an interval that does not nest with the others,
+       e.g., a message in flight.  It is accumulated as a region of
+       the current one, and may overlap its siblings.
+       @param start The start of the interval, as returned by Now()
+       @param stop The end of the interval, as returned by Now()
+     */
+    void Interval(const std::string &name, double start, double stop);
+
+    /**< @return The wall-clock time in seconds since the epoch */
+    static double Now();
+
+    /**
+       Write out all profiles, if QUDA_PROFILE_OUTPUT is set: rank 0
+       writes <prefix>.json, with the mean, min and max across ranks of
+       every category and region, and each rank writes its intervals to
+       <prefix>.<rank>.trace.json in the Chrome trace format.  This is
+       collective over all ranks.
+     */
+    static void Save();
+
+  private:
+    bool registered; /**< Whether the profile is part of what Save() writes out */
+
+    TimeProfile(const std::string &fname, bool registered);
+
+    /**< Add the interval last timed for the category to the open regions and the trace */
+    void Record(QudaProfileType idx);
+
+    /**< Add an interval to the trace */
+    void Trace(const std::string &name, double start, double duration, bool nested);
+
+    /**< @return The index of the named region in the given parent, adding it if absent */
+    int Child(int parent, const std::string &name);
+
+    /**< Accumulate another profile of the same function */
+    void Merge(const TimeProfile &p);
+
+    void PrintRegions(int parent, int depth);
+  };
+
+  /**
+     Times a region of a profile for the lifetime of the object, e.g.,
+     ProfileRegion region(profile, "cg");
+   */
+  class ProfileRegion {
+    TimeProfile &profile;
+    const std::string name;
+
+  public:
+    ProfileRegion(TimeProfile &profile, const std::string &name) : profile(profile), name(name) {
+      profile.StartRegion(name);
+    }
+    ~ProfileRegion() { profile.StopRegion(name); }
   };
 
 #ifdef MULTI_GPU
@@ -0,0 +1,128 @@
+#ifndef _REPRO_SUM_H
+#define _REPRO_SUM_H
+
+#include <string.h>
+#include <math.h>
+
+namespace quda {
+
+  /**
+     Exact accumulator for sums of doubles.  Every finite double is an
+     integer multiple of 2^-1074, so a sum of doubles is held exactly
+     as a fixed-point integer, stored in 32-bit digits ("limbs") kept in
+     64-bit integers so that carries need only be propagated every
+     2^29 additions.  Since the accumulated sum is exact, it does not
+     depend on the order of the additions: the rounded value() is the
+     same however the terms are distributed over threads or processes.
+
+     The normalized limbs are below 2^32, so that they are exactly
+     representable as doubles; the sum of the packed limbs of up to
+     2^20 accumulators is then still exact in double precision, which
+     allows accumulators to be summed over processes with the ordinary
+     double precision allreduce.
+   */
+  class ReproSum {
+
+  public:
+    static const int nLimb = 67; // 32*67 bits cover 2^-1074 ... 2^1070
+    static const int packSize = nLimb + 1; // the limbs and the non-finite sum
+
+  private:
+    static const int maxWeight = 1<<29;
+
+    long long limb[nLimb];
+    int weight; // bound on the magnitude of the limbs in units of 2^32
+    double special; // sum of the infinite and NaN terms
+
+    /** Propagate the carries, leaving limbs 0 ... nLimb-2 in [0, 2^32) */
+    void carry() {
+      long long c = 0;
+      for (int i=0; i<nLimb-1; i++) {
+	const long long v = limb[i] + c;
+	limb[i] = v & 0xffffffffLL;
+	c = v >> 32; // arithmetic shift, so this rounds toward -infinity
+      }
+      limb[nLimb-1] += c;
+      weight = 1;
+    }
+
+  public:
+    ReproSum() { clear(); }
+
+    void clear() {
+      for (int i=0; i<nLimb; i++) limb[i] = 0;
+      weight = 0;
+      special = 0.0;
+    }
+
+    inline void add(const double a) {
+      unsigned long long bits;
+      memcpy(&bits, &a, sizeof(double));
+      const int e = (bits >> 52) & 0x7ff;
+      if (e == 0x7ff) { special += a; return; }
+
+      // a = +/- m * 2^(p - 1074)
+      unsigned long long m = bits & 0xfffffffffffffULL;
+      if (e) m |= 0x10000000000000ULL;
+      const int p = e ? e - 1 : 0;
+      const int i = p >> 5, shift = p & 31;
+
+      const unsigned long long lo = (m & 0xffffffffULL) << shift;
+      const unsigned long long hi = (m >> 32) << shift;
+      long long d0 = lo & 0xffffffffULL;
+      long long d1 = (lo >> 32) + (hi & 0xffffffffULL);
+      long long d2 = hi >> 32;
+      if (bits >> 63) { d0 = -d0; d1 = -d1; d2 = -d2; }
+
+      if (weight + 2 >= maxWeight) carry();
+      limb[i] += d0;
+      limb[i+1] += d1;
+      limb[i+2] += d2;
+      weight += 2;
+    }
+
+    void add(const ReproSum &a) {
+      if (weight + a.weight >= maxWeight) carry();
+      for (int i=0; i<nLimb; i++) limb[i] += a.limb[i];
+      weight += a.weight;
+      special += a.special;
+    }
+
+    /** @return The sum rounded to double precision */
+    double value() {
+      if (special != 0.0) return special; // NaN compares unequal too
+      carry();
+
+      // sum the magnitude, which has no large cancelling limbs
+      const bool negative = limb[nLimb-1] < 0;
+      long long mag[nLimb];
+      long long c = 0;
+      for (int i=0; i<nLimb; i++) {
+	const long long v = (negative ? -limb[i] : limb[i]) + c;
+	mag[i] = (i < nLimb-1) ? (v & 0xffffffffLL) : v;
+	c = v >> 32;
+      }
+
+      double sum = 0.0;
+      for (int i=0; i<nLimb; i++) if (mag[i]) sum += ldexp((double)mag[i], 32*i - 1074);
+      return negative ? -sum : sum;
+    }
+
+    /** Store the normalized limbs as packSize doubles */
+    void pack(double *buf) {
+      carry();
+      for (int i=0; i<nLimb; i++) buf[i] = (double)limb[i];
+      buf[nLimb] = special;
+    }
+
+    /** Load limbs stored by pack(), or a sum of packed limbs */
+    void unpack(const double *buf) {
+      for (int i=0; i<nLimb; i++) limb[i] = (long long)buf[i];
+      special = buf[nLimb];
+      weight = maxWeight; // forces a carry before further additions
+    }
+  };
+
+} // namespace quda
+
+#endif // _REPRO_SUM_H
@@ -0,0 +1,84 @@
+#ifndef _SPINOR_CPU_H
+#define _SPINOR_CPU_H
+
+#include <math.h>
+#include <quda_internal.h> // for MAX_SHORT
+
+namespace quda {
+
+  /**
+     Site accessor for host spinor fields in
+     QUDA_SPACE_SPIN_COLOR_FIELD_ORDER, where site i holds n
+     contiguous real numbers.  The host kernels read and write sites
+     only through load() and save(), with the arithmetic done in the
+     register type real, so that a single kernel serves every storage
+     precision.
+   */
+  template <typename Float>
+  struct SpinorCpu {
+    typedef Float real;
+    Float *v;
+
+    SpinorCpu(void *v=0, void *norm=0) : v((Float*)v) { }
+
+    bool valid() const { return v != 0; }
+
+    /** @return An accessor starting the given number of sites into this one */
+    SpinorCpu offset(const size_t sites, const int n) const { return SpinorCpu(v + sites*n); }
+
+    // dst[c*stride] = component c of site i
+    inline void load(real *dst, const int stride, const int i, const int n) const {
+      const Float *p = v + (size_t)i*n;
+      for (int c=0; c<n; c++) dst[c*stride] = p[c];
+    }
+
+    inline void save(const real *src, const int i, const int n) const {
+      Float *p = v + (size_t)i*n;
+      for (int c=0; c<n; c++) p[c] = src[c];
+    }
+  };
+
+  /**
+     Half precision specialization.  Each site is stored as 16-bit
+     fixed-point numbers in units of the largest absolute value on
+     the site, which is kept in a separate single precision norm
+     array.  The conversions are those of the device half precision
+     fields, so host and device half precision data are
+     interchangeable bit for bit.
+   */
+  template <>
+  struct SpinorCpu<short> {
+    typedef float real;
+    short *v;
+    float *norm;
+
+    SpinorCpu(void *v=0, void *norm=0) : v((short*)v), norm((float*)norm) { }
+
+    bool valid() const { return v != 0; }
+
+    SpinorCpu offset(const size_t sites, const int n) const {
+      return SpinorCpu(v + sites*n, norm ? norm + sites : 0);
+    }
+
+    inline void load(real *dst, const int stride, const int i, const int n) const {
+      const short *p = v + (size_t)i*n;
+      const float scale = norm[i];
+      for (int c=0; c<n; c++) dst[c*stride] = (float)p[c] / MAX_SHORT * scale;
+    }
+
+    inline void save(const real *src, const int i, const int n) const {
+      short *p = v + (size_t)i*n;
+      float scale = 0.0f;
+      for (int c=0; c<n; c++) scale = fabsf(src[c]) > scale ? fabsf(src[c]) : scale;
+      norm[i] = scale;
+      if (scale == 0.0f) {
+	for (int c=0; c<n; c++) p[c] = 0;
+      } else {
+	for (int c=0; c<n; c++) p[c] = (short)((src[c] / scale) * MAX_SHORT);
+      }
+    }
+  };
+
+} // namespace quda
+
+#endif // _SPINOR_CPU_H
@@ -0,0 +1,73 @@
+#ifndef _SU3_CPU_H
+#define _SU3_CPU_H
+
+#include <quda_internal.h>
+
+// ---------- su3_cpu.cpp ----------
+
+namespace quda {
+
+  /**
+     Host kernels for the SU(3) and spin algebra of the dslash, acting
+     on structure-of-arrays blocks of n sites.  Real component c of
+     site i is stored at field[c*stride + i], where the components of
+     a site follow the usual ordering: (row*3 + col)*2 + re/im for a
+     link, col*2 + re/im for a color vector and (spin*3 + col)*2 +
+     re/im for a spinor.  A half spinor holds spin components 0 and 1
+     only.  Output blocks must not alias the input blocks.
+
+     Each kernel is compiled for AVX-512, AVX2 and generic x86 (or
+     just generically on other hosts), and the widest instruction set
+     supported by the CPU is selected at run time.  The selection can
+     be overridden by setting QUDA_HOST_SIMD to "scalar", "avx2" or
+     "avx512".
+   */
+
+  enum HostSimdType {
+    HOST_SIMD_SCALAR,
+    HOST_SIMD_AVX2,
+    HOST_SIMD_AVX512
+  };
+
+  /**
+     @return The instruction set used by the host kernels.  It is
+     selected on the first call, which must not be made from within a
+     parallel region; initQuda and the host dslash drivers make it.
+   */
+  HostSimdType hostSimdType();
+
+  /** Force the instruction set used by the host kernels (capped at what the CPU supports) */
+  void setHostSimdType(HostSimdType type);
+
+  const char *hostSimdString(HostSimdType type);
+
+  // out = U * v
+  void su3MatVecCpu(double *out, const double *U, const double *v, int n, int stride);
+  void su3MatVecCpu(float *out, const float *U, const float *v, int n, int stride);
+
+  // out = U^dagger * v
+  void su3MatDagVecCpu(double *out, const double *U, const double *v, int n, int stride);
+  void su3MatDagVecCpu(float *out, const float *U, const float *v, int n, int stride);
+
+  // out = A * B
+  void su3MatMatCpu(double *out, const double *A, const double *B, int n, int stride);
+  void su3MatMatCpu(float *out, const float *A, const float *B, int n, int stride);
+
+  /**
+     Spin projection h = (1 -/+ gamma_mu) psi onto a half spinor, in
+     the DeGrand-Rossi basis.  The projector index is proj = 2*mu +
+     (dir + dagger)%2, as in the host dslash.
+   */
+  void spinProjectCpu(double *h, const double *psi, int proj, int n, int stride);
+  void spinProjectCpu(float *h, const float *psi, int proj, int n, int stride);
+
+  /**
+     Accumulate the full spinor reconstructed from the half spinor h
+     (as produced by spinProjectCpu with the same proj) into out.
+   */
+  void spinReconstructCpu(double *out, const double *h, int proj, int n, int stride);
+  void spinReconstructCpu(float *out, const float *h, int proj, int n, int stride);
+
+} // namespace quda
+
+#endif // _SU3_CPU_H
@@ -8,6 +8,15 @@
 #include <iostream>
 #include <iomanip>
 
+// Hash of the sources the including file is compiled from, defined in
+// lib/Makefile.  Each Tunable passes it to the TuneKey returned by its
+// tuneKey(), so that it is recorded with the cached launch parameters
+// of the kernels in that file and these are re-tuned only when their
+// source has changed.  An empty hash matches any cached entry.
+#ifndef QUDA_SOURCE_HASH
+#define QUDA_SOURCE_HASH ""
+#endif
+
 namespace quda {
 
   class TuneKey {
@@ -16,18 +25,20 @@ namespace quda {
     std::string volume;
     std::string name;
     std::string aux;
+    std::string hash; // source hash, not part of the ordering
 
     TuneKey() { }
-  TuneKey(std::string v, std::string n, std::string a=std::string("type=default"))
-    : volume(v), name(n), aux(a) { }
+  TuneKey(std::string v, std::string n, std::string a, std::string h)
+    : volume(v), name(n), aux(a), hash(h) { }
   TuneKey(const TuneKey &key)
-    : volume(key.volume), name(key.name), aux(key.aux) { }
+    : volume(key.volume), name(key.name), aux(key.aux), hash(key.hash) { }
 
     TuneKey& operator=(const TuneKey &key) {
       if (&key != this) {
 	volume = key.volume;
 	name = key.name;
 	aux = key.aux;
+	hash = key.hash;
       }
       return *this;
     }
@@ -38,6 +49,11 @@ namespace quda {
 	((volume == other.volume) && (name == other.name) && (aux < other.aux));
     }
 
+    /** Whether the cached entry with key other was tuned for the current source */
+    bool current(const TuneKey &other) const {
+      return hash.empty() || other.hash.empty() || hash == other.hash;
+    }
+
   };
 
 
@@ -47,16 +63,25 @@ namespace quda {
     dim3 block;
     dim3 grid;
     int shared_bytes;
+    int threads; // OpenMP threads of a host kernel (0 = all available)
+    int chunk; // dynamic schedule chunk of a host kernel's work loop (0 = static schedule)
+    int simd; // instruction set of a host kernel, a HostSimdType (-1 = the one selected by hostSimdType())
+    float time; // seconds per launch when tuned (0 = unknown)
     std::string comment;
 
-  TuneParam() : block(32, 1, 1), grid(1, 1, 1), shared_bytes(0) { }
+  TuneParam() : block(32, 1, 1), grid(1, 1, 1), shared_bytes(0), threads(0), chunk(0), simd(-1), time(0.0) { }
   TuneParam(const TuneParam &param)
-    : block(param.block), grid(param.grid), shared_bytes(param.shared_bytes), comment(param.comment) { }
+    : block(param.block), grid(param.grid), shared_bytes(param.shared_bytes),
+      threads(param.threads), chunk(param.chunk), simd(param.simd), time(param.time), comment(param.comment) { }
     TuneParam& operator=(const TuneParam &param) {
       if (&param != this) {
 	block = param.block;
 	grid = param.grid;
 	shared_bytes = param.shared_bytes;
+	threads = param.threads;
+	chunk = param.chunk;
+	simd = param.simd;
+	time = param.time;
 	comment = param.comment;
       }
       return *this;
@@ -64,12 +89,40 @@ namespace quda {
 
   };
 
+  /** @return The number of OpenMP threads available to host kernels */
+  int hostMaxThreads();
+
+  /**
+     Applies the launch parameters of a host kernel to the OpenMP
+     parallel regions started in its scope: the number of threads, the
+     schedule of loops declared with schedule(runtime) and, if set, the
+     instruction set of the su3_cpu.h kernels.  The previous settings
+     are restored on destruction.
+   */
+  class HostLaunch {
+
+  private:
+    int threads;
+    int kind;
+    int chunk;
+    int simd;
+
+  public:
+    HostLaunch(const TuneParam &param);
+    virtual ~HostLaunch();
+  };
+
+
+  class Tunable;
+  TuneParam tuneLaunch(Tunable &tunable, QudaTune enabled, QudaVerbosity verbosity);
 
   class Tunable {
 
+    friend TuneParam tuneLaunch(Tunable &tunable, QudaTune enabled, QudaVerbosity verbosity); // uses the performance model
+
   protected:
     virtual long long flops() const = 0;
-    virtual long long bytes() const { return 0; } // FIXME
+    virtual long long bytes() const { return 0; } // bytes loaded and stored per launch, or zero if unknown
 
     // the minimum number of shared bytes per thread
     virtual unsigned int sharedBytesPerThread() const = 0;
@@ -161,6 +214,7 @@ namespace quda {
     virtual ~Tunable() { }
     virtual TuneKey tuneKey() const = 0;
     virtual void apply(const cudaStream_t &stream) = 0;
+    virtual bool hostTunable() const { return false; } // whether this is a host kernel, timed on the host
     virtual void preTune() { }
     virtual void postTune() { }
     virtual int tuningIter() const { return 1; }
@@ -223,7 +277,7 @@ namespace quda {
      * Check the launch parameters of the kernel to ensure that they are
      * valid for the current device.
      */
-    void checkLaunchParam(TuneParam &param) {
+    virtual void checkLaunchParam(TuneParam &param) {
     
       if (param.block.x > (unsigned int)deviceProp.maxThreadsDim[0])
 	errorQuda("Requested X-dimension block size %d greater than hardware limit %d", 
@@ -253,8 +307,83 @@ namespace quda {
 
   };
 
+  /**
+     Base class for host kernels threaded with OpenMP.  The launch
+     parameters are the number of threads and the schedule of the
+     kernel's work loop: static if TuneParam::chunk is zero, otherwise
+     dynamic with chunks of that many iterations.  apply() should get
+     them from tuneLaunch() and hand them to a HostLaunch, and the work
+     loop should be declared with schedule(runtime).  apply() is called
+     with a null stream.  Kernels built on the su3_cpu.h routines may
+     also tune TuneParam::simd, the instruction set those dispatch to
+     at run time, which TunableHost leaves unset.
+   */
+  class TunableHost : public Tunable {
+
+  protected:
+    unsigned int sharedBytesPerThread() const { return 0; }
+    unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
+
+    /** @return The number of iterations of the kernel's work loop */
+    virtual int workItems() const = 0;
+
+    /** @return The smallest chunk of iterations worth scheduling dynamically */
+    virtual int minChunk() const { return 1; }
+
+  public:
+    TunableHost() { }
+    virtual ~TunableHost() { }
+
+    bool hostTunable() const { return true; }
+
+    virtual std::string paramString(const TuneParam &param) const
+      {
+	std::stringstream ps;
+	ps << "threads=" << param.threads << ", schedule=";
+	if (param.chunk) ps << "dynamic," << param.chunk;
+	else ps << "static";
+	return ps.str();
+      }
+
+    virtual void initTuneParam(TuneParam &param) const
+    {
+      param.threads = hostMaxThreads();
+      param.chunk = 0;
+      param.simd = -1;
+    }
+
+    virtual void defaultTuneParam(TuneParam &param) const { initTuneParam(param); }
+
+    /**
+       Try dynamic schedules with chunks growing by factors of four, as
+       long as every thread gets a chunk, then the same with half the
+       threads, down to a quarter of those available.
+     */
+    virtual bool advanceTuneParam(TuneParam &param) const
+    {
+      param.chunk = param.chunk ? 4*param.chunk : minChunk();
+      if ((long)param.chunk*param.threads <= workItems()) return true;
+      param.chunk = 0;
+      param.threads /= 2;
+      return param.threads >= 1 && 4*param.threads >= hostMaxThreads();
+    }
+
+    /** Use all threads if the parameters were tuned with more threads than are available */
+    virtual void checkLaunchParam(TuneParam &param) {
+      if (param.threads < 1 || param.threads > hostMaxThreads()) param.threads = hostMaxThreads();
+      if (param.chunk < 0) param.chunk = 0;
+    }
+
+  };
+
   void loadTuneCache(QudaVerbosity verbosity);
   void saveTuneCache(QudaVerbosity verbosity);
+
+  /**
+     Print the number of launches of each kernel, and its performance
+     at the tuned launch parameters against the machine roofline.
+   */
+  void printLaunchReport(QudaVerbosity verbosity);
   TuneParam tuneLaunch(Tunable &tunable, QudaTune enabled, QudaVerbosity verbosity);
 
 } // namespace quda
@@ -80,7 +80,7 @@ public:
     vol << blasConstants.x[2] << "x";
     vol << blasConstants.x[3];    
     aux << "stride=" << blasConstants.stride << ",prec=" << arg.X.Precision();
-    return TuneKey(vol.str(), typeid(arg.f).name(), aux.str());
+    return TuneKey(vol.str(), typeid(arg.f).name(), aux.str(), QUDA_SOURCE_HASH);
   }  
 
   void apply(const cudaStream_t &stream) {
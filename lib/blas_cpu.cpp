@@ -1,344 +1,1219 @@
+#include <vector>
+#include <string.h>
+#include <typeinfo>
+
 #include <color_spinor_field.h>
 #include <blas_quda.h>
 #include <face_quda.h>
+#include <spinor_cpu.h>
+#include <tune_quda.h>
+
+// Host BLAS.  As with the device BLAS (blas_core.h and
+// reduce_core.h), every operation is expressed as a functor acting on
+// one complex element of up to five fields, and a single driver
+// applies it over the fields, so that compound operations read and
+// write each field exactly once.  The element loop is threaded with
+// OpenMP and written so that the compiler can vectorize it.
+//
+// Reductions are accumulated in double precision and are
+// deterministic: the fields are split into fixed-size chunks, each
+// chunk is summed in a fixed order (over a fixed number of
+// interleaved lanes so that the loop vectorizes) with compensated
+// (Kahan) summation, and the chunk partial sums are combined by
+// pairwise summation.  The result is thus independent of the number
+// of threads, the error within a chunk does not grow with its length,
+// and the error of the combination grows only logarithmically with
+// the field length.
+//
+// When reductions are reproducible (see reduceReproducible()), the
+// functor's results are instead summed over each site in a fixed
+// order and the site sums are accumulated exactly (ReproSum), so that
+// the result does not depend on how the sites are ordered or
+// distributed over threads and nodes.
+//
+// Half precision fields are processed a site at a time: the sites of
+// the distinct fields are converted to single precision, the functor
+// is applied, and the fields flagged as written by the caller (the
+// same write flags as the device blasCuda and reduceCuda) are
+// converted back.
 
 namespace quda {
 
-  template <typename Float>
-  void axpby(const Float &a, const Float *x, const Float &b, Float *y, const int N) {
-    for (int i=0; i<N; i++) y[i] = a*x[i] + b*y[i];
+  namespace blas_cpu {
+
+#define checkSpinor(a, b)						\
+    {									\
+      if (a.Precision() != b.Precision())				\
+	errorQuda("precisions do not match: %d %d", a.Precision(), b.Precision()); \
+      if (a.Length() != b.Length())					\
+	errorQuda("lengths do not match: %d %d", a.Length(), b.Length()); \
+    }
+
+    // number of reals per reduction chunk, and number of interleaved
+    // complex accumulators within a chunk (chunk must be a multiple of 2*nLane)
+    static const int reduceChunk = 4096;
+    static const int nLane = 4;
+
+    // maximum number of reals per site of a half precision field
+    static const int maxSiteLength = 24;
+
+    // add term to sum, carrying the rounding error of the addition in comp
+    static inline void kahanAdd(double &sum, double &comp, const double term) {
+      const double y = term - comp;
+      const double t = sum + y;
+      comp = (t - sum) - y;
+      sum = t;
+    }
+
+    // apply the functor to one element, adding its results to the lane's compensated sums
+    template <typename F, typename Float>
+    static inline void reduceElement(F &f, double *sum, double *comp,
+				     Float *x, Float *y, Float *z, Float *w, Float *v) {
+      double term[F::nReduce];
+      for (int r=0; r<F::nReduce; r++) term[r] = 0.0;
+      f(term, x, y, z, w, v);
+      for (int r=0; r<F::nReduce; r++) kahanAdd(sum[r], comp[r], term[r]);
+    }
+
+    template <template <typename> class Functor, typename Float>
+    void blas(const Complex &a, const Complex &b, const Complex &c, Float *x, Float *y,
+	      Float *z, Float *w, Float *v, const int N) {
+      Functor<Float> f(a, b, c);
+#pragma omp parallel for schedule(runtime)
+      for (int i=0; i<N; i+=2) f(x+i, y+i, z+i, w+i, v+i);
+    }
+
+    /**
+       Set up the half precision site buffers: fields that alias an
+       earlier field share its buffer (so that the functor sees the
+       same in-place semantics as at higher precision), and only the
+       first of each set of aliased fields is loaded.
+    */
+    template <typename Float>
+    static inline void siteAlias(int alias[5], const SpinorCpu<Float> s[5]) {
+      for (int k=0; k<5; k++) {
+	alias[k] = k;
+	for (int j=k-1; j>=0; j--) if (s[j].v == s[k].v) alias[k] = j;
+      }
+    }
+
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW>
+    void blasHalf(const Complex &a, const Complex &b, const Complex &c, const SpinorCpu<short> s[5],
+		  const int volume, const int Nint) {
+      const int write[5] = { writeX, writeY, writeZ, writeW, 0 };
+      int alias[5];
+      siteAlias(alias, s);
+
+#pragma omp parallel for schedule(runtime)
+      for (int i=0; i<volume; i++) {
+	Functor<float> f(a, b, c);
+	float buf[5][maxSiteLength];
+	float *e[5];
+	for (int k=0; k<5; k++) {
+	  e[k] = buf[alias[k]];
+	  if (alias[k] == k) s[k].load(buf[k], 1, i, Nint);
+	}
+	for (int j=0; j<Nint; j+=2) f(e[0]+j, e[1]+j, e[2]+j, e[3]+j, e[4]+j);
+	for (int k=0; k<5; k++) if (write[k]) s[k].save(e[k], i, Nint);
+      }
+    }
+
+    template <typename Float>
+    static inline void fieldSites(SpinorCpu<Float> s[5], int &volume, int &Nint,
+				  const cpuColorSpinorField &x, const cpuColorSpinorField &y,
+				  const cpuColorSpinorField &z, const cpuColorSpinorField &w,
+				  const cpuColorSpinorField &v) {
+      Nint = 2*x.Ncolor()*x.Nspin();
+      if (Nint > maxSiteLength) errorQuda("Site length %d not supported", Nint);
+      volume = x.Length() / Nint;
+      const cpuColorSpinorField *f[5] = { &x, &y, &z, &w, &v };
+      for (int k=0; k<5; k++) s[k] = SpinorCpu<Float>(const_cast<void*>(f[k]->V()), const_cast<void*>(f[k]->Norm()));
+    }
+
+    template <template <typename> class Functor, typename Float>
+    void reduce(double *result, const Complex &a, const Complex &b, const Complex &c,
+		Float *x, Float *y, Float *z, Float *w, Float *v, const int N) {
+      typedef Functor<Float> F;
+      const int nChunk = (N + reduceChunk - 1) / reduceChunk;
+      std::vector<double> partial(nChunk*F::nReduce);
+
+#pragma omp parallel for schedule(runtime)
+      for (int k=0; k<nChunk; k++) {
+	F f(a, b, c);
+	const int begin = k*reduceChunk;
+	const int end = (begin + reduceChunk < N) ? begin + reduceChunk : N;
+	const int vecEnd = begin + (end - begin) / (2*nLane) * (2*nLane);
+
+	double sum[nLane][F::nReduce], comp[nLane][F::nReduce];
+	for (int l=0; l<nLane; l++) for (int r=0; r<F::nReduce; r++) sum[l][r] = comp[l][r] = 0.0;
+
+	for (int i=begin; i<vecEnd; i+=2*nLane) {
+	  for (int l=0; l<nLane; l++) {
+	    const int j = i + 2*l;
+	    reduceElement(f, sum[l], comp[l], x+j, y+j, z+j, w+j, v+j);
+	  }
+	}
+	for (int j=vecEnd; j<end; j+=2) reduceElement(f, sum[0], comp[0], x+j, y+j, z+j, w+j, v+j);
+
+	for (int r=0; r<F::nReduce; r++)
+	  partial[k*F::nReduce + r] = ((sum[0][r] - comp[0][r]) + (sum[1][r] - comp[1][r])) +
+	    ((sum[2][r] - comp[2][r]) + (sum[3][r] - comp[3][r]));
+      }
+
+      // pairwise summation of the chunk partial sums
+      for (int s=1; s<nChunk; s*=2) {
+	for (int k=0; k+s<nChunk; k+=2*s) {
+	  for (int r=0; r<F::nReduce; r++) partial[k*F::nReduce + r] += partial[(k+s)*F::nReduce + r];
+	}
+      }
+
+      for (int r=0; r<F::nReduce; r++) result[r] = nChunk ? partial[r] : 0.0;
+    }
+
+    // half precision reduction, with chunks of whole sites
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW>
+    void reduceHalf(double *result, const Complex &a, const Complex &b, const Complex &c,
+		    const SpinorCpu<short> s[5], const int volume, const int Nint) {
+      typedef Functor<float> F;
+      const int write[5] = { writeX, writeY, writeZ, writeW, 0 };
+      int alias[5];
+      siteAlias(alias, s);
+      const int chunk = reduceChunk / Nint > 0 ? reduceChunk / Nint : 1;
+      const int nChunk = (volume + chunk - 1) / chunk;
+      std::vector<double> partial(nChunk*F::nReduce);
+
+#pragma omp parallel for schedule(runtime)
+      for (int k=0; k<nChunk; k++) {
+	F f(a, b, c);
+	const int end = ((k+1)*chunk < volume) ? (k+1)*chunk : volume;
+
+	double sum[nLane][F::nReduce], comp[nLane][F::nReduce];
+	for (int l=0; l<nLane; l++) for (int r=0; r<F::nReduce; r++) sum[l][r] = comp[l][r] = 0.0;
+
+	for (int i=k*chunk; i<end; i++) {
+	  float buf[5][maxSiteLength];
+	  float *e[5];
+	  for (int m=0; m<5; m++) {
+	    e[m] = buf[alias[m]];
+	    if (alias[m] == m) s[m].load(buf[m], 1, i, Nint);
+	  }
+	  for (int j=0; j<Nint; j+=2) {
+	    const int l = (j/2) % nLane;
+	    reduceElement(f, sum[l], comp[l], e[0]+j, e[1]+j, e[2]+j, e[3]+j, e[4]+j);
+	  }
+	  for (int m=0; m<5; m++) if (write[m]) s[m].save(e[m], i, Nint);
+	}
+
+	for (int r=0; r<F::nReduce; r++)
+	  partial[k*F::nReduce + r] = ((sum[0][r] - comp[0][r]) + (sum[1][r] - comp[1][r])) +
+	    ((sum[2][r] - comp[2][r]) + (sum[3][r] - comp[3][r]));
+      }
+
+      for (int t=1; t<nChunk; t*=2) {
+	for (int k=0; k+t<nChunk; k+=2*t) {
+	  for (int r=0; r<F::nReduce; r++) partial[k*F::nReduce + r] += partial[(k+t)*F::nReduce + r];
+	}
+      }
+
+      for (int r=0; r<F::nReduce; r++) result[r] = nChunk ? partial[r] : 0.0;
+    }
+
+    // applies the blas (reduction = false) or reduction driver of the field precision
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW, bool reduction>
+    struct BlasLaunch { };
+
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW>
+    struct BlasLaunch<Functor, writeX, writeY, writeZ, writeW, false> {
+      static void apply(double *result, const Complex &a, const Complex &b, const Complex &c,
+			const cpuColorSpinorField *const f[5]) {
+	const cpuColorSpinorField &x = *f[0], &y = *f[1], &z = *f[2], &w = *f[3], &v = *f[4];
+	if (x.Precision() == QUDA_DOUBLE_PRECISION)
+	  blas<Functor>(a, b, c, (double*)x.V(), (double*)y.V(), (double*)z.V(),
+			(double*)w.V(), (double*)v.V(), x.Length());
+	else if (x.Precision() == QUDA_SINGLE_PRECISION)
+	  blas<Functor>(a, b, c, (float*)x.V(), (float*)y.V(), (float*)z.V(),
+			(float*)w.V(), (float*)v.V(), x.Length());
+	else if (x.Precision() == QUDA_HALF_PRECISION) {
+	  SpinorCpu<short> s[5];
+	  int volume, Nint;
+	  fieldSites(s, volume, Nint, x, y, z, w, v);
+	  blasHalf<Functor, writeX, writeY, writeZ, writeW>(a, b, c, s, volume, Nint);
+	} else
+	  errorQuda("Precision type %d not implemented", x.Precision());
+      }
+    };
+
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW>
+    struct BlasLaunch<Functor, writeX, writeY, writeZ, writeW, true> {
+      static void apply(double *result, const Complex &a, const Complex &b, const Complex &c,
+			const cpuColorSpinorField *const f[5]) {
+	const cpuColorSpinorField &x = *f[0], &y = *f[1], &z = *f[2], &w = *f[3], &v = *f[4];
+	if (x.Precision() == QUDA_DOUBLE_PRECISION)
+	  reduce<Functor>(result, a, b, c, (double*)x.V(), (double*)y.V(), (double*)z.V(),
+			  (double*)w.V(), (double*)v.V(), x.Length());
+	else if (x.Precision() == QUDA_SINGLE_PRECISION)
+	  reduce<Functor>(result, a, b, c, (float*)x.V(), (float*)y.V(), (float*)z.V(),
+			  (float*)w.V(), (float*)v.V(), x.Length());
+	else if (x.Precision() == QUDA_HALF_PRECISION) {
+	  SpinorCpu<short> s[5];
+	  int volume, Nint;
+	  fieldSites(s, volume, Nint, x, y, z, w, v);
+	  reduceHalf<Functor, writeX, writeY, writeZ, writeW>(result, a, b, c, s, volume, Nint);
+	} else
+	  errorQuda("Precision type %d not implemented", x.Precision());
+      }
+    };
+
+    /**
+       The blas and reduction drivers as host Tunables, tuned per
+       functor, field length and precision.  The fields written by the
+       functor are backed up while tuning.  Reductions leave the node
+       local sums in result.
+    */
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW, bool reduction>
+    class BlasCpu : public TunableHost {
+
+    private:
+      const Complex a, b, c;
+      const cpuColorSpinorField *f[5];
+      double *result;
+      std::vector<char> backup[4];
+
+      int workItems() const {
+	const int N = f[0]->Length();
+	if (f[0]->Precision() != QUDA_HALF_PRECISION) return reduction ? (N + reduceChunk - 1) / reduceChunk : N/2;
+	const int Nint = 2*f[0]->Ncolor()*f[0]->Nspin();
+	const int volume = N / Nint;
+	const int chunk = reduceChunk / Nint > 0 ? reduceChunk / Nint : 1;
+	return reduction ? (volume + chunk - 1) / chunk : volume;
+      }
+
+      int minChunk() const {
+	if (reduction) return 1; // the iterations are already chunks
+	return f[0]->Precision() == QUDA_HALF_PRECISION ? 16 : 256;
+      }
+
+      // whether field k is written and not an alias of an earlier written field
+      bool backedUp(const int k) const {
+	const int write[4] = { writeX, writeY, writeZ, writeW };
+	if (!write[k]) return false;
+	for (int j=0; j<k; j++) if (write[j] && f[j]->V() == f[k]->V()) return false;
+	return true;
+      }
+
+      long long flops() const { return 0; }
+
+      long long bytes() const {
+	int streams = 0;
+	for (int k=0; k<5; k++) {
+	  bool distinct = true;
+	  for (int j=0; j<k; j++) if (f[j]->V() == f[k]->V()) distinct = false;
+	  if (distinct) streams++;
+	}
+	for (int k=0; k<4; k++) if (backedUp(k)) streams++;
+	long long site_bytes = (long long)f[0]->Length()*f[0]->Precision();
+	if (f[0]->Precision() == QUDA_HALF_PRECISION) site_bytes += f[0]->Volume()*sizeof(float);
+	return streams*site_bytes;
+      }
+
+      void launch() { BlasLaunch<Functor, writeX, writeY, writeZ, writeW, reduction>::apply(result, a, b, c, f); }
+
+    public:
+      BlasCpu(const Complex &a, const Complex &b, const Complex &c,
+	      const cpuColorSpinorField &x, const cpuColorSpinorField &y, const cpuColorSpinorField &z,
+	      const cpuColorSpinorField &w, const cpuColorSpinorField &v, double *result)
+	: a(a), b(b), c(c), result(result) {
+	f[0] = &x; f[1] = &y; f[2] = &z; f[3] = &w; f[4] = &v;
+      }
+      virtual ~BlasCpu() { }
+
+      TuneKey tuneKey() const {
+	std::stringstream vol, aux;
+	vol << f[0]->Length();
+	aux << "prec=" << f[0]->Precision() << ",omp=" << hostMaxThreads();
+	return TuneKey(vol.str(), typeid(Functor<float>).name(), aux.str(), QUDA_SOURCE_HASH);
+      }
+
+      void apply(const cudaStream_t &stream) {
+	TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+	HostLaunch hostLaunch(tp);
+	launch();
+      }
+
+      void preTune() {
+	for (int k=0; k<4; k++) {
+	  if (!backedUp(k)) continue;
+	  const char *v = static_cast<const char*>(f[k]->V());
+	  backup[k].assign(v, v + (size_t)f[k]->Length()*f[k]->Precision());
+	  if (f[k]->Precision() == QUDA_HALF_PRECISION) {
+	    const char *norm = static_cast<const char*>(f[k]->Norm());
+	    backup[k].insert(backup[k].end(), norm, norm + (size_t)f[k]->Volume()*sizeof(float));
+	  }
+	}
+      }
+
+      void postTune() {
+	for (int k=0; k<4; k++) {
+	  if (!backedUp(k)) continue;
+	  const size_t bytes = (size_t)f[k]->Length()*f[k]->Precision();
+	  memcpy(const_cast<void*>(f[k]->V()), &backup[k][0], bytes);
+	  if (f[k]->Precision() == QUDA_HALF_PRECISION)
+	    memcpy(const_cast<void*>(f[k]->Norm()), &backup[k][bytes], (size_t)f[k]->Volume()*sizeof(float));
+	  std::vector<char>().swap(backup[k]);
+	}
+      }
+    };
+
+    /**
+       Generic host blas driver.  The functor is applied to every
+       complex element of the fields x, y, z, w and v, where unused
+       fields may be passed as a duplicate of x.  The write flags give
+       the fields that the functor modifies.
+    */
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW>
+    void blasCpu(const Complex &a, const Complex &b, const Complex &c,
+		 const cpuColorSpinorField &x, const cpuColorSpinorField &y, const cpuColorSpinorField &z,
+		 const cpuColorSpinorField &w, const cpuColorSpinorField &v) {
+      checkSpinor(x, y); checkSpinor(x, z); checkSpinor(x, w); checkSpinor(x, v);
+      BlasCpu<Functor, writeX, writeY, writeZ, writeW, false>(a, b, c, x, y, z, w, v, 0).apply(0);
+    }
+
+    // reproducible reduction, summing the site sums exactly
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW,
+	      typename Float>
+    void reduceRepro(ReproSum *result, const Complex &a, const Complex &b, const Complex &c,
+		     const SpinorCpu<Float> s[5], const int volume, const int Nint) {
+      typedef typename SpinorCpu<Float>::real real;
+      typedef Functor<real> F;
+      const int write[5] = { writeX, writeY, writeZ, writeW, 0 };
+      int alias[5];
+      siteAlias(alias, s);
+
+#pragma omp parallel
+      {
+	F f(a, b, c);
+	ReproSum acc[F::nReduce];
+
+#pragma omp for
+	for (int i=0; i<volume; i++) {
+	  real buf[5][maxSiteLength];
+	  real *e[5];
+	  for (int m=0; m<5; m++) {
+	    e[m] = buf[alias[m]];
+	    if (alias[m] == m) s[m].load(buf[m], 1, i, Nint);
+	  }
+	  double sum[F::nReduce];
+	  for (int r=0; r<F::nReduce; r++) sum[r] = 0.0;
+	  for (int j=0; j<Nint; j+=2) f(sum, e[0]+j, e[1]+j, e[2]+j, e[3]+j, e[4]+j);
+	  for (int m=0; m<5; m++) if (write[m]) s[m].save(e[m], i, Nint);
+	  for (int r=0; r<F::nReduce; r++) acc[r].add(sum[r]);
+	}
+
+	// the order of the threads does not matter since the sums are exact
+#pragma omp critical
+	for (int r=0; r<F::nReduce; r++) result[r].add(acc[r]);
+      }
+    }
+
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW,
+	      typename Float>
+    void reduceRepro(ReproSum *result, const Complex &a, const Complex &b, const Complex &c,
+		     const cpuColorSpinorField &x, const cpuColorSpinorField &y, const cpuColorSpinorField &z,
+		     const cpuColorSpinorField &w, const cpuColorSpinorField &v) {
+      SpinorCpu<Float> s[5];
+      int volume, Nint;
+      fieldSites(s, volume, Nint, x, y, z, w, v);
+      reduceRepro<Functor, writeX, writeY, writeZ, writeW>(result, a, b, c, s, volume, Nint);
+    }
+
+    /**
+       Generic host reduction driver, with the same conventions as
+       blasCpu.  The functor's nReduce partial results are summed over
+       the fields and over all processes.
+    */
+    template <template <typename> class Functor, int writeX, int writeY, int writeZ, int writeW>
+    void reduceCpu(double *result, const Complex &a, const Complex &b, const Complex &c,
+		   const cpuColorSpinorField &x, const cpuColorSpinorField &y, const cpuColorSpinorField &z,
+		   const cpuColorSpinorField &w, const cpuColorSpinorField &v) {
+      checkSpinor(x, y); checkSpinor(x, z); checkSpinor(x, w); checkSpinor(x, v);
+
+      if (reduceReproducible()) {
+	ReproSum sum[Functor<float>::nReduce];
+	if (x.Precision() == QUDA_DOUBLE_PRECISION)
+	  reduceRepro<Functor, writeX, writeY, writeZ, writeW, double>(sum, a, b, c, x, y, z, w, v);
+	else if (x.Precision() == QUDA_SINGLE_PRECISION)
+	  reduceRepro<Functor, writeX, writeY, writeZ, writeW, float>(sum, a, b, c, x, y, z, w, v);
+	else if (x.Precision() == QUDA_HALF_PRECISION)
+	  reduceRepro<Functor, writeX, writeY, writeZ, writeW, short>(sum, a, b, c, x, y, z, w, v);
+	else
+	  errorQuda("Precision type %d not implemented", x.Precision());
+	reduceReproArray(sum, result, Functor<float>::nReduce);
+	return;
+      }
+
+      BlasCpu<Functor, writeX, writeY, writeZ, writeW, true>(a, b, c, x, y, z, w, v, result).apply(0);
+      reduceDoubleArray(result, Functor<float>::nReduce);
+    }
+
+#undef checkSpinor
+
+    // complex helpers acting on an element stored as (re, im)
+    template <typename Float>
+    static inline void cmac(Float *y, const Float a_re, const Float a_im, const Float *x) {
+      const Float x_re = x[0], x_im = x[1];
+      y[0] += a_re*x_re - a_im*x_im;
+      y[1] += a_re*x_im + a_im*x_re;
+    }
+
+    template <typename Float>
+    static inline double norm2_(const Float *x) { return (double)x[0]*x[0] + (double)x[1]*x[1]; }
+
+    // accumulates the complex dot product conj(x)*y
+    template <typename Float>
+    static inline void cdot_(double *sum, const Float *x, const Float *y) {
+      sum[0] += (double)x[0]*y[0] + (double)x[1]*y[1];
+      sum[1] += (double)x[0]*y[1] - (double)x[1]*y[0];
+    }
+
+    /**
+       Functor base holding the (up to three) complex coefficients
+    */
+    template <typename Float>
+    struct Coeff {
+      const Float a_re, a_im, b_re, b_im, c_re, c_im;
+      Coeff(const Complex &a, const Complex &b, const Complex &c)
+	: a_re(real(a)), a_im(imag(a)), b_re(real(b)), b_im(imag(b)), c_re(real(c)), c_im(imag(c)) { }
+    };
+
+    /**
+       Functor to perform the operation y = a*x + b*y (real a and b)
+    */
+    template <typename Float>
+    struct axpby : Coeff<Float> {
+      axpby(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) y[j] = this->a_re*x[j] + this->b_re*y[j];
+      }
+    };
+
+    /**
+       Functor to perform the operation x = a*x (real a)
+    */
+    template <typename Float>
+    struct ax : Coeff<Float> {
+      ax(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) x[j] *= this->a_re;
+      }
+    };
+
+    /**
+       Functor to perform the operation y = a*x + b*y
+    */
+    template <typename Float>
+    struct caxpby : Coeff<Float> {
+      caxpby(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	const Float y_re = y[0], y_im = y[1];
+	y[0] = this->b_re*y_re - this->b_im*y_im;
+	y[1] = this->b_re*y_im + this->b_im*y_re;
+	cmac(y, this->a_re, this->a_im, x);
+      }
+    };
+
+    /**
+       Functor to perform the operation y += a*x
+    */
+    template <typename Float>
+    struct caxpy : Coeff<Float> {
+      caxpy(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cmac(y, this->a_re, this->a_im, x);
+      }
+    };
+
+    /**
+       Functor to perform the operation z = x + a*y + b*z
+    */
+    template <typename Float>
+    struct cxpaypbz : Coeff<Float> {
+      cxpaypbz(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	const Float z_re = z[0], z_im = z[1];
+	z[0] = x[0] + this->b_re*z_re - this->b_im*z_im;
+	z[1] = x[1] + this->b_re*z_im + this->b_im*z_re;
+	cmac(z, this->a_re, this->a_im, y);
+      }
+    };
+
+    /**
+       Functor to perform the operations y += a*x, x = b*z + c*x (real a, b and c)
+    */
+    template <typename Float>
+    struct axpyBzpcx : Coeff<Float> {
+      axpyBzpcx(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) {
+	  y[j] += this->a_re*x[j];
+	  x[j] = this->b_re*z[j] + this->c_re*x[j];
+	}
+      }
+    };
+
+    /**
+       Functor to perform the operations y += a*x, x = z + b*x (real a and b)
+    */
+    template <typename Float>
+    struct axpyZpbx : Coeff<Float> {
+      axpyZpbx(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) {
+	  y[j] += this->a_re*x[j];
+	  x[j] = z[j] + this->b_re*x[j];
+	}
+      }
+    };
+
+    /**
+       Functor to perform the operations z += a*x + b*y, y -= b*w
+    */
+    template <typename Float>
+    struct caxpbypzYmbw : Coeff<Float> {
+      caxpbypzYmbw(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cmac(z, this->a_re, this->a_im, x);
+	cmac(z, this->b_re, this->b_im, y);
+	cmac(y, -this->b_re, -this->b_im, w);
+      }
+    };
+
+    /**
+       Functor to perform the operations x = a*x, y += b*x (real a)
+    */
+    template <typename Float>
+    struct cabxpyAx : Coeff<Float> {
+      cabxpyAx(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) x[j] *= this->a_re;
+	cmac(y, this->b_re, this->b_im, x);
+      }
+    };
+
+    /**
+       Functor to perform the operations y += a*x, x -= a*z
+    */
+    template <typename Float>
+    struct caxpyXmaz : Coeff<Float> {
+      caxpyXmaz(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cmac(y, this->a_re, this->a_im, x);
+	cmac(x, -this->a_re, -this->a_im, z);
+      }
+    };
+
+    /**
+       Functor to perform the operation z += a*x + b*y
+    */
+    template <typename Float>
+    struct caxpbypz : Coeff<Float> {
+      caxpbypz(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cmac(z, this->a_re, this->a_im, x);
+	cmac(z, this->b_re, this->b_im, y);
+      }
+    };
+
+    /**
+       Functor to perform the operation w += a*x + b*y + c*z
+    */
+    template <typename Float>
+    struct caxpbypczpw : Coeff<Float> {
+      caxpbypczpw(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cmac(w, this->a_re, this->a_im, x);
+	cmac(w, this->b_re, this->b_im, y);
+	cmac(w, this->c_re, this->c_im, z);
+      }
+    };
+
+    /**
+       Return the L2 norm of x
+    */
+    template <typename Float>
+    struct Norm2 : Coeff<Float> {
+      static const int nReduce = 1;
+      Norm2(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	sum[0] += norm2_(x);
+      }
+    };
+
+    /**
+       Return the real dot product (x,y)
+    */
+    template <typename Float>
+    struct Dot : Coeff<Float> {
+      static const int nReduce = 1;
+      Dot(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	sum[0] += (double)x[0]*y[0] + (double)x[1]*y[1];
+      }
+    };
+
+    /**
+       First performs the operation y += a*x (real a)
+       Second returns the norm of y
+    */
+    template <typename Float>
+    struct axpyNorm2 : Coeff<Float> {
+      static const int nReduce = 1;
+      axpyNorm2(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) y[j] += this->a_re*x[j];
+	sum[0] += norm2_(y);
+      }
+    };
+
+    /**
+       First performs the operation y = x - y
+       Second returns the norm of y
+    */
+    template <typename Float>
+    struct xmyNorm2 : Coeff<Float> {
+      static const int nReduce = 1;
+      xmyNorm2(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) y[j] = x[j] - y[j];
+	sum[0] += norm2_(y);
+      }
+    };
+
+    /**
+       Return the complex dot product (x,y)
+    */
+    template <typename Float>
+    struct Cdot : Coeff<Float> {
+      static const int nReduce = 2;
+      Cdot(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cdot_(sum, x, y);
+      }
+    };
+
+    /**
+       First performs the operation y = x + a*y (real a)
+       Second returns the complex dot product (z,y)
+    */
+    template <typename Float>
+    struct xpaycdotzy : Coeff<Float> {
+      static const int nReduce = 2;
+      xpaycdotzy(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) y[j] = x[j] + this->a_re*y[j];
+	cdot_(sum, z, y);
+      }
+    };
+
+    /**
+       Return the complex dot product (x,y) and the norm of x
+    */
+    template <typename Float>
+    struct CdotNormA : Coeff<Float> {
+      static const int nReduce = 3;
+      CdotNormA(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cdot_(sum, x, y);
+	sum[2] += norm2_(x);
+      }
+    };
+
+    /**
+       Return the complex dot product (x,y) and the norm of y
+    */
+    template <typename Float>
+    struct CdotNormB : Coeff<Float> {
+      static const int nReduce = 3;
+      CdotNormB(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cdot_(sum, x, y);
+	sum[2] += norm2_(y);
+      }
+    };
+
+    /**
+       This convoluted kernel does the following:
+       z += a*x + b*y, y -= b*w, norm = (y,y), dot = (u, y)
+       where u is passed as v
+    */
+    template <typename Float>
+    struct caxpbypzYmbwcDotProductUYNormY : Coeff<Float> {
+      static const int nReduce = 3;
+      caxpbypzYmbwcDotProductUYNormY(const Complex &a, const Complex &b, const Complex &c)
+	: Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cmac(z, this->a_re, this->a_im, x);
+	cmac(z, this->b_re, this->b_im, y);
+	cmac(y, -this->b_re, -this->b_im, w);
+	cdot_(sum, v, y);
+	sum[2] += norm2_(y);
+      }
+    };
+
+    /**
+       First performs the operation y += a*x
+       Second returns the norm of y
+    */
+    template <typename Float>
+    struct caxpyNorm2 : Coeff<Float> {
+      static const int nReduce = 1;
+      caxpyNorm2(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cmac(y, this->a_re, this->a_im, x);
+	sum[0] += norm2_(y);
+      }
+    };
+
+    /**
+       First performs the operations y += a*x, x -= a*z
+       Second returns the norm of x
+    */
+    template <typename Float>
+    struct caxpyXmazNormX : Coeff<Float> {
+      static const int nReduce = 1;
+      caxpyXmazNormX(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cmac(y, this->a_re, this->a_im, x);
+	cmac(x, -this->a_re, -this->a_im, z);
+	sum[0] += norm2_(x);
+      }
+    };
+
+    /**
+       First performs the operations x = a*x, y += b*x (real a)
+       Second returns the norm of y
+    */
+    template <typename Float>
+    struct cabxpyAxNorm : Coeff<Float> {
+      static const int nReduce = 1;
+      cabxpyAxNorm(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) x[j] *= this->a_re;
+	cmac(y, this->b_re, this->b_im, x);
+	sum[0] += norm2_(y);
+      }
+    };
+
+    /**
+       First performs the operation y += a*x
+       Second returns the complex dot product (z,y)
+    */
+    template <typename Float>
+    struct caxpydotzy : Coeff<Float> {
+      static const int nReduce = 2;
+      caxpydotzy(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	cmac(y, this->a_re, this->a_im, x);
+	cdot_(sum, z, y);
+      }
+    };
+
+    /**
+       First performs the operation y = y + a*x (real a)
+       Second returns the norm of y and the real dot product (y, y_new - y_old)
+    */
+    template <typename Float>
+    struct axpyCGNorm2 : Coeff<Float> {
+      static const int nReduce = 2;
+      axpyCGNorm2(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) {
+	  const Float y_new = y[j] + this->a_re*x[j];
+	  sum[0] += (double)y_new*y_new;
+	  sum[1] += (double)y_new*(y_new - y[j]);
+	  y[j] = y_new;
+	}
+      }
+    };
+
+    /**
+       First performs the operation y = y - a*x
+       Second performs the operation z = z + a*w
+       Third performs the operation w = y + b*w (real a and b)
+    */
+    template <typename Float>
+    struct tripleCGUpdate : Coeff<Float> {
+      tripleCGUpdate(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(Float *x, Float *y, Float *z, Float *w, Float *v) {
+	for (int j=0; j<2; j++) {
+	  y[j] -= this->a_re*x[j];
+	  z[j] += this->a_re*w[j];
+	  w[j] = y[j] + this->b_re*w[j];
+	}
+      }
+    };
+
+    /**
+       Return the norm of x, the norm of y and the real dot product (y,z)
+    */
+    template <typename Float>
+    struct tripleCGReduction : Coeff<Float> {
+      static const int nReduce = 3;
+      tripleCGReduction(const Complex &a, const Complex &b, const Complex &c) : Coeff<Float>(a, b, c) { }
+      inline void operator()(double *sum, Float *x, Float *y, Float *z, Float *w, Float *v) {
+	sum[0] += norm2_(x);
+	sum[1] += norm2_(y);
+	sum[2] += (double)y[0]*z[0] + (double)y[1]*z[1];
+      }
+    };
+
+  } // namespace blas_cpu
+
+  using namespace blas_cpu;
+
+  static const Complex zero(0.0, 0.0);
+
+  void zeroCpu(cpuColorSpinorField &a) { a.zero(); }
+
+  template <typename dstFloat, typename srcFloat>
+  static void convert(dstFloat *dst, const srcFloat *src, const int N) {
+#pragma omp parallel for
+    for (int i=0; i<N; i++) dst[i] = src[i];
   }
 
-  void axpbyCpu(const double &a, const cpuColorSpinorField &x, 
-		const double &b, cpuColorSpinorField &y) {
-    if (x.Precision() == QUDA_DOUBLE_PRECISION)
-      axpby(a, (double*)x.V(), b, (double*)y.V(), x.Length());
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      axpby((float)a, (float*)x.V(), (float)b, (float*)y.V(), x.Length());
+  // conversions to and from half precision go site by site
+  template <typename dstFloat, typename srcFloat>
+  static void convert(const SpinorCpu<dstFloat> &dst, const SpinorCpu<srcFloat> &src, const int volume, const int Nint) {
+#pragma omp parallel for
+    for (int i=0; i<volume; i++) {
+      typename SpinorCpu<srcFloat>::real in[maxSiteLength];
+      typename SpinorCpu<dstFloat>::real out[maxSiteLength];
+      src.load(in, 1, i, Nint);
+      for (int c=0; c<Nint; c++) out[c] = in[c];
+      dst.save(out, i, Nint);
+    }
+  }
+
+  template <typename dstFloat>
+  static void convertHalf(cpuColorSpinorField &dst, const cpuColorSpinorField &src) {
+    const int Nint = 2*src.Ncolor()*src.Nspin();
+    if (Nint > maxSiteLength) errorQuda("Site length %d not supported in half precision", Nint);
+    const int volume = src.Length() / Nint;
+    SpinorCpu<dstFloat> d(dst.V(), dst.Norm());
+    void *v = const_cast<void*>(src.V()), *norm = const_cast<void*>(src.Norm());
+    if (src.Precision() == QUDA_DOUBLE_PRECISION)
+      convert(d, SpinorCpu<double>(v), volume, Nint);
+    else if (src.Precision() == QUDA_SINGLE_PRECISION)
+      convert(d, SpinorCpu<float>(v), volume, Nint);
     else
-      errorQuda("Precision type %d not implemented", x.Precision());
+      convert(d, SpinorCpu<short>(v, norm), volume, Nint);
+  }
+
+  void copyCpu(cpuColorSpinorField &dst, const cpuColorSpinorField &src) {
+    // precision conversion between fields of the same layout is a
+    // simple threaded loop, everything else is left to the generic copy
+    if (dst.Precision() != src.Precision() && dst.FieldOrder() == src.FieldOrder() &&
+	dst.FieldOrder() != QUDA_QOP_DOMAIN_WALL_FIELD_ORDER && dst.Length() == src.Length() &&
+	(dst.SiteSubset() == QUDA_PARITY_SITE_SUBSET || dst.SiteOrder() == src.SiteOrder())) {
+      if (dst.Precision() == QUDA_DOUBLE_PRECISION && src.Precision() == QUDA_SINGLE_PRECISION)
+	convert((double*)dst.V(), (const float*)src.V(), dst.Length());
+      else if (dst.Precision() == QUDA_SINGLE_PRECISION && src.Precision() == QUDA_DOUBLE_PRECISION)
+	convert((float*)dst.V(), (const double*)src.V(), dst.Length());
+      else if (dst.Precision() == QUDA_DOUBLE_PRECISION)
+	convertHalf<double>(dst, src);
+      else if (dst.Precision() == QUDA_SINGLE_PRECISION)
+	convertHalf<float>(dst, src);
+      else if (dst.Precision() == QUDA_HALF_PRECISION)
+	convertHalf<short>(dst, src);
+      else
+	errorQuda("Precision combination %d %d not supported", dst.Precision(), src.Precision());
+    } else {
+      dst.copy(src);
+    }
+  }
+
+  void axpbyCpu(const double &a, const cpuColorSpinorField &x,
+		const double &b, cpuColorSpinorField &y) {
+    blasCpu<axpby,0,1,0,0>(a, b, zero, x, y, x, x, x);
   }
 
   void xpyCpu(const cpuColorSpinorField &x, cpuColorSpinorField &y) {
-    if (x.Precision() == QUDA_DOUBLE_PRECISION)
-      axpby(1.0, (double*)x.V(), 1.0, (double*)y.V(), x.Length());
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      axpby(1.0f, (float*)x.V(), 1.0f, (float*)y.V(), x.Length());
-    else
-      errorQuda("Precision type %d not implemented", x.Precision());
+    blasCpu<axpby,0,1,0,0>(1.0, 1.0, zero, x, y, x, x, x);
   }
 
-  void axpyCpu(const double &a, const cpuColorSpinorField &x, 
+  void axpyCpu(const double &a, const cpuColorSpinorField &x,
 	       cpuColorSpinorField &y) {
-    if (x.Precision() == QUDA_DOUBLE_PRECISION)
-      axpby(a, (double*)x.V(), 1.0, (double*)y.V(), x.Length());
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      axpby((float)a, (float*)x.V(), 1.0f, (float*)y.V(), x.Length());
-    else
-      errorQuda("Precision type %d not implemented", x.Precision());
+    blasCpu<axpby,0,1,0,0>(a, 1.0, zero, x, y, x, x, x);
   }
 
-  void xpayCpu(const cpuColorSpinorField &x, const double &a, 
+  void xpayCpu(const cpuColorSpinorField &x, const double &a,
 	       cpuColorSpinorField &y) {
-    if (x.Precision() == QUDA_DOUBLE_PRECISION)
-      axpby(1.0, (double*)x.V(), a, (double*)y.V(), x.Length());
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      axpby(1.0f, (float*)x.V(), (float)a, (float*)y.V(), x.Length());
-    else
-      errorQuda("Precision type %d not implemented", x.Precision());
+    blasCpu<axpby,0,1,0,0>(1.0, a, zero, x, y, x, x, x);
   }
 
   void mxpyCpu(const cpuColorSpinorField &x, cpuColorSpinorField &y) {
-    if (x.Precision() == QUDA_DOUBLE_PRECISION)
-      axpby(-1.0, (double*)x.V(), 1.0, (double*)y.V(), x.Length());
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      axpby(-1.0f, (float*)x.V(), 1.0f, (float*)y.V(), x.Length());
-    else
-      errorQuda("Precision type %d not implemented", x.Precision());
+    blasCpu<axpby,0,1,0,0>(-1.0, 1.0, zero, x, y, x, x, x);
   }
 
   void axCpu(const double &a, cpuColorSpinorField &x) {
-    if (x.Precision() == QUDA_DOUBLE_PRECISION)
-      axpby(0.0, (double*)x.V(), a, (double*)x.V(), x.Length());
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      axpby(0.0f, (float*)x.V(), (float)a, (float*)x.V(), x.Length());
-    else
-      errorQuda("Precision type %d not implemented", x.Precision());
-  }
-
-  template <typename Float>
-  void caxpby(const std::complex<Float> &a, const std::complex<Float> *x,
-	      const std::complex<Float> &b, std::complex<Float> *y, int N) {
-
-    for (int i=0; i<N; i++) {
-      y[i] = a*x[i] + b*y[i];
-    }
-
+    blasCpu<ax,1,0,0,0>(a, zero, zero, x, x, x, x, x);
   }
 
   void caxpyCpu(const Complex &a, const cpuColorSpinorField &x,
 		cpuColorSpinorField &y) {
-
-    if ( x.Precision() == QUDA_DOUBLE_PRECISION)
-      caxpby(a, (Complex*)x.V(), Complex(1.0), 
-	     (Complex*)y.V(), x.Length()/2);
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      caxpby((std::complex<float>)a, (std::complex<float>*)x.V(), std::complex<float>(1.0), 
-	     (std::complex<float>*)y.V(), x.Length()/2);
-    else 
-      errorQuda("Precision type %d not implemented", x.Precision());
+    blasCpu<caxpy,0,1,0,0>(a, zero, zero, x, y, x, x, x);
   }
 
   void caxpbyCpu(const Complex &a, const cpuColorSpinorField &x,
 		 const Complex &b, cpuColorSpinorField &y) {
-
-    if ( x.Precision() == QUDA_DOUBLE_PRECISION)
-      caxpby(a, (Complex*)x.V(), b, (Complex*)y.V(), x.Length()/2);
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      caxpby((std::complex<float>)a, (std::complex<float>*)x.V(), (std::complex<float>)b, 
-	     (std::complex<float>*)y.V(), x.Length()/2);
-    else 
-      errorQuda("Precision type %d not implemented", x.Precision());
-  }
-
-  template <typename Float>
-  void caxpbypcz(const std::complex<Float> &a, const std::complex<Float> *x,
-		 const std::complex<Float> &b, const std::complex<Float> *y, 
-		 const std::complex<Float> &c, std::complex<Float> *z, int N) {
-
-    for (int i=0; i<N; i++) {
-      z[i] = a*x[i] + b*y[i] + c*z[i];
-    }
-
+    blasCpu<caxpby,0,1,0,0>(a, b, zero, x, y, x, x, x);
   }
 
-  void cxpaypbzCpu(const cpuColorSpinorField &x, const Complex &a, 
+  void cxpaypbzCpu(const cpuColorSpinorField &x, const Complex &a,
 		   const cpuColorSpinorField &y, const Complex &b,
 		   cpuColorSpinorField &z) {
-
-    if (x.Precision() == QUDA_DOUBLE_PRECISION)
-      caxpbypcz(Complex(1, 0), (Complex*)x.V(), a, (Complex*)y.V(), 
-		b, (Complex*)z.V(), x.Length()/2);
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      caxpbypcz(std::complex<float>(1, 0), (std::complex<float>*)x.V(), (std::complex<float>)a, (std::complex<float>*)y.V(), 
-		(std::complex<float>)b, (std::complex<float>*)z.V(), x.Length()/2);
-    else 
-      errorQuda("Precision type %d not implemented", x.Precision());
+    blasCpu<cxpaypbz,0,0,1,0>(a, b, zero, x, y, z, x, x);
   }
 
-  void axpyBzpcxCpu(const double &a, cpuColorSpinorField& x, cpuColorSpinorField& y, 
+  // performs the operations: {y[i] = a*x[i] + y[i]; x[i] = b*z[i] + c*x[i]}
+  void axpyBzpcxCpu(const double &a, cpuColorSpinorField& x, cpuColorSpinorField& y,
 		    const double &b, const cpuColorSpinorField& z, const double &c) {
-    axpyCpu(a, x, y);
-    axpbyCpu(b, z, c, x);
+    blasCpu<axpyBzpcx,1,1,0,0>(a, b, c, x, y, z, x, x);
   }
 
   // performs the operations: {y[i] = a*x[i] + y[i]; x[i] = z[i] + b*x[i]}
-  void axpyZpbxCpu(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y, 
+  void axpyZpbxCpu(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y,
 		   const cpuColorSpinorField &z, const double &b) {
-    axpyCpu(a, x, y);
-    xpayCpu(z, b, x);
+    blasCpu<axpyZpbx,1,1,0,0>(a, b, zero, x, y, z, x, x);
   }
 
   // performs the operation z[i] = a*x[i] + b*y[i] + z[i] and y[i] -= b*w[i]
-  void caxpbypzYmbwCpu(const Complex &a, const cpuColorSpinorField &x, const Complex &b, 
+  void caxpbypzYmbwCpu(const Complex &a, const cpuColorSpinorField &x, const Complex &b,
 		       cpuColorSpinorField &y, cpuColorSpinorField &z, const cpuColorSpinorField &w) {
+    blasCpu<caxpbypzYmbw,0,1,1,0>(a, b, zero, x, y, z, w, x);
+  }
 
-    if (x.Precision() == QUDA_DOUBLE_PRECISION)
-      caxpbypcz(a, (Complex*)x.V(), b, (Complex*)y.V(), 
-		Complex(1, 0), (Complex*)z.V(), x.Length()/2);
-    else if (x.Precision() == QUDA_SINGLE_PRECISION)
-      caxpbypcz((std::complex<float>)a, (std::complex<float>*)x.V(), 
-		(std::complex<float>)b, (std::complex<float>*)y.V(), 
-		(std::complex<float>)(1.0f), (std::complex<float>*)z.V(), x.Length()/2);
-    else 
-      errorQuda("Precision type %d not implemented", x.Precision());
+  void cabxpyAxCpu(const double &a, const Complex &b, cpuColorSpinorField &x, cpuColorSpinorField &y) {
+    blasCpu<cabxpyAx,1,1,0,0>(a, b, zero, x, y, x, x, x);
+  }
+
+  void caxpyXmazCpu(const Complex &a, cpuColorSpinorField &x,
+		    cpuColorSpinorField &y, cpuColorSpinorField &z) {
+    blasCpu<caxpyXmaz,1,1,0,0>(a, zero, zero, x, y, z, x, x);
+  }
 
-    caxpyCpu(-b, w, y);
+  void caxpbypzCpu(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y,
+		   cpuColorSpinorField &z) {
+    blasCpu<caxpbypz,0,0,1,0>(a, b, zero, x, y, z, x, x);
   }
 
-  template <typename Float>
-  double norm(const Float *a, const int N) {
-    double norm2 = 0;
-    for (int i=0; i<N; i++) norm2 += a[i]*a[i];
-    return norm2;
+  void caxpbypczpwCpu(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y,
+		      const Complex &c, cpuColorSpinorField &z, cpuColorSpinorField &w) {
+    blasCpu<caxpbypczpw,0,0,0,1>(a, b, c, x, y, z, w, x);
   }
 
   double normCpu(const cpuColorSpinorField &a) {
-    double norm2 = 0.0;
-    if (a.Precision() == QUDA_DOUBLE_PRECISION)
-      norm2 = norm((double*)a.V(), a.Length());
-    else if (a.Precision() == QUDA_SINGLE_PRECISION)
-      norm2 = norm((float*)a.V(), a.Length());
-    else
-      errorQuda("Precision type %d not implemented", a.Precision());
-    reduceDouble(norm2);
+    double norm2;
+    reduceCpu<Norm2,0,0,0,0>(&norm2, zero, zero, zero, a, a, a, a, a);
     return norm2;
   }
 
-  double axpyNormCpu(const double &a, const cpuColorSpinorField &x, 
+  double axpyNormCpu(const double &a, const cpuColorSpinorField &x,
 		     cpuColorSpinorField &y) {
-    axpyCpu(a, x, y);
-    return normCpu(y);
-  }
-
-  template <typename Float>
-  double reDotProduct(const Float *a, const Float *b, const int N) {
-    double dot = 0;
-    for (int i=0; i<N; i++) dot += a[i]*b[i];
-    return dot;
+    double norm2;
+    reduceCpu<axpyNorm2,0,1,0,0>(&norm2, a, zero, zero, x, y, x, x, x);
+    return norm2;
   }
 
   double reDotProductCpu(const cpuColorSpinorField &a, const cpuColorSpinorField &b) {
-    double dot = 0.0;
-    if (a.Precision() == QUDA_DOUBLE_PRECISION)
-      dot = reDotProduct((double*)a.V(), (double*)b.V(), a.Length());
-    else if (a.Precision() == QUDA_SINGLE_PRECISION)
-      dot = reDotProduct((float*)a.V(), (float*)b.V(), a.Length());
-    else
-      errorQuda("Precision type %d not implemented", a.Precision());
-    reduceDouble(dot);
+    double dot;
+    reduceCpu<Dot,0,0,0,0>(&dot, zero, zero, zero, a, b, a, a, a);
     return dot;
   }
 
   // First performs the operation y[i] = x[i] - y[i]
   // Second returns the norm of y
   double xmyNormCpu(const cpuColorSpinorField &x, cpuColorSpinorField &y) {
-    xpayCpu(x, -1, y);
-    return normCpu(y);
-  }
-
-  template <typename Float>
-  Complex cDotProduct(const std::complex<Float> *a, const std::complex<Float> *b, const int N) {
-    quda::Complex dot = 0;
-    for (int i=0; i<N; i++) dot += conj(a[i])*b[i];
-    return dot;
+    double norm2;
+    reduceCpu<xmyNorm2,0,1,0,0>(&norm2, zero, zero, zero, x, y, x, x, x);
+    return norm2;
   }
 
   Complex cDotProductCpu(const cpuColorSpinorField &a, const cpuColorSpinorField &b) {
-    Complex dot = 0.0;
-    if (a.Precision() == QUDA_DOUBLE_PRECISION)
-      dot = cDotProduct((Complex*)a.V(), (Complex*)b.V(), a.Length()/2);
-    else if (a.Precision() == QUDA_SINGLE_PRECISION)
-      dot = cDotProduct((std::complex<float>*)a.V(), (std::complex<float>*)b.V(), a.Length()/2);
-    else
-      errorQuda("Precision type %d not implemented", a.Precision());
-    reduceDoubleArray((double*)&dot, 2);
-    return dot;
+    double dot[2];
+    reduceCpu<Cdot,0,0,0,0>(dot, zero, zero, zero, a, b, a, a, a);
+    return Complex(dot[0], dot[1]);
   }
 
   // First performs the operation y = x + a*y
   // Second returns complex dot product (z,y)
-  Complex xpaycDotzyCpu(const cpuColorSpinorField &x, const double &a, 
-			      cpuColorSpinorField &y, const cpuColorSpinorField &z) {
-    xpayCpu(x, a, y);
-    return cDotProductCpu(z,y);
+  Complex xpaycDotzyCpu(const cpuColorSpinorField &x, const double &a,
+			cpuColorSpinorField &y, const cpuColorSpinorField &z) {
+    double dot[2];
+    reduceCpu<xpaycdotzy,0,1,0,0>(dot, a, zero, zero, x, y, z, x, x);
+    return Complex(dot[0], dot[1]);
   }
 
   double3 cDotProductNormACpu(const cpuColorSpinorField &a, const cpuColorSpinorField &b) {
-    Complex dot = cDotProductCpu(a, b);
-    double norm = normCpu(a);
-    return make_double3(real(dot), imag(dot), norm);
+    double sum[3];
+    reduceCpu<CdotNormA,0,0,0,0>(sum, zero, zero, zero, a, b, a, a, a);
+    return make_double3(sum[0], sum[1], sum[2]);
   }
 
   double3 cDotProductNormBCpu(const cpuColorSpinorField &a, const cpuColorSpinorField &b) {
-    Complex dot = cDotProductCpu(a, b);
-    double norm = normCpu(b);
-    return make_double3(real(dot), imag(dot), norm);
+    double sum[3];
+    reduceCpu<CdotNormB,0,0,0,0>(sum, zero, zero, zero, a, b, a, a, a);
+    return make_double3(sum[0], sum[1], sum[2]);
   }
 
   // This convoluted kernel does the following: z += a*x + b*y, y -= b*w, norm = (y,y), dot = (u, y)
-  double3 caxpbypzYmbwcDotProductUYNormYCpu(const Complex &a, const cpuColorSpinorField &x, 
-					    const Complex &b, cpuColorSpinorField &y, 
-					    cpuColorSpinorField &z, const cpuColorSpinorField &w, 
+  double3 caxpbypzYmbwcDotProductUYNormYCpu(const Complex &a, const cpuColorSpinorField &x,
+					    const Complex &b, cpuColorSpinorField &y,
+					    cpuColorSpinorField &z, const cpuColorSpinorField &w,
 					    const cpuColorSpinorField &u) {
-
-    caxpbypzYmbwCpu(a, x, b, y, z, w);
-    return cDotProductNormBCpu(u, y);
-  }
-
-  void cabxpyAxCpu(const double &a, const Complex &b, cpuColorSpinorField &x, cpuColorSpinorField &y) {
-    axCpu(a, x);
-    caxpyCpu(b, x, y);
+    double sum[3];
+    reduceCpu<caxpbypzYmbwcDotProductUYNormY,0,1,1,0>(sum, a, b, zero, x, y, z, w, u);
+    return make_double3(sum[0], sum[1], sum[2]);
   }
 
-  double caxpyNormCpu(const Complex &a, cpuColorSpinorField &x, 
+  double caxpyNormCpu(const Complex &a, cpuColorSpinorField &x,
 		      cpuColorSpinorField &y) {
-    caxpyCpu(a, x, y);
-    return norm2(y);
+    double norm2;
+    reduceCpu<caxpyNorm2,0,1,0,0>(&norm2, a, zero, zero, x, y, x, x, x);
+    return norm2;
   }
 
-  double caxpyXmazNormXCpu(const Complex &a, cpuColorSpinorField &x, 
+  double caxpyXmazNormXCpu(const Complex &a, cpuColorSpinorField &x,
 			   cpuColorSpinorField &y, cpuColorSpinorField &z) {
-    caxpyCpu(a, x, y);
-    caxpyCpu(-a, z, x);
-    return norm2(x);
+    double norm2;
+    reduceCpu<caxpyXmazNormX,1,1,0,0>(&norm2, a, zero, zero, x, y, z, x, x);
+    return norm2;
   }
 
-  void caxpyXmazCpu(const Complex &a, cpuColorSpinorField &x, 
-		    cpuColorSpinorField &y, cpuColorSpinorField &z) {
-    caxpyCpu(a, x, y);
-    caxpyCpu(-a, z, x);
+  double cabxpyAxNormCpu(const double &a, const Complex &b, cpuColorSpinorField &x, cpuColorSpinorField &y) {
+    double norm2;
+    reduceCpu<cabxpyAxNorm,1,1,0,0>(&norm2, a, b, zero, x, y, x, x, x);
+    return norm2;
   }
 
-  double cabxpyAxNormCpu(const double &a, const Complex &b, cpuColorSpinorField &x, cpuColorSpinorField &y) {
-    axCpu(a, x);
-    caxpyCpu(b, x, y);
-    return norm2(y);
+  Complex caxpyDotzyCpu(const Complex &a, cpuColorSpinorField &x, cpuColorSpinorField &y,
+			cpuColorSpinorField &z) {
+    double dot[2];
+    reduceCpu<caxpydotzy,0,1,0,0>(dot, a, zero, zero, x, y, z, x, x);
+    return Complex(dot[0], dot[1]);
   }
 
-  void caxpbypzCpu(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y, 
-		   cpuColorSpinorField &z) {
-    caxpyCpu(a, x, z);
-    caxpyCpu(b, y, z);
+  Complex axpyCGNormCpu(const double &a, cpuColorSpinorField &x, cpuColorSpinorField &y) {
+    double cg_norm[2];
+    reduceCpu<axpyCGNorm2,0,1,0,0>(cg_norm, a, zero, zero, x, y, x, x, x);
+    return Complex(cg_norm[0], cg_norm[1]);
   }
 
-  void caxpbypczpwCpu(const Complex &a, cpuColorSpinorField &x, const Complex &b, cpuColorSpinorField &y, 
-		      const Complex &c, cpuColorSpinorField &z, cpuColorSpinorField &w) {
-    caxpyCpu(a, x, w);
-    caxpyCpu(b, y, w);
-    caxpyCpu(c, z, w);
+  void tripleCGUpdateCpu(const double &a, const double &b, cpuColorSpinorField &x,
+			 cpuColorSpinorField &y, cpuColorSpinorField &z, cpuColorSpinorField &w) {
+    blasCpu<tripleCGUpdate,0,1,1,1>(a, b, zero, x, y, z, w, x);
+  }
 
+  double3 tripleCGReductionCpu(cpuColorSpinorField &x, cpuColorSpinorField &y, cpuColorSpinorField &z) {
+    double sum[3];
+    reduceCpu<tripleCGReduction,0,0,0,0>(sum, zero, zero, zero, x, y, z, x, x);
+    return make_double3(sum[0], sum[1], sum[2]);
   }
 
-  Complex caxpyDotzyCpu(const Complex &a, cpuColorSpinorField &x, cpuColorSpinorField &y,
-			cpuColorSpinorField &z) {
-    caxpyCpu(a, x, y);
-    return cDotProductCpu(z, y);
+  // returns |x|^2, |r|^2 and |r|^2/|x|^2 on site i, where x is x + y if y is valid
+  template <typename Float>
+  static inline double3 HeavyQuarkResidualSite(const SpinorCpu<Float> &x, const SpinorCpu<Float> &y,
+					       const SpinorCpu<Float> &r, const int i, const int Nint) {
+    typename SpinorCpu<Float>::real xi[maxSiteLength], yi[maxSiteLength], ri[maxSiteLength];
+    x.load(xi, 1, i, Nint);
+    if (y.valid()) y.load(yi, 1, i, Nint);
+    r.load(ri, 1, i, Nint);
+    double x2 = 0;
+    double r2 = 0;
+    for (int j=0; j<Nint; j++) { // loop over internal degrees of freedom
+      const double xl = y.valid() ? (double)xi[j] + yi[j] : xi[j];
+      x2 += xl*xl;
+      r2 += (double)ri[j]*ri[j];
+    }
+    return make_double3(x2, r2, (x2 > 0.0) ? (r2 / x2) : 1.0);
   }
-  
+
+  /**
+     Heavy quark residual norm of x + y (or of x if y is null) and r.
+     Returns the sums over sites of |x|^2, |r|^2 and |r|^2/|x|^2, the
+     latter reduced deterministically in the same way as the blas.
+     If repro is given the site values are instead accumulated there
+     exactly.
+  */
   template <typename Float>
-  double3 HeavyQuarkResidualNorm(const Float *x, const Float *r, const int volume, const int Nint) {
-    
-    double3 sum = make_double3(0.0, 0.0, 0.0);
-    for (int i = 0; i<volume; i++) {
-      double x2 = 0;
-      double r2 = 0;
-      
-      for (int j=0; j<Nint; j++) { // loop over internal degrees of freedom
-	int k = i*Nint + j;
-	x2 += x[k]*x[k];
-	r2 += r[k]*r[k];
-      }
-      
-      sum.x += x2;
-      sum.y += r2;
-      sum.z += (x2 > 0.0) ? (r2 / x2) : 1.0; 
+  static double3 HeavyQuarkResidualNorm(const SpinorCpu<Float> &x, const SpinorCpu<Float> &y,
+					const SpinorCpu<Float> &r, const int volume, const int Nint,
+					ReproSum *repro) {
+    if (repro) {
+#pragma omp parallel
+      {
+	ReproSum acc[3];
+#pragma omp for
+	for (int i=0; i<volume; i++) {
+	  const double3 site = HeavyQuarkResidualSite(x, y, r, i, Nint);
+	  acc[0].add(site.x);
+	  acc[1].add(site.y);
+	  acc[2].add(site.z);
+	}
+#pragma omp critical
+	for (int k=0; k<3; k++) repro[k].add(acc[k]);
+      }
+      return make_double3(0.0, 0.0, 0.0);
+    }
+
+    const int chunk = reduceChunk / Nint > 0 ? reduceChunk / Nint : 1;
+    const int nChunk = (volume + chunk - 1) / chunk;
+    std::vector<double3> partial(nChunk);
+
+#pragma omp parallel for
+    for (int k=0; k<nChunk; k++) {
+      double3 sum = make_double3(0.0, 0.0, 0.0);
+      const int end = ((k+1)*chunk < volume) ? (k+1)*chunk : volume;
+      for (int i=k*chunk; i<end; i++) {
+	const double3 site = HeavyQuarkResidualSite(x, y, r, i, Nint);
+	sum.x += site.x;
+	sum.y += site.y;
+	sum.z += site.z;
+      }
+      partial[k] = sum;
+    }
+
+    for (int s=1; s<nChunk; s*=2) {
+      for (int k=0; k+s<nChunk; k+=2*s) {
+	partial[k].x += partial[k+s].x;
+	partial[k].y += partial[k+s].y;
+	partial[k].z += partial[k+s].z;
+      }
     }
-    return sum;
+    return nChunk ? partial[0] : make_double3(0.0, 0.0, 0.0);
   }
-  
-  
-  double3 HeavyQuarkResidualNormCpu(cpuColorSpinorField &x, cpuColorSpinorField &r) {
+
+  static double3 HeavyQuarkResidualNormCpu(cpuColorSpinorField &x, cpuColorSpinorField *y,
+					   cpuColorSpinorField &r) {
     double3 rtn;
+    const int Nint = 2*x.Ncolor()*x.Nspin();
+    if (Nint > maxSiteLength) errorQuda("Site length %d not supported", Nint);
+    void *yv = y ? y->V() : 0, *yNorm = y ? y->Norm() : 0;
+    ReproSum repro[3];
+    ReproSum *repro_p = reduceReproducible() ? repro : 0;
     if (x.Precision() == QUDA_DOUBLE_PRECISION) {
-      rtn = HeavyQuarkResidualNorm<double>((const double*)(x.V()), (const double*)(r.V()), 
-					   x.Volume(), 2*x.Ncolor()*x.Nspin());
+      rtn = HeavyQuarkResidualNorm(SpinorCpu<double>(x.V()), SpinorCpu<double>(yv),
+				   SpinorCpu<double>(r.V()), x.Volume(), Nint, repro_p);
     } else if (x.Precision() == QUDA_SINGLE_PRECISION) {
-      rtn = HeavyQuarkResidualNorm<float>((const float*)(x.V()), (const float*)(r.V()), 
-					  x.Volume(), 2*x.Ncolor()*x.Nspin());
+      rtn = HeavyQuarkResidualNorm(SpinorCpu<float>(x.V()), SpinorCpu<float>(yv),
+				   SpinorCpu<float>(r.V()), x.Volume(), Nint, repro_p);
+    } else if (x.Precision() == QUDA_HALF_PRECISION) {
+      rtn = HeavyQuarkResidualNorm(SpinorCpu<short>(x.V(), x.Norm()), SpinorCpu<short>(yv, yNorm),
+				   SpinorCpu<short>(r.V(), r.Norm()), x.Volume(), Nint, repro_p);
     } else {
       errorQuda("Precision type %d not implemented", x.Precision());
     }
+    if (repro_p) reduceReproArray(repro, (double*)&rtn, 3);
+    else reduceDoubleArray((double*)&rtn, 3);
 #ifdef MULTI_GPU
     rtn.z /= (x.Volume()*comm_size());
 #else
@@ -346,12 +1221,13 @@ namespace quda {
 #endif
     return rtn;
   }
-  
-  double3 HeavyQuarkResidualNormCpu(cpuColorSpinorField &x, cpuColorSpinorField &y, cpuColorSpinorField &r) {
-    cpuColorSpinorField tmp(x);
-    xpyCpu(y, tmp);
-    return HeavyQuarkResidualNormCpu(tmp, r);
+
+  double3 HeavyQuarkResidualNormCpu(cpuColorSpinorField &x, cpuColorSpinorField &r) {
+    return HeavyQuarkResidualNormCpu(x, 0, r);
   }
 
-} // namespace quda
+  double3 xpyHeavyQuarkResidualNormCpu(cpuColorSpinorField &x, cpuColorSpinorField &y, cpuColorSpinorField &r) {
+    return HeavyQuarkResidualNormCpu(x, &y, r);
+  }
 
+} // namespace quda
@@ -47,6 +47,10 @@ void printQudaGaugeParam(QudaGaugeParam *param) {
   P(location, QUDA_INVALID_FIELD_LOCATION);
 #endif
 
+#ifndef CHECK_PARAM
+  P(solver_location, QUDA_CUDA_FIELD_LOCATION);
+#endif
+
   for (int i=0; i<4; i++) P(X[i], INVALID_INT);
 
 #if defined INIT_PARAM
@@ -198,6 +202,10 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(clover_location, QUDA_INVALID_FIELD_LOCATION);
 #endif
 
+#ifndef CHECK_PARAM
+  P(solver_location, QUDA_CUDA_FIELD_LOCATION);
+#endif
+
 #if defined INIT_PARAM
   P(cuda_prec_precondition, QUDA_INVALID_PRECISION);
 #else
@@ -214,7 +222,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
 #if defined INIT_PARAM
   P(gcrNkrylov, INVALID_INT);
 #else
-  if (param->inv_type == QUDA_GCR_INVERTER) {
+  if (param->inv_type == QUDA_GCR_INVERTER || param->inv_type == QUDA_SSTEP_CG_INVERTER) {
     P(gcrNkrylov, INVALID_INT);
   }
 #endif
@@ -251,6 +259,14 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(omega, INVALID_DOUBLE);
 #endif
 
+#ifndef CHECK_PARAM
+  P(chrono_use_resident, 0);
+  P(chrono_make_resident, 0);
+  P(chrono_max_dim, 0);
+  P(chrono_refresh, 1);
+  P(chrono_index, 0);
+#endif
+
 #ifndef INIT_PARAM
   if (param->dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
 #endif
@@ -235,13 +235,18 @@ namespace quda {
   }
 
   cpuCloverField::cpuCloverField(const CloverFieldParam &param) : CloverField(param) {
-    if (create != QUDA_REFERENCE_FIELD_CREATE) errorQuda("Create type %d not supported", create);
+    if (create != QUDA_NULL_FIELD_CREATE && create != QUDA_REFERENCE_FIELD_CREATE)
+      errorQuda("Create type %d not supported", create);
 
     if (create == QUDA_REFERENCE_FIELD_CREATE) {
       clover = param.clover;
       norm = param.norm;
       cloverInv = param.cloverInv;
       invNorm = param.invNorm;
+    } else {
+      if (precision == QUDA_HALF_PRECISION) errorQuda("Half precision not supported on CPU");
+      if (param.direct) clover = safe_malloc(bytes);
+      if (param.inverse) cloverInv = safe_malloc(bytes);
     }
   }
 
@@ -68,12 +68,11 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
   }
   host_free(hostname_recv_buf);
 
-  int device_count;
+  // having no devices is left to initQudaDevice(), since the host
+  // solvers may be run without one (see initQudaHost())
+  int device_count = 0;
   cudaGetDeviceCount(&device_count);
-  if (device_count == 0) {
-    errorQuda("No CUDA devices found");
-  }
-  if (gpuid >= device_count) {
+  if (device_count > 0 && gpuid >= device_count) {
     errorQuda("Too few GPUs available on %s", hostname);
   }
 }
@@ -180,6 +179,14 @@ void comm_allreduce_array(double* data, size_t size)
 }
 
 
+void comm_allreduce_max_array(double* data, size_t size)
+{
+  double recvbuf[size];
+  MPI_CHECK( MPI_Allreduce(data, &recvbuf, size, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD) );
+  memcpy(data, recvbuf, sizeof(recvbuf));
+}
+
+
 void comm_allreduce_int(int* data)
 {
   int recvbuf;
@@ -188,6 +195,34 @@ void comm_allreduce_int(int* data)
 }
 
 
+/**
+ * Start a sum of the array over all ranks, in place.  The array must
+ * not be touched until comm_allreduce_wait() has returned.
+ */
+MsgHandle *comm_allreduce_async(double* data, size_t size)
+{
+  MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+#if MPI_VERSION >= 3
+  MPI_CHECK( MPI_Iallreduce(MPI_IN_PLACE, data, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &(mh->request)) );
+#else
+  // no non-blocking collectives before MPI-3
+  comm_allreduce_array(data, size);
+  mh->request = MPI_REQUEST_NULL;
+#endif
+  return mh;
+}
+
+
+/**
+ * Complete a sum started with comm_allreduce_async() and free the handle.
+ */
+void comm_allreduce_wait(MsgHandle *mh)
+{
+  MPI_CHECK( MPI_Wait(&(mh->request), MPI_STATUS_IGNORE) );
+  host_free(mh);
+}
+
+
 /**  broadcast from rank 0 */
 void comm_broadcast(void *data, size_t nbytes)
 {
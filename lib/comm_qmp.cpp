@@ -40,13 +40,12 @@ void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *m
 
   // determine which GPU this process will use (FIXME: adopt the scheme in comm_mpi.cpp)
 
-  int device_count;
+  // having no devices is left to initQudaDevice(), since the host
+  // solvers may be run without one (see initQudaHost())
+  int device_count = 0;
   cudaGetDeviceCount(&device_count);
-  if (device_count == 0) {
-    errorQuda("No CUDA devices found");
-  }
 
-  gpuid = (comm_rank() % device_count);
+  gpuid = device_count ? (comm_rank() % device_count) : 0;
 }
 
 
@@ -152,12 +151,42 @@ void comm_allreduce_array(double* data, size_t size)
 }
 
 
+// QMP has no array form of QMP_max_double, so the maximum is taken by a
+// binary reduction, which is told the length of the arrays through here
+static size_t max_array_size;
+
+static void max_array(void *inout, void *in)
+{
+  double *a = static_cast<double*>(inout);
+  const double *b = static_cast<const double*>(in);
+  for (size_t i=0; i<max_array_size; i++) if (b[i] > a[i]) a[i] = b[i];
+}
+
+
+void comm_allreduce_max_array(double* data, size_t size)
+{
+  max_array_size = size;
+  QMP_CHECK( QMP_binary_reduction(data, size*sizeof(double), max_array) );
+}
+
+
 void comm_allreduce_int(int* data)
 {
   QMP_CHECK( QMP_sum_int(data) );
 }
 
 
+// QMP has no non-blocking global sums, so the sum is completed here
+MsgHandle *comm_allreduce_async(double* data, size_t size)
+{
+  comm_allreduce_array(data, size);
+  return NULL;
+}
+
+
+void comm_allreduce_wait(MsgHandle *mh) {}
+
+
 void comm_broadcast(void *data, size_t nbytes)
 {
   QMP_CHECK( QMP_broadcast(data, nbytes) );
@@ -80,7 +80,7 @@ namespace quda {
       std::stringstream vol, aux;
       vol << arg.in.volumeCB; 
       aux << "out_stride=" << arg.out.stride << ",in_stride=" << arg.in.stride;
-      return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+      return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
     }
 
     std::string paramString(const TuneParam &param) const { // Don't bother printing the grid dim.
@@ -87,6 +87,7 @@ namespace quda {
     void packSpinor(OutOrder &outOrder, const InOrder &inOrder, Basis basis, int volume) {  
     typedef typename mapper<FloatIn>::type RegTypeIn;
     typedef typename mapper<FloatOut>::type RegTypeOut;
+#pragma omp parallel for schedule(static)
     for (int x=0; x<volume; x++) {
       RegTypeIn in[Ns*Nc*2];
       RegTypeOut out[Ns*Nc*2];
@@ -151,7 +152,7 @@ namespace quda {
       std::stringstream vol, aux;
       vol << in.volumeCB; 
       aux << "out_stride=" << out.stride << ",in_stride=" << in.stride;
-      return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+      return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
     }
 
     std::string paramString(const TuneParam &param) const { // Don't bother printing the grid dim.
@@ -215,7 +216,7 @@ namespace quda {
       genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>
 	(outOrder, inOrder, out.VolumeCB(), out.GammaBasis(), inBasis, location);
     } else if (out.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
-      SpaceSpinorColorOrder<FloatOut, Ns, Nc> outOrder(out, Out);
+      SpaceSpinorColorOrder<FloatOut, Ns, Nc> outOrder(out, Out, outNorm);
       genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>
 	(outOrder, inOrder, out.VolumeCB(), out.GammaBasis(), inBasis, location);
     } else if (out.FieldOrder() == QUDA_SPACE_COLOR_SPIN_FIELD_ORDER) {
@@ -250,7 +251,7 @@ namespace quda {
       FloatNOrder<FloatIn, Ns, Nc, 2> inOrder(in, In, inNorm);
       genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>(inOrder, out, in.GammaBasis(), location, Out, outNorm);
     } else if (in.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
-      SpaceSpinorColorOrder<FloatIn, Ns, Nc> inOrder(in, In);
+      SpaceSpinorColorOrder<FloatIn, Ns, Nc> inOrder(in, In, inNorm);
       genericCopyColorSpinor<FloatOut,FloatIn,Ns,Nc>(inOrder, out, in.GammaBasis(), location, Out, outNorm);
     } else if (in.FieldOrder() == QUDA_SPACE_COLOR_SPIN_FIELD_ORDER) {
       SpaceColorSpinorOrder<FloatIn, Ns, Nc> inOrder(in, In);
@@ -19,17 +19,34 @@ namespace quda {
   };
 
   /**
-     Generic CPU gauge reordering and packing 
+     Number of sites per block in the CPU gauge reordering.  All
+     dimensions of a block are copied before moving on to the next
+     block, so that orders which interleave the dimensions within a
+     site (MILC, BQCD, CPS) and orders which store each dimension
+     separately (QDP, FloatN) are both traversed with good locality.
+  */
+  static const int copyGaugeBlock = 64;
+
+  /**
+     Generic CPU gauge reordering and packing.  The blocks of sites
+     are distributed over the OpenMP threads.
   */
   template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder>
   void copyGauge(CopyGaugeArg<OutOrder,InOrder> arg) {  
     typedef typename mapper<FloatIn>::type RegTypeIn;
     typedef typename mapper<FloatOut>::type RegTypeOut;
 
-    for (int parity=0; parity<2; parity++) {
+    const int volumeCB = arg.volume/2;
+    const int nBlock = (volumeCB + copyGaugeBlock - 1) / copyGaugeBlock;
+
+#pragma omp parallel for schedule(static)
+    for (int b=0; b<2*nBlock; b++) {
+      const int parity = b / nBlock;
+      const int xBegin = (b % nBlock) * copyGaugeBlock;
+      const int xEnd = (xBegin + copyGaugeBlock < volumeCB) ? xBegin + copyGaugeBlock : volumeCB;
 
       for (int d=0; d<arg.nDim; d++) {
-	for (int x=0; x<arg.volume/2; x++) {
+	for (int x=xBegin; x<xEnd; x++) {
 	  RegTypeIn in[length];
 	  RegTypeOut out[length];
 	  arg.in.load(in, x, d, parity);
@@ -66,16 +83,19 @@ namespace quda {
   }
 
   /**
-     Generic CPU gauge ghost reordering and packing 
+     Generic CPU gauge ghost reordering and packing.  The faces are
+     small, so each face is split over the threads in turn.
   */
   template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder>
     void copyGhost(CopyGaugeArg<OutOrder,InOrder> arg) {  
     typedef typename mapper<FloatIn>::type RegTypeIn;
     typedef typename mapper<FloatOut>::type RegTypeOut;
 
+#pragma omp parallel
     for (int parity=0; parity<2; parity++) {
 
       for (int d=0; d<arg.nDim; d++) {
+#pragma omp for schedule(static)
 	for (int x=0; x<arg.faceVolumeCB[d]; x++) {
 	  RegTypeIn in[length];
 	  RegTypeOut out[length];
@@ -150,7 +170,7 @@ namespace quda {
       std::stringstream vol, aux;
       vol << arg.in.volumeCB; 
       aux << "out_stride=" << arg.out.stride << ",in_stride=" << arg.in.stride;
-      return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+      return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
     }
 
     std::string paramString(const TuneParam &param) const { // Don't bother printing the grid dim.
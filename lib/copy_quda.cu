@@ -69,7 +69,7 @@ namespace quda {
 	vol << blasConstants.x[2] << "x";
 	vol << blasConstants.x[3];
 	aux << "stride=" << blasConstants.stride << ",out_prec=" << Y.Precision() << ",in_prec=" << X.Precision();
-	return TuneKey(vol.str(), "copyKernel", aux.str());
+	return TuneKey(vol.str(), "copyKernel", aux.str(), QUDA_SOURCE_HASH);
       }  
 
       void apply(const cudaStream_t &stream) {
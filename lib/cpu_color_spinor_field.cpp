@@ -39,14 +39,20 @@ namespace quda {
 
   cpuColorSpinorField::cpuColorSpinorField(const ColorSpinorParam &param) :
     ColorSpinorField(param), init(false), reference(false) {
+    // this must come before create so that the parity subsets are set correctly
+    if (param.create == QUDA_REFERENCE_FIELD_CREATE) {
+      v = param.v;
+      if (precision == QUDA_HALF_PRECISION) norm = param.norm;
+      reference = true;
+    }
+
     create(param.create);
     if (param.create == QUDA_NULL_FIELD_CREATE) {
       // do nothing
     } else if (param.create == QUDA_ZERO_FIELD_CREATE) {
       zero();
     } else if (param.create == QUDA_REFERENCE_FIELD_CREATE) {
-      v = param.v;
-      reference = true;
+      // do nothing
     } else {
       errorQuda("Creation type %d not supported", param.create);
     }
@@ -56,6 +62,51 @@ namespace quda {
     ColorSpinorField(src), init(false), reference(false) {
     create(QUDA_COPY_FIELD_CREATE);
     memcpy(v,src.v,bytes);
+    if (precision == QUDA_HALF_PRECISION) memcpy(norm, src.norm, norm_bytes);
+  }
+
+  // creates a copy of src, any differences defined in param
+  cpuColorSpinorField::cpuColorSpinorField(const ColorSpinorField &src, 
+					   const ColorSpinorParam &param) :
+    ColorSpinorField(src), init(false), reference(false) {
+
+    // can only overide if we are not using a reference or parity special case
+    if (param.create != QUDA_REFERENCE_FIELD_CREATE || 
+	(param.create == QUDA_REFERENCE_FIELD_CREATE && 
+	 src.SiteSubset() == QUDA_FULL_SITE_SUBSET && 
+	 param.siteSubset == QUDA_PARITY_SITE_SUBSET && 
+	 typeid(src) == typeid(cpuColorSpinorField) ) ) {
+      reset(param);
+    } else {
+      errorQuda("Undefined behaviour"); // else silent bug possible?
+    }
+
+    // This must be set before create is called
+    if (param.create == QUDA_REFERENCE_FIELD_CREATE) {
+      v = (void*)src.V();
+      norm = (void*)src.Norm();
+      reference = true;
+    }
+
+    create(param.create);
+
+    if (param.create == QUDA_NULL_FIELD_CREATE) {
+      // do nothing
+    } else if (param.create == QUDA_ZERO_FIELD_CREATE) {
+      zero();
+    } else if (param.create == QUDA_COPY_FIELD_CREATE) {
+      if (typeid(src) == typeid(cpuColorSpinorField)) {
+	copy(dynamic_cast<const cpuColorSpinorField&>(src));
+      } else if (typeid(src) == typeid(cudaColorSpinorField)) {
+	dynamic_cast<const cudaColorSpinorField&>(src).saveSpinorField(*this);
+      } else {
+	errorQuda("Unknown input ColorSpinorField %s", typeid(src).name());
+      }
+    } else if (param.create == QUDA_REFERENCE_FIELD_CREATE) {
+      // do nothing
+    } else {
+      errorQuda("CreateType %d not implemented", param.create);
+    }
   }
 
   cpuColorSpinorField::cpuColorSpinorField(const ColorSpinorField &src) : 
@@ -63,6 +114,7 @@ namespace quda {
     create(QUDA_COPY_FIELD_CREATE);
     if (typeid(src) == typeid(cpuColorSpinorField)) {
       memcpy(v, dynamic_cast<const cpuColorSpinorField&>(src).v, bytes);
+      if (precision == QUDA_HALF_PRECISION) memcpy(norm, src.Norm(), norm_bytes);
     } else if (typeid(src) == typeid(cudaColorSpinorField)) {
       dynamic_cast<const cudaColorSpinorField&>(src).saveSpinorField(*this);
     } else {
@@ -120,8 +172,14 @@ namespace quda {
     bytes = total_length * precision; // includes pads and ghost zones
     bytes = ALIGNMENT_ADJUST(bytes);
 
+    // half precision fields store a single precision norm per site,
+    // with the odd parity norms starting at norm_bytes/2
+    if (precision != QUDA_HALF_PRECISION) total_norm_length = 0;
+    norm_bytes = total_norm_length * sizeof(float);
+
     if (pad != 0) errorQuda("Non-zero pad not supported");  
-    if (precision == QUDA_HALF_PRECISION) errorQuda("Half precision not supported");
+    if (precision == QUDA_HALF_PRECISION && fieldOrder != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+      errorQuda("Half precision requires QUDA_SPACE_SPIN_COLOR_FIELD_ORDER, not %d", fieldOrder);
 
     if (fieldOrder != QUDA_SPACE_COLOR_SPIN_FIELD_ORDER && 
 	fieldOrder != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER &&
@@ -139,9 +197,32 @@ namespace quda {
       } else {
 	v = safe_malloc(bytes);
       }
+      if (precision == QUDA_HALF_PRECISION) norm = safe_malloc(norm_bytes);
       init = true;
     }
- 
+
+    // create the associated even and odd subsets (only possible for
+    // checkerboarded fields that are not an array of 4-d fields)
+    if (siteSubset == QUDA_FULL_SITE_SUBSET && fieldOrder != QUDA_QOP_DOMAIN_WALL_FIELD_ORDER &&
+	(siteOrder == QUDA_EVEN_ODD_SITE_ORDER || siteOrder == QUDA_ODD_EVEN_SITE_ORDER)) {
+      ColorSpinorParam param;
+      param.siteSubset = QUDA_PARITY_SITE_SUBSET;
+      param.nDim = nDim;
+      memcpy(param.x, x, nDim*sizeof(int));
+      param.x[0] /= 2; // set single parity dimensions
+      param.create = QUDA_REFERENCE_FIELD_CREATE;
+      even = new cpuColorSpinorField(*this, param);
+      odd = new cpuColorSpinorField(*this, param);
+
+      // the parity stored second starts half way into the full field
+      void *second = (void*)((char*)v + (size_t)(length/2)*precision);
+      void *secondNorm = norm ? (void*)((char*)norm + norm_bytes/2) : 0;
+      cpuColorSpinorField *secondField =
+	dynamic_cast<cpuColorSpinorField*>(siteOrder == QUDA_EVEN_ODD_SITE_ORDER ? odd : even);
+      secondField->v = second;
+      secondField->norm = secondNorm;
+    }
+
   }
 
   void cpuColorSpinorField::destroy() {
@@ -150,18 +231,47 @@ namespace quda {
       if (fieldOrder == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER) 
 	for (int i=0; i<x[nDim-1]; i++) host_free(((void**)v)[i]);
       host_free(v);
+      if (norm) host_free(norm);
+      norm = 0;
       init = false;
     }
 
+    if (siteSubset == QUDA_FULL_SITE_SUBSET) {
+      delete even;
+      delete odd;
+      even = 0;
+      odd = 0;
+    }
+
+  }
+
+  cpuColorSpinorField& cpuColorSpinorField::Even() const { 
+    if (siteSubset == QUDA_FULL_SITE_SUBSET && even) {
+      return *(dynamic_cast<cpuColorSpinorField*>(even)); 
+    }
+
+    errorQuda("Cannot return even subset of %d subset", siteSubset);
+    exit(-1);
+  }
+
+  cpuColorSpinorField& cpuColorSpinorField::Odd() const {
+    if (siteSubset == QUDA_FULL_SITE_SUBSET && odd) {
+      return *(dynamic_cast<cpuColorSpinorField*>(odd)); 
+    }
+
+    errorQuda("Cannot return odd subset of %d subset", siteSubset);
+    exit(-1);
   }
 
   void cpuColorSpinorField::copy(const cpuColorSpinorField &src) {
     checkField(*this, src);
-    if (fieldOrder == src.fieldOrder) {
+    if (fieldOrder == src.fieldOrder && precision == src.precision &&
+	(siteSubset == QUDA_PARITY_SITE_SUBSET || siteOrder == src.siteOrder)) {
       if (fieldOrder == QUDA_QOP_DOMAIN_WALL_FIELD_ORDER) 
-	for (int i=0; i<x[nDim-1]; i++) memcpy(((void**)v)[i], ((void**)src.v)[i], bytes);
+	for (int i=0; i<x[nDim-1]; i++) memcpy(((void**)v)[i], ((void**)src.v)[i], bytes/x[nDim-1]);
       else 
 	memcpy(v, src.v, bytes);
+      if (precision == QUDA_HALF_PRECISION) memcpy(norm, src.norm, norm_bytes);
     } else {
       copyGenericColorSpinor(*this, src, QUDA_CPU_FIELD_LOCATION);
     }
@@ -170,6 +280,7 @@ namespace quda {
   void cpuColorSpinorField::zero() {
     if (fieldOrder != QUDA_QOP_DOMAIN_WALL_FIELD_ORDER) memset(v, '\0', bytes);
     else for (int i=0; i<x[nDim-1]; i++) memset(((void**)v)[i], '\0', bytes/x[nDim-1]);
+    if (precision == QUDA_HALF_PRECISION) memset(norm, '\0', norm_bytes);
   }
 
   void cpuColorSpinorField::Source(QudaSourceType source_type, int x, int s, int c) {
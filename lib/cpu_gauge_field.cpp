@@ -109,9 +109,34 @@ namespace quda {
     // get the links into contiguous buffers
     extractGaugeGhost(*this, send);
 
-    // communicate between nodes
-    FaceBuffer faceBuf(x, nDim, reconstruct, nFace, precision);
-    faceBuf.exchangeLink(ghost, send, QUDA_CPU_FIELD_LOCATION);
+    // communicate between nodes directly from the host buffers, since
+    // FaceBuffer would allocate pinned memory and so require a device
+    size_t bytes[QUDA_MAX_DIM];
+    MsgHandle *mh_send_fwd[QUDA_MAX_DIM];
+    MsgHandle *mh_from_back[QUDA_MAX_DIM];
+    for (int d=0; d<nDim; d++) {
+      bytes[d] = nFace*surface[d]*reconstruct*precision;
+      if (commDimPartitioned(d)) {
+	mh_send_fwd[d] = comm_declare_send_relative(send[d], d, +1, bytes[d]);
+	mh_from_back[d] = comm_declare_receive_relative(ghost[d], d, -1, bytes[d]);
+      } else {
+	memcpy(ghost[d], send[d], bytes[d]);
+      }
+    }
+
+    for (int d=0; d<nDim; d++) {
+      if (!commDimPartitioned(d)) continue;
+      comm_start(mh_send_fwd[d]);
+      comm_start(mh_from_back[d]);
+    }
+
+    for (int d=0; d<nDim; d++) {
+      if (!commDimPartitioned(d)) continue;
+      comm_wait(mh_send_fwd[d]);
+      comm_wait(mh_from_back[d]);
+      comm_free(mh_send_fwd[d]);
+      comm_free(mh_from_back[d]);
+    }
 
     for (int d=0; d<nDim; d++) host_free(send[d]);
 
@@ -0,0 +1,1330 @@
+#include <dirac_quda.h>
+#include <dslash_quda.h>
+#include <blas_quda.h>
+
+#include <iostream>
+#include <vector>
+
+// Host Dirac operators.  These follow the structure of the device
+// operators (dirac.cpp, dirac_wilson.cpp, dirac_clover.cpp, etc.) but
+// apply the host dslash kernels to cpuColorSpinorFields.
+
+namespace quda {
+
+  cpuDirac::cpuDirac(const DiracParam &param)
+    : gauge(*(param.cpuGauge)), kappa(param.kappa), mass(param.mass), matpcType(param.matpcType),
+      dagger(param.dagger), flops(0), tmp1(0), tmp2(0)
+  {
+    if (!param.cpuGauge) errorQuda("Host Dirac operator requires a host gauge field");
+    if (gauge.Order() != QUDA_QDP_GAUGE_ORDER)
+      errorQuda("Host Dirac operator requires QDP gauge order, not %d", gauge.Order());
+    for (int i=0; i<4; i++) commDim[i] = param.commDim[i];
+  }
+
+  cpuDirac::cpuDirac(const cpuDirac &dirac)
+    : gauge(dirac.gauge), kappa(dirac.kappa), mass(dirac.mass), matpcType(dirac.matpcType),
+      dagger(dirac.dagger), flops(0), tmp1(dirac.tmp1), tmp2(dirac.tmp2)
+  {
+    for (int i=0; i<4; i++) commDim[i] = dirac.commDim[i];
+  }
+
+  cpuDirac::~cpuDirac() { }
+
+  bool cpuDirac::newTmp(cpuColorSpinorField **tmp, const cpuColorSpinorField &a) const {
+    if (*tmp) return false;
+    ColorSpinorParam param(a);
+    param.create = QUDA_ZERO_FIELD_CREATE;
+    *tmp = new cpuColorSpinorField(a, param);
+    return true;
+  }
+
+  void cpuDirac::deleteTmp(cpuColorSpinorField **a, const bool &reset) const {
+    if (reset) {
+      delete *a;
+      *a = NULL;
+    }
+  }
+
+  // swap the dagger setting, for Mdag in terms of M
+  static inline void flip(DagType &dagger) {
+    dagger = (dagger == QUDA_DAG_YES) ? QUDA_DAG_NO : QUDA_DAG_YES;
+  }
+
+  void cpuDirac::Mdag(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    flip(dagger);
+    M(out, in);
+    flip(dagger);
+  }
+
+  // create (or destroy) a set of temporaries with the same layout as the fields in a
+  static void createBlock(std::vector<cpuColorSpinorField*> &tmp, cpuColorSpinorField **a, const int n)
+  {
+    tmp.resize(n);
+    for (int r=0; r<n; r++) {
+      ColorSpinorParam param(*a[r]);
+      param.create = QUDA_ZERO_FIELD_CREATE;
+      tmp[r] = new cpuColorSpinorField(*a[r], param);
+    }
+  }
+
+  static void destroyBlock(std::vector<cpuColorSpinorField*> &tmp)
+  {
+    for (unsigned int r=0; r<tmp.size(); r++) delete tmp[r];
+    tmp.clear();
+  }
+
+  // the even and odd parity subsets of a set of full fields
+  static void parityBlock(std::vector<cpuColorSpinorField*> &even, std::vector<cpuColorSpinorField*> &odd,
+			  cpuColorSpinorField **a, const int n)
+  {
+    even.resize(n);
+    odd.resize(n);
+    for (int r=0; r<n; r++) {
+      even[r] = &(a[r]->Even());
+      odd[r] = &(a[r]->Odd());
+    }
+  }
+
+  void cpuDirac::DslashBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+			     const QudaParity parity) const
+  {
+    for (int r=0; r<nRhs; r++) Dslash(*out[r], *in[r], parity);
+  }
+
+  void cpuDirac::DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+				 const QudaParity parity, cpuColorSpinorField **x, const double &k) const
+  {
+    for (int r=0; r<nRhs; r++) DslashXpay(*out[r], *in[r], parity, *x[r], k);
+  }
+
+  void cpuDirac::MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+  {
+    for (int r=0; r<nRhs; r++) M(*out[r], *in[r]);
+  }
+
+  void cpuDirac::MdagMBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+  {
+    for (int r=0; r<nRhs; r++) MdagM(*out[r], *in[r]);
+  }
+
+  void cpuDirac::MdagBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+  {
+    flip(dagger);
+    MBlock(out, in, nRhs);
+    flip(dagger);
+  }
+
+  void cpuDirac::checkParitySpinor(const cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    if (in.GammaBasis() != QUDA_DEGRAND_ROSSI_GAMMA_BASIS ||
+	out.GammaBasis() != QUDA_DEGRAND_ROSSI_GAMMA_BASIS) {
+      errorQuda("Host Dirac operator requires DeGrand-Rossi basis, out = %d, in = %d",
+		out.GammaBasis(), in.GammaBasis());
+    }
+
+    if (in.Precision() != out.Precision()) {
+      errorQuda("Input precision %d and output spinor precision %d don't match",
+		in.Precision(), out.Precision());
+    }
+
+    if (in.SiteSubset() != QUDA_PARITY_SITE_SUBSET || out.SiteSubset() != QUDA_PARITY_SITE_SUBSET) {
+      errorQuda("ColorSpinorFields are not single parity: in = %d, out = %d",
+		in.SiteSubset(), out.SiteSubset());
+    }
+
+    if (out.Ndim() != 5) {
+      if (out.Volume() != gauge.VolumeCB()) {
+	errorQuda("Spinor volume %d doesn't match gauge volume %d", out.Volume(), gauge.VolumeCB());
+      }
+    } else {
+      // Domain wall fermions, compare 4d volumes not 5d
+      if (out.Volume()/out.X(4) != gauge.VolumeCB()) {
+	errorQuda("Spinor volume %d doesn't match gauge volume %d", out.Volume(), gauge.VolumeCB());
+      }
+    }
+  }
+
+  void cpuDirac::checkFullSpinor(const cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    if (in.SiteSubset() != QUDA_FULL_SITE_SUBSET || out.SiteSubset() != QUDA_FULL_SITE_SUBSET) {
+      errorQuda("ColorSpinorFields are not full fields: in = %d, out = %d",
+		in.SiteSubset(), out.SiteSubset());
+    }
+  }
+
+  void cpuDirac::checkSpinorAlias(const cpuColorSpinorField &a, const cpuColorSpinorField &b) const {
+    if (a.V() == b.V()) errorQuda("Aliasing pointers");
+  }
+
+  // host Dirac operator factory
+  cpuDirac* cpuDirac::create(const DiracParam &param)
+  {
+    if (param.type == QUDA_WILSON_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracWilson operator\n");
+      return new cpuDiracWilson(param);
+    } else if (param.type == QUDA_WILSONPC_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracWilsonPC operator\n");
+      return new cpuDiracWilsonPC(param);
+    } else if (param.type == QUDA_CLOVER_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracClover operator\n");
+      return new cpuDiracClover(param);
+    } else if (param.type == QUDA_CLOVERPC_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracCloverPC operator\n");
+      return new cpuDiracCloverPC(param);
+    } else if (param.type == QUDA_DOMAIN_WALL_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracDomainWall operator\n");
+      return new cpuDiracDomainWall(param);
+    } else if (param.type == QUDA_DOMAIN_WALLPC_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracDomainWallPC operator\n");
+      return new cpuDiracDomainWallPC(param);
+    } else if (param.type == QUDA_ASQTAD_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracStaggered operator\n");
+      return new cpuDiracStaggered(param);
+    } else if (param.type == QUDA_ASQTADPC_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracStaggeredPC operator\n");
+      return new cpuDiracStaggeredPC(param);
+    } else if (param.type == QUDA_TWISTED_MASS_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracTwistedMass operator\n");
+      return new cpuDiracTwistedMass(param);
+    } else if (param.type == QUDA_TWISTED_MASSPC_DIRAC) {
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating a cpuDiracTwistedMassPC operator\n");
+      return new cpuDiracTwistedMassPC(param);
+    } else {
+      errorQuda("Host Dirac operator type %d not supported", param.type);
+      return 0;
+    }
+  }
+
+  cpuDiracWilson::cpuDiracWilson(const DiracParam &param) : cpuDirac(param) { }
+
+  cpuDiracWilson::cpuDiracWilson(const cpuDiracWilson &dirac) : cpuDirac(dirac) { }
+
+  cpuDiracWilson::~cpuDiracWilson() { }
+
+  void cpuDiracWilson::Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+			      const QudaParity parity) const
+  {
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+
+    wilsonDslashCpu(&out, gauge, &in, parity, dagger, 0, 0.0, commDim);
+
+    flops += 1320ll*in.Volume();
+  }
+
+  void cpuDiracWilson::DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+				  const QudaParity parity, const cpuColorSpinorField &x,
+				  const double &k) const
+  {
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+
+    wilsonDslashCpu(&out, gauge, &in, parity, dagger, &x, k, commDim);
+
+    flops += 1368ll*in.Volume();
+  }
+
+  void cpuDiracWilson::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+    DslashXpay(out.Odd(), in.Even(), QUDA_ODD_PARITY, in.Odd(), -kappa);
+    DslashXpay(out.Even(), in.Odd(), QUDA_EVEN_PARITY, in.Even(), -kappa);
+  }
+
+  void cpuDiracWilson::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+
+    bool reset = newTmp(&tmp1, in);
+    checkFullSpinor(*tmp1, in);
+
+    M(*tmp1, in);
+    Mdag(out, *tmp1);
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracWilson::DslashBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+				   const QudaParity parity) const
+  {
+    for (int r=0; r<nRhs; r++) {
+      checkParitySpinor(*in[r], *out[r]);
+      checkSpinorAlias(*in[r], *out[r]);
+    }
+
+    wilsonDslashCpu(out, gauge, in, nRhs, parity, dagger, 0, 0.0, commDim);
+
+    flops += 1320ll*in[0]->Volume()*nRhs;
+  }
+
+  void cpuDiracWilson::DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+				       const QudaParity parity, cpuColorSpinorField **x, const double &k) const
+  {
+    for (int r=0; r<nRhs; r++) {
+      checkParitySpinor(*in[r], *out[r]);
+      checkSpinorAlias(*in[r], *out[r]);
+    }
+
+    wilsonDslashCpu(out, gauge, in, nRhs, parity, dagger, x, k, commDim);
+
+    flops += 1368ll*in[0]->Volume()*nRhs;
+  }
+
+  void cpuDiracWilson::MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+  {
+    for (int r=0; r<nRhs; r++) checkFullSpinor(*out[r], *in[r]);
+
+    std::vector<cpuColorSpinorField*> outEven, outOdd, inEven, inOdd;
+    parityBlock(outEven, outOdd, out, nRhs);
+    parityBlock(inEven, inOdd, in, nRhs);
+
+    DslashXpayBlock(&outOdd[0], &inEven[0], nRhs, QUDA_ODD_PARITY, &inOdd[0], -kappa);
+    DslashXpayBlock(&outEven[0], &inOdd[0], nRhs, QUDA_EVEN_PARITY, &inEven[0], -kappa);
+  }
+
+  void cpuDiracWilson::MdagMBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+  {
+    std::vector<cpuColorSpinorField*> tmp;
+    createBlock(tmp, in, nRhs);
+
+    MBlock(&tmp[0], in, nRhs);
+    MdagBlock(out, &tmp[0], nRhs);
+
+    destroyBlock(tmp);
+  }
+
+  void cpuDiracWilson::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+			       cpuColorSpinorField &x, cpuColorSpinorField &b,
+			       const QudaSolutionType solType) const
+  {
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      errorQuda("Preconditioned solution requires a preconditioned solve_type");
+    }
+
+    src = &b;
+    sol = &x;
+  }
+
+  void cpuDiracWilson::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+				   const QudaSolutionType solType) const
+  {
+    // do nothing
+  }
+
+  cpuDiracWilsonPC::cpuDiracWilsonPC(const DiracParam &param) : cpuDiracWilson(param) { }
+
+  cpuDiracWilsonPC::cpuDiracWilsonPC(const cpuDiracWilsonPC &dirac) : cpuDiracWilson(dirac) { }
+
+  cpuDiracWilsonPC::~cpuDiracWilsonPC() { }
+
+  void cpuDiracWilsonPC::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    double kappa2 = -kappa*kappa;
+
+    bool reset = newTmp(&tmp1, in);
+
+    if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+      Dslash(*tmp1, in, QUDA_ODD_PARITY);
+      DslashXpay(out, *tmp1, QUDA_EVEN_PARITY, in, kappa2);
+    } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+      Dslash(*tmp1, in, QUDA_EVEN_PARITY);
+      DslashXpay(out, *tmp1, QUDA_ODD_PARITY, in, kappa2);
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracWilsonPC", matpcType);
+    }
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracWilsonPC::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    bool reset = newTmp(&tmp2, in);
+    M(*tmp2, in);
+    Mdag(out, *tmp2);
+    deleteTmp(&tmp2, reset);
+  }
+
+  void cpuDiracWilsonPC::MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+  {
+    double kappa2 = -kappa*kappa;
+
+    std::vector<cpuColorSpinorField*> tmp;
+    createBlock(tmp, in, nRhs);
+
+    if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+      DslashBlock(&tmp[0], in, nRhs, QUDA_ODD_PARITY);
+      DslashXpayBlock(out, &tmp[0], nRhs, QUDA_EVEN_PARITY, in, kappa2);
+    } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+      DslashBlock(&tmp[0], in, nRhs, QUDA_EVEN_PARITY);
+      DslashXpayBlock(out, &tmp[0], nRhs, QUDA_ODD_PARITY, in, kappa2);
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracWilsonPC", matpcType);
+    }
+
+    destroyBlock(tmp);
+  }
+
+  void cpuDiracWilsonPC::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+				 cpuColorSpinorField &x, cpuColorSpinorField &b,
+				 const QudaSolutionType solType) const
+  {
+    // we desire solution to preconditioned system
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      src = &b;
+      sol = &x;
+    } else {
+      // we desire solution to full system
+      if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+	// src = b_e + k D_eo b_o
+	DslashXpay(x.Odd(), b.Odd(), QUDA_EVEN_PARITY, b.Even(), kappa);
+	src = &(x.Odd());
+	sol = &(x.Even());
+      } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+	// src = b_o + k D_oe b_e
+	DslashXpay(x.Even(), b.Even(), QUDA_ODD_PARITY, b.Odd(), kappa);
+	src = &(x.Even());
+	sol = &(x.Odd());
+      } else {
+	errorQuda("MatPCType %d not valid for cpuDiracWilsonPC", matpcType);
+      }
+      // here we use final solution to store parity solution and parity source
+      // b is now up for grabs if we want
+    }
+
+  }
+
+  void cpuDiracWilsonPC::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+				     const QudaSolutionType solType) const
+  {
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      return;
+    }
+
+    // create full solution
+
+    checkFullSpinor(x, b);
+    if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+      // x_o = b_o + k D_oe x_e
+      DslashXpay(x.Odd(), x.Even(), QUDA_ODD_PARITY, b.Odd(), kappa);
+    } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+      // x_e = b_e + k D_eo x_o
+      DslashXpay(x.Even(), x.Odd(), QUDA_EVEN_PARITY, b.Even(), kappa);
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracWilsonPC", matpcType);
+    }
+  }
+
+
+  cpuDiracClover::cpuDiracClover(const DiracParam &param)
+    : cpuDiracWilson(param), clover(*(param.cpuClover))
+  {
+    if (!param.cpuClover) errorQuda("Host clover operator requires a host clover field");
+  }
+
+  cpuDiracClover::cpuDiracClover(const cpuDiracClover &dirac) 
+    : cpuDiracWilson(dirac), clover(dirac.clover) { }
+
+  cpuDiracClover::~cpuDiracClover() { }
+
+  void cpuDiracClover::checkParitySpinor(const cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    cpuDirac::checkParitySpinor(out, in);
+
+    if (out.Volume() != clover.VolumeCB()) {
+      errorQuda("Parity spinor volume %d doesn't match clover checkboard volume %d",
+		out.Volume(), clover.VolumeCB());
+    }
+  }
+
+  /** Applies the operator (A + k D) */
+  void cpuDiracClover::DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+				  const QudaParity parity, const cpuColorSpinorField &x,
+				  const double &k) const
+  {
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+
+    // out = A x, then accumulate the hopping term onto it
+    cloverCpu(&out, clover, &x, parity, false, 0, 0.0);
+    wilsonDslashCpu(&out, gauge, &in, parity, dagger, &out, k, commDim);
+
+    flops += 1872ll*in.Volume();
+  }
+
+  void cpuDiracClover::DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+				       const QudaParity parity, cpuColorSpinorField **x, const double &k) const
+  {
+    for (int r=0; r<nRhs; r++) {
+      checkParitySpinor(*in[r], *out[r]);
+      checkSpinorAlias(*in[r], *out[r]);
+    }
+
+    cloverCpu(out, clover, x, nRhs, parity, false, 0, 0.0);
+    wilsonDslashCpu(out, gauge, in, nRhs, parity, dagger, out, k, commDim);
+
+    flops += 1872ll*in[0]->Volume()*nRhs;
+  }
+
+  // Public method to apply the clover term only
+  void cpuDiracClover::Clover(cpuColorSpinorField &out, const cpuColorSpinorField &in, const QudaParity parity) const
+  {
+    checkParitySpinor(in, out);
+
+    cloverCpu(&out, clover, &in, parity, false, 0, 0.0);
+
+    flops += 504ll*in.Volume();
+  }
+
+  void cpuDiracClover::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+    DslashXpay(out.Odd(), in.Even(), QUDA_ODD_PARITY, in.Odd(), -kappa);
+    DslashXpay(out.Even(), in.Odd(), QUDA_EVEN_PARITY, in.Even(), -kappa);
+  }
+
+  void cpuDiracClover::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+
+    bool reset = newTmp(&tmp1, in);
+    checkFullSpinor(*tmp1, in);
+
+    M(*tmp1, in);
+    Mdag(out, *tmp1);
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracClover::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+			       cpuColorSpinorField &x, cpuColorSpinorField &b, 
+			       const QudaSolutionType solType) const
+  {
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      errorQuda("Preconditioned solution requires a preconditioned solve_type");
+    }
+
+    src = &b;
+    sol = &x;
+  }
+
+  void cpuDiracClover::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+				   const QudaSolutionType solType) const
+  {
+    // do nothing
+  }
+
+  cpuDiracCloverPC::cpuDiracCloverPC(const DiracParam &param) : cpuDiracClover(param)
+  {
+    if (!clover.V(true)) errorQuda("Clover inverse required for cpuDiracCloverPC");
+  }
+
+  cpuDiracCloverPC::cpuDiracCloverPC(const cpuDiracCloverPC &dirac) : cpuDiracClover(dirac) { }
+
+  cpuDiracCloverPC::~cpuDiracCloverPC() { }
+
+  // Public method
+  void cpuDiracCloverPC::CloverInv(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+				   const QudaParity parity) const
+  {
+    checkParitySpinor(in, out);
+
+    cloverCpu(&out, clover, &in, parity, true, 0, 0.0);
+
+    flops += 504ll*in.Volume();
+  }
+
+  // apply hopping term, then clover: (A_ee^-1 D_eo) or (A_oo^-1 D_oe),
+  // and likewise for dagger: (A_ee^-1 D^dagger_eo) or (A_oo^-1 D^dagger_oe)
+  void cpuDiracCloverPC::Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+				const QudaParity parity) const
+  {
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+
+    wilsonDslashCpu(&out, gauge, &in, parity, dagger, 0, 0.0, commDim);
+    cloverCpu(&out, clover, &out, parity, true, 0, 0.0);
+
+    flops += 1824ll*in.Volume();
+  }
+
+  // xpay version of the above
+  void cpuDiracCloverPC::DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+				    const QudaParity parity, const cpuColorSpinorField &x,
+				    const double &k) const
+  {
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+    checkSpinorAlias(x, out); // the hopping term is accumulated in out
+
+    wilsonDslashCpu(&out, gauge, &in, parity, dagger, 0, 0.0, commDim);
+    cloverCpu(&out, clover, &out, parity, true, &x, k);
+
+    flops += 1872ll*in.Volume();
+  }
+
+  void cpuDiracCloverPC::CloverInvBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+					const QudaParity parity) const
+  {
+    for (int r=0; r<nRhs; r++) checkParitySpinor(*in[r], *out[r]);
+
+    cloverCpu(out, clover, in, nRhs, parity, true, 0, 0.0);
+
+    flops += 504ll*in[0]->Volume()*nRhs;
+  }
+
+  void cpuDiracCloverPC::DslashBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+				     const QudaParity parity) const
+  {
+    for (int r=0; r<nRhs; r++) {
+      checkParitySpinor(*in[r], *out[r]);
+      checkSpinorAlias(*in[r], *out[r]);
+    }
+
+    wilsonDslashCpu(out, gauge, in, nRhs, parity, dagger, 0, 0.0, commDim);
+    cloverCpu(out, clover, out, nRhs, parity, true, 0, 0.0);
+
+    flops += 1824ll*in[0]->Volume()*nRhs;
+  }
+
+  void cpuDiracCloverPC::DslashXpayBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs,
+					 const QudaParity parity, cpuColorSpinorField **x, const double &k) const
+  {
+    for (int r=0; r<nRhs; r++) {
+      checkParitySpinor(*in[r], *out[r]);
+      checkSpinorAlias(*in[r], *out[r]);
+      checkSpinorAlias(*x[r], *out[r]); // the hopping term is accumulated in out
+    }
+
+    wilsonDslashCpu(out, gauge, in, nRhs, parity, dagger, 0, 0.0, commDim);
+    cloverCpu(out, clover, out, nRhs, parity, true, x, k);
+
+    flops += 1872ll*in[0]->Volume()*nRhs;
+  }
+
+  // Apply the even-odd preconditioned clover-improved Dirac operator
+  void cpuDiracCloverPC::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    double kappa2 = -kappa*kappa;
+
+    bool reset1 = newTmp(&tmp1, in);
+
+    if (matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) {
+      // DiracCloverPC::Dslash applies A^{-1}Dslash
+      Dslash(*tmp1, in, QUDA_ODD_PARITY);
+      // DiracClover::DslashXpay applies (A - kappa^2 D)
+      cpuDiracClover::DslashXpay(out, *tmp1, QUDA_EVEN_PARITY, in, kappa2);
+    } else if (matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
+      Dslash(*tmp1, in, QUDA_EVEN_PARITY);
+      cpuDiracClover::DslashXpay(out, *tmp1, QUDA_ODD_PARITY, in, kappa2);
+    } else if (!dagger) { // symmetric preconditioning
+      if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+	Dslash(*tmp1, in, QUDA_ODD_PARITY);
+	DslashXpay(out, *tmp1, QUDA_EVEN_PARITY, in, kappa2); 
+      } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+	Dslash(*tmp1, in, QUDA_EVEN_PARITY);
+	DslashXpay(out, *tmp1, QUDA_ODD_PARITY, in, kappa2); 
+      } else {
+	errorQuda("Invalid matpcType");
+      }
+    } else { // symmetric preconditioning, dagger
+      if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+	CloverInv(out, in, QUDA_EVEN_PARITY); 
+	Dslash(*tmp1, out, QUDA_ODD_PARITY);
+	cpuDiracWilson::DslashXpay(out, *tmp1, QUDA_EVEN_PARITY, in, kappa2); 
+      } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+	CloverInv(out, in, QUDA_ODD_PARITY); 
+	Dslash(*tmp1, out, QUDA_EVEN_PARITY);
+	cpuDiracWilson::DslashXpay(out, *tmp1, QUDA_ODD_PARITY, in, kappa2); 
+      } else {
+	errorQuda("MatPCType %d not valid for cpuDiracCloverPC", matpcType);
+      }
+    }
+  
+    deleteTmp(&tmp1, reset1);
+  }
+
+  // multi-RHS version of the above
+  void cpuDiracCloverPC::MBlock(cpuColorSpinorField **out, cpuColorSpinorField **in, const int nRhs) const
+  {
+    double kappa2 = -kappa*kappa;
+
+    std::vector<cpuColorSpinorField*> tmp;
+    createBlock(tmp, in, nRhs);
+
+    QudaParity parity = QUDA_INVALID_PARITY;
+    QudaParity other = QUDA_INVALID_PARITY;
+    if (matpcType == QUDA_MATPC_EVEN_EVEN || matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) {
+      parity = QUDA_EVEN_PARITY;
+      other = QUDA_ODD_PARITY;
+    } else if (matpcType == QUDA_MATPC_ODD_ODD || matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
+      parity = QUDA_ODD_PARITY;
+      other = QUDA_EVEN_PARITY;
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracCloverPC", matpcType);
+    }
+
+    if (matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC || matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
+      DslashBlock(&tmp[0], in, nRhs, other);
+      cpuDiracClover::DslashXpayBlock(out, &tmp[0], nRhs, parity, in, kappa2);
+    } else if (!dagger) {
+      DslashBlock(&tmp[0], in, nRhs, other);
+      DslashXpayBlock(out, &tmp[0], nRhs, parity, in, kappa2);
+    } else {
+      CloverInvBlock(out, in, nRhs, parity);
+      DslashBlock(&tmp[0], out, nRhs, other);
+      cpuDiracWilson::DslashXpayBlock(out, &tmp[0], nRhs, parity, in, kappa2);
+    }
+
+    destroyBlock(tmp);
+  }
+
+  void cpuDiracCloverPC::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    // need extra temporary because of symmetric preconditioning dagger
+    bool reset = newTmp(&tmp2, in);
+    M(*tmp2, in);
+    Mdag(out, *tmp2);
+    deleteTmp(&tmp2, reset);
+  }
+
+  void cpuDiracCloverPC::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol, 
+				 cpuColorSpinorField &x, cpuColorSpinorField &b, 
+				 const QudaSolutionType solType) const
+  {
+    // we desire solution to preconditioned system
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      src = &b;
+      sol = &x;
+      return;
+    }
+
+    bool reset = newTmp(&tmp1, b.Even());
+  
+    // we desire solution to full system
+    if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+      // src = A_ee^-1 (b_e + k D_eo A_oo^-1 b_o)
+      src = &(x.Odd());
+      CloverInv(*src, b.Odd(), QUDA_ODD_PARITY);
+      cpuDiracWilson::DslashXpay(*tmp1, *src, QUDA_EVEN_PARITY, b.Even(), kappa);
+      CloverInv(*src, *tmp1, QUDA_EVEN_PARITY);
+      sol = &(x.Even());
+    } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+      // src = A_oo^-1 (b_o + k D_oe A_ee^-1 b_e)
+      src = &(x.Even());
+      CloverInv(*src, b.Even(), QUDA_EVEN_PARITY);
+      cpuDiracWilson::DslashXpay(*tmp1, *src, QUDA_ODD_PARITY, b.Odd(), kappa);
+      CloverInv(*src, *tmp1, QUDA_ODD_PARITY);
+      sol = &(x.Odd());
+    } else if (matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) {
+      // src = b_e + k D_eo A_oo^-1 b_o
+      src = &(x.Odd());
+      CloverInv(*tmp1, b.Odd(), QUDA_ODD_PARITY); // safe even when *tmp1 = b.odd
+      cpuDiracWilson::DslashXpay(*src, *tmp1, QUDA_EVEN_PARITY, b.Even(), kappa);
+      sol = &(x.Even());
+    } else if (matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
+      // src = b_o + k D_oe A_ee^-1 b_e
+      src = &(x.Even());
+      CloverInv(*tmp1, b.Even(), QUDA_EVEN_PARITY); // safe even when *tmp1 = b.even
+      cpuDiracWilson::DslashXpay(*src, *tmp1, QUDA_ODD_PARITY, b.Odd(), kappa);
+      sol = &(x.Odd());
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracCloverPC", matpcType);
+    }
+
+    // here we use final solution to store parity solution and parity source
+    // b is now up for grabs if we want
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracCloverPC::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+				     const QudaSolutionType solType) const
+  {
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      return;
+    }
+
+    checkFullSpinor(x, b);
+
+    bool reset = newTmp(&tmp1, b.Even());
+
+    // create full solution
+
+    if (matpcType == QUDA_MATPC_EVEN_EVEN ||
+	matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) {
+      // x_o = A_oo^-1 (b_o + k D_oe x_e)
+      cpuDiracWilson::DslashXpay(*tmp1, x.Even(), QUDA_ODD_PARITY, b.Odd(), kappa);
+      CloverInv(x.Odd(), *tmp1, QUDA_ODD_PARITY);
+    } else if (matpcType == QUDA_MATPC_ODD_ODD ||
+	       matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
+      // x_e = A_ee^-1 (b_e + k D_eo x_o)
+      cpuDiracWilson::DslashXpay(*tmp1, x.Odd(), QUDA_EVEN_PARITY, b.Even(), kappa);
+      CloverInv(x.Even(), *tmp1, QUDA_EVEN_PARITY);
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracCloverPC", matpcType);
+    }
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  cpuDiracDomainWall::cpuDiracDomainWall(const DiracParam &param)
+    : cpuDiracWilson(param), m5(param.m5), kappa5(0.5/(5.0 + m5)) { }
+
+  cpuDiracDomainWall::cpuDiracDomainWall(const cpuDiracDomainWall &dirac)
+    : cpuDiracWilson(dirac), m5(dirac.m5), kappa5(0.5/(5.0 + m5)) { }
+
+  cpuDiracDomainWall::~cpuDiracDomainWall() { }
+
+  void cpuDiracDomainWall::Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+				  const QudaParity parity) const
+  {
+    if (in.Ndim() != 5 || out.Ndim() != 5) errorQuda("Wrong number of dimensions\n");
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+
+    domainWallDslashCpu(&out, gauge, &in, parity, dagger, 0, mass, 0.0, commDim);
+
+    long long Ls = in.X(4);
+    long long bulk = (Ls-2)*(in.Volume()/Ls);
+    long long wall = 2*in.Volume()/Ls;
+    flops += 1320LL*(long long)in.Volume() + 96LL*bulk + 120LL*wall;
+  }
+
+  void cpuDiracDomainWall::DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+				      const QudaParity parity, const cpuColorSpinorField &x,
+				      const double &k) const
+  {
+    if (in.Ndim() != 5 || out.Ndim() != 5) errorQuda("Wrong number of dimensions\n");
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+
+    domainWallDslashCpu(&out, gauge, &in, parity, dagger, &x, mass, k, commDim);
+
+    long long Ls = in.X(4);
+    long long bulk = (Ls-2)*(in.Volume()/Ls);
+    long long wall = 2*in.Volume()/Ls;
+    flops += (1320LL+48LL)*(long long)in.Volume() + 96LL*bulk + 120LL*wall;
+  }
+
+  void cpuDiracDomainWall::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+    DslashXpay(out.Odd(), in.Even(), QUDA_ODD_PARITY, in.Odd(), -kappa5);
+    DslashXpay(out.Even(), in.Odd(), QUDA_EVEN_PARITY, in.Even(), -kappa5);
+  }
+
+  void cpuDiracDomainWall::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+
+    bool reset = newTmp(&tmp1, in);
+
+    M(*tmp1, in);
+    Mdag(out, *tmp1);
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracDomainWall::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+				   cpuColorSpinorField &x, cpuColorSpinorField &b, 
+				   const QudaSolutionType solType) const
+  {
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      errorQuda("Preconditioned solution requires a preconditioned solve_type");
+    }
+
+    src = &b;
+    sol = &x;
+  }
+
+  void cpuDiracDomainWall::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+				       const QudaSolutionType solType) const
+  {
+    // do nothing
+  }
+
+  cpuDiracDomainWallPC::cpuDiracDomainWallPC(const DiracParam &param) : cpuDiracDomainWall(param) { }
+
+  cpuDiracDomainWallPC::cpuDiracDomainWallPC(const cpuDiracDomainWallPC &dirac) : cpuDiracDomainWall(dirac) { }
+
+  cpuDiracDomainWallPC::~cpuDiracDomainWallPC() { }
+
+  // Apply the even-odd preconditioned domain wall operator
+  void cpuDiracDomainWallPC::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    if (in.Ndim() != 5 || out.Ndim() != 5) errorQuda("Wrong number of dimensions\n");
+    double kappa2 = -kappa5*kappa5;
+
+    bool reset = newTmp(&tmp1, in);
+
+    if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+      Dslash(*tmp1, in, QUDA_ODD_PARITY);
+      DslashXpay(out, *tmp1, QUDA_EVEN_PARITY, in, kappa2); 
+    } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+      Dslash(*tmp1, in, QUDA_EVEN_PARITY);
+      DslashXpay(out, *tmp1, QUDA_ODD_PARITY, in, kappa2); 
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracDomainWallPC", matpcType);
+    }
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracDomainWallPC::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    bool reset = newTmp(&tmp2, in);
+    M(*tmp2, in);
+    Mdag(out, *tmp2);
+    deleteTmp(&tmp2, reset);
+  }
+
+  void cpuDiracDomainWallPC::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+				     cpuColorSpinorField &x, cpuColorSpinorField &b, 
+				     const QudaSolutionType solType) const
+  {
+    // we desire solution to preconditioned system
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      src = &b;
+      sol = &x;
+    } else {  
+      // we desire solution to full system
+      if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+	// src = b_e + k D_eo b_o
+	DslashXpay(x.Odd(), b.Odd(), QUDA_EVEN_PARITY, b.Even(), kappa5);
+	src = &(x.Odd());
+	sol = &(x.Even());
+      } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+	// src = b_o + k D_oe b_e
+	DslashXpay(x.Even(), b.Even(), QUDA_ODD_PARITY, b.Odd(), kappa5);
+	src = &(x.Even());
+	sol = &(x.Odd());
+      } else {
+	errorQuda("MatPCType %d not valid for cpuDiracDomainWallPC", matpcType);
+      }
+      // here we use final solution to store parity solution and parity source
+      // b is now up for grabs if we want
+    }
+
+  }
+
+  void cpuDiracDomainWallPC::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+					 const QudaSolutionType solType) const
+  {
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      return;
+    }				
+
+    // create full solution
+
+    checkFullSpinor(x, b);
+    if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+      // x_o = b_o + k D_oe x_e
+      DslashXpay(x.Odd(), x.Even(), QUDA_ODD_PARITY, b.Odd(), kappa5);
+    } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+      // x_e = b_e + k D_eo x_o
+      DslashXpay(x.Even(), x.Odd(), QUDA_EVEN_PARITY, b.Even(), kappa5);
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracDomainWallPC", matpcType);
+    }
+  }
+
+  cpuDiracTwistedMass::cpuDiracTwistedMass(const DiracParam &param) : cpuDiracWilson(param), mu(param.mu) { }
+
+  cpuDiracTwistedMass::cpuDiracTwistedMass(const cpuDiracTwistedMass &dirac) : cpuDiracWilson(dirac), mu(dirac.mu) { }
+
+  cpuDiracTwistedMass::~cpuDiracTwistedMass() { }
+
+  // the twisted mass parameter including the sign of the flavor
+  double cpuDiracTwistedMass::flavorMu(const cpuColorSpinorField &in) const
+  {
+    if (in.TwistFlavor() == QUDA_TWIST_NO || in.TwistFlavor() == QUDA_TWIST_INVALID)
+      errorQuda("Twist flavor not set %d\n", in.TwistFlavor());
+    if (in.TwistFlavor() != QUDA_TWIST_PLUS && in.TwistFlavor() != QUDA_TWIST_MINUS)
+      errorQuda("Host twisted mass operator for flavor doublet is not implemented\n");
+    return in.TwistFlavor() * mu;
+  }
+
+  // Protected method for applying twist
+  void cpuDiracTwistedMass::twistedApply(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+					 const QudaTwistGamma5Type twistType) const
+  {
+    checkParitySpinor(out, in);
+
+    twistGamma5Cpu(&out, &in, dagger, kappa, flavorMu(in), twistType, 0, 0.0);
+
+    flops += 24ll*in.Volume();
+  }
+
+  // Public method to apply the twist
+  void cpuDiracTwistedMass::Twist(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    twistedApply(out, in, QUDA_TWIST_GAMMA5_DIRECT);
+  }
+
+  void cpuDiracTwistedMass::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+    if (in.TwistFlavor() != out.TwistFlavor()) 
+      errorQuda("Twist flavors %d %d don't match", in.TwistFlavor(), out.TwistFlavor());
+    const double flavor_mu = flavorMu(in);
+
+    // out = (1 + i a gamma_5) x - kappa D in, with the twist applied in place first
+    twistGamma5Cpu(&out.Odd(), &in.Odd(), dagger, kappa, flavor_mu, QUDA_TWIST_GAMMA5_DIRECT, 0, 0.0);
+    wilsonDslashCpu(&out.Odd(), gauge, &in.Even(), QUDA_ODD_PARITY, dagger, &out.Odd(), -kappa, commDim);
+    twistGamma5Cpu(&out.Even(), &in.Even(), dagger, kappa, flavor_mu, QUDA_TWIST_GAMMA5_DIRECT, 0, 0.0);
+    wilsonDslashCpu(&out.Even(), gauge, &in.Odd(), QUDA_EVEN_PARITY, dagger, &out.Even(), -kappa, commDim);
+
+    flops += (1320ll+72ll)*in.Volume();
+  }
+
+  void cpuDiracTwistedMass::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+    bool reset = newTmp(&tmp1, in);
+
+    M(*tmp1, in);
+    Mdag(out, *tmp1);
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracTwistedMass::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+				    cpuColorSpinorField &x, cpuColorSpinorField &b, 
+				    const QudaSolutionType solType) const
+  {
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      errorQuda("Preconditioned solution requires a preconditioned solve_type");
+    }
+
+    src = &b;
+    sol = &x;
+  }
+
+  void cpuDiracTwistedMass::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+					const QudaSolutionType solType) const
+  {
+    // do nothing
+  }
+
+  cpuDiracTwistedMassPC::cpuDiracTwistedMassPC(const DiracParam &param) : cpuDiracTwistedMass(param) { }
+
+  cpuDiracTwistedMassPC::cpuDiracTwistedMassPC(const cpuDiracTwistedMassPC &dirac) : cpuDiracTwistedMass(dirac) { }
+
+  cpuDiracTwistedMassPC::~cpuDiracTwistedMassPC() { }
+
+  // Public method to apply the inverse twist
+  void cpuDiracTwistedMassPC::TwistInv(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    twistedApply(out, in, QUDA_TWIST_GAMMA5_INVERSE);
+  }
+
+  // apply hopping term, then inverse twist: (A_ee^-1 D_eo) or (A_oo^-1 D_oe),
+  // and likewise for dagger: (D^dagger_eo D_ee^-1) or (D^dagger_oe A_oo^-1)
+  void cpuDiracTwistedMassPC::Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+				     const QudaParity parity) const
+  {
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+    if (in.TwistFlavor() != out.TwistFlavor()) 
+      errorQuda("Twist flavors %d %d don't match", in.TwistFlavor(), out.TwistFlavor());
+    const double flavor_mu = flavorMu(in);
+
+    if (!dagger || matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC || matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
+      wilsonDslashCpu(&out, gauge, &in, parity, dagger, 0, 0.0, commDim);
+      twistGamma5Cpu(&out, &out, dagger, kappa, flavor_mu, QUDA_TWIST_GAMMA5_INVERSE, 0, 0.0);
+    } else {
+      cpuColorSpinorField *twistTmp = 0;
+      bool reset = newTmp(&twistTmp, in);
+      twistGamma5Cpu(twistTmp, &in, dagger, kappa, flavor_mu, QUDA_TWIST_GAMMA5_INVERSE, 0, 0.0);
+      wilsonDslashCpu(&out, gauge, twistTmp, parity, dagger, 0, 0.0, commDim);
+      deleteTmp(&twistTmp, reset);
+    }
+
+    flops += 1392ll*in.Volume();
+  }
+
+  // xpay version of the above
+  void cpuDiracTwistedMassPC::DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in,
+					 const QudaParity parity, const cpuColorSpinorField &x,
+					 const double &k) const
+  {
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+    if (in.TwistFlavor() != out.TwistFlavor()) 
+      errorQuda("Twist flavors %d %d don't match", in.TwistFlavor(), out.TwistFlavor());
+    const double flavor_mu = flavorMu(in);
+
+    if (!dagger) {
+      checkSpinorAlias(x, out); // the hopping term is accumulated in out
+      wilsonDslashCpu(&out, gauge, &in, parity, dagger, 0, 0.0, commDim);
+      twistGamma5Cpu(&out, &out, dagger, kappa, flavor_mu, QUDA_TWIST_GAMMA5_INVERSE, &x, k);
+    } else {
+      cpuColorSpinorField *twistTmp = 0;
+      bool reset = newTmp(&twistTmp, in);
+      twistGamma5Cpu(twistTmp, &in, dagger, kappa, flavor_mu, QUDA_TWIST_GAMMA5_INVERSE, 0, 0.0);
+      wilsonDslashCpu(&out, gauge, twistTmp, parity, dagger, &x, k, commDim);
+      deleteTmp(&twistTmp, reset);
+    }
+
+    flops += 1416ll*in.Volume();
+  }
+
+  void cpuDiracTwistedMassPC::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    double kappa2 = -kappa*kappa;
+
+    bool reset = newTmp(&tmp1, in);
+
+    if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+      Dslash(*tmp1, in, QUDA_ODD_PARITY);
+      DslashXpay(out, *tmp1, QUDA_EVEN_PARITY, in, kappa2); 
+    } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+      Dslash(*tmp1, in, QUDA_EVEN_PARITY);
+      DslashXpay(out, *tmp1, QUDA_ODD_PARITY, in, kappa2); 
+    } else if (matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC || matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
+      // asymmetric preconditioning: out = (1 + i a gamma_5) in - kappa^2 D A^-1 D in
+      QudaParity parity = (matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) ? QUDA_EVEN_PARITY : QUDA_ODD_PARITY;
+      QudaParity other = (parity == QUDA_EVEN_PARITY) ? QUDA_ODD_PARITY : QUDA_EVEN_PARITY;
+      Dslash(*tmp1, in, other);
+      twistGamma5Cpu(&out, &in, dagger, kappa, flavorMu(in), QUDA_TWIST_GAMMA5_DIRECT, 0, 0.0);
+      wilsonDslashCpu(&out, gauge, tmp1, parity, dagger, &out, kappa2, commDim);
+      flops += (1320ll+96ll)*in.Volume();
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracTwistedMassPC", matpcType);
+    }
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracTwistedMassPC::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    // need extra temporary because of symmetric preconditioning dagger
+    bool reset = newTmp(&tmp2, in);
+    M(*tmp2, in);
+    Mdag(out, *tmp2);
+    deleteTmp(&tmp2, reset);
+  }
+
+  void cpuDiracTwistedMassPC::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+				      cpuColorSpinorField &x, cpuColorSpinorField &b, 
+				      const QudaSolutionType solType) const
+  {
+    // we desire solution to preconditioned system
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      src = &b;
+      sol = &x;
+      return;
+    }
+
+    bool reset = newTmp(&tmp1, b.Even());
+
+    // we desire solution to full system
+    if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+      // src = A_ee^-1 (b_e + k D_eo A_oo^-1 b_o)
+      src = &(x.Odd());
+      TwistInv(*src, b.Odd());
+      cpuDiracWilson::DslashXpay(*tmp1, *src, QUDA_EVEN_PARITY, b.Even(), kappa);
+      TwistInv(*src, *tmp1);
+      sol = &(x.Even());
+    } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+      // src = A_oo^-1 (b_o + k D_oe A_ee^-1 b_e)
+      src = &(x.Even());
+      TwistInv(*src, b.Even());
+      cpuDiracWilson::DslashXpay(*tmp1, *src, QUDA_ODD_PARITY, b.Odd(), kappa);
+      TwistInv(*src, *tmp1);
+      sol = &(x.Odd());
+    } else if (matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) {
+      // src = b_e + k D_eo A_oo^-1 b_o
+      src = &(x.Odd());
+      TwistInv(*tmp1, b.Odd()); // safe even when *tmp1 = b.odd
+      cpuDiracWilson::DslashXpay(*src, *tmp1, QUDA_EVEN_PARITY, b.Even(), kappa);
+      sol = &(x.Even());
+    } else if (matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
+      // src = b_o + k D_oe A_ee^-1 b_e
+      src = &(x.Even());
+      TwistInv(*tmp1, b.Even()); // safe even when *tmp1 = b.even
+      cpuDiracWilson::DslashXpay(*src, *tmp1, QUDA_ODD_PARITY, b.Odd(), kappa);
+      sol = &(x.Odd());
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracTwistedMassPC", matpcType);
+    }
+
+    // here we use final solution to store parity solution and parity source
+    // b is now up for grabs if we want
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracTwistedMassPC::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+					  const QudaSolutionType solType) const
+  {
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      return;
+    }				
+
+    checkFullSpinor(x, b);
+
+    bool reset = newTmp(&tmp1, b.Even());
+
+    // create full solution
+
+    if (matpcType == QUDA_MATPC_EVEN_EVEN || matpcType == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) {
+      // x_o = A_oo^-1 (b_o + k D_oe x_e)
+      cpuDiracWilson::DslashXpay(*tmp1, x.Even(), QUDA_ODD_PARITY, b.Odd(), kappa);
+      TwistInv(x.Odd(), *tmp1);
+    } else if (matpcType == QUDA_MATPC_ODD_ODD || matpcType == QUDA_MATPC_ODD_ODD_ASYMMETRIC) {
+      // x_e = A_ee^-1 (b_e + k D_eo x_o)
+      cpuDiracWilson::DslashXpay(*tmp1, x.Odd(), QUDA_EVEN_PARITY, b.Even(), kappa);
+      TwistInv(x.Even(), *tmp1);
+    } else {
+      errorQuda("MatPCType %d not valid for cpuDiracTwistedMassPC", matpcType);
+    }
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  cpuDiracStaggered::cpuDiracStaggered(const DiracParam &param)
+    : cpuDirac(param), fatGauge(*(param.cpuFatGauge)), longGauge(*(param.cpuLongGauge))
+  {
+    if (!param.cpuFatGauge || !param.cpuLongGauge)
+      errorQuda("Host staggered operator requires host fat and long link fields");
+    if (fatGauge.Order() != QUDA_QDP_GAUGE_ORDER || longGauge.Order() != QUDA_QDP_GAUGE_ORDER)
+      errorQuda("Host staggered operator requires QDP gauge order");
+  }
+
+  cpuDiracStaggered::cpuDiracStaggered(const cpuDiracStaggered &dirac)
+    : cpuDirac(dirac), fatGauge(dirac.fatGauge), longGauge(dirac.longGauge) { }
+
+  cpuDiracStaggered::~cpuDiracStaggered() { }
+
+  void cpuDiracStaggered::checkParitySpinor(const cpuColorSpinorField &in, const cpuColorSpinorField &out) const
+  {
+    if (in.Precision() != out.Precision()) {
+      errorQuda("Input and output spinor precisions don't match");
+    }
+
+    if (in.SiteSubset() != QUDA_PARITY_SITE_SUBSET || out.SiteSubset() != QUDA_PARITY_SITE_SUBSET) {
+      errorQuda("ColorSpinorFields are not single parity, in = %d, out = %d", 
+		in.SiteSubset(), out.SiteSubset());
+    }
+
+    if (out.Volume() != fatGauge.VolumeCB()) {
+      errorQuda("Spinor volume %d doesn't match gauge volume %d", out.Volume(), fatGauge.VolumeCB());
+    }
+  }
+
+  void cpuDiracStaggered::Dslash(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+				 const QudaParity parity) const
+  {
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+
+    staggeredDslashCpu(&out, fatGauge, longGauge, &in, parity, dagger, 0, 0.0, commDim);
+  
+    flops += 1146ll*in.Volume();
+  }
+
+  // out = k x - D in
+  void cpuDiracStaggered::DslashXpay(cpuColorSpinorField &out, const cpuColorSpinorField &in, 
+				     const QudaParity parity, const cpuColorSpinorField &x,
+				     const double &k) const
+  {    
+    checkParitySpinor(in, out);
+    checkSpinorAlias(in, out);
+
+    staggeredDslashCpu(&out, fatGauge, longGauge, &in, parity, dagger, &x, k, commDim);
+  
+    flops += 1158ll*in.Volume();
+  }
+
+  // Full staggered operator
+  void cpuDiracStaggered::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+    DslashXpay(out.Even(), in.Odd(), QUDA_EVEN_PARITY, in.Even(), 2*mass);  
+    DslashXpay(out.Odd(), in.Even(), QUDA_ODD_PARITY, in.Odd(), 2*mass);
+  }
+
+  void cpuDiracStaggered::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    checkFullSpinor(out, in);
+    bool reset = newTmp(&tmp1, in);
+    cpuColorSpinorField &tmp = tmp1->Even();
+
+    //even
+    Dslash(tmp, in.Even(), QUDA_ODD_PARITY);  
+    DslashXpay(out.Even(), tmp, QUDA_EVEN_PARITY, in.Even(), 4*mass*mass);
+  
+    //odd
+    Dslash(tmp, in.Odd(), QUDA_EVEN_PARITY);  
+    DslashXpay(out.Odd(), tmp, QUDA_ODD_PARITY, in.Odd(), 4*mass*mass);    
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracStaggered::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+				  cpuColorSpinorField &x, cpuColorSpinorField &b, 
+				  const QudaSolutionType solType) const
+  {
+    if (solType == QUDA_MATPC_SOLUTION || solType == QUDA_MATPCDAG_MATPC_SOLUTION) {
+      errorQuda("Preconditioned solution requires a preconditioned solve_type");
+    }
+
+    src = &b;
+    sol = &x;  
+  }
+
+  void cpuDiracStaggered::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+				      const QudaSolutionType solType) const
+  {
+    // do nothing
+  }
+
+  cpuDiracStaggeredPC::cpuDiracStaggeredPC(const DiracParam &param) : cpuDiracStaggered(param) { }
+
+  cpuDiracStaggeredPC::cpuDiracStaggeredPC(const cpuDiracStaggeredPC &dirac) : cpuDiracStaggered(dirac) { }
+
+  cpuDiracStaggeredPC::~cpuDiracStaggeredPC() { }
+
+  void cpuDiracStaggeredPC::M(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    errorQuda("cpuDiracStaggeredPC::M() is not implemented\n");
+  }
+
+  void cpuDiracStaggeredPC::MdagM(cpuColorSpinorField &out, const cpuColorSpinorField &in) const
+  {
+    bool reset = newTmp(&tmp1, in);
+  
+    QudaParity parity = QUDA_INVALID_PARITY;
+    QudaParity other_parity = QUDA_INVALID_PARITY;
+    if (matpcType == QUDA_MATPC_EVEN_EVEN) {
+      parity = QUDA_EVEN_PARITY;
+      other_parity = QUDA_ODD_PARITY;
+    } else if (matpcType == QUDA_MATPC_ODD_ODD) {
+      parity = QUDA_ODD_PARITY;
+      other_parity = QUDA_EVEN_PARITY;
+    } else {
+      errorQuda("Invalid matpcType(%d) in function\n", matpcType);    
+    }
+    Dslash(*tmp1, in, other_parity);  
+    DslashXpay(out, *tmp1, parity, in, 4*mass*mass);
+
+    deleteTmp(&tmp1, reset);
+  }
+
+  void cpuDiracStaggeredPC::prepare(cpuColorSpinorField* &src, cpuColorSpinorField* &sol,
+				    cpuColorSpinorField &x, cpuColorSpinorField &b, 
+				    const QudaSolutionType solType) const
+  {
+    src = &b;
+    sol = &x;  
+  }
+
+  void cpuDiracStaggeredPC::reconstruct(cpuColorSpinorField &x, const cpuColorSpinorField &b,
+					const QudaSolutionType solType) const
+  {
+    // do nothing
+  }
+
+} // namespace quda
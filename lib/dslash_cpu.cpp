@@ -0,0 +1,1122 @@
+#include <vector>
+#include <string.h>
+#include <typeinfo>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+#include <clover_field.h>
+#include <dslash_quda.h>
+#include <tune_quda.h>
+#include <lattice_geometry.h>
+#include <halo_exchange.h>
+#include <su3_cpu.h>
+#include <spinor_cpu.h>
+
+// Host implementation of the Wilson dslash.  The lattice is processed
+// in blocks of sites, with the block loop threaded with OpenMP and
+// the neighbor indices read from the LatticeGeometry tables.  For
+// each hop the neighboring spinors and links of a block are gathered
+// into structure-of-arrays form and handed to the vectorized kernels
+// of su3_cpu.h: the spinor is projected onto a two-component half
+// spinor, only the two surviving color vectors are multiplied by the
+// link, and the lower spin components are reconstructed from the
+// upper ones.  Only the DeGrand-Rossi gamma basis is supported (this
+// is the basis used by all of the host reference code).
+//
+// The spinors are read and written through the SpinorCpu accessors,
+// so half precision fields are computed in single precision, with
+// the conversions done as the sites are gathered and stored.
+//
+// When dimensions are partitioned, the operators are split as on the
+// device: the ghost zone exchange is started first, the interior
+// kernel then applies all hops between local sites while the faces
+// are in flight, and the exterior kernel of each dimension adds the
+// hops from its ghost zone to the sites on the face as soon as that
+// dimension's messages have arrived.
+
+namespace quda {
+
+  namespace dslash_cpu {
+
+    // sites per block; a multiple of the widest SIMD vector
+    static const int blockSize = 16;
+
+    // kernel selector: the interior kernel applies the hops between
+    // local sites, and the exterior kernel of dimension mu (kernel =
+    // mu) adds the hops from the ghost zone of that dimension
+    static const int interiorKernel = -1;
+
+    // whether a hop to neighbor table entry n is applied by the given kernel
+    inline bool hopKernel(const int n, const int mu, const int kernel) {
+      return (kernel == interiorKernel) ? n >= 0 : (mu == kernel && n < 0);
+    }
+
+    template <typename Spinor, typename gFloat>
+    void wilsonDslash(const Spinor &out, gFloat **gauge, gFloat **ghostGauge, const Spinor &in,
+		      const Spinor *fwdGhost, const Spinor *backGhost,
+		      const LatticeGeometry &geom, int parity, int dagger, const Spinor &x, double k,
+		      const int kernel) {
+      typedef typename Spinor::real sFloat;
+      const int volumeCB = geom.VolumeCB();
+      int nSites = volumeCB;
+      const int *sites = (kernel == interiorKernel) ? 0 : geom.FaceSites(parity, kernel, nSites);
+      const int nBlock = (nSites + blockSize - 1) / blockSize;
+      const sFloat a = k;
+      hostSimdType(); // selects the instruction set before the threads look it up
+
+#pragma omp parallel for schedule(runtime)
+      for (int b=0; b<nBlock; b++) {
+	const int i0 = b*blockSize;
+	const int n = (nSites - i0 < blockSize) ? nSites - i0 : blockSize;
+
+	sFloat psi[24*blockSize], U[18*blockSize], h[12*blockSize], uh[12*blockSize], res[24*blockSize];
+	for (int c=0; c<24*blockSize; c++) res[c] = 0.0;
+
+	for (int dir=0; dir<8; dir++) {
+	  const int mu = dir/2;
+	  if (kernel != interiorKernel && mu != kernel) continue;
+	  const int *nbr = geom.Neighbor(parity, dir);
+
+	  for (int j=0; j<n; j++) {
+	    const int i = sites ? sites[i0 + j] : i0 + j;
+	    const int nb = nbr[i];
+	    if (!hopKernel(nb, mu, kernel)) { // hop applied by another kernel
+	      for (int c=0; c<24; c++) psi[c*blockSize + j] = 0.0;
+	      for (int c=0; c<18; c++) U[c*blockSize + j] = 0.0;
+	      continue;
+	    }
+	    const gFloat *u;
+	    if (nb >= 0) {
+	      in.load(psi + j, blockSize, nb, 24);
+	      u = (dir % 2 == 0) ? gauge[mu] + (parity*volumeCB + i)*18 :
+		gauge[mu] + ((1-parity)*volumeCB + nb)*18;
+	    } else {
+	      const int g = geom.Ghost(nb, dir, 1);
+	      ((dir % 2 == 0) ? fwdGhost[mu] : backGhost[mu]).load(psi + j, blockSize, g, 24);
+	      u = (dir % 2 == 0) ? gauge[mu] + (parity*volumeCB + i)*18 :
+		ghostGauge[mu] + ((1-parity)*geom.FaceVolumeCB(mu) + g)*18;
+	    }
+	    for (int c=0; c<18; c++) U[c*blockSize + j] = u[c];
+	  }
+
+	  const int proj = 2*mu + (dir + dagger) % 2;
+	  spinProjectCpu(h, psi, proj, n, blockSize);
+	  for (int s=0; s<2; s++) {
+	    if (dir % 2 == 0) su3MatVecCpu(uh + 6*s*blockSize, U, h + 6*s*blockSize, n, blockSize);
+	    else su3MatDagVecCpu(uh + 6*s*blockSize, U, h + 6*s*blockSize, n, blockSize);
+	  }
+	  spinReconstructCpu(res, uh, proj, n, blockSize);
+	}
+
+	for (int j=0; j<n; j++) {
+	  const int i = sites ? sites[i0 + j] : i0 + j;
+	  sFloat o[24];
+	  if (kernel != interiorKernel) { // accumulate onto the interior result
+	    const sFloat c0 = x.valid() ? a : 1.0;
+	    out.load(o, 1, i, 24);
+	    for (int c=0; c<24; c++) o[c] += c0*res[c*blockSize + j];
+	  } else if (x.valid()) {
+	    x.load(o, 1, i, 24);
+	    for (int c=0; c<24; c++) o[c] += a*res[c*blockSize + j];
+	  } else {
+	    for (int c=0; c<24; c++) o[c] = res[c*blockSize + j];
+	  }
+	  out.save(o, i, 24);
+	}
+      }
+    }
+
+    template <typename Spinor>
+    void wilsonDslash(const Spinor &out, const cpuGaugeField &gauge, const Spinor &in,
+		      const Spinor *fwdGhost, const Spinor *backGhost, const LatticeGeometry &geom,
+		      const int parity, const int dagger, const Spinor &x, const double &k,
+		      const int kernel) {
+      void **ghostGauge = (void**)gauge.Ghost();
+      if (gauge.Precision() == QUDA_DOUBLE_PRECISION) {
+	wilsonDslash(out, (double**)gauge.Gauge_p(), (double**)ghostGauge, in,
+		     fwdGhost, backGhost, geom, parity, dagger, x, k, kernel);
+      } else if (gauge.Precision() == QUDA_SINGLE_PRECISION) {
+	wilsonDslash(out, (float**)gauge.Gauge_p(), (float**)ghostGauge, in,
+		     fwdGhost, backGhost, geom, parity, dagger, x, k, kernel);
+      } else {
+	errorQuda("Gauge precision %d not supported", gauge.Precision());
+      }
+    }
+
+    // maximum number of right-hand sides handled by a single pass of the multi-RHS kernels
+    static const int maxRhs = 16;
+
+    // SIMD lanes per block of the multi-RHS kernels
+    static const int maxLanes = 4*blockSize;
+
+    /**
+       Multi-RHS Wilson dslash.  The blocks are laid out with the
+       right-hand side innermost, lane j*nRhs + r holding site i0 + j of
+       field r, so each link is read from memory once per block and
+       reused for all of the right-hand sides.
+    */
+    template <typename Spinor, typename gFloat>
+    void wilsonDslash(const Spinor *out, gFloat **gauge, gFloat **ghostGauge, const Spinor *in,
+		      Spinor **fwdGhost, Spinor **backGhost, const int nRhs,
+		      const LatticeGeometry &geom, int parity, int dagger, const Spinor *x, double k) {
+      typedef typename Spinor::real sFloat;
+      const int volumeCB = geom.VolumeCB();
+      const int nSite = maxLanes / nRhs;
+      const int nBlock = (volumeCB + nSite - 1) / nSite;
+      const sFloat a = k;
+      hostSimdType(); // selects the instruction set before the threads look it up
+
+#pragma omp parallel for
+      for (int b=0; b<nBlock; b++) {
+	const int i0 = b*nSite;
+	const int ns = (volumeCB - i0 < nSite) ? volumeCB - i0 : nSite;
+	const int n = ns*nRhs;
+
+	sFloat psi[24*maxLanes], U[18*maxLanes], h[12*maxLanes], uh[12*maxLanes], res[24*maxLanes];
+	for (int c=0; c<24*maxLanes; c++) res[c] = 0.0;
+
+	for (int dir=0; dir<8; dir++) {
+	  const int mu = dir/2;
+	  const int *nbr = geom.Neighbor(parity, dir) + i0;
+
+	  for (int j=0; j<ns; j++) {
+	    const int i = i0 + j;
+	    const gFloat *u;
+	    int g = 0;
+	    if (nbr[j] >= 0) {
+	      u = (dir % 2 == 0) ? gauge[mu] + (parity*volumeCB + i)*18 :
+		gauge[mu] + ((1-parity)*volumeCB + nbr[j])*18;
+	    } else {
+	      g = geom.Ghost(nbr[j], dir, 1);
+	      u = (dir % 2 == 0) ? gauge[mu] + (parity*volumeCB + i)*18 :
+		ghostGauge[mu] + ((1-parity)*geom.FaceVolumeCB(mu) + g)*18;
+	    }
+	    for (int c=0; c<18; c++) {
+	      const sFloat uc = u[c];
+	      for (int r=0; r<nRhs; r++) U[c*maxLanes + j*nRhs + r] = uc;
+	    }
+	    for (int r=0; r<nRhs; r++) {
+	      if (nbr[j] >= 0) in[r].load(psi + j*nRhs + r, maxLanes, nbr[j], 24);
+	      else ((dir % 2 == 0) ? fwdGhost[r][mu] : backGhost[r][mu]).load(psi + j*nRhs + r, maxLanes, g, 24);
+	    }
+	  }
+
+	  const int proj = 2*mu + (dir + dagger) % 2;
+	  spinProjectCpu(h, psi, proj, n, maxLanes);
+	  for (int s=0; s<2; s++) {
+	    if (dir % 2 == 0) su3MatVecCpu(uh + 6*s*maxLanes, U, h + 6*s*maxLanes, n, maxLanes);
+	    else su3MatDagVecCpu(uh + 6*s*maxLanes, U, h + 6*s*maxLanes, n, maxLanes);
+	  }
+	  spinReconstructCpu(res, uh, proj, n, maxLanes);
+	}
+
+	for (int r=0; r<nRhs; r++) {
+	  for (int j=0; j<ns; j++) {
+	    sFloat o[24];
+	    const sFloat *rj = res + j*nRhs + r;
+	    if (x) {
+	      x[r].load(o, 1, i0 + j, 24);
+	      for (int c=0; c<24; c++) o[c] += a*rj[c*maxLanes];
+	    } else {
+	      for (int c=0; c<24; c++) o[c] = rj[c*maxLanes];
+	    }
+	    out[r].save(o, i0 + j, 24);
+	  }
+	}
+      }
+    }
+
+    template <typename Spinor>
+    void wilsonDslash(const Spinor *out, const cpuGaugeField &gauge, const Spinor *in,
+		      Spinor **fwdGhost, Spinor **backGhost, const int nRhs, const LatticeGeometry &geom,
+		      const int parity, const int dagger, const Spinor *x, const double &k) {
+      void **ghostGauge = (void**)gauge.Ghost();
+      if (gauge.Precision() == QUDA_DOUBLE_PRECISION) {
+	wilsonDslash(out, (double**)gauge.Gauge_p(), (double**)ghostGauge, in,
+		     fwdGhost, backGhost, nRhs, geom, parity, dagger, x, k);
+      } else if (gauge.Precision() == QUDA_SINGLE_PRECISION) {
+	wilsonDslash(out, (float**)gauge.Gauge_p(), (float**)ghostGauge, in,
+		     fwdGhost, backGhost, nRhs, geom, parity, dagger, x, k);
+      } else {
+	errorQuda("Gauge precision %d not supported", gauge.Precision());
+      }
+    }
+
+    /**
+       Fifth-dimension hopping term of the domain wall operator, which
+       is local to each 4-d site: out += k * (P_+ in(s+1) + P_- in(s-1))
+       (with the projectors interchanged for the dagger), where the hops
+       across the walls pick up a factor of -m_f.  In the DeGrand-Rossi
+       basis 2P_+ and 2P_- simply keep the upper and lower spin pairs.
+    */
+    template <typename Spinor>
+    void domainWall5th(const Spinor &out, const Spinor &in, const int Ls, const int volumeCB,
+		       const int dagger, const double &mferm, const double &k) {
+      typedef typename Spinor::real sFloat;
+      const int fwdOffset = dagger ? 0 : 12; // spin components kept by the forward hop
+      const int backOffset = dagger ? 12 : 0;
+
+#pragma omp parallel for
+      for (int i=0; i<Ls*volumeCB; i++) {
+	const int xs = i / volumeCB;
+	const int i4 = i - xs*volumeCB;
+	sFloat o[24], fwd[24], back[24];
+	out.load(o, 1, i, 24);
+	in.load(fwd, 1, ((xs+1) % Ls)*volumeCB + i4, 24);
+	in.load(back, 1, ((xs-1+Ls) % Ls)*volumeCB + i4, 24);
+	const sFloat a = 2.0*k*(xs == Ls-1 ? -mferm : 1.0);
+	const sFloat b = 2.0*k*(xs == 0 ? -mferm : 1.0);
+	for (int c=0; c<12; c++) o[fwdOffset + c] += a*fwd[fwdOffset + c];
+	for (int c=0; c<12; c++) o[backOffset + c] += b*back[backOffset + c];
+	out.save(o, i, 24);
+      }
+    }
+
+    template <typename Spinor, typename gFloat>
+    void staggeredDslash(const Spinor &out, gFloat **fatGauge, gFloat **longGauge, gFloat **ghostFat, gFloat **ghostLong,
+			 const Spinor &in, const Spinor *fwdGhost, const Spinor *backGhost, const LatticeGeometry &geom,
+			 int parity, int dagger, const Spinor &x, double k, const int kernel) {
+      typedef typename Spinor::real sFloat;
+      const int volumeCB = geom.VolumeCB();
+      int nSites = volumeCB;
+      const int *sites = (kernel == interiorKernel) ? 0 : geom.FaceSites(parity, kernel, nSites);
+      const int nBlock = (nSites + blockSize - 1) / blockSize;
+      const sFloat a = k;
+      hostSimdType(); // selects the instruction set before the threads look it up
+
+#pragma omp parallel for schedule(runtime)
+      for (int b=0; b<nBlock; b++) {
+	const int i0 = b*blockSize;
+	const int n = (nSites - i0 < blockSize) ? nSites - i0 : blockSize;
+
+	sFloat psi[6*blockSize], U[18*blockSize], Upsi[6*blockSize], res[6*blockSize];
+	for (int c=0; c<6*blockSize; c++) res[c] = 0.0;
+
+	for (int dir=0; dir<8; dir++) {
+	  const int mu = dir/2;
+	  if (kernel != interiorKernel && mu != kernel) continue;
+	  const int faceVolumeCB = geom.FaceVolumeCB(mu);
+
+	  // the one-hop term uses the fat links and the three-hop term the long links
+	  for (int hop=1; hop<=3; hop+=2) {
+	    gFloat **gauge = (hop == 1) ? fatGauge : longGauge;
+	    gFloat **ghostGauge = (hop == 1) ? ghostFat : ghostLong;
+	    const int *nbr = geom.Neighbor(parity, dir, hop);
+
+	    for (int j=0; j<n; j++) {
+	      const int i = sites ? sites[i0 + j] : i0 + j;
+	      const int nb = nbr[i];
+	      if (!hopKernel(nb, mu, kernel)) { // hop applied by another kernel
+		for (int c=0; c<6; c++) psi[c*blockSize + j] = 0.0;
+		for (int c=0; c<18; c++) U[c*blockSize + j] = 0.0;
+		continue;
+	      }
+	      const gFloat *u;
+	      if (nb >= 0) {
+		in.load(psi + j, blockSize, nb, 6);
+		u = (dir % 2 == 0) ? gauge[mu] + (parity*volumeCB + i)*18 :
+		  gauge[mu] + ((1-parity)*volumeCB + nb)*18;
+	      } else {
+		((dir % 2 == 0) ? fwdGhost[mu] : backGhost[mu]).load(psi + j, blockSize, geom.Ghost(nb, dir, 3), 6);
+		u = (dir % 2 == 0) ? gauge[mu] + (parity*volumeCB + i)*18 :
+		  ghostGauge[mu] + ((1-parity)*hop*faceVolumeCB + geom.Ghost(nb, dir, hop))*18;
+	      }
+	      for (int c=0; c<18; c++) U[c*blockSize + j] = u[c];
+	    }
+
+	    if (dir % 2 == 0) {
+	      su3MatVecCpu(Upsi, U, psi, n, blockSize);
+	      for (int c=0; c<6; c++) for (int j=0; j<n; j++) res[c*blockSize + j] += Upsi[c*blockSize + j];
+	    } else {
+	      su3MatDagVecCpu(Upsi, U, psi, n, blockSize);
+	      for (int c=0; c<6; c++) for (int j=0; j<n; j++) res[c*blockSize + j] -= Upsi[c*blockSize + j];
+	    }
+	  }
+	}
+
+	// the staggered operator is anti-Hermitian, so the dagger is a sign flip
+	const sFloat sign = dagger ? -1.0 : 1.0;
+	for (int j=0; j<n; j++) {
+	  const int i = sites ? sites[i0 + j] : i0 + j;
+	  sFloat o[6];
+	  if (kernel != interiorKernel) { // accumulate onto the interior result
+	    const sFloat c0 = x.valid() ? -sign : sign;
+	    out.load(o, 1, i, 6);
+	    for (int c=0; c<6; c++) o[c] += c0*res[c*blockSize + j];
+	  } else if (x.valid()) {
+	    x.load(o, 1, i, 6);
+	    for (int c=0; c<6; c++) o[c] = a*o[c] - sign*res[c*blockSize + j];
+	  } else {
+	    for (int c=0; c<6; c++) o[c] = sign*res[c*blockSize + j];
+	  }
+	  out.save(o, i, 6);
+	}
+      }
+    }
+
+    template <typename Spinor>
+    void staggeredDslash(const Spinor &out, const cpuGaugeField &fatGauge, const cpuGaugeField &longGauge,
+			 const Spinor &in, const Spinor *fwdGhost, const Spinor *backGhost, const LatticeGeometry &geom,
+			 const int parity, const int dagger, const Spinor &x, const double &k, const int kernel) {
+      if (fatGauge.Precision() != longGauge.Precision())
+	errorQuda("Fat and long link precisions do not match (%d %d)", fatGauge.Precision(), longGauge.Precision());
+      void **ghostFat = (void**)fatGauge.Ghost();
+      void **ghostLong = (void**)longGauge.Ghost();
+      if (fatGauge.Precision() == QUDA_DOUBLE_PRECISION) {
+	staggeredDslash(out, (double**)fatGauge.Gauge_p(), (double**)longGauge.Gauge_p(),
+			(double**)ghostFat, (double**)ghostLong, in, fwdGhost, backGhost, geom, parity, dagger, x, k, kernel);
+      } else if (fatGauge.Precision() == QUDA_SINGLE_PRECISION) {
+	staggeredDslash(out, (float**)fatGauge.Gauge_p(), (float**)longGauge.Gauge_p(),
+			(float**)ghostFat, (float**)ghostLong, in, fwdGhost, backGhost, geom, parity, dagger, x, k, kernel);
+      } else {
+	errorQuda("Gauge precision %d not supported", fatGauge.Precision());
+      }
+    }
+
+    // raw copies of the first sites of a field, used to restore the output of a kernel after tuning it
+    template <typename Float>
+    static void backupSpinor(std::vector<char> &b, const SpinorCpu<Float> &s, const size_t sites, const int n) {
+      const char *v = reinterpret_cast<const char*>(s.v);
+      b.assign(v, v + sites*n*sizeof(Float));
+    }
+
+    static void backupSpinor(std::vector<char> &b, const SpinorCpu<short> &s, const size_t sites, const int n) {
+      const char *v = reinterpret_cast<const char*>(s.v), *norm = reinterpret_cast<const char*>(s.norm);
+      b.assign(v, v + sites*n*sizeof(short));
+      b.insert(b.end(), norm, norm + sites*sizeof(float));
+    }
+
+    template <typename Float>
+    static void restoreSpinor(const SpinorCpu<Float> &s, const std::vector<char> &b, const size_t sites, const int n) {
+      memcpy(s.v, &b[0], sites*n*sizeof(Float));
+    }
+
+    static void restoreSpinor(const SpinorCpu<short> &s, const std::vector<char> &b, const size_t sites, const int n) {
+      memcpy(s.v, &b[0], sites*n*sizeof(short));
+      memcpy(s.norm, &b[sites*n*sizeof(short)], sites*sizeof(float));
+    }
+
+    /**
+       Base class of the single right-hand side dslash kernels as host
+       Tunables, tuned per kernel (interior or the exterior kernel of a
+       dimension), volume and precision.  Besides the threads and
+       schedule, the instruction set of the su3_cpu.h kernels is tuned,
+       from the one selected by hostSimdType() down to scalar code.
+       The output field is backed up while tuning, since the exterior
+       kernels accumulate onto it.
+    */
+    template <typename Spinor>
+    class DslashCpu : public TunableHost {
+
+    protected:
+      const Spinor out;
+      const LatticeGeometry &geom;
+      const int parity;
+      const int dagger;
+      const bool xpay;
+      const int kernel;
+      const int nComponent; // reals per site
+      const int gaugePrecision;
+      int nSites;
+      std::vector<char> backup;
+
+      int workItems() const { return (nSites + blockSize - 1) / blockSize; }
+
+      /**
+	 Bytes loaded and stored, counting every load of a neighbor.
+	 The interior kernel loads nNeighbor spinors and links per site
+	 and the accumulated spinor, and stores the output; the exterior
+	 kernels load a ghost spinor and a link per face site and update
+	 the output.  Host links are stored in full.
+      */
+      long long dslashBytes(int nNeighbor) const {
+	const int spinorBytes = nComponent*sizeof(typename Spinor::real);
+	const int linkBytes = 18*gaugePrecision;
+	if (kernel == interiorKernel) return (long long)nSites * (nNeighbor*(spinorBytes + linkBytes) + (xpay ? 2 : 1)*spinorBytes);
+	return (long long)nSites * (linkBytes + 3*spinorBytes);
+      }
+
+    public:
+      DslashCpu(const Spinor &out, const LatticeGeometry &geom, const int parity, const int dagger,
+		const bool xpay, const int kernel, const int nComponent, const int gaugePrecision)
+	: out(out), geom(geom), parity(parity), dagger(dagger), xpay(xpay), kernel(kernel),
+	  nComponent(nComponent), gaugePrecision(gaugePrecision), nSites(geom.VolumeCB()) {
+	if (kernel != interiorKernel) geom.FaceSites(parity, kernel, nSites);
+      }
+      virtual ~DslashCpu() { }
+
+      TuneKey tuneKey() const {
+	std::stringstream vol, aux;
+	vol << geom.X(0) << "x" << geom.X(1) << "x" << geom.X(2) << "x" << geom.X(3);
+	aux << "prec=" << sizeof(typename Spinor::real) << ",gauge=" << gaugePrecision;
+	if (kernel == interiorKernel) aux << ",interior";
+	else aux << ",exterior=" << kernel;
+	aux << ",dagger=" << dagger << ",xpay=" << xpay << ",omp=" << hostMaxThreads();
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
+      }
+
+      std::string paramString(const TuneParam &param) const {
+	std::stringstream ps;
+	ps << TunableHost::paramString(param) << ", simd=" << hostSimdString(static_cast<HostSimdType>(param.simd));
+	return ps.str();
+      }
+
+      void initTuneParam(TuneParam &param) const {
+	TunableHost::initTuneParam(param);
+	param.simd = hostSimdType();
+      }
+
+      void defaultTuneParam(TuneParam &param) const { initTuneParam(param); }
+
+      /** Try the threads and schedules of each instruction set in turn */
+      bool advanceTuneParam(TuneParam &param) const {
+	if (TunableHost::advanceTuneParam(param)) return true;
+	if (param.simd <= HOST_SIMD_SCALAR) return false;
+	const int simd = param.simd - 1;
+	TunableHost::initTuneParam(param);
+	param.simd = simd;
+	return true;
+      }
+
+      /** Cached parameters may name an instruction set that has since been disabled, or none at all */
+      void checkLaunchParam(TuneParam &param) {
+	TunableHost::checkLaunchParam(param);
+	if (param.simd < 0 || param.simd > hostSimdType()) param.simd = hostSimdType();
+      }
+
+      void preTune() { backupSpinor(backup, out, geom.VolumeCB(), nComponent); }
+      void postTune() {
+	restoreSpinor(out, backup, geom.VolumeCB(), nComponent);
+	std::vector<char>().swap(backup);
+      }
+    };
+
+    template <typename Spinor>
+    class WilsonDslashCpu : public DslashCpu<Spinor> {
+
+    private:
+      const cpuGaugeField &gauge;
+      const Spinor in;
+      const Spinor *fwdGhost;
+      const Spinor *backGhost;
+      const Spinor x;
+      const double k;
+
+      long long flops() const {
+	// the exterior kernels apply about one of the eight hops per face site
+	return (this->kernel == interiorKernel ? (this->xpay ? 1368ll : 1320ll) : 165ll) * this->nSites;
+      }
+      long long bytes() const { return this->dslashBytes(8); }
+
+    public:
+      WilsonDslashCpu(const Spinor &out, const cpuGaugeField &gauge, const Spinor &in,
+		      const Spinor *fwdGhost, const Spinor *backGhost, const LatticeGeometry &geom,
+		      const int parity, const int dagger, const Spinor &x, const double &k, const int kernel)
+	: DslashCpu<Spinor>(out, geom, parity, dagger, x.valid(), kernel, 24, gauge.Precision()),
+	  gauge(gauge), in(in), fwdGhost(fwdGhost), backGhost(backGhost), x(x), k(k) { }
+      virtual ~WilsonDslashCpu() { }
+
+      void apply(const cudaStream_t &stream) {
+	TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+	HostLaunch launch(tp);
+	wilsonDslash(this->out, gauge, in, fwdGhost, backGhost, this->geom, this->parity, this->dagger,
+		     x, k, this->kernel);
+      }
+    };
+
+    template <typename Spinor>
+    class StaggeredDslashCpu : public DslashCpu<Spinor> {
+
+    private:
+      const cpuGaugeField &fatGauge;
+      const cpuGaugeField &longGauge;
+      const Spinor in;
+      const Spinor *fwdGhost;
+      const Spinor *backGhost;
+      const Spinor x;
+      const double k;
+
+      long long flops() const {
+	return (this->kernel == interiorKernel ? (this->xpay ? 1158ll : 1146ll) : 143ll) * this->nSites;
+      }
+      long long bytes() const { return this->dslashBytes(16); }
+
+    public:
+      StaggeredDslashCpu(const Spinor &out, const cpuGaugeField &fatGauge, const cpuGaugeField &longGauge,
+			 const Spinor &in, const Spinor *fwdGhost, const Spinor *backGhost,
+			 const LatticeGeometry &geom, const int parity, const int dagger, const Spinor &x,
+			 const double &k, const int kernel)
+	: DslashCpu<Spinor>(out, geom, parity, dagger, x.valid(), kernel, 6, fatGauge.Precision()),
+	  fatGauge(fatGauge), longGauge(longGauge), in(in), fwdGhost(fwdGhost), backGhost(backGhost), x(x), k(k) { }
+      virtual ~StaggeredDslashCpu() { }
+
+      void apply(const cudaStream_t &stream) {
+	TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+	HostLaunch launch(tp);
+	staggeredDslash(this->out, fatGauge, longGauge, in, fwdGhost, backGhost, this->geom, this->parity,
+			this->dagger, x, k, this->kernel);
+      }
+    };
+
+    /**
+       Apply the packed clover term (or its inverse) site by site.  Each
+       chiral block is a Hermitian 6x6 matrix stored as its 6 real
+       diagonal elements followed by the 15 complex elements of the
+       strictly lower triangle in column-major order.  In the
+       DeGrand-Rossi basis the first block acts on spins 0 and 1 and
+       the second on spins 2 and 3.  Each site is read before it is
+       written, so out may alias in or x.
+    */
+    template <typename sFloat, typename cFloat>
+    inline void cloverSite(sFloat *res, const cFloat *A, const sFloat *in) {
+      for (int ch=0; ch<2; ch++) {
+	const cFloat *diag = A + ch*36;
+	const cFloat *offdiag = diag + 6;
+	const sFloat *v = in + ch*12;
+	sFloat *r = res + ch*12;
+
+	for (int a=0; a<6; a++) {
+	  r[2*a+0] = diag[a]*v[2*a+0];
+	  r[2*a+1] = diag[a]*v[2*a+1];
+	}
+
+	int idx = 0;
+	for (int col=0; col<6; col++) {
+	  for (int row=col+1; row<6; row++, idx++) {
+	    const sFloat re = offdiag[2*idx+0], im = offdiag[2*idx+1];
+	    // A[row][col] v[col]
+	    r[2*row+0] += re*v[2*col+0] - im*v[2*col+1];
+	    r[2*row+1] += re*v[2*col+1] + im*v[2*col+0];
+	    // A[col][row] v[row] = conj(A[row][col]) v[row]
+	    r[2*col+0] += re*v[2*row+0] + im*v[2*row+1];
+	    r[2*col+1] += re*v[2*row+1] - im*v[2*row+0];
+	  }
+	}
+      }
+    }
+
+    // out = A in, or out = x + k A in
+    template <typename Spinor, typename cFloat>
+    void clover(const Spinor &out, const cFloat *A, const Spinor &in, const int volumeCB,
+		const Spinor &x, const double &k) {
+      typedef typename Spinor::real sFloat;
+#pragma omp parallel for
+      for (int i=0; i<volumeCB; i++) {
+	sFloat v[24], res[24];
+	in.load(v, 1, i, 24);
+	cloverSite(res, A + i*72, v);
+
+	if (x.valid()) {
+	  const sFloat a = k;
+	  sFloat xi[24];
+	  x.load(xi, 1, i, 24);
+	  for (int c=0; c<24; c++) res[c] = xi[c] + a*res[c];
+	}
+	out.save(res, i, 24);
+      }
+    }
+
+    // multi-RHS version of the above: the clover matrix of each site is read once for all fields
+    template <typename Spinor, typename cFloat>
+    void clover(const Spinor *out, const cFloat *A, const Spinor *in, const int nRhs, const int volumeCB,
+		const Spinor *x, const double &k) {
+      typedef typename Spinor::real sFloat;
+#pragma omp parallel for
+      for (int i=0; i<volumeCB; i++) {
+	cFloat Ai[72];
+	for (int c=0; c<72; c++) Ai[c] = A[i*72 + c];
+
+	for (int r=0; r<nRhs; r++) {
+	  sFloat v[24], res[24];
+	  in[r].load(v, 1, i, 24);
+	  cloverSite(res, Ai, v);
+
+	  if (x) {
+	    const sFloat a = k;
+	    sFloat xi[24];
+	    x[r].load(xi, 1, i, 24);
+	    for (int c=0; c<24; c++) res[c] = xi[c] + a*res[c];
+	  }
+	  out[r].save(res, i, 24);
+	}
+      }
+    }
+
+    // out = b (1 + i a gamma_5) in, or out = x + k b (1 + i a gamma_5) in
+    template <typename Spinor>
+    void twistGamma5(const Spinor &out, const Spinor &in, const int volumeCB, const double &a,
+		     const double &b, const Spinor &x, const double &k) {
+      typedef typename Spinor::real sFloat;
+      const sFloat bk = x.valid() ? b*k : b;
+#pragma omp parallel for
+      for (int i=0; i<volumeCB; i++) {
+	sFloat v[24], res[24];
+	in.load(v, 1, i, 24);
+	for (int s=0; s<4; s++) {
+	  const sFloat a5 = ((s / 2) ? -1.0 : +1.0) * a;
+	  for (int c=0; c<3; c++) {
+	    res[s*6 + c*2 + 0] = bk * (v[s*6 + c*2 + 0] - a5*v[s*6 + c*2 + 1]);
+	    res[s*6 + c*2 + 1] = bk * (v[s*6 + c*2 + 1] + a5*v[s*6 + c*2 + 0]);
+	  }
+	}
+
+	if (x.valid()) {
+	  sFloat xi[24];
+	  x.load(xi, 1, i, 24);
+	  for (int c=0; c<24; c++) res[c] = xi[c] + res[c];
+	}
+	out.save(res, i, 24);
+      }
+    }
+
+    static void checkFields(const cpuColorSpinorField *out, const cpuColorSpinorField *in,
+			    const cpuColorSpinorField *x) {
+      if (in->SiteSubset() != QUDA_PARITY_SITE_SUBSET || out->SiteSubset() != QUDA_PARITY_SITE_SUBSET)
+	errorQuda("Host dslash requires single parity fields");
+      if (in->FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER || out->FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+	errorQuda("Host dslash requires QUDA_SPACE_SPIN_COLOR_FIELD_ORDER");
+      if (in->Nspin() == 4 && in->GammaBasis() != QUDA_DEGRAND_ROSSI_GAMMA_BASIS)
+	errorQuda("Host dslash requires the DeGrand-Rossi gamma basis");
+      if (in->Precision() != out->Precision() || (x && x->Precision() != in->Precision()))
+	errorQuda("Precisions do not match (out=%d in=%d)", out->Precision(), in->Precision());
+      if (in->Volume() != out->Volume() || (x && x->Volume() != in->Volume()))
+	errorQuda("Volumes do not match (out=%d in=%d)", out->Volume(), in->Volume());
+    }
+
+    // exchange the ghost zone of the input field (which has the opposite parity to the output),
+    // through the exchange of the given slot so that the ghost zones of several fields may be kept
+    static void exchangeGhost(const cpuColorSpinorField *in, const int *X, const int nFace,
+			      const int Ls, const int parity, const int dagger, const int *comm,
+			      void **fwdGhost, void **backGhost, const int slot) {
+      for (int d=0; d<4; d++) fwdGhost[d] = backGhost[d] = 0;
+
+#ifdef MULTI_GPU
+      if (comm[0] || comm[1] || comm[2] || comm[3]) {
+	SpinorGhostExchange &exchange = SpinorGhostExchange::Get(X, nFace, in->Nspin(), in->Precision(), Ls, slot);
+	exchange.start(const_cast<cpuColorSpinorField&>(*in), 1-parity, dagger, comm);
+	for (int d=0; d<4; d++) {
+	  exchange.wait(d);
+	  fwdGhost[d] = exchange.Fwd()[d];
+	  backGhost[d] = exchange.Back()[d];
+	}
+      }
+#endif
+    }
+
+    /**
+       Ghost zone exchange of the input field of a dslash, started on
+       construction so that it proceeds while the interior kernel runs.
+       next() then returns the dimensions with a ghost zone in the order
+       in which their faces arrive.
+    */
+    class GhostExchange {
+
+    private:
+      SpinorGhostExchange *exchange; // the persistent exchange for this geometry
+      bool done[4]; // whether the exterior kernel of each dimension has been handed out
+
+    public:
+      void *fwd[QUDA_MAX_DIM];
+      void *back[QUDA_MAX_DIM];
+
+      GhostExchange(const cpuColorSpinorField *in, const int *X, const int nFace,
+		    const int Ls, const int parity, const int dagger, const int *comm) : exchange(0) {
+	for (int d=0; d<4; d++) {
+	  fwd[d] = back[d] = 0;
+	  done[d] = true;
+	}
+
+#ifdef MULTI_GPU
+	if (comm[0] || comm[1] || comm[2] || comm[3]) {
+	  exchange = &SpinorGhostExchange::Get(X, nFace, in->Nspin(), in->Precision(), Ls);
+	  exchange->start(const_cast<cpuColorSpinorField&>(*in), 1-parity, dagger, comm);
+	  for (int d=0; d<4; d++) {
+	    fwd[d] = exchange->Fwd()[d];
+	    back[d] = exchange->Back()[d];
+	    done[d] = !comm[d];
+	  }
+	}
+#endif
+      }
+
+      virtual ~GhostExchange() {
+	if (exchange) for (int d=0; d<4; d++) exchange->wait(d);
+      }
+
+      /** @return The next dimension whose ghost zone has arrived, or -1 once there are none left */
+      int next() {
+	while (true) {
+	  bool pending = false;
+	  for (int d=0; d<4; d++) {
+	    if (done[d]) continue;
+	    if (exchange->query(d)) {
+	      done[d] = true;
+	      return d;
+	    }
+	    pending = true;
+	  }
+	  if (!pending) return -1;
+	}
+      }
+    };
+
+    static void commDims(int *comm, const int *commDim) {
+      for (int d=0; d<4; d++) comm[d] = 0;
+#ifdef MULTI_GPU
+      for (int d=0; d<4; d++) comm[d] = commDim[d];
+#endif
+    }
+
+    // accessor for a field, or a null accessor if the field is absent
+    template <typename Float>
+    inline SpinorCpu<Float> spinor(const cpuColorSpinorField *f) {
+      return f ? SpinorCpu<Float>(const_cast<void*>(f->V()), const_cast<void*>(f->Norm())) : SpinorCpu<Float>();
+    }
+
+    template <typename Float>
+    inline void ghosts(SpinorCpu<Float> *ghost, void **buffer) {
+      for (int d=0; d<4; d++) ghost[d] = SpinorCpu<Float>(buffer[d]);
+    }
+
+    template <typename Float>
+    void wilsonDslash(cpuColorSpinorField *out, const cpuGaugeField &gauge, const cpuColorSpinorField *in,
+		      GhostExchange &ghost, const LatticeGeometry &geom,
+		      const int parity, const int dagger, const cpuColorSpinorField *x, const double &k) {
+      SpinorCpu<Float> fwd[4], back[4];
+      ghosts(fwd, ghost.fwd);
+      ghosts(back, ghost.back);
+      const SpinorCpu<Float> o = spinor<Float>(out), v = spinor<Float>(in), xv = spinor<Float>(x);
+      WilsonDslashCpu<SpinorCpu<Float> >(o, gauge, v, fwd, back, geom, parity, dagger, xv, k, interiorKernel).apply(0);
+      for (int d; (d = ghost.next()) >= 0; )
+	WilsonDslashCpu<SpinorCpu<Float> >(o, gauge, v, fwd, back, geom, parity, dagger, xv, k, d).apply(0);
+    }
+
+    template <typename Float>
+    void wilsonDslash(cpuColorSpinorField **out, const cpuGaugeField &gauge, cpuColorSpinorField **in,
+		      void ***fwdGhost, void ***backGhost, const int nRhs, const LatticeGeometry &geom,
+		      const int parity, const int dagger, cpuColorSpinorField **x, const double &k) {
+      SpinorCpu<Float> o[maxRhs], v[maxRhs], xv[maxRhs], fwd[maxRhs][4], back[maxRhs][4];
+      SpinorCpu<Float> *fwdp[maxRhs], *backp[maxRhs];
+      for (int r=0; r<nRhs; r++) {
+	o[r] = spinor<Float>(out[r]);
+	v[r] = spinor<Float>(in[r]);
+	xv[r] = spinor<Float>(x ? x[r] : 0);
+	ghosts(fwd[r], fwdGhost[r]);
+	ghosts(back[r], backGhost[r]);
+	fwdp[r] = fwd[r];
+	backp[r] = back[r];
+      }
+      wilsonDslash(o, gauge, v, fwdp, backp, nRhs, geom, parity, dagger, x ? xv : 0, k);
+    }
+
+    // the given kernel of the Wilson dslash on each fifth-dimension slice
+    template <typename Float>
+    void domainWallDslash4d(const SpinorCpu<Float> &o, const cpuGaugeField &gauge, const SpinorCpu<Float> &v,
+			    const SpinorCpu<Float> *fwdGhost5, const SpinorCpu<Float> *backGhost5,
+			    const LatticeGeometry &geom, const int Ls, const int parity, const int dagger,
+			    const SpinorCpu<Float> &xv, const double &k, const int kernel) {
+      const int volumeCB = geom.VolumeCB();
+      for (int xs=0; xs<Ls; xs++) {
+	const size_t offset = (size_t)xs*volumeCB;
+	SpinorCpu<Float> fwd[4], back[4];
+	for (int d=0; d<4; d++) {
+	  const size_t ghostOffset = (size_t)xs*geom.FaceVolumeCB(d);
+	  if (fwdGhost5[d].valid()) fwd[d] = fwdGhost5[d].offset(ghostOffset, 24);
+	  if (backGhost5[d].valid()) back[d] = backGhost5[d].offset(ghostOffset, 24);
+	}
+	const int p = (parity + xs) & 1;
+	WilsonDslashCpu<SpinorCpu<Float> >(o.offset(offset, 24), gauge, v.offset(offset, 24), fwd, back, geom, p,
+					   dagger, xv.valid() ? xv.offset(offset, 24) : SpinorCpu<Float>(), k,
+					   kernel).apply(0);
+      }
+    }
+
+    // the Wilson dslash of each fifth-dimension slice followed by the fifth-dimension hopping term
+    template <typename Float>
+    void domainWallDslash(cpuColorSpinorField *out, const cpuGaugeField &gauge, const cpuColorSpinorField *in,
+			  GhostExchange &ghost, const LatticeGeometry &geom, const int Ls,
+			  const int parity, const int dagger, const cpuColorSpinorField *x,
+			  const double &m_f, const double &k) {
+      const int volumeCB = geom.VolumeCB();
+      const SpinorCpu<Float> o = spinor<Float>(out), v = spinor<Float>(in), xv = spinor<Float>(x);
+      SpinorCpu<Float> fwdGhost5[4], backGhost5[4];
+      ghosts(fwdGhost5, ghost.fwd);
+      ghosts(backGhost5, ghost.back);
+
+      domainWallDslash4d(o, gauge, v, fwdGhost5, backGhost5, geom, Ls, parity, dagger, xv, k, interiorKernel);
+      // the fifth-dimension term is local, so it is also overlapped with the exchange
+      domainWall5th(o, v, Ls, volumeCB, dagger, m_f, x ? k : 1.0);
+      for (int d; (d = ghost.next()) >= 0; )
+	domainWallDslash4d(o, gauge, v, fwdGhost5, backGhost5, geom, Ls, parity, dagger, xv, k, d);
+    }
+
+    template <typename Float>
+    void staggeredDslash(cpuColorSpinorField *out, const cpuGaugeField &fatGauge, const cpuGaugeField &longGauge,
+			 const cpuColorSpinorField *in, GhostExchange &ghost, const LatticeGeometry &geom,
+			 const int parity, const int dagger, const cpuColorSpinorField *x, const double &k) {
+      SpinorCpu<Float> fwd[4], back[4];
+      ghosts(fwd, ghost.fwd);
+      ghosts(back, ghost.back);
+      const SpinorCpu<Float> o = spinor<Float>(out), v = spinor<Float>(in), xv = spinor<Float>(x);
+      StaggeredDslashCpu<SpinorCpu<Float> >(o, fatGauge, longGauge, v, fwd, back, geom, parity, dagger, xv, k,
+					    interiorKernel).apply(0);
+      for (int d; (d = ghost.next()) >= 0; )
+	StaggeredDslashCpu<SpinorCpu<Float> >(o, fatGauge, longGauge, v, fwd, back, geom, parity, dagger, xv, k,
+					      d).apply(0);
+    }
+
+    template <typename Float>
+    void clover(cpuColorSpinorField *out, const cpuCloverField &field, const void *A,
+		const cpuColorSpinorField *in, const cpuColorSpinorField *x, const double &k) {
+      if (field.Precision() == QUDA_DOUBLE_PRECISION)
+	clover(spinor<Float>(out), (const double*)A, spinor<Float>(in), in->Volume(), spinor<Float>(x), k);
+      else
+	clover(spinor<Float>(out), (const float*)A, spinor<Float>(in), in->Volume(), spinor<Float>(x), k);
+    }
+
+    template <typename Float>
+    void clover(cpuColorSpinorField **out, const cpuCloverField &field, const void *A,
+		cpuColorSpinorField **in, const int nRhs, cpuColorSpinorField **x, const double &k) {
+      SpinorCpu<Float> o[maxRhs], v[maxRhs], xv[maxRhs];
+      for (int r=0; r<nRhs; r++) {
+	o[r] = spinor<Float>(out[r]);
+	v[r] = spinor<Float>(in[r]);
+	xv[r] = spinor<Float>(x ? x[r] : 0);
+      }
+      const int volumeCB = field.VolumeCB();
+      if (field.Precision() == QUDA_DOUBLE_PRECISION)
+	clover(o, (const double*)A, v, nRhs, volumeCB, x ? xv : 0, k);
+      else
+	clover(o, (const float*)A, v, nRhs, volumeCB, x ? xv : 0, k);
+    }
+
+  } // namespace dslash_cpu
+
+  void wilsonDslashCpu(cpuColorSpinorField *out, const cpuGaugeField &gauge, const cpuColorSpinorField *in,
+		       const int parity, const int dagger, const cpuColorSpinorField *x,
+		       const double &k, const int *commDim) {
+    dslash_cpu::checkFields(out, in, x);
+    if (in->Nspin() != 4) errorQuda("Wilson dslash requires nSpin = 4, not %d", in->Nspin());
+    if (gauge.Order() != QUDA_QDP_GAUGE_ORDER)
+      errorQuda("Host dslash requires QDP gauge order");
+    if (parity != QUDA_EVEN_PARITY && parity != QUDA_ODD_PARITY)
+      errorQuda("Invalid parity %d", parity);
+
+    const int *X = gauge.X();
+    int comm[4];
+    dslash_cpu::commDims(comm, commDim);
+    const LatticeGeometry &geom = LatticeGeometry::Get(X, 1, comm);
+
+    dslash_cpu::GhostExchange ghost(in, X, 1, 1, parity, dagger, comm);
+
+    if (in->Precision() == QUDA_DOUBLE_PRECISION) {
+      dslash_cpu::wilsonDslash<double>(out, gauge, in, ghost, geom, parity, dagger, x, k);
+    } else if (in->Precision() == QUDA_SINGLE_PRECISION) {
+      dslash_cpu::wilsonDslash<float>(out, gauge, in, ghost, geom, parity, dagger, x, k);
+    } else if (in->Precision() == QUDA_HALF_PRECISION) {
+      dslash_cpu::wilsonDslash<short>(out, gauge, in, ghost, geom, parity, dagger, x, k);
+    } else {
+      errorQuda("Precision %d not supported", in->Precision());
+    }
+  }
+
+  // The right-hand sides are processed in batches of at most maxRhs
+  // fields, with the ghost zones of each field exchanged separately
+  // into the buffers of its own slot.
+  void wilsonDslashCpu(cpuColorSpinorField **out, const cpuGaugeField &gauge, cpuColorSpinorField **in,
+		       const int nRhs, const int parity, const int dagger, cpuColorSpinorField **x,
+		       const double &k, const int *commDim) {
+    for (int r=0; r<nRhs; r++) {
+      dslash_cpu::checkFields(out[r], in[r], x ? x[r] : 0);
+      if (in[r]->Nspin() != 4) errorQuda("Wilson dslash requires nSpin = 4, not %d", in[r]->Nspin());
+      if (in[r]->Precision() != in[0]->Precision())
+	errorQuda("Precisions do not match (in[%d]=%d in[0]=%d)", r, in[r]->Precision(), in[0]->Precision());
+    }
+    if (gauge.Order() != QUDA_QDP_GAUGE_ORDER)
+      errorQuda("Host dslash requires QDP gauge order");
+    if (parity != QUDA_EVEN_PARITY && parity != QUDA_ODD_PARITY)
+      errorQuda("Invalid parity %d", parity);
+
+    const int *X = gauge.X();
+    int comm[4];
+    dslash_cpu::commDims(comm, commDim);
+    const LatticeGeometry &geom = LatticeGeometry::Get(X, 1, comm);
+
+    for (int r0=0; r0<nRhs; r0+=dslash_cpu::maxRhs) {
+      const int n = (nRhs - r0 < dslash_cpu::maxRhs) ? nRhs - r0 : dslash_cpu::maxRhs;
+
+      void *fwd[dslash_cpu::maxRhs][QUDA_MAX_DIM], *back[dslash_cpu::maxRhs][QUDA_MAX_DIM];
+      void **fwdGhost[dslash_cpu::maxRhs], **backGhost[dslash_cpu::maxRhs];
+      for (int r=0; r<n; r++) {
+	dslash_cpu::exchangeGhost(in[r0+r], X, 1, 1, parity, dagger, comm, fwd[r], back[r], r);
+	fwdGhost[r] = fwd[r];
+	backGhost[r] = back[r];
+      }
+
+      cpuColorSpinorField **xr = x ? x + r0 : 0;
+      if (in[0]->Precision() == QUDA_DOUBLE_PRECISION) {
+	dslash_cpu::wilsonDslash<double>(out + r0, gauge, in + r0, fwdGhost, backGhost, n, geom, parity, dagger, xr, k);
+      } else if (in[0]->Precision() == QUDA_SINGLE_PRECISION) {
+	dslash_cpu::wilsonDslash<float>(out + r0, gauge, in + r0, fwdGhost, backGhost, n, geom, parity, dagger, xr, k);
+      } else if (in[0]->Precision() == QUDA_HALF_PRECISION) {
+	dslash_cpu::wilsonDslash<short>(out + r0, gauge, in + r0, fwdGhost, backGhost, n, geom, parity, dagger, xr, k);
+      } else {
+	errorQuda("Precision %d not supported", in[0]->Precision());
+      }
+    }
+  }
+
+  // The 4-d hopping term of each fifth-dimension slice is a Wilson
+  // dslash, where the 4-d parity of slice s is that of the 5-d field
+  // shifted by s.  The ghost zones are ordered (layer, s, face).
+  void domainWallDslashCpu(cpuColorSpinorField *out, const cpuGaugeField &gauge, const cpuColorSpinorField *in,
+			   const int parity, const int dagger, const cpuColorSpinorField *x,
+			   const double &m_f, const double &k, const int *commDim) {
+    dslash_cpu::checkFields(out, in, x);
+    if (in->Ndim() != 5 || out->Ndim() != 5) errorQuda("Domain wall dslash requires 5-d fields");
+    if (gauge.Order() != QUDA_QDP_GAUGE_ORDER)
+      errorQuda("Host dslash requires QDP gauge order");
+    if (parity != QUDA_EVEN_PARITY && parity != QUDA_ODD_PARITY)
+      errorQuda("Invalid parity %d", parity);
+
+    const int *X = gauge.X();
+    const int Ls = in->X(4);
+    int comm[4];
+    dslash_cpu::commDims(comm, commDim);
+    const LatticeGeometry &geom = LatticeGeometry::Get(X, 1, comm);
+    const int volumeCB = geom.VolumeCB();
+    if (in->Volume() != Ls*volumeCB) errorQuda("Spinor volume %d doesn't match Ls*gauge volume %d", in->Volume(), Ls*volumeCB);
+
+    dslash_cpu::GhostExchange ghost(in, X, 1, Ls, parity, dagger, comm);
+
+    if (in->Precision() == QUDA_DOUBLE_PRECISION) {
+      dslash_cpu::domainWallDslash<double>(out, gauge, in, ghost, geom, Ls, parity, dagger, x, m_f, k);
+    } else if (in->Precision() == QUDA_SINGLE_PRECISION) {
+      dslash_cpu::domainWallDslash<float>(out, gauge, in, ghost, geom, Ls, parity, dagger, x, m_f, k);
+    } else if (in->Precision() == QUDA_HALF_PRECISION) {
+      dslash_cpu::domainWallDslash<short>(out, gauge, in, ghost, geom, Ls, parity, dagger, x, m_f, k);
+    } else {
+      errorQuda("Precision %d not supported", in->Precision());
+    }
+  }
+
+  void staggeredDslashCpu(cpuColorSpinorField *out, const cpuGaugeField &fatGauge, const cpuGaugeField &longGauge,
+			  const cpuColorSpinorField *in, const int parity, const int dagger,
+			  const cpuColorSpinorField *x, const double &k, const int *commDim) {
+    dslash_cpu::checkFields(out, in, x);
+    if (in->Nspin() != 1) errorQuda("Staggered dslash requires nSpin = 1, not %d", in->Nspin());
+    if (fatGauge.Order() != QUDA_QDP_GAUGE_ORDER || longGauge.Order() != QUDA_QDP_GAUGE_ORDER)
+      errorQuda("Host dslash requires QDP gauge order");
+    if (parity != QUDA_EVEN_PARITY && parity != QUDA_ODD_PARITY)
+      errorQuda("Invalid parity %d", parity);
+
+    const int *X = fatGauge.X();
+    int comm[4];
+    dslash_cpu::commDims(comm, commDim);
+    const LatticeGeometry &geom = LatticeGeometry::Get(X, 3, comm);
+
+    dslash_cpu::GhostExchange ghost(in, X, 3, 1, parity, dagger, comm);
+
+    if (in->Precision() == QUDA_DOUBLE_PRECISION) {
+      dslash_cpu::staggeredDslash<double>(out, fatGauge, longGauge, in, ghost, geom, parity, dagger, x, k);
+    } else if (in->Precision() == QUDA_SINGLE_PRECISION) {
+      dslash_cpu::staggeredDslash<float>(out, fatGauge, longGauge, in, ghost, geom, parity, dagger, x, k);
+    } else if (in->Precision() == QUDA_HALF_PRECISION) {
+      dslash_cpu::staggeredDslash<short>(out, fatGauge, longGauge, in, ghost, geom, parity, dagger, x, k);
+    } else {
+      errorQuda("Precision %d not supported", in->Precision());
+    }
+  }
+
+  void cloverCpu(cpuColorSpinorField *out, const cpuCloverField &clover, const cpuColorSpinorField *in,
+		 const int parity, const bool inverse, const cpuColorSpinorField *x, const double &k) {
+    dslash_cpu::checkFields(out, in, x);
+    if (in->Nspin() != 4) errorQuda("Clover term requires nSpin = 4, not %d", in->Nspin());
+    if (clover.Order() != QUDA_PACKED_CLOVER_ORDER)
+      errorQuda("Host clover term requires packed clover order, not %d", clover.Order());
+    if (in->Volume() != clover.VolumeCB())
+      errorQuda("Spinor volume %d doesn't match clover volume %d", in->Volume(), clover.VolumeCB());
+    if (!clover.V(inverse)) errorQuda("Clover %s not allocated", inverse ? "inverse" : "term");
+
+    // the two parities are stored one after the other
+    const void *A = (const char*)clover.V(inverse) + parity*clover.Bytes()/2;
+
+    if (in->Precision() == QUDA_DOUBLE_PRECISION) {
+      dslash_cpu::clover<double>(out, clover, A, in, x, k);
+    } else if (in->Precision() == QUDA_SINGLE_PRECISION) {
+      dslash_cpu::clover<float>(out, clover, A, in, x, k);
+    } else if (in->Precision() == QUDA_HALF_PRECISION) {
+      dslash_cpu::clover<short>(out, clover, A, in, x, k);
+    } else {
+      errorQuda("Precision %d not supported", in->Precision());
+    }
+  }
+
+  void cloverCpu(cpuColorSpinorField **out, const cpuCloverField &clover, cpuColorSpinorField **in,
+		 const int nRhs, const int parity, const bool inverse, cpuColorSpinorField **x,
+		 const double &k) {
+    for (int r=0; r<nRhs; r++) {
+      dslash_cpu::checkFields(out[r], in[r], x ? x[r] : 0);
+      if (in[r]->Nspin() != 4) errorQuda("Clover term requires nSpin = 4, not %d", in[r]->Nspin());
+      if (in[r]->Precision() != in[0]->Precision())
+	errorQuda("Precisions do not match (in[%d]=%d in[0]=%d)", r, in[r]->Precision(), in[0]->Precision());
+      if (in[r]->Volume() != clover.VolumeCB())
+	errorQuda("Spinor volume %d doesn't match clover volume %d", in[r]->Volume(), clover.VolumeCB());
+    }
+    if (clover.Order() != QUDA_PACKED_CLOVER_ORDER)
+      errorQuda("Host clover term requires packed clover order, not %d", clover.Order());
+    if (!clover.V(inverse)) errorQuda("Clover %s not allocated", inverse ? "inverse" : "term");
+
+    const void *A = (const char*)clover.V(inverse) + parity*clover.Bytes()/2;
+
+    for (int r0=0; r0<nRhs; r0+=dslash_cpu::maxRhs) {
+      const int n = (nRhs - r0 < dslash_cpu::maxRhs) ? nRhs - r0 : dslash_cpu::maxRhs;
+      cpuColorSpinorField **xr = x ? x + r0 : 0;
+
+      if (in[0]->Precision() == QUDA_DOUBLE_PRECISION) {
+	dslash_cpu::clover<double>(out + r0, clover, A, in + r0, n, xr, k);
+      } else if (in[0]->Precision() == QUDA_SINGLE_PRECISION) {
+	dslash_cpu::clover<float>(out + r0, clover, A, in + r0, n, xr, k);
+      } else if (in[0]->Precision() == QUDA_HALF_PRECISION) {
+	dslash_cpu::clover<short>(out + r0, clover, A, in + r0, n, xr, k);
+      } else {
+	errorQuda("Precision %d not supported", in[0]->Precision());
+      }
+    }
+  }
+
+  void twistGamma5Cpu(cpuColorSpinorField *out, const cpuColorSpinorField *in, const int dagger,
+		      const double &kappa, const double &mu, const QudaTwistGamma5Type twist,
+		      const cpuColorSpinorField *x, const double &k) {
+    dslash_cpu::checkFields(out, in, x);
+    if (in->Nspin() != 4) errorQuda("Twist requires nSpin = 4, not %d", in->Nspin());
+
+    double a, b;
+    if (twist == QUDA_TWIST_GAMMA5_DIRECT) {
+      a = 2.0 * kappa * mu;
+      b = 1.0;
+    } else if (twist == QUDA_TWIST_GAMMA5_INVERSE) {
+      a = -2.0 * kappa * mu;
+      b = 1.0 / (1.0 + a*a);
+    } else {
+      errorQuda("Twist type %d not supported", twist);
+      return;
+    }
+    if (dagger) a *= -1.0;
+
+    if (in->Precision() == QUDA_DOUBLE_PRECISION) {
+      dslash_cpu::twistGamma5(dslash_cpu::spinor<double>(out), dslash_cpu::spinor<double>(in), in->Volume(), a, b,
+			      dslash_cpu::spinor<double>(x), k);
+    } else if (in->Precision() == QUDA_SINGLE_PRECISION) {
+      dslash_cpu::twistGamma5(dslash_cpu::spinor<float>(out), dslash_cpu::spinor<float>(in), in->Volume(), a, b,
+			      dslash_cpu::spinor<float>(x), k);
+    } else if (in->Precision() == QUDA_HALF_PRECISION) {
+      dslash_cpu::twistGamma5(dslash_cpu::spinor<short>(out), dslash_cpu::spinor<short>(in), in->Volume(), a, b,
+			      dslash_cpu::spinor<short>(x), k);
+    } else {
+      errorQuda("Precision %d not supported", in->Precision());
+    }
+  }
+
+} // namespace quda
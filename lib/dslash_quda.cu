@@ -497,6 +497,38 @@ namespace quda {
     bool tuneGridDim() const { return false; } // Don't tune the grid dimensions.
     unsigned int minThreads() const { return dslashConstants.VolumeCB(); }
 
+    /** Bytes per site of the input spinor, including the norm of half precision fields */
+    int spinorSiteBytes() const {
+      return 2*in->Ncolor()*in->Nspin()*in->Precision() + (in->Precision() == QUDA_HALF_PRECISION ? sizeof(float) : 0);
+    }
+
+    /**
+       Bytes loaded and stored by the kernel, counting every load of a
+       neighbor (i.e., ignoring cache reuse).  Interior kernels load
+       nNeighbor spinors and links per site, any further per-site
+       fields and the accumulated spinor, and store the output.
+       Exterior kernels load a ghost spinor (spin projected if the
+       field has four spins) and a link per face site, and update the
+       output.
+       @param linkBytes Bytes per link
+       @param siteBytes Bytes of further fields loaded per site by interior kernels, e.g., the clover term
+       @param nNeighbor Number of neighbors of each site
+     */
+    long long dslashBytes(int linkBytes, int siteBytes=0, int nNeighbor=8) const
+    {
+      const long long sites = dslashParam.threads;
+      const int spinorBytes = spinorSiteBytes();
+      if (dslashParam.kernel_type == INTERIOR_KERNEL)
+	return sites * (nNeighbor*(spinorBytes + linkBytes) + siteBytes + (x ? 2 : 1)*spinorBytes);
+      const int ghostBytes = in->Nspin() == 4 ? spinorBytes - in->Ncolor()*in->Nspin()*in->Precision() : spinorBytes;
+      return sites * (ghostBytes + linkBytes + 2*spinorBytes);
+    }
+
+    /** Bytes per site of the clover term, including the norms of half precision fields */
+    int cloverSiteBytes() const {
+      return 72*in->Precision() + (in->Precision() == QUDA_HALF_PRECISION ? 2*sizeof(float) : 0);
+    }
+
   public:
     DslashCuda(cudaColorSpinorField *out, const cudaColorSpinorField *in,
 	       const cudaColorSpinorField *x) 
@@ -570,7 +602,7 @@ namespace quda {
     aux << "single-GPU";
 #endif // MULTI_GPU
 
-    return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+    return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
   }
 
   /** This derived class is specifically for driving the Dslash kernels
@@ -752,6 +784,7 @@ namespace quda {
     }
 
     long long flops() const { return (x ? 1368ll : 1320ll) * dslashConstants.VolumeCB(); } // FIXME for multi-GPU
+    long long bytes() const { return dslashBytes(reconstruct*in->Precision()); }
   };
 
   template <typename sFloat, typename gFloat, typename cFloat>
@@ -815,6 +848,7 @@ namespace quda {
     }
 
     long long flops() const { return (x ? 1872ll : 1824ll) * dslashConstants.VolumeCB(); } // FIXME for multi-GPU
+    long long bytes() const { return dslashBytes(reconstruct*in->Precision(), cloverSiteBytes()); }
   };
 
   template <typename sFloat, typename gFloat, typename cFloat>
@@ -879,6 +913,7 @@ namespace quda {
     }
 
     long long flops() const { return 1872ll * dslashConstants.VolumeCB(); } // FIXME for multi-GPU
+    long long bytes() const { return dslashBytes(reconstruct*in->Precision(), cloverSiteBytes()); }
   };
 
   void setTwistParam(double &a, double &b, const double &kappa, const double &mu, 
@@ -997,6 +1032,7 @@ namespace quda {
     }
 
     long long flops() const { return (x ? 1416ll : 1392ll) * dslashConstants.VolumeCB(); } // FIXME for multi-GPU
+    long long bytes() const { return dslashBytes(reconstruct*in->Precision()); }
   };
 
   template <typename sFloat, typename gFloat>
@@ -1121,6 +1157,8 @@ namespace quda {
       long long wall = 2*dslashConstants.VolumeCB()/dslashConstants.Ls;
       return (x ? 1368ll : 1320ll)*dslashConstants.VolumeCB()*dslashConstants.Ls + 96ll*bulk + 120ll*wall;
     }
+    // the neighbors in the fifth dimension are loaded without links
+    long long bytes() const { return dslashBytes(reconstruct*in->Precision(), 2*spinorSiteBytes()); }
   };
 
 
@@ -1187,14 +1225,23 @@ namespace quda {
     int Nface() { return 6; }
 
     long long flops() const { return (x ? 1158ll : 1146ll) * dslashConstants.VolumeCB(); } // FIXME for multi-GPU
+    // half of the links are the fat links, which are never reconstructed
+    long long bytes() const { return dslashBytes((18 + reconstruct)*in->Precision()/2, 0, 16); }
   };
 
   int gatherCompleted[Nstream];
   int previousDir[Nstream];
   int commsCompleted[Nstream];
   int dslashCompleted[Nstream];
+  double commsStartTime[Nstream];
   int commDimTotal;
 
+#ifdef MULTI_GPU
+  // the message of direction 2*dim+0 is sent backwards, that of 2*dim+1 forwards
+  static const char *commsName[] = { "comms x back", "comms x fwd", "comms y back", "comms y fwd",
+				     "comms z back", "comms z fwd", "comms t back", "comms t fwd" };
+#endif
+
   /**
    * Initialize the arrays used for the dynamic scheduling.
    */
@@ -1307,6 +1354,7 @@ namespace quda {
 	      gatherCompleted[2*i+dir] = 1;
 	      completeSum++;
 	      PROFILE(face->commsStart(2*i+dir), profile, QUDA_PROFILE_COMMS_START);
+	      commsStartTime[2*i+dir] = TimeProfile::Now();
 	    }
 	  }
 	
@@ -1318,6 +1366,7 @@ namespace quda {
 	    if (comms_test) { 
 	      commsCompleted[2*i+dir] = 1;
 	      completeSum++;
+	      profile.Interval(commsName[2*i+dir], commsStartTime[2*i+dir], TimeProfile::Now());
 	    
 	      // Scatter into the end zone
 	      // Both directions use the same stream
@@ -1406,6 +1455,7 @@ namespace quda {
       if (!dslashParam.commDim[i]) continue;
       for (int dir=1; dir>=0; dir--) {
 	PROFILE(face->commsStart(2*i+dir), profile, QUDA_PROFILE_COMMS_START);    
+	commsStartTime[2*i+dir] = TimeProfile::Now();
       }
     }
 
@@ -1428,6 +1478,7 @@ namespace quda {
 	    if (comms_test) { 
 	      commsCompleted[2*i+dir] = 1;
 	      completeSum++;
+	      profile.Interval(commsName[2*i+dir], commsStartTime[2*i+dir], TimeProfile::Now());
 	    
 	      // Scatter into the end zone
 	      // Both directions use the same stream
@@ -1898,7 +1949,7 @@ namespace quda {
       vol << dslashConstants.x[1] << "x";
       vol << dslashConstants.x[2] << "x";
       vol << dslashConstants.x[3];
-      return TuneKey(vol.str(), typeid(*this).name());
+      return TuneKey(vol.str(), typeid(*this).name(), "type=default", QUDA_SOURCE_HASH);
     }
 
     // Need to save the out field if it aliases the in field
@@ -1934,6 +1985,11 @@ namespace quda {
     }
 
     long long flops() const { return 504ll * dslashConstants.VolumeCB(); }
+    long long bytes() const {
+      const int norm = in->Precision() == QUDA_HALF_PRECISION ? 2*sizeof(float) : 0;
+      return in->Bytes() + in->NormBytes() + out->Bytes() + out->NormBytes() +
+	(long long)dslashParam.threads * (72*in->Precision() + norm);
+    }
   };
 
 
@@ -2014,7 +2070,7 @@ namespace quda {
      vol << dslashConstants.x[2] << "x";
      vol << dslashConstants.x[3];    
      aux << "TwistFlavor" << in->TwistFlavor();
-     return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+     return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
    }  
 
   void apply(const cudaStream_t &stream) 
@@ -142,7 +142,7 @@ namespace quda {
       std::stringstream vol, aux;
       vol << arg.order.volumeCB; 
       aux << "stride=" << arg.order.stride;
-      return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+      return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
     }
 
     std::string paramString(const TuneParam &param) const { // Don't bother printing the grid dim.
@@ -3,6 +3,7 @@
 #include <dslash_quda.h>
 
 #include <string.h>    
+#include <stdlib.h>
 
 using namespace quda;
 
@@ -74,6 +75,8 @@ FaceBuffer::FaceBuffer(const int *X, const int nDim, const int Ninternal,
     mh_recv_back[i] = comm_declare_receive_relative(ib_from_back_face[i], i, -1, nbytes[i]);
   }
 
+  for (int i=0; i<QUDA_MAX_DIM; i++) cpuPending[i] = false;
+
   checkCudaError();
 }
 
@@ -85,6 +88,8 @@ FaceBuffer::FaceBuffer(const FaceBuffer &face) {
 
 FaceBuffer::~FaceBuffer()
 {  
+  for (int i=0; i<nDimComms; i++) exchangeCpuSpinorWait(i);
+
   for (int i=0; i<nDimComms; i++) {
     if (commDimPartitioned(i)) {
 #ifndef GPU_DIRECT
@@ -365,7 +370,7 @@ void FaceBuffer::scatter(cudaColorSpinorField &out, int dagger, int dir)
 
 
 // This is just an initial hack for CPU comms - should be creating the message handlers at instantiation
-void FaceBuffer::exchangeCpuSpinor(cpuColorSpinorField &spinor, int oddBit, int dagger)
+void FaceBuffer::exchangeCpuSpinorStart(cpuColorSpinorField &spinor, int oddBit, int dagger)
 {
   // allocate the ghost buffer if not yet allocated
   spinor.allocateGhostBuffer();
@@ -377,46 +382,63 @@ void FaceBuffer::exchangeCpuSpinor(cpuColorSpinorField &spinor, int oddBit, int
 		     QUDA_FORWARDS, (QudaParity)oddBit, dagger);
   }
 
-  MsgHandle *mh_send_fwd[4];
-  MsgHandle *mh_from_back[4];
-  MsgHandle *mh_from_fwd[4];
-  MsgHandle *mh_send_back[4];
-
   for (int i=0; i<nDimComms; i++) {
     if (!commDimPartitioned(i)) continue;
-    mh_send_fwd[i] = comm_declare_send_relative(spinor.fwdGhostFaceSendBuffer[i], i, +1, nbytes[i]);
-    mh_send_back[i] = comm_declare_send_relative(spinor.backGhostFaceSendBuffer[i], i, -1, nbytes[i]);
-    mh_from_fwd[i] = comm_declare_receive_relative(spinor.fwdGhostFaceBuffer[i], i, +1, nbytes[i]);
-    mh_from_back[i] = comm_declare_receive_relative(spinor.backGhostFaceBuffer[i], i, -1, nbytes[i]);
+    if (cpuPending[i]) errorQuda("Host spinor exchange already in progress in dimension %d", i);
+    mh_cpu_send_fwd[i] = comm_declare_send_relative(spinor.fwdGhostFaceSendBuffer[i], i, +1, nbytes[i]);
+    mh_cpu_send_back[i] = comm_declare_send_relative(spinor.backGhostFaceSendBuffer[i], i, -1, nbytes[i]);
+    mh_cpu_recv_fwd[i] = comm_declare_receive_relative(spinor.fwdGhostFaceBuffer[i], i, +1, nbytes[i]);
+    mh_cpu_recv_back[i] = comm_declare_receive_relative(spinor.backGhostFaceBuffer[i], i, -1, nbytes[i]);
   }
 
   for (int i=0; i<nDimComms; i++) {
     if (commDimPartitioned(i)) {
-      comm_start(mh_from_back[i]);
-      comm_start(mh_from_fwd[i]);
-      comm_start(mh_send_fwd[i]);
-      comm_start(mh_send_back[i]);
+      comm_start(mh_cpu_recv_back[i]);
+      comm_start(mh_cpu_recv_fwd[i]);
+      comm_start(mh_cpu_send_fwd[i]);
+      comm_start(mh_cpu_send_back[i]);
+      cpuPending[i] = true;
     } else {
       memcpy(spinor.backGhostFaceBuffer[i], spinor.fwdGhostFaceSendBuffer[i], nbytes[i]);
       memcpy(spinor.fwdGhostFaceBuffer[i], spinor.backGhostFaceSendBuffer[i], nbytes[i]);
     }
   }
+}
 
-  for (int i=0; i<nDimComms; i++) {
-    if (!commDimPartitioned(i)) continue;
-    comm_wait(mh_send_fwd[i]);
-    comm_wait(mh_send_back[i]);
-    comm_wait(mh_from_back[i]);
-    comm_wait(mh_from_fwd[i]);
-  }
 
-  for (int i=0; i<nDimComms; i++) {
-    if (!commDimPartitioned(i)) continue;
-    comm_free(mh_send_fwd[i]);
-    comm_free(mh_send_back[i]);
-    comm_free(mh_from_back[i]);
-    comm_free(mh_from_fwd[i]);
+int FaceBuffer::exchangeCpuSpinorQuery(int dim)
+{
+  if (!cpuPending[dim]) return 1;
+  // the sends are tested too, so that the send buffers may be reused once this returns
+  if (comm_query(mh_cpu_recv_back[dim]) && comm_query(mh_cpu_recv_fwd[dim]) &&
+      comm_query(mh_cpu_send_fwd[dim]) && comm_query(mh_cpu_send_back[dim])) {
+    exchangeCpuSpinorWait(dim);
+    return 1;
   }
+  return 0;
+}
+
+
+void FaceBuffer::exchangeCpuSpinorWait(int dim)
+{
+  if (!cpuPending[dim]) return;
+  comm_wait(mh_cpu_send_fwd[dim]);
+  comm_wait(mh_cpu_send_back[dim]);
+  comm_wait(mh_cpu_recv_back[dim]);
+  comm_wait(mh_cpu_recv_fwd[dim]);
+
+  comm_free(mh_cpu_send_fwd[dim]);
+  comm_free(mh_cpu_send_back[dim]);
+  comm_free(mh_cpu_recv_back[dim]);
+  comm_free(mh_cpu_recv_fwd[dim]);
+  cpuPending[dim] = false;
+}
+
+
+void FaceBuffer::exchangeCpuSpinor(cpuColorSpinorField &spinor, int oddBit, int dagger)
+{
+  exchangeCpuSpinorStart(spinor, oddBit, dagger);
+  for (int i=0; i<nDimComms; i++) exchangeCpuSpinorWait(i);
 }
 
 
@@ -488,10 +510,98 @@ void FaceBuffer::exchangeLink(void** ghost_link, void** link_sendbuf, QudaFieldL
 
 void reduceMaxDouble(double &max) { comm_allreduce_max(&max); }
 
-void reduceDouble(double &sum) { if (globalReduce) comm_allreduce(&sum); }
+static int reproducible = -1;
+
+bool reduceReproducible()
+{
+  if (reproducible < 0) {
+    char *env = getenv("QUDA_REPRODUCIBLE_REDUCE");
+    reproducible = (env && strcmp(env, "0") != 0) ? 1 : 0;
+  }
+  return reproducible;
+}
+
+void reduceReproArray(ReproSum *sum, double *result, const int len)
+{
+  if (globalReduce) {
+    std::vector<double> buf(len*ReproSum::packSize);
+    for (int i=0; i<len; i++) sum[i].pack(&buf[i*ReproSum::packSize]);
+    // the packed limbs are integers, so that their sum is exact
+    comm_allreduce_array(&buf[0], buf.size());
+    for (int i=0; i<len; i++) sum[i].unpack(&buf[i*ReproSum::packSize]);
+  }
+  for (int i=0; i<len; i++) result[i] = sum[i].value();
+}
 
 void reduceDoubleArray(double *sum, const int len) 
-{ if (globalReduce) comm_allreduce_array(sum, len); }
+{
+  if (!globalReduce) return;
+  if (reduceReproducible()) {
+    std::vector<ReproSum> repro(len);
+    for (int i=0; i<len; i++) repro[i].add(sum[i]);
+    reduceReproArray(&repro[0], sum, len);
+  } else {
+    comm_allreduce_array(sum, len);
+  }
+}
+
+void reduceDouble(double &sum) 
+{
+  if (!globalReduce) return;
+  if (reduceReproducible()) reduceDoubleArray(&sum, 1);
+  else comm_allreduce(&sum);
+}
+
+/**
+   Start the global sum of an array of partial sums, in place.  The
+   array must not be accessed until reduceDoubleArrayWait() returns.
+   MPI progresses the sum while the caller polls for halo messages,
+   e.g., in the dslash.  Reproducible sums are done immediately.
+ */
+MsgHandle *reduceDoubleArrayAsync(double *sum, const int len)
+{
+  if (globalReduce && reduceReproducible()) {
+    reduceDoubleArray(sum, len);
+    return NULL;
+  }
+  return globalReduce ? comm_allreduce_async(sum, len) : NULL;
+}
+
+void reduceDoubleArrayWait(MsgHandle *mh) { if (mh) comm_allreduce_wait(mh); }
+
+ReduceBatch::ReduceBatch() : reduceState(globalReduce)
+{
+  // reproducible reductions must be summed from the site sums
+  if (!reduceReproducible()) globalReduce = false;
+}
+
+ReduceBatch::~ReduceBatch()
+{
+  if (sums.size() > 0) warningQuda("ReduceBatch destroyed with %d unflushed reductions", (int)sums.size());
+  globalReduce = reduceState;
+}
+
+void ReduceBatch::flush()
+{
+  int n = 0;
+  for (unsigned int i=0; i<sums.size(); i++) n += sums[i].second;
+  if (n == 0 || reduceReproducible()) {
+    sums.clear();
+    return;
+  }
+
+  std::vector<double> buf(n);
+  for (unsigned int i=0, j=0; i<sums.size(); j+=sums[i].second, i++)
+    for (int s=0; s<sums[i].second; s++) buf[j+s] = sums[i].first[s];
+
+  globalReduce = reduceState;
+  reduceDoubleArray(&buf[0], n);
+  globalReduce = false;
+
+  for (unsigned int i=0, j=0; i<sums.size(); j+=sums[i].second, i++)
+    for (int s=0; s<sums[i].second; s++) sums[i].first[s] = buf[j+s];
+  sums.clear();
+}
 
 int commDim(int dir) { return comm_dim(dir); }
 
@@ -7,6 +7,7 @@
 #include <comm_quda.h>
 #include <fat_force_quda.h>
 #include <face_quda.h>
+#include <halo_exchange.h>
 
 using namespace quda;
 
@@ -312,393 +313,36 @@ void exchange_cpu_sitelink(int* X,
 }
 
 
-#define MEMCOPY_GAUGE_FIELDS_GRID_TO_BUF(ghost_buf, dst_idx, sitelink, src_idx, num, dir) \
-  if(src_oddness){							\
-    src_idx += Vh_ex;							\
-  }									\
-  if(dst_oddness){							\
-    dst_idx += R[dir]*slice_3d[dir]/2;					\
-  }									\
-  if(cpu_order == QUDA_QDP_GAUGE_ORDER){				\
-    for(int linkdir=0; linkdir < 4; linkdir++){				\
-      char* src = (char*) sitelink[linkdir] + (src_idx)*gaugebytes;	\
-      char* dst = ((char*)ghost_buf[dir])+ linkdir*R[dir]*slice_3d[dir]*gaugebytes + (dst_idx)*gaugebytes; \
-      memcpy(dst, src, gaugebytes*(num));				\
-    }									\
-  }else{	/*QUDA_MILC_GAUGE_ORDER*/				\
-    char* src = ((char*)sitelink)+ 4*(src_idx)*gaugebytes;		\
-    char* dst = ((char*)ghost_buf[dir]) + 4*(dst_idx)*gaugebytes;	\
-    memcpy(dst, src, 4*gaugebytes*(num));				\
-  }									\
-
-#define MEMCOPY_GAUGE_FIELDS_BUF_TO_GRID(sitelink, dst_idx, ghost_buf, src_idx, num, dir) \
-  if(oddness){								\
-    if(commDimPartitioned(dir)){					\
-      src_idx += R[dir]*slice_3d[dir]/2;				\
-    }else{								\
-      src_idx += Vh_ex;							\
-    }									\
-    dst_idx += Vh_ex;							\
-  }									\
-  if(cpu_order == QUDA_QDP_GAUGE_ORDER){				\
-    for(int linkdir=0; linkdir < 4; linkdir++){				\
-      char* src;							\
-      if(commDimPartitioned(dir)){					\
-	src = ((char*)ghost_buf[dir])+ linkdir*R[dir]*slice_3d[dir]*gaugebytes + (src_idx)*gaugebytes; \
-      }else{								\
-	src = ((char*)sitelink[linkdir])+ (src_idx)*gaugebytes;		\
-      }									\
-      char* dst = (char*) sitelink[linkdir] + (dst_idx)*gaugebytes;	\
-      memcpy(dst, src, gaugebytes*(num));				\
-    }									\
-  }else{/*QUDA_MILC_GAUGE_FIELD*/					\
-    char* src;								\
-    if(commDimPartitioned(dir)){					\
-      src=((char*)ghost_buf[dir]) + 4*(src_idx)*gaugebytes;		\
-    }else{								\
-      src = ((char*)sitelink)+ 4*(src_idx)*gaugebytes;			\
-    }									\
-    char* dst = ((char*)sitelink) + 4*(dst_idx)*gaugebytes;		\
-    memcpy(dst, src, 4*gaugebytes*(num));				\
-  }
-
-#define MEMCOPY_GAUGE_FIELDS_BUF_TO_GRID_T(sitelink, ghost_buf, dst_face, src_face, dir) \
-  /*even*/								\
-  int even_dst_idx = (dst_face*E3E2E1)/2;				\
-  int even_src_idx;							\
-  if(commDimPartitioned(dir)){						\
-    even_src_idx = 0;							\
-  }else{								\
-    even_src_idx = (src_face*E3E2E1)/2;					\
-  }									\
-  /*odd*/								\
-  int odd_dst_idx = even_dst_idx+Vh_ex;					\
-  int odd_src_idx;							\
-  if(commDimPartitioned(dir)){						\
-    odd_src_idx = R[dir]*slice_3d[dir]/2;				\
-  }else{								\
-    odd_src_idx = even_src_idx+Vh_ex;					\
-  }									\
-  if(cpu_order == QUDA_QDP_GAUGE_ORDER){				\
-    for(int linkdir=0; linkdir < 4; linkdir ++){			\
-      char* dst = (char*)sitelink[linkdir];				\
-      char* src;							\
-      if(commDimPartitioned(dir)){					\
-	src = ((char*)ghost_buf[dir]) + linkdir*R[dir]*slice_3d[dir]*gaugebytes; \
-      }else{								\
-	src = (char*)sitelink[linkdir];					\
-      }									\
-      memcpy(dst + even_dst_idx * gaugebytes, src + even_src_idx*gaugebytes, R[dir]*slice_3d[dir]*gaugebytes/2); \
-      memcpy(dst + odd_dst_idx * gaugebytes, src + odd_src_idx*gaugebytes, R[dir]*slice_3d[dir]*gaugebytes/2); \
-    }									\
-  }else{/*QUDA_MILC_GAUGE_ORDER*/					\
-    char* dst = (char*)sitelink;					\
-    char* src;								\
-    if(commDimPartitioned(dir)){					\
-      src = (char*)ghost_buf[dir];					\
-    }else{								\
-      src = (char*)sitelink;						\
-    }									\
-    memcpy(dst+4*even_dst_idx*gaugebytes, src+4*even_src_idx*gaugebytes, 4*R[dir]*slice_3d[dir]*gaugebytes/2); \
-    memcpy(dst+4*odd_dst_idx*gaugebytes, src+4*odd_src_idx*gaugebytes, 4*R[dir]*slice_3d[dir]*gaugebytes/2); \
-  }    
-
 /* This function exchange the sitelink and store them in the correspoinding portion of 
  * the extended sitelink memory region
  * @sitelink: this is stored according to dimension size  (X4+R4) * (X1+R1) * (X2+R2) * (X3+R3)
+ * @optflag: if set, the dimensions that are not partitioned are left untouched
  */
 
 void exchange_cpu_sitelink_ex(int* X, int *R, void** sitelink, QudaGaugeFieldOrder cpu_order,
 			      QudaPrecision gPrecision, int optflag)
 {
-  int E1,E2,E3,E4;  
-  E1 = X[0]+2*R[0]; E2 = X[1]+2*R[1]; E3 = X[2]+2*R[2]; E4 = X[3]+2*R[3]; 
-  int E3E2E1=E3*E2*E1;
-  int E2E1=E2*E1;
-  int E4E3E2=E4*E3*E2;
-  int E3E2=E3*E2;
-  int E4E3E1=E4*E3*E1;
-  int E3E1=E3*E1;
-  int E4E2E1=E4*E2*E1;
-  int Vh_ex = E4*E3*E2*E1/2;
-  
-  //...............x.........y.....z......t
-  int starta[] = {R[3],      R[3],       R[3],     0};
-  int enda[]   = {X[3]+R[3], X[3]+R[3],  X[3]+R[3], X[2]+2*R[2]};
-  
-  int startb[] = {R[2],     R[2],       0,     0};
-  int endb[]   = {X[2]+R[2], X[2]+R[2], X[1]+2*R[1], X[1]+2*R[1]};
-  
-  int startc[] = {R[1],     0,       0,     0};
-  int endc[]   = {X[1]+R[1], X[0]+2*R[0],  X[0]+2*R[0],  X[0]+2*R[0]};
-  
-  int f_main[4][4] = {
-    {E3E2E1,    E2E1, E1,     1},
-    {E3E2E1,    E2E1,    1,  E1},
-    {E3E2E1,  E1,    1,    E2E1},
-    {E2E1,  E1,    1,   E3E2E1}
-  };  
-  
-  int f_bound[4][4]={
-    {E3E2, E2, 1, E4E3E2},
-    {E3E1, E1, 1, E4E3E1}, 
-    {E2E1, E1, 1, E4E2E1},
-    {E2E1, E1, 1, E3E2E1}
-  };
-  
-  int slice_3d[] = { E4E3E2, E4E3E1, E4E2E1, E3E2E1};  
-  int len[4];
-  for(int i=0;i < 4;i++){
-    len[i] = slice_3d[i] * R[i] * 4*gaugeSiteSize*gPrecision; //2 slices, 4 directions' links
+  HaloParam param;
+  for (int d=0; d<4; d++) {
+    param.X[d] = X[d];
+    param.R[d] = R[d];
   }
 
-  void* ghost_sitelink_fwd_sendbuf[4];
-  void* ghost_sitelink_back_sendbuf[4];
-  void* ghost_sitelink_fwd[4];
-  void* ghost_sitelink_back[4];  
-
-  for(int i=0; i<4; i++) {
-    if(!commDimPartitioned(i)) continue;
-    ghost_sitelink_fwd_sendbuf[i] = safe_malloc(len[i]);
-    ghost_sitelink_back_sendbuf[i] = safe_malloc(len[i]);
-    ghost_sitelink_fwd[i] = safe_malloc(len[i]);
-    ghost_sitelink_back[i] = safe_malloc(len[i]);
+  void *field[4];
+  if (cpu_order == QUDA_QDP_GAUGE_ORDER) {
+    param.siteBytes = gaugeSiteSize*gPrecision;
+    param.nArray = 4;
+    for (int dir=0; dir<4; dir++) field[dir] = sitelink[dir];
+  } else { // QUDA_MILC_GAUGE_ORDER, the links of a site are stored together
+    param.siteBytes = 4*gaugeSiteSize*gPrecision;
+    param.nArray = 1;
+    field[0] = (void*)sitelink;
   }
 
-  int gaugebytes = gaugeSiteSize*gPrecision;
-  int a, b, c,d;
-  for(int dir =0;dir < 4;dir++){
-    if( (!commDimPartitioned(dir)) && optflag) continue;
-    if(commDimPartitioned(dir)){
-      //fill the sendbuf here
-      //back
-      for(d=R[dir]; d < 2*R[dir]; d++)
-	for(a=starta[dir];a < enda[dir]; a++)
-	  for(b=startb[dir]; b < endb[dir]; b++)
-
-	    if(f_main[dir][2] != 1 || f_bound[dir][2] !=1){
-	      for (c=startc[dir]; c < endc[dir]; c++){
-		int oddness = (a+b+c+d)%2;
-		int src_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + d*f_main[dir][3])>> 1;
-		int dst_idx = ( a*f_bound[dir][0] + b*f_bound[dir][1]+ c*f_bound[dir][2] + (d-R[dir])*f_bound[dir][3])>> 1;	      
-		
-		int src_oddness = oddness;
-		int dst_oddness = oddness;
-		if((X[dir] % 2 ==1) && (commDim(dir) > 1)){ //switch even/odd position
-		  dst_oddness = 1-oddness;
-		}
-
-		MEMCOPY_GAUGE_FIELDS_GRID_TO_BUF(ghost_sitelink_back_sendbuf, dst_idx, sitelink, src_idx, 1, dir);		
-
-	      }//c
-	    }else{
-	      for(int loop=0; loop < 2; loop++){
-		c=startc[dir]+loop;
-		if(c < endc[dir]){
-		  int oddness = (a+b+c+d)%2;
-		  int src_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + d*f_main[dir][3])>> 1;
-		  int dst_idx = ( a*f_bound[dir][0] + b*f_bound[dir][1]+ c*f_bound[dir][2] + (d-R[dir])*f_bound[dir][3])>> 1;	      
-		  
-		  int src_oddness = oddness;
-		  int dst_oddness = oddness;
-		  if((X[dir] % 2 ==1) && (commDim(dir) > 1)){ //switch even/odd position
-		    dst_oddness = 1-oddness;
-		  }
-		  MEMCOPY_GAUGE_FIELDS_GRID_TO_BUF(ghost_sitelink_back_sendbuf, dst_idx, sitelink, src_idx, (endc[dir]-c+1)/2, dir);	
-
-		}//if c
-	      }//for loop
-	    }//if
-      
-      
-      //fwd
-      for(d=X[dir]; d < X[dir]+R[dir]; d++) {
-	for(a=starta[dir];a < enda[dir]; a++) {
-	  for(b=startb[dir]; b < endb[dir]; b++) {
-	    
-	    if(f_main[dir][2] != 1 || f_bound[dir][2] !=1){
-	      for (c=startc[dir]; c < endc[dir]; c++){
-		int oddness = (a+b+c+d)%2;
-		int src_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + d*f_main[dir][3])>> 1;
-		int dst_idx = ( a*f_bound[dir][0] + b*f_bound[dir][1]+ c*f_bound[dir][2] + (d-X[dir])*f_bound[dir][3])>> 1;
-		
-		int src_oddness = oddness;
-		int dst_oddness = oddness;
-		if((X[dir] % 2 ==1) && (commDim(dir) > 1)){ //switch even/odd position
-		  dst_oddness = 1-oddness;
-		}
-		
-		MEMCOPY_GAUGE_FIELDS_GRID_TO_BUF(ghost_sitelink_fwd_sendbuf, dst_idx, sitelink, src_idx, 1,dir);
-	      }//c
-	    }else{
-	      for(int loop=0; loop < 2; loop++){
-		c=startc[dir]+loop;
-		if(c < endc[dir]){
-		  int oddness = (a+b+c+d)%2;
-		  int src_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + d*f_main[dir][3])>> 1;
-		  int dst_idx = ( a*f_bound[dir][0] + b*f_bound[dir][1]+ c*f_bound[dir][2] + (d-X[dir])*f_bound[dir][3])>> 1;
-		  
-		  int src_oddness = oddness;
-		  int dst_oddness = oddness;
-		  if((X[dir] % 2 ==1) && (commDim(dir) > 1)){ //switch even/odd position
-		    dst_oddness = 1-oddness;
-		  }
-		  MEMCOPY_GAUGE_FIELDS_GRID_TO_BUF(ghost_sitelink_fwd_sendbuf, dst_idx, sitelink, src_idx, (endc[dir]-c+1)/2,dir);
-		}
-	      }//for loop
-	    }//if
-
-	  }
-	}
-      }
-      
-      MsgHandle *mh_recv_back;
-      MsgHandle *mh_recv_fwd;
-      MsgHandle *mh_send_fwd;
-      MsgHandle *mh_send_back;
-  
-      mh_recv_back = comm_declare_receive_relative(ghost_sitelink_back[dir], dir, -1, len[dir]);
-      mh_recv_fwd = comm_declare_receive_relative(ghost_sitelink_fwd[dir], dir, +1, len[dir]);
-      mh_send_fwd = comm_declare_send_relative(ghost_sitelink_fwd_sendbuf[dir], dir, +1, len[dir]);
-      mh_send_back = comm_declare_send_relative(ghost_sitelink_back_sendbuf[dir], dir, -1, len[dir]);
-
-      comm_start(mh_recv_back);
-      comm_start(mh_recv_fwd);
-      comm_start(mh_send_fwd);
-      comm_start(mh_send_back);
-
-      comm_wait(mh_send_fwd);
-      comm_wait(mh_send_back);
-      comm_wait(mh_recv_back);
-      comm_wait(mh_recv_fwd);
-
-      comm_free(mh_send_fwd);
-      comm_free(mh_send_back);
-      comm_free(mh_recv_back);
-      comm_free(mh_recv_fwd);
-      
-    }//if
-
-    //use the messages to fill the sitelink data
-    //back
-    if (dir < 3 ) {
-
-      for(d=0; d < R[dir]; d++) {
-	for(a=starta[dir];a < enda[dir]; a++) {
-	  for(b=startb[dir]; b < endb[dir]; b++) {
-
-	    if(f_main[dir][2] != 1 || f_bound[dir][2] !=1){
-	      for (c=startc[dir]; c < endc[dir]; c++){
-		int oddness = (a+b+c+d)%2;
-		int dst_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + d*f_main[dir][3])>> 1;
-		int src_idx;
-		if(commDimPartitioned(dir)){
-		  src_idx = ( a*f_bound[dir][0] + b*f_bound[dir][1]+ c*f_bound[dir][2] + d*f_bound[dir][3])>> 1;
-		}else{
-		  src_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + (d+X[dir])*f_main[dir][3])>> 1;
-		}
-
-		MEMCOPY_GAUGE_FIELDS_BUF_TO_GRID(sitelink, dst_idx, ghost_sitelink_back, src_idx, 1, dir);
-		
-	      }//c    
-	    }else{
-	      //optimized copy
-	      //first half:   startc[dir] -> end[dir] with step=2
-
-	      for(int loop =0;loop <2;loop++){
-		int c=startc[dir]+loop;
-		if(c < endc[dir]){
-		  int oddness = (a+b+c+d)%2;
-		  int dst_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + d*f_main[dir][3])>> 1;
-		  int src_idx;
-		  if(commDimPartitioned(dir)){
-		    src_idx = ( a*f_bound[dir][0] + b*f_bound[dir][1]+ c*f_bound[dir][2] + d*f_bound[dir][3])>> 1;
-		  }else{
-		    src_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + (d+X[dir])*f_main[dir][3])>> 1;
-		  }
-
-		  MEMCOPY_GAUGE_FIELDS_BUF_TO_GRID(sitelink, dst_idx, ghost_sitelink_back, src_idx, (endc[dir]-c+1)/2, dir);
-
-		}//if c  		
-	      }//for loop	      
-	    }//if
-
-	  }
-	}
-      }
-
-    }else{
-      //when dir == 3 (T direction), the data layout format in sitelink and the message is the same, we can do large copys  
-
-      MEMCOPY_GAUGE_FIELDS_BUF_TO_GRID_T(sitelink, ghost_sitelink_back, 0, X[3], dir)
-    }//if
-    
-    //fwd
-    if( dir < 3 ){
-
-      for(d=X[dir]+R[dir]; d < X[dir]+2*R[dir]; d++) {
-	for(a=starta[dir];a < enda[dir]; a++) {
-	  for(b=startb[dir]; b < endb[dir]; b++) {
-
-	    if(f_main[dir][2] != 1 || f_bound[dir][2] != 1){
-	      for (c=startc[dir]; c < endc[dir]; c++){
-		int oddness = (a+b+c+d)%2;
-		int dst_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + d*f_main[dir][3])>> 1;
-		int src_idx;
-		if(commDimPartitioned(dir)){
-		  src_idx = ( a*f_bound[dir][0] + b*f_bound[dir][1]+ c*f_bound[dir][2] + (d-X[dir]-R[dir])*f_bound[dir][3])>> 1;
-		}else{
-		  src_idx =  ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + (d-X[dir])*f_main[dir][3])>> 1;
-		}
-
-		MEMCOPY_GAUGE_FIELDS_BUF_TO_GRID(sitelink, dst_idx, ghost_sitelink_fwd, src_idx, 1, dir);
-
-	      }//c
-	    }else{
-	      for(int loop =0; loop < 2; loop++){
-		//for (c=startc[dir]; c < endc[dir]; c++){
-		c=startc[dir] + loop;
-		if(c < endc[dir]){
-		  int oddness = (a+b+c+d)%2;
-		  int dst_idx = ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + d*f_main[dir][3])>> 1;
-		  int src_idx;
-		  if(commDimPartitioned(dir)){
-		    src_idx = ( a*f_bound[dir][0] + b*f_bound[dir][1]+ c*f_bound[dir][2] + (d-X[dir]-R[dir])*f_bound[dir][3])>> 1;
-		  }else{
-		    src_idx =  ( a*f_main[dir][0] + b*f_main[dir][1]+ c*f_main[dir][2] + (d-X[dir])*f_main[dir][3])>> 1;
-		  }
-		  MEMCOPY_GAUGE_FIELDS_BUF_TO_GRID(sitelink, dst_idx, ghost_sitelink_fwd, src_idx, (endc[dir]-c+1)/2, dir);
-		}//if		
-	      }//for loop
-	    }//if 
-
-	  }
-	}
-      }
-      
-
-    } else {
-
-      //when dir == 3 (T direction), the data layout format in sitelink and the message is the same, we can do large copys
-      MEMCOPY_GAUGE_FIELDS_BUF_TO_GRID_T(sitelink, ghost_sitelink_fwd, (X[3]+R[3]), 2, dir) // TESTME 2
-
-    }//if    
-
-  }//dir for loop
-    
-  
-  for(int dir=0;dir < 4;dir++){
-    if(!commDimPartitioned(dir)) continue;
-    host_free(ghost_sitelink_fwd_sendbuf[dir]);
-    host_free(ghost_sitelink_back_sendbuf[dir]);    
-    host_free(ghost_sitelink_fwd[dir]);
-    host_free(ghost_sitelink_back[dir]);    
-  }
-    
+  HaloExchange::Get(param).exchange(field, optflag);
 }
 
 
-
 template<typename Float>
 void
 do_exchange_cpu_staple(Float* staple, Float** ghost_staple, Float** staple_fwd_sendbuf, Float** staple_back_sendbuf, int* X)
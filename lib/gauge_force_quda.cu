@@ -136,6 +136,7 @@ namespace quda {
     const int *length;
     const void *path_coeff;
     const int num_paths;
+    const int path_links; // total length of the paths
     const kernel_param_t &kparam;
 
     unsigned int sharedBytesPerThread() const { return 0; }
@@ -148,9 +149,9 @@ namespace quda {
   public:
     GaugeForceCuda(cudaGaugeField &mom, const int dir, const double &eb3, const cudaGaugeField &link,
 		   const int *input_path, const int *length, const void *path_coeff, 
-		   const int num_paths, const kernel_param_t &kparam) :
+		   const int num_paths, const int path_links, const kernel_param_t &kparam) :
       mom(mom), dir(dir), eb3(eb3), link(link), input_path(input_path), length(length), 
-      path_coeff(path_coeff), num_paths(num_paths), kparam(kparam) { 
+      path_coeff(path_coeff), num_paths(num_paths), path_links(path_links), kparam(kparam) { 
 
       if(link.Precision() == QUDA_DOUBLE_PRECISION){
 	cudaBindTexture(0, siteLink0TexDouble, link.Even_p(), link.Bytes()/2);
@@ -244,7 +245,12 @@ namespace quda {
     void preTune() { mom.backup(); }
     void postTune() { mom.restore(); } 
   
-    long long flops() const { return 0; } // FIXME: add flops counter
+    // per site, the product of the links along each path is added to the staple with its coefficient, and
+    // the product of the link and the staple updates the momentum (10 reals)
+    long long flops() const { return 2ll*kparam.threads*((path_links - num_paths + 1)*198ll + num_paths*36ll); }
+    long long bytes() const {
+      return 2ll*kparam.threads*((path_links + 1)*link.Reconstruct()*link.Precision() + 2*10*mom.Precision());
+    }
   
     TuneKey tuneKey() const {
       std::stringstream vol, aux;
@@ -255,7 +261,7 @@ namespace quda {
       aux << "threads=" << link.Volume() << ",prec=" << link.Precision();
       aux << "stride=" << link.Stride() << ",recon=" << link.Reconstruct();
       aux << "dir=" << dir << "num_paths=" << num_paths;
-      return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+      return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
     }  
   
   };
@@ -303,8 +309,11 @@ namespace quda {
 #endif
     kparam.threads = volume/2;
 
+    int path_links = 0;
+    for(int i=0; i < num_paths; i++) path_links += length[i];
+
     GaugeForceCuda gaugeForce(cudaMom, dir, eb3, cudaSiteLink, input_path_d, 
-			      length_d, path_coeff_d, num_paths, kparam);
+			      length_d, path_coeff_d, num_paths, path_links, kparam);
     gaugeForce.apply(0);
     checkCudaError();
     
@@ -129,7 +129,7 @@ namespace quda {
       vol << X[3] << "x";
       aux << "threads=" << 2*arg.in.volumeCB << ",prec=" << sizeof(Complex)/2;
       aux << "stride=" << arg.in.stride;
-      return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+      return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
     }
   };
   
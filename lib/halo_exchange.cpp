@@ -0,0 +1,311 @@
+#include <string.h>
+#include <vector>
+
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <face_quda.h>
+#include <halo_exchange.h>
+#include <color_spinor_field.h>
+
+namespace quda {
+
+  static std::vector<HaloExchange*> exchangeCache;
+  static std::vector<SpinorGhostExchange*> ghostExchangeCache;
+
+  HaloExchange::HaloExchange(const HaloParam &param) : param(param), volumeEx(1)
+  {
+    if (param.siteBytes == 0 || param.nArray < 1)
+      errorQuda("Invalid site size %lu or number of arrays %d", (unsigned long)param.siteBytes, param.nArray);
+    if (param.parity < -1 || param.parity > 1) errorQuda("Invalid parity %d", param.parity);
+
+    for (int d=0; d<4; d++) {
+      if (param.R[d] < 0 || param.R[d] > param.X[d])
+	errorQuda("Halo depth %d is not within the local length %d of dimension %d", param.R[d], param.X[d], d);
+      // a single parity is only preserved by shifts of even length
+      if (param.parity >= 0 && param.R[d] && param.X[d] % 2)
+	errorQuda("Dimension %d of odd length %d cannot be exchanged for a single parity", d, param.X[d]);
+      E[d] = param.X[d] + 2*param.R[d];
+      volumeEx *= E[d];
+    }
+    if (E[0] % 2) errorQuda("Extended X dimension %d must be even", E[0]);
+
+    for (int d=0; d<4; d++) {
+      pending[d] = false;
+      bytes[d] = param.R[d] ? transfer(0, d, param.R[d], 0, HALO_COUNT) : 0;
+      for (int dir=0; dir<2; dir++) {
+	sendBuf[d][dir] = recvBuf[d][dir] = 0;
+	mhSend[d][dir] = mhRecv[d][dir] = 0;
+      }
+      if (!bytes[d]) continue;
+
+      // the send buffers also stage the periodic copy of dimensions that are not partitioned
+      for (int dir=0; dir<2; dir++) sendBuf[d][dir] = safe_malloc(bytes[d]);
+      if (!commDimPartitioned(d)) continue;
+
+      for (int dir=0; dir<2; dir++) recvBuf[d][dir] = safe_malloc(bytes[d]);
+      mhRecv[d][0] = comm_declare_receive_relative(recvBuf[d][0], d, -1, bytes[d]);
+      mhRecv[d][1] = comm_declare_receive_relative(recvBuf[d][1], d, +1, bytes[d]);
+      mhSend[d][0] = comm_declare_send_relative(sendBuf[d][0], d, -1, bytes[d]);
+      mhSend[d][1] = comm_declare_send_relative(sendBuf[d][1], d, +1, bytes[d]);
+    }
+  }
+
+  HaloExchange::~HaloExchange()
+  {
+    for (int d=0; d<4; d++) {
+      for (int dir=0; dir<2; dir++) {
+	if (pending[d]) {
+	  comm_wait(mhSend[d][dir]);
+	  comm_wait(mhRecv[d][dir]);
+	}
+	if (mhSend[d][dir]) comm_free(mhSend[d][dir]);
+	if (mhRecv[d][dir]) comm_free(mhRecv[d][dir]);
+	if (sendBuf[d][dir]) host_free(sendBuf[d][dir]);
+	if (recvBuf[d][dir]) host_free(recvBuf[d][dir]);
+      }
+    }
+  }
+
+  size_t HaloExchange::transfer(void **field, int dim, int begin, char *buf, TransferType type) const
+  {
+    // dimensions exchanged earlier contribute their halos when corners are filled
+    int lo[4], hi[4];
+    for (int d=0; d<4; d++) {
+      if (d == dim) {
+	lo[d] = begin;
+	hi[d] = begin + param.R[d];
+      } else if (d < dim && param.corners) {
+	lo[d] = 0;
+	hi[d] = E[d];
+      } else {
+	lo[d] = param.R[d];
+	hi[d] = param.R[d] + param.X[d];
+      }
+    }
+
+    // along x, the sites of each parity in a row are adjacent in memory
+    size_t offset = 0;
+    for (int t=lo[3]; t<hi[3]; t++) {
+      for (int z=lo[2]; z<hi[2]; z++) {
+	for (int y=lo[1]; y<hi[1]; y++) {
+	  for (int c=0; c<2; c++) {
+	    const int x = lo[0] + c;
+	    if (x >= hi[0]) continue;
+	    const int parity = (x + y + z + t) & 1;
+	    if (param.parity >= 0 && parity != param.parity) continue;
+
+	    const size_t lex = ((((size_t)t*E[2] + z)*E[1] + y)*E[0] + x);
+	    const size_t site = lex/2 + (param.parity < 0 ? parity*(volumeEx/2) : 0);
+	    const size_t run = ((hi[0] - x + 1)/2) * param.siteBytes;
+
+	    for (int k=0; k<param.nArray; k++) {
+	      if (type != HALO_COUNT) {
+		char *f = static_cast<char*>(field[k]) + site*param.siteBytes;
+		if (type == HALO_PACK) memcpy(buf + offset, f, run);
+		else memcpy(f, buf + offset, run);
+	      }
+	      offset += run;
+	    }
+	  }
+	}
+      }
+    }
+
+    return offset;
+  }
+
+  void HaloExchange::start(void **field, int dim)
+  {
+    if (!bytes[dim]) return;
+    if (pending[dim]) errorQuda("Exchange in dimension %d is already in progress", dim);
+
+    const int X = param.X[dim], R = param.R[dim];
+    char *sendBack = static_cast<char*>(sendBuf[dim][0]);
+    char *sendFwd = static_cast<char*>(sendBuf[dim][1]);
+
+    transfer(field, dim, R, sendBack, HALO_PACK);
+    transfer(field, dim, X, sendFwd, HALO_PACK);
+
+    if (!commDimPartitioned(dim)) {
+      transfer(field, dim, 0, sendFwd, HALO_UNPACK);
+      transfer(field, dim, X + R, sendBack, HALO_UNPACK);
+      return;
+    }
+
+    // keep this order: if both neighbors are the same node, the
+    // receives are matched with the sends in the order they are posted
+    comm_start(mhRecv[dim][0]);
+    comm_start(mhRecv[dim][1]);
+    comm_start(mhSend[dim][1]);
+    comm_start(mhSend[dim][0]);
+    pending[dim] = true;
+  }
+
+  int HaloExchange::query(int dim)
+  {
+    if (!pending[dim]) return 1;
+    return comm_query(mhRecv[dim][0]) && comm_query(mhRecv[dim][1]);
+  }
+
+  void HaloExchange::wait(void **field, int dim)
+  {
+    if (!pending[dim]) return;
+
+    comm_wait(mhSend[dim][1]);
+    comm_wait(mhSend[dim][0]);
+    comm_wait(mhRecv[dim][0]);
+    comm_wait(mhRecv[dim][1]);
+    pending[dim] = false;
+
+    transfer(field, dim, 0, static_cast<char*>(recvBuf[dim][0]), HALO_UNPACK);
+    transfer(field, dim, param.X[dim] + param.R[dim], static_cast<char*>(recvBuf[dim][1]), HALO_UNPACK);
+  }
+
+  void HaloExchange::exchange(void **field, bool partitionedOnly)
+  {
+    bool active[4];
+    for (int d=0; d<4; d++) active[d] = !partitionedOnly || commDimPartitioned(d);
+
+    if (param.corners) {
+      for (int d=0; d<4; d++) {
+	if (!active[d]) continue;
+	start(field, d);
+	wait(field, d);
+      }
+    } else {
+      for (int d=0; d<4; d++) if (active[d]) start(field, d);
+      for (int d=0; d<4; d++) if (active[d]) wait(field, d);
+    }
+  }
+
+  HaloExchange& HaloExchange::Get(const HaloParam &param)
+  {
+    for (unsigned int i=0; i<exchangeCache.size(); i++) {
+      if (exchangeCache[i]->param == param) return *exchangeCache[i];
+    }
+
+    HaloExchange *h = new HaloExchange(param);
+    exchangeCache.push_back(h);
+    return *h;
+  }
+
+  void HaloExchange::freeCache()
+  {
+    for (unsigned int i=0; i<exchangeCache.size(); i++) delete exchangeCache[i];
+    exchangeCache.clear();
+  }
+
+  SpinorGhostExchange::SpinorGhostExchange(const int *X, const int nFace, const int nSpin,
+					   const QudaPrecision precision, const int Ls, const int slot)
+    : Ls(Ls), nFace(nFace), nSpin(nSpin), precision(precision), slot(slot)
+  {
+    // the ghost zones hold no norms
+    if (precision == QUDA_HALF_PRECISION)
+      errorQuda("Half precision host spinors do not support partitioned dimensions");
+
+    for (int d=0; d<4; d++) this->X[d] = X[d];
+
+    for (int d=0; d<4; d++) {
+      size_t faceVolumeCB = Ls;
+      for (int j=0; j<4; j++) if (j != d) faceVolumeCB *= X[j];
+      faceVolumeCB /= 2;
+      bytes[d] = nFace*faceVolumeCB*2*3*nSpin*precision;
+
+      pending[d] = false;
+      for (int dir=0; dir<2; dir++) {
+	sendBuf[d][dir] = safe_malloc(bytes[d]);
+	recvBuf[d][dir] = 0;
+	mhSend[d][dir] = mhRecv[d][dir] = 0;
+      }
+
+      if (!commDimPartitioned(d)) continue;
+
+      for (int dir=0; dir<2; dir++) recvBuf[d][dir] = safe_malloc(bytes[d]);
+      mhRecv[d][0] = comm_declare_receive_relative(recvBuf[d][0], d, -1, bytes[d]);
+      mhRecv[d][1] = comm_declare_receive_relative(recvBuf[d][1], d, +1, bytes[d]);
+      mhSend[d][0] = comm_declare_send_relative(sendBuf[d][0], d, -1, bytes[d]);
+      mhSend[d][1] = comm_declare_send_relative(sendBuf[d][1], d, +1, bytes[d]);
+    }
+
+    for (int d=0; d<4; d++) {
+      // the forwards ghost zone is the backwards face of the neighbor
+      fwd[d] = commDimPartitioned(d) ? recvBuf[d][1] : sendBuf[d][0];
+      back[d] = commDimPartitioned(d) ? recvBuf[d][0] : sendBuf[d][1];
+    }
+  }
+
+  SpinorGhostExchange::~SpinorGhostExchange()
+  {
+    for (int d=0; d<4; d++) {
+      wait(d);
+      for (int dir=0; dir<2; dir++) {
+	if (mhSend[d][dir]) comm_free(mhSend[d][dir]);
+	if (mhRecv[d][dir]) comm_free(mhRecv[d][dir]);
+	if (sendBuf[d][dir]) host_free(sendBuf[d][dir]);
+	if (recvBuf[d][dir]) host_free(recvBuf[d][dir]);
+      }
+    }
+  }
+
+  void SpinorGhostExchange::start(cpuColorSpinorField &in, const int parity, const int dagger, const int *comm)
+  {
+    for (int d=0; d<4; d++) {
+      if (!comm[d]) continue;
+      if (pending[d]) errorQuda("Exchange in dimension %d is already in progress", d);
+
+      in.packGhost(sendBuf[d][0], d, QUDA_BACKWARDS, (QudaParity)parity, dagger);
+      in.packGhost(sendBuf[d][1], d, QUDA_FORWARDS, (QudaParity)parity, dagger);
+      if (!commDimPartitioned(d)) continue;
+
+      comm_start(mhRecv[d][0]);
+      comm_start(mhRecv[d][1]);
+      comm_start(mhSend[d][1]);
+      comm_start(mhSend[d][0]);
+      pending[d] = true;
+    }
+  }
+
+  int SpinorGhostExchange::query(int dim)
+  {
+    if (!pending[dim]) return 1;
+    // the sends are tested too, so that the send buffers may be reused once this returns
+    if (comm_query(mhRecv[dim][0]) && comm_query(mhRecv[dim][1]) &&
+	comm_query(mhSend[dim][1]) && comm_query(mhSend[dim][0])) {
+      wait(dim);
+      return 1;
+    }
+    return 0;
+  }
+
+  void SpinorGhostExchange::wait(int dim)
+  {
+    if (!pending[dim]) return;
+    comm_wait(mhSend[dim][1]);
+    comm_wait(mhSend[dim][0]);
+    comm_wait(mhRecv[dim][0]);
+    comm_wait(mhRecv[dim][1]);
+    pending[dim] = false;
+  }
+
+  SpinorGhostExchange& SpinorGhostExchange::Get(const int *X, const int nFace, const int nSpin,
+						const QudaPrecision precision, const int Ls, const int slot)
+  {
+    for (unsigned int i=0; i<ghostExchangeCache.size(); i++) {
+      const SpinorGhostExchange &g = *ghostExchangeCache[i];
+      bool match = (g.nFace == nFace && g.nSpin == nSpin && g.precision == precision && g.Ls == Ls && g.slot == slot);
+      for (int d=0; d<4; d++) if (g.X[d] != X[d]) match = false;
+      if (match) return *ghostExchangeCache[i];
+    }
+
+    SpinorGhostExchange *g = new SpinorGhostExchange(X, nFace, nSpin, precision, Ls, slot);
+    ghostExchangeCache.push_back(g);
+    return *g;
+  }
+
+  void SpinorGhostExchange::freeCache()
+  {
+    for (unsigned int i=0; i<ghostExchangeCache.size(); i++) delete ghostExchangeCache[i];
+    ghostExchangeCache.clear();
+  }
+
+} // namespace quda
@@ -604,6 +604,22 @@ namespace quda {
 
 
 
+    // 3x3 complex matrix product and sum
+    static const int matMulFlops = 198;
+    static const int matAddFlops = 18;
+
+    /**
+       Bytes moved by a force kernel launched over both parities of
+       threads sites, each site loading nLink links and loading or
+       storing nMatrix color matrices.  The numbers per site are
+       tabulated with the kernels in hisq_paths_force_core.h.
+     */
+    template<class RealA>
+    long long forceBytes(const cudaGaugeField &link, int threads, int nLink, int nMatrix)
+    {
+      return 2ll*threads*(nLink*link.Reconstruct()*link.Precision() + nMatrix*18*sizeof(typename RealTypeId<RealA>::Type));
+    }
+
     template<class RealA, class RealB>
     class MiddleLink : public Tunable {
 
@@ -665,7 +681,7 @@ namespace quda {
 	vol << kparam.D4;    
 	aux << "threads=" << kparam.threads << ",prec=" << link.Precision();
 	aux << ",recon=" << link.Reconstruct() << ",sig=" << sig << ",mu=" << mu;
-	return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
       }  
 
       
@@ -759,7 +775,15 @@ namespace quda {
 	newOprod.restore();
       }
 
-      long long flops() const { return 0; }
+      // Qprev is the link when there is no previous Q to load
+      long long flops() const {
+	if (&Qprev == &link) return 2ll*kparam.threads*(GOES_FORWARDS(sig) ? 3*matMulFlops + matAddFlops : 2*matMulFlops);
+	return 2ll*kparam.threads*(GOES_FORWARDS(sig) ? 4*matMulFlops + matAddFlops : 3*matMulFlops);
+      }
+      long long bytes() const {
+	if (&Qprev == &link) return forceBytes<RealA>(link, kparam.threads, 3, GOES_FORWARDS(sig) ? 6 : 4);
+	return forceBytes<RealA>(link, kparam.threads, 3, GOES_FORWARDS(sig) ? 7 : 5);
+      }
     };
 
 
@@ -805,7 +829,7 @@ namespace quda {
 	vol << kparam.D4;    
 	aux << "threads=" << kparam.threads << ",prec=" << link.Precision();
 	aux << ",recon=" << link.Reconstruct() << ",sig=" << sig << ",mu=" << mu;
-	return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
       }  
       
 #define CALL_ARGUMENTS(typeA, typeB) <<<tp.grid, tp.block>>>		\
@@ -888,7 +912,10 @@ namespace quda {
 	newOprod.restore();
       }
 
-      long long flops() const { return 0; }
+      long long flops() const {
+	return 2ll*kparam.threads*(GOES_FORWARDS(sig) ? 4*matMulFlops + matAddFlops : 2*matMulFlops);
+      }
+      long long bytes() const { return forceBytes<RealA>(link, kparam.threads, 3, GOES_FORWARDS(sig) ? 5 : 2); }
     };
     
     template<class RealA, class RealB>
@@ -937,7 +964,7 @@ namespace quda {
 	vol << kparam.D4;    
 	aux << "threads=" << kparam.threads << ",prec=" << link.Precision();
 	aux << ",recon=" << link.Reconstruct() << ",sig=" << sig << ",mu=" << mu;
-	return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
       }  
       
 #define CALL_ARGUMENTS(typeA, typeB) <<<tp.grid, tp.block>>>		\
@@ -1020,7 +1047,8 @@ namespace quda {
 	newOprod.restore();
       }
 
-      long long flops() const { return 0; }
+      long long flops() const { return 2ll*kparam.threads*(2*matMulFlops + 2*matAddFlops); }
+      long long bytes() const { return forceBytes<RealA>(link, kparam.threads, 1, 6); }
     };
 
 
@@ -1059,7 +1087,7 @@ namespace quda {
 	vol << kparam.D4;    
 	aux << "threads=" << kparam.threads << ",prec=" << link.Precision();
 	aux << ",recon=" << link.Reconstruct() << ",sig=" << sig << ",mu=" << mu;
-	return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
       }  
       
 #define CALL_ARGUMENTS(typeA, typeB) <<<tp.grid, tp.block>>>		\
@@ -1138,7 +1166,8 @@ namespace quda {
 	newOprod.restore();
       }
 
-      long long flops() const { return 0; }
+      long long flops() const { return 2ll*kparam.threads*matAddFlops; }
+      long long bytes() const { return forceBytes<RealA>(link, kparam.threads, 0, 3); }
     };
 
     template<class RealA, class RealB>
@@ -1186,7 +1215,7 @@ namespace quda {
 	vol << kparam.D4;    
 	aux << "threads=" << kparam.threads << ",prec=" << link.Precision();
 	aux << ",recon=" << link.Reconstruct() << ",sig=" << sig << ",mu=" << mu;
-	return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
       }  
       
 #define CALL_ARGUMENTS(typeA, typeB) <<<tp.grid, tp.block>>>		\
@@ -1281,7 +1310,10 @@ namespace quda {
 	param.grid = dim3((kparam.threads+param.block.x-1)/param.block.x, 1, 1);
       }
 
-      long long flops() const { return 0; }
+      long long flops() const {
+	return 2ll*kparam.threads*(GOES_FORWARDS(sig) ? 6*matMulFlops + 3*matAddFlops : 4*matMulFlops + 2*matAddFlops);
+      }
+      long long bytes() const { return forceBytes<RealA>(link, kparam.threads, 3, GOES_FORWARDS(sig) ? 8 : 6); }
     };
 
 
@@ -1320,7 +1352,7 @@ namespace quda {
 	int threads = X[0]*X[1]*X[2]*X[3]/2;
 	aux << "threads=" << threads << ",prec=" << oprod.Precision();
 	aux << ",sig=" << sig << ",coeff=" << coeff;
-	return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
       }  
 
       void apply(const cudaStream_t &stream) {
@@ -1353,7 +1385,9 @@ namespace quda {
 	ForceMatrix.restore();
       }
 
-      long long flops() const { return 0; }
+      // only the forward directions are updated
+      long long flops() const { return GOES_FORWARDS(sig) ? (long long)X[0]*X[1]*X[2]*X[3]*matAddFlops : 0; }
+      long long bytes() const { return GOES_FORWARDS(sig) ? forceBytes<RealA>(oprod, X[0]*X[1]*X[2]*X[3]/2, 0, 3) : 0; }
     };
     
 
@@ -1395,7 +1429,7 @@ namespace quda {
 	int threads = X[0]*X[1]*X[2]*X[3]/2;
 	aux << "threads=" << threads << ",prec=" << link.Precision();
 	aux << ",sig=" << sig;
-	return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
       }  
 
 #define CALL_ARGUMENTS(typeA, typeB) <<<tp.grid,tp.block>>>		\
@@ -1439,7 +1473,8 @@ namespace quda {
 	output.restore();
       }
 
-      long long flops() const { return 0; }
+      long long flops() const { return 2ll*kparam.threads*(6*matMulFlops + 3*matAddFlops); }
+      long long bytes() const { return forceBytes<RealA>(link, kparam.threads, 4, 5); }
     };
 
 
@@ -1478,7 +1513,7 @@ namespace quda {
 	vol << X[3];    
 	int threads = X[0]*X[1]*X[2]*X[3]/2;
 	aux << "threads=" << threads << ",prec=" << link.Precision() << ",sig=" << sig;
-	return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
       }  
 
 #define CALL_ARGUMENTS(typeA, typeB)  <<<tp.grid, tp.block>>>		\
@@ -1521,7 +1556,11 @@ namespace quda {
 	mom.restore();
       }
 
-      long long flops() const { return 0; }
+      // the momentum is stored in 10 reals
+      long long flops() const { return (long long)X[0]*X[1]*X[2]*X[3]*matMulFlops; }
+      long long bytes() const {
+	return forceBytes<RealA>(link, X[0]*X[1]*X[2]*X[3]/2, 1, 1) + (long long)X[0]*X[1]*X[2]*X[3]*10*mom.Precision();
+      }
     };
 
 
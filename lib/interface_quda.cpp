@@ -4,6 +4,8 @@
 #include <math.h>
 #include <string.h>
 #include <sys/time.h>
+#include <vector>
+#include <algorithm>
 
 #include <quda.h>
 #include <quda_internal.h>
@@ -13,6 +15,8 @@
 #include <gauge_field.h>
 #include <dirac_quda.h>
 #include <dslash_quda.h>
+#include <lattice_geometry.h>
+#include <halo_exchange.h>
 #include <invert_quda.h>
 #include <color_spinor_field.h>
 #include <clover_field.h>
@@ -59,6 +63,7 @@ extern void exchange_cpu_sitelink_ex(int* X, int *R, void** sitelink, QudaGaugeF
 #undef PRINT_PARAM
 
 #include "face_quda.h"
+#include "su3_cpu.h"
 
 int numa_affinity_enabled = 1;
 
@@ -77,15 +82,42 @@ cudaGaugeField *gaugeLongPrecise = NULL;
 cudaGaugeField *gaugeLongSloppy = NULL;
 cudaGaugeField *gaugeLongPrecondition = NULL;
 
+// host copies of the gauge field, used when the solver is run on the host
+cpuGaugeField *gaugeHostPrecise = NULL;
+cpuGaugeField *gaugeHostSloppy = NULL;
+
+// as above, the host fat links alias the host gauge field so cpuDirac::cpuDirac() sees them
+cpuGaugeField *&gaugeFatHostPrecise = gaugeHostPrecise;
+cpuGaugeField *&gaugeFatHostSloppy = gaugeHostSloppy;
+
+cpuGaugeField *gaugeLongHostPrecise = NULL;
+cpuGaugeField *gaugeLongHostSloppy = NULL;
+
 cudaCloverField *cloverPrecise = NULL;
 cudaCloverField *cloverSloppy = NULL;
 cudaCloverField *cloverPrecondition = NULL;
 
+// host copies of the clover field, used when the solver is run on the host
+cpuCloverField *cloverHostPrecise = NULL;
+cpuCloverField *cloverHostSloppy = NULL;
+
 
 cudaDeviceProp deviceProp;
 cudaStream_t *streams;
 
 static bool initialized = false;
+static bool hostOnly = false; // set by initQudaHost(), no device fields are created
+
+// incremented whenever the resident gauge or clover fields change, so
+// that operators cached in a solver context know to rebuild
+static int fieldGeneration = 0;
+
+// there are no half-precision host gauge or clover fields, so their host
+// sloppy precision is at least single (host spinor fields support half)
+static QudaPrecision hostSloppyPrecision(QudaPrecision precision)
+{
+  return (precision == QUDA_HALF_PRECISION) ? QUDA_SINGLE_PRECISION : precision;
+}
 
 //!< Profiler for initQuda
 static TimeProfile profileInit("initQuda");
@@ -99,6 +131,9 @@ static TimeProfile profileClover("loadCloverQuda");
 //!< Profiler for invertQuda
 static TimeProfile profileInvert("invertQuda");
 
+//!< Profiler for invertBlockQuda
+static TimeProfile profileBlock("invertBlockQuda");
+
 //!< Profiler for invertMultiShiftQuda
 static TimeProfile profileMulti("invertMultiShiftQuda");
 
@@ -336,6 +371,8 @@ void initQuda(int dev)
 {
   profileInit.Start(QUDA_PROFILE_TOTAL);
 
+  if (hostOnly) errorQuda("QUDA has already been initialized without a device by initQudaHost()");
+
   // initialize communications topology, if not already done explicitly via initCommsGridQuda()
   if (!comms_initialized) init_default_comms();
 
@@ -345,10 +382,66 @@ void initQuda(int dev)
   // set the persistant memory allocations that QUDA uses (Blas, streams, etc.)
   initQudaMemory();
 
+  // read the host settings now, rather than from within the threaded host kernels
+  hostSimdType();
+  reduceReproducible();
+
+  profileInit.Stop(QUDA_PROFILE_TOTAL);
+}
+
+
+void initQudaHost()
+{
+  profileInit.Start(QUDA_PROFILE_TOTAL);
+
+  if (!initialized) {
+    // initialize communications topology, if not already done explicitly via initCommsGridQuda()
+    if (!comms_initialized) init_default_comms();
+
+    initialized = true;
+    hostOnly = true;
+
+    loadTuneCache(getVerbosity());
+
+    // read the host settings now, rather than from within the threaded host kernels
+    hostSimdType();
+    reduceReproducible();
+  }
+
   profileInit.Stop(QUDA_PROFILE_TOTAL);
 }
 
 
+// keep QDP-ordered host copies of the gauge field for the host Dirac operators
+static void loadHostGauge(void *h_gauge, GaugeField &in, QudaGaugeParam *param)
+{
+  if (param->location != QUDA_CPU_FIELD_LOCATION) errorQuda("Host solver requires a host gauge field");
+
+  // the Wilson and fat links share the host gauge field, the long links get their own
+  cpuGaugeField *&hostPrecise = (param->type == QUDA_ASQTAD_LONG_LINKS) ? gaugeLongHostPrecise : gaugeHostPrecise;
+  cpuGaugeField *&hostSloppy = (param->type == QUDA_ASQTAD_LONG_LINKS) ? gaugeLongHostSloppy : gaugeHostSloppy;
+
+  profileGauge.Start(QUDA_PROFILE_INIT);
+  if (hostSloppy != hostPrecise && hostSloppy) delete hostSloppy;
+  if (hostPrecise) delete hostPrecise;
+
+  GaugeFieldParam host_param(h_gauge, *param);
+  host_param.create = QUDA_NULL_FIELD_CREATE;
+  host_param.order = QUDA_QDP_GAUGE_ORDER;
+  hostPrecise = new cpuGaugeField(host_param);
+  copyGenericGauge(*hostPrecise, in, QUDA_CPU_FIELD_LOCATION);
+
+  host_param.precision = hostSloppyPrecision(param->cuda_prec_sloppy);
+  if (host_param.precision != hostPrecise->Precision()) {
+    hostSloppy = new cpuGaugeField(host_param);
+    copyGenericGauge(*hostSloppy, *hostPrecise, QUDA_CPU_FIELD_LOCATION);
+  } else {
+    hostSloppy = hostPrecise;
+  }
+  profileGauge.Stop(QUDA_PROFILE_INIT);
+}
+
+
 void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 {
   profileGauge.Start(QUDA_PROFILE_TOTAL);
@@ -375,6 +468,21 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
     static_cast<GaugeField*>(new cpuGaugeField(gauge_param)) : 
     static_cast<GaugeField*>(new cudaGaugeField(gauge_param));
 
+  // without a device only the host copies are kept
+  if (hostOnly) {
+    profileGauge.Stop(QUDA_PROFILE_INIT);
+    if (param->solver_location != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("QUDA was initialized without a device, so solver_location must be QUDA_CPU_FIELD_LOCATION");
+    loadHostGauge(h_gauge, *in, param);
+    fieldGeneration++;
+
+    profileGauge.Start(QUDA_PROFILE_FREE);
+    delete in;
+    profileGauge.Stop(QUDA_PROFILE_FREE);
+    profileGauge.Stop(QUDA_PROFILE_TOTAL);
+    return;
+  }
+
   // switch the parameters for creating the mirror precise cuda gauge field
   gauge_param.create = QUDA_NULL_FIELD_CREATE;
   gauge_param.precision = param->cuda_prec;
@@ -455,6 +563,9 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
     default:
       errorQuda("Invalid gauge type");   
   }
+  fieldGeneration++;
+
+  if (param->solver_location == QUDA_CPU_FIELD_LOCATION) loadHostGauge(h_gauge, *in, param);
 
   profileGauge.Start(QUDA_PROFILE_FREE);  
   delete in;
@@ -499,6 +610,35 @@ void saveGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 }
 
 
+// keep packed host copies of the clover field for the host Dirac operators
+static void loadHostClover(void *h_clover, void *h_clovinv, CloverField &in,
+			   const CloverFieldParam &cpuParam, QudaInvertParam *inv_param)
+{
+  if (inv_param->clover_location != QUDA_CPU_FIELD_LOCATION) errorQuda("Host solver requires a host clover field");
+
+  profileClover.Start(QUDA_PROFILE_INIT);
+  if (cloverHostSloppy != cloverHostPrecise && cloverHostSloppy) delete cloverHostSloppy;
+  if (cloverHostPrecise) delete cloverHostPrecise;
+
+  CloverFieldParam host_param = cpuParam;
+  host_param.order = QUDA_PACKED_CLOVER_ORDER;
+  host_param.create = QUDA_NULL_FIELD_CREATE;
+  cloverHostPrecise = new cpuCloverField(host_param);
+  if (h_clover) copyGenericClover(*cloverHostPrecise, in, false, QUDA_CPU_FIELD_LOCATION);
+  if (h_clovinv) copyGenericClover(*cloverHostPrecise, in, true, QUDA_CPU_FIELD_LOCATION);
+
+  host_param.precision = hostSloppyPrecision(inv_param->clover_cuda_prec_sloppy);
+  if (host_param.precision != cloverHostPrecise->Precision()) {
+    cloverHostSloppy = new cpuCloverField(host_param);
+    if (h_clover) copyGenericClover(*cloverHostSloppy, *cloverHostPrecise, false, QUDA_CPU_FIELD_LOCATION);
+    if (h_clovinv) copyGenericClover(*cloverHostSloppy, *cloverHostPrecise, true, QUDA_CPU_FIELD_LOCATION);
+  } else {
+    cloverHostSloppy = cloverHostPrecise;
+  }
+  profileClover.Stop(QUDA_PROFILE_INIT);
+}
+
+
 void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
 {
   profileClover.Start(QUDA_PROFILE_TOTAL);
@@ -514,7 +654,9 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
   if (inv_param->clover_cpu_prec == QUDA_HALF_PRECISION) {
     errorQuda("Half precision not supported on CPU");
   }
-  if (gaugePrecise == NULL) {
+  // without a device only the host gauge field is resident
+  GaugeField *gauge = hostOnly ? static_cast<GaugeField*>(gaugeHostPrecise) : static_cast<GaugeField*>(gaugePrecise);
+  if (gauge == NULL) {
     errorQuda("Gauge field must be loaded before clover");
   }
   if (inv_param->dslash_type != QUDA_CLOVER_WILSON_DSLASH) {
@@ -554,7 +696,7 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
   profileClover.Start(QUDA_PROFILE_INIT);
   CloverFieldParam cpuParam;
   cpuParam.nDim = 4;
-  for (int i=0; i<4; i++) cpuParam.x[i] = gaugePrecise->X()[i];
+  for (int i=0; i<4; i++) cpuParam.x[i] = gauge->X()[i];
   cpuParam.precision = inv_param->clover_cpu_prec;
   cpuParam.order = inv_param->clover_order;
   cpuParam.direct = h_clover ? true : false;
@@ -569,6 +711,19 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
     static_cast<CloverField*>(new cpuCloverField(cpuParam)) : 
     static_cast<CloverField*>(new cudaCloverField(cpuParam));
 
+  if (hostOnly) {
+    profileClover.Stop(QUDA_PROFILE_INIT);
+    if (inv_param->solver_location != QUDA_CPU_FIELD_LOCATION)
+      errorQuda("QUDA was initialized without a device, so solver_location must be QUDA_CPU_FIELD_LOCATION");
+    loadHostClover(h_clover, h_clovinv, *in, cpuParam, inv_param);
+    fieldGeneration++;
+
+    delete in; // delete object referencing input field
+    popVerbosity();
+    profileClover.Stop(QUDA_PROFILE_TOTAL);
+    return;
+  }
+
   CloverFieldParam clover_param;
   clover_param.nDim = 4;
   for (int i=0; i<4; i++) clover_param.x[i] = gaugePrecise->X()[i];
@@ -578,6 +733,7 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
   clover_param.inverse = h_clovinv ? true : false;
   clover_param.create = QUDA_NULL_FIELD_CREATE;
   cloverPrecise = new cudaCloverField(clover_param);
+  fieldGeneration++;
   profileClover.Stop(QUDA_PROFILE_INIT);
 
   profileClover.Start(QUDA_PROFILE_H2D);
@@ -617,6 +773,9 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
     cloverPrecondition = cloverSloppy;
   }
 
+  if (inv_param->solver_location == QUDA_CPU_FIELD_LOCATION)
+    loadHostClover(h_clover, h_clovinv, *in, cpuParam, inv_param);
+
   delete in; // delete object referencing input field
 
   popVerbosity();
@@ -650,6 +809,20 @@ void freeGaugeQuda(void)
   gaugeFatPrecondition = NULL;
   gaugeFatSloppy = NULL;
   gaugeFatPrecise = NULL;
+
+  if (gaugeHostPrecise != gaugeHostSloppy && gaugeHostSloppy) delete gaugeHostSloppy;
+  if (gaugeHostPrecise) delete gaugeHostPrecise;
+
+  gaugeHostSloppy = NULL;
+  gaugeHostPrecise = NULL;
+
+  if (gaugeLongHostPrecise != gaugeLongHostSloppy && gaugeLongHostSloppy) delete gaugeLongHostSloppy;
+  if (gaugeLongHostPrecise) delete gaugeLongHostPrecise;
+
+  gaugeLongHostSloppy = NULL;
+  gaugeLongHostPrecise = NULL;
+
+  fieldGeneration++;
 }
 
 
@@ -663,6 +836,14 @@ void freeCloverQuda(void)
   cloverPrecondition = NULL;
   cloverSloppy = NULL;
   cloverPrecise = NULL;
+
+  if (cloverHostSloppy != cloverHostPrecise && cloverHostSloppy) delete cloverHostSloppy;
+  if (cloverHostPrecise) delete cloverHostPrecise;
+
+  cloverHostSloppy = NULL;
+  cloverHostPrecise = NULL;
+
+  fieldGeneration++;
 }
 
 
@@ -676,27 +857,38 @@ void endQuda(void)
   cudaColorSpinorField::freeBuffer();
   cudaColorSpinorField::freeGhostBuffer();
   cpuColorSpinorField::freeGhostBuffer();
+  LatticeGeometry::freeCache();
+  HaloExchange::freeCache();
+  SpinorGhostExchange::freeCache();
   FaceBuffer::flushPinnedCache();
   freeGaugeQuda();
   freeCloverQuda();
+  flushChronoQuda(-1);
 
-  endBlas();
+  // initQudaHost() set up neither the device nor its streams and events
+  if (!hostOnly) {
+    endBlas();
 
-  if (streams) {
-    for (int i=0; i<Nstream; i++) cudaStreamDestroy(streams[i]);
-    delete []streams;
-    streams = NULL;
+    if (streams) {
+      for (int i=0; i<Nstream; i++) cudaStreamDestroy(streams[i]);
+      delete []streams;
+      streams = NULL;
+    }
+    destroyDslashEvents();
   }
-  destroyDslashEvents();
 
   saveTuneCache(getVerbosity());
 
 #ifndef USE_QDPJIT
   // end this CUDA context
-  cudaDeviceReset();
+  if (!hostOnly) cudaDeviceReset();
 #endif
 
   initialized = false;
+  hostOnly = false;
+
+  // export the profiles while the ranks can still be reduced over
+  TimeProfile::Save();
 
   comm_finalize();
   comms_initialized = false;
@@ -709,6 +901,7 @@ void endQuda(void)
     profileGauge.Print();
     profileClover.Print();
     profileInvert.Print();
+    profileBlock.Print();
     profileMulti.Print();
     profileMultiMixed.Print();
     profileFatLink.Print();
@@ -716,6 +909,7 @@ void endQuda(void)
     profileGaugeUpdate.Print();
     profileEnd.Print();
 
+    printLaunchReport(getVerbosity());
     printfQuda("\n");
     printPeakMemUsage();
     printfQuda("\n");
@@ -731,7 +925,8 @@ namespace quda {
   {
     double kappa = inv_param->kappa;
     if (inv_param->dirac_order == QUDA_CPS_WILSON_DIRAC_ORDER) {
-      kappa *= gaugePrecise->Anisotropy();
+      // only the host gauge field is resident after initQudaHost()
+      kappa *= gaugePrecise ? gaugePrecise->Anisotropy() : gaugeHostPrecise->Anisotropy();
     }
 
     switch (inv_param->dslash_type) {
@@ -771,6 +966,10 @@ namespace quda {
     diracParam.fatGauge = gaugeFatPrecise;
     diracParam.longGauge = gaugeLongPrecise;    
     diracParam.clover = cloverPrecise;
+    diracParam.cpuGauge = gaugeHostPrecise;
+    diracParam.cpuFatGauge = gaugeFatHostPrecise;
+    diracParam.cpuLongGauge = gaugeLongHostPrecise;
+    diracParam.cpuClover = cloverHostPrecise;
     diracParam.kappa = kappa;
     diracParam.mass = inv_param->mass;
     diracParam.m5 = inv_param->m5;
@@ -790,6 +989,10 @@ namespace quda {
     diracParam.fatGauge = gaugeFatSloppy;
     diracParam.longGauge = gaugeLongSloppy;    
     diracParam.clover = cloverSloppy;
+    diracParam.cpuGauge = gaugeHostSloppy;
+    diracParam.cpuFatGauge = gaugeFatHostSloppy;
+    diracParam.cpuLongGauge = gaugeLongHostSloppy;
+    diracParam.cpuClover = cloverHostSloppy;
 
     for (int i=0; i<4; i++) {
       diracParam.commDim[i] = 1;   // comms are always on
@@ -806,6 +1009,10 @@ namespace quda {
     diracParam.fatGauge = gaugeFatPrecondition;
     diracParam.longGauge = gaugeLongPrecondition;    
     diracParam.clover = cloverPrecondition;
+    diracParam.cpuGauge = gaugeHostSloppy;
+    diracParam.cpuFatGauge = gaugeFatHostSloppy;
+    diracParam.cpuLongGauge = gaugeLongHostSloppy;
+    diracParam.cpuClover = cloverHostSloppy;
 
     for (int i=0; i<4; i++) {
       diracParam.commDim[i] = 0; // comms are always off
@@ -828,13 +1035,14 @@ namespace quda {
     dPre = Dirac::create(diracPreParam);
   }
 
+  template <typename Field>
   void massRescale(QudaDslashType dslash_type, double &kappa, QudaSolutionType solution_type, 
-      QudaMassNormalization mass_normalization, cudaColorSpinorField &b)
+      QudaMassNormalization mass_normalization, Field &b)
   {   
     if (getVerbosity() >= QUDA_DEBUG_VERBOSE) {
       printfQuda("Mass rescale: Kappa is: %g\n", kappa);
       printfQuda("Mass rescale: mass normalization: %d\n", mass_normalization);
-      double nin = norm2(b);
+      double nin = blas::norm2(b);
       printfQuda("Mass rescale: norm of source in = %g\n", nin);
     }
 
@@ -850,27 +1058,27 @@ namespace quda {
       case QUDA_MAT_SOLUTION:
         if (mass_normalization == QUDA_MASS_NORMALIZATION ||
             mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
-          axCuda(2.0*kappa, b);
+          blas::ax(2.0*kappa, b);
         }
         break;
       case QUDA_MATDAG_MAT_SOLUTION:
         if (mass_normalization == QUDA_MASS_NORMALIZATION ||
             mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
-          axCuda(4.0*kappa*kappa, b);
+          blas::ax(4.0*kappa*kappa, b);
         }
         break;
       case QUDA_MATPC_SOLUTION:
         if (mass_normalization == QUDA_MASS_NORMALIZATION) {
-          axCuda(4.0*kappa*kappa, b);
+          blas::ax(4.0*kappa*kappa, b);
         } else if (mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
-          axCuda(2.0*kappa, b);
+          blas::ax(2.0*kappa, b);
         }
         break;
       case QUDA_MATPCDAG_MATPC_SOLUTION:
         if (mass_normalization == QUDA_MASS_NORMALIZATION) {
-          axCuda(16.0*pow(kappa,4), b);
+          blas::ax(16.0*pow(kappa,4), b);
         } else if (mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
-          axCuda(4.0*kappa*kappa, b);
+          blas::ax(4.0*kappa*kappa, b);
         }
         break;
       default:
@@ -881,7 +1089,7 @@ namespace quda {
     if (getVerbosity() >= QUDA_DEBUG_VERBOSE) {
       printfQuda("Mass rescale: Kappa is: %g\n", kappa);
       printfQuda("Mass rescale: mass normalization: %d\n", mass_normalization);
-      double nin = norm2(b);
+      double nin = blas::norm2(b);
       printfQuda("Mass rescale: norm of source out = %g\n", nin);
     }
 
@@ -1003,10 +1211,89 @@ void dslashQuda(void *h_out, void *h_in, QudaInvertParam *inv_param, QudaParity
 }
 
 
+/*!
+ * Host version of MatQuda() and MatDagMatQuda(), used when
+ * solver_location is QUDA_CPU_FIELD_LOCATION.  The operator (or its
+ * normal operator if normal is set) is applied with the host Dirac
+ * operators, with the same mass normalization as the device path.
+ */
+static void matHostQuda(void *h_out, void *h_in, QudaInvertParam *inv_param, bool normal)
+{
+  if (gaugeHostPrecise == NULL)
+    errorQuda("Host gauge field doesn't exist (load the gauge field with solver_location = QUDA_CPU_FIELD_LOCATION)");
+
+  bool pc = (inv_param->solution_type == QUDA_MATPC_SOLUTION ||
+      inv_param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+
+  ColorSpinorParam cpuParam(h_in, *inv_param, gaugeHostPrecise->X(), pc);
+  ColorSpinorField *in_h = (inv_param->input_location == QUDA_CPU_FIELD_LOCATION) ?
+    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
+    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
+
+  ColorSpinorParam hostParam(cpuParam);
+  hostParam.v = 0;
+  hostParam.precision = inv_param->cpu_prec;
+  hostParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  hostParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  hostParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  hostParam.create = QUDA_COPY_FIELD_CREATE;
+  cpuColorSpinorField in(*in_h, hostParam);
+
+  hostParam.create = QUDA_NULL_FIELD_CREATE;
+  cpuColorSpinorField out(hostParam);
+
+  DiracParam diracParam;
+  setDiracParam(diracParam, inv_param, pc);
+
+  cpuDirac *dirac = cpuDirac::create(diracParam); // create the Dirac operator
+  if (normal) dirac->MdagM(out, in);
+  else dirac->M(out, in);
+  delete dirac; // clean up
+
+  double kappa = inv_param->kappa;
+  double scale = 1.0;
+  if (pc) {
+    if (inv_param->mass_normalization == QUDA_MASS_NORMALIZATION) {
+      scale = normal ? 1.0/pow(2.0*kappa,4) : 0.25/(kappa*kappa);
+    } else if (inv_param->mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
+      scale = normal ? 0.25/(kappa*kappa) : 0.5/kappa;
+    }
+  } else {
+    if (inv_param->mass_normalization == QUDA_MASS_NORMALIZATION ||
+        inv_param->mass_normalization == QUDA_ASYMMETRIC_MASS_NORMALIZATION) {
+      scale = normal ? 0.25/(kappa*kappa) : 0.5/kappa;
+    }
+  }
+  if (scale != 1.0) blas::ax(scale, out);
+
+  cpuParam.v = h_out;
+
+  ColorSpinorField *out_h = (inv_param->output_location == QUDA_CPU_FIELD_LOCATION) ?
+    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
+    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
+  *out_h = out;
+
+  if (getVerbosity() >= QUDA_VERBOSE) {
+    double nin = blas::norm2(in);
+    double nout = blas::norm2(out);
+    printfQuda("In %e Out %e\n", nin, nout);
+  }
+
+  delete out_h;
+  delete in_h;
+}
+
+
 void MatQuda(void *h_out, void *h_in, QudaInvertParam *inv_param)
 {
   pushVerbosity(inv_param->verbosity);
 
+  if (inv_param->solver_location == QUDA_CPU_FIELD_LOCATION) {
+    matHostQuda(h_out, h_in, inv_param, false);
+    popVerbosity();
+    return;
+  }
+
   if (inv_param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
   if (gaugePrecise == NULL) errorQuda("Gauge field not allocated");
   if (cloverPrecise == NULL && inv_param->dslash_type == QUDA_CLOVER_WILSON_DSLASH) 
@@ -1078,6 +1365,12 @@ void MatDagMatQuda(void *h_out, void *h_in, QudaInvertParam *inv_param)
 {
   pushVerbosity(inv_param->verbosity);
 
+  if (inv_param->solver_location == QUDA_CPU_FIELD_LOCATION) {
+    matHostQuda(h_out, h_in, inv_param, true);
+    popVerbosity();
+    return;
+  }
+
   if (inv_param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
 
   if (!initialized) errorQuda("QUDA not initialized");
@@ -1170,6 +1463,21 @@ quda::cudaGaugeField* checkGauge(QudaInvertParam *param) {
 }
 
 
+// the host counterpart of checkGauge(), for solver_location = QUDA_CPU_FIELD_LOCATION
+static void checkHostGauge(QudaInvertParam *param)
+{
+  if (gaugeHostPrecise == NULL)
+    errorQuda("Host gauge field doesn't exist (load the gauge field with solver_location = QUDA_CPU_FIELD_LOCATION)");
+  if (gaugeHostSloppy == NULL) errorQuda("Sloppy host gauge field doesn't exist");
+  if (param->dslash_type == QUDA_ASQTAD_DSLASH) {
+    if (gaugeLongHostPrecise == NULL) errorQuda("Precise host gauge long field doesn't exist");
+    if (gaugeLongHostSloppy == NULL) errorQuda("Sloppy host gauge long field doesn't exist");
+  }
+  if (param->dslash_type == QUDA_CLOVER_WILSON_DSLASH && cloverHostPrecise == NULL)
+    errorQuda("Host clover field doesn't exist (load the clover field with solver_location = QUDA_CPU_FIELD_LOCATION)");
+}
+
+
 void cloverQuda(void *h_out, void *h_in, QudaInvertParam *inv_param, QudaParity parity, int inverse)
 {
   pushVerbosity(inv_param->verbosity);
@@ -1242,26 +1550,19 @@ void cloverQuda(void *h_out, void *h_in, QudaInvertParam *inv_param, QudaParity
 }
 
 
-void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
+/*!
+ * Host version of invertQuda(), used when solver_location is
+ * QUDA_CPU_FIELD_LOCATION.  The source and solution are copied into
+ * host fields in the layout expected by the host Dirac operators
+ * (space-spin-color order, DeGrand-Rossi basis) and the solve is
+ * carried out with the same solvers, driven by the host operators.
+ */
+static void invertHostQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
 {
-
-  if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
-
-  profileInvert.Start(QUDA_PROFILE_TOTAL);
-
-  if (!initialized) errorQuda("QUDA not initialized");
-
-  pushVerbosity(param->verbosity);
-  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(param);
-
-  // check the gauge fields have been created
-  cudaGaugeField *cudaGauge = checkGauge(param);
-
-  checkInvertParam(param);
-
-  // It was probably a bad design decision to encode whether the system is even/odd preconditioned (PC) in
-  // solve_type and solution_type, rather than in separate members of QudaInvertParam.  We're stuck with it
-  // for now, though, so here we factorize everything for convenience.
+  if (gaugeHostPrecise == NULL)
+    errorQuda("Host gauge field doesn't exist (load the gauge field with solver_location = QUDA_CPU_FIELD_LOCATION)");
+  if (param->chrono_use_resident || param->chrono_make_resident)
+    errorQuda("Chronological initial guess is not supported with solver_location = QUDA_CPU_FIELD_LOCATION");
 
   bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) || 
     (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
@@ -1272,40 +1573,40 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
   bool direct_solve = (param->solve_type == QUDA_DIRECT_SOLVE) || 
     (param->solve_type == QUDA_DIRECT_PC_SOLVE);
 
-  param->spinorGiB = cudaGauge->VolumeCB() * spinorSiteSize;
-  if (!pc_solve) param->spinorGiB *= 2;
-  param->spinorGiB *= (param->cuda_prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
-  if (param->preserve_source == QUDA_PRESERVE_SOURCE_NO) {
-    param->spinorGiB *= (param->inv_type == QUDA_CG_INVERTER ? 5 : 7)/(double)(1<<30);
-  } else {
-    param->spinorGiB *= (param->inv_type == QUDA_CG_INVERTER ? 8 : 9)/(double)(1<<30);
+  if (pc_solution && !pc_solve) {
+    errorQuda("Preconditioned (PC) solution_type requires a PC solve_type");
+  }
+
+  if (!mat_solution && !pc_solution && pc_solve) {
+    errorQuda("Unpreconditioned MATDAG_MAT solution_type requires an unpreconditioned solve_type");
   }
 
   param->secs = 0;
   param->gflops = 0;
   param->iter = 0;
 
-  Dirac *d = NULL;
-  Dirac *dSloppy = NULL;
-  Dirac *dPre = NULL;
+  // create the host dirac operators (the preconditioner is the sloppy operator with no comms)
+  DiracParam diracParam;
+  DiracParam diracSloppyParam;
+  DiracParam diracPreParam;
 
-  // create the dirac operator
-  createDirac(d, dSloppy, dPre, *param, pc_solve);
+  setDiracParam(diracParam, param, pc_solve);
+  setDiracSloppyParam(diracSloppyParam, param, pc_solve);
+  setDiracPreParam(diracPreParam, param, pc_solve);
 
-  Dirac &dirac = *d;
-  Dirac &diracSloppy = *dSloppy;
-  Dirac &diracPre = *dPre;
+  cpuDirac *d = cpuDirac::create(diracParam);
+  cpuDirac *dSloppy = cpuDirac::create(diracSloppyParam);
+  cpuDirac *dPre = cpuDirac::create(diracPreParam);
 
-  profileInvert.Start(QUDA_PROFILE_H2D);
+  cpuDirac &dirac = *d;
+  cpuDirac &diracSloppy = *dSloppy;
+  cpuDirac &diracPre = *dPre;
 
-  cudaColorSpinorField *b = NULL;
-  cudaColorSpinorField *x = NULL;
-  cudaColorSpinorField *in = NULL;
-  cudaColorSpinorField *out = NULL;
+  profileInvert.Start(QUDA_PROFILE_H2D);
 
-  const int *X = cudaGauge->X();
+  const int *X = gaugeHostPrecise->X();
 
-  // wrap CPU host side pointers
+  // wrap the user's pointers
   ColorSpinorParam cpuParam(hp_b, *param, X, pc_solution);
   ColorSpinorField *h_b = (param->input_location == QUDA_CPU_FIELD_LOCATION) ?
     static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
@@ -1316,126 +1617,99 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
     static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
 
-  // download source
-  ColorSpinorParam cudaParam(cpuParam, *param);
-  cudaParam.create = QUDA_COPY_FIELD_CREATE;
-  b = new cudaColorSpinorField(*h_b, cudaParam); 
-
-  if (param->use_init_guess == QUDA_USE_INIT_GUESS_YES) { // download initial guess
+  // copy the source into the layout used by the host operators
+  ColorSpinorParam hostParam(cpuParam);
+  hostParam.v = 0;
+  hostParam.precision = param->cpu_prec;
+  hostParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  hostParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  hostParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  hostParam.create = QUDA_COPY_FIELD_CREATE;
+  cpuColorSpinorField *b = new cpuColorSpinorField(*h_b, hostParam);
+  cpuColorSpinorField *x = NULL;
+
+  if (param->use_init_guess == QUDA_USE_INIT_GUESS_YES) { // copy initial guess
     // initial guess only supported for single-pass solvers
     if ((param->solution_type == QUDA_MATDAG_MAT_SOLUTION || param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION) &&
         (param->solve_type == QUDA_DIRECT_SOLVE || param->solve_type == QUDA_DIRECT_PC_SOLVE)) {
       errorQuda("Initial guess not supported for two-pass solver");
     }
 
-    x = new cudaColorSpinorField(*h_x, cudaParam); // solution  
+    x = new cpuColorSpinorField(*h_x, hostParam); // solution  
   } else { // zero initial guess
-    cudaParam.create = QUDA_ZERO_FIELD_CREATE;
-    x = new cudaColorSpinorField(cudaParam); // solution
+    hostParam.create = QUDA_ZERO_FIELD_CREATE;
+    x = new cpuColorSpinorField(hostParam); // solution
   }
 
   profileInvert.Stop(QUDA_PROFILE_H2D);
 
-  double nb = norm2(*b);
+  double nb = blas::norm2(*b);
   if (nb==0.0) errorQuda("Solution has zero norm");
 
   if (getVerbosity() >= QUDA_VERBOSE) {
-    double nh_b = norm2(*h_b);
-    double nh_x = norm2(*h_x);
-    double nx = norm2(*x);
-    printfQuda("Source: CPU = %g, CUDA copy = %g\n", nh_b, nb);
-    printfQuda("Solution: CPU = %g, CUDA copy = %g\n", nh_x, nx);
+    double nx = blas::norm2(*x);
+    printfQuda("Source = %g, Solution = %g\n", nb, nx);
   }
 
   // rescale the source and solution vectors to help prevent the onset of underflow
   if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
-    axCuda(1.0/sqrt(nb), *b);
-    axCuda(1.0/sqrt(nb), *x);
+    blas::ax(1.0/sqrt(nb), *b);
+    blas::ax(1.0/sqrt(nb), *x);
   }
 
-  setTuning(param->tune);
+  cpuColorSpinorField *in = NULL;
+  cpuColorSpinorField *out = NULL;
 
   dirac.prepare(in, out, *x, *b, param->solution_type);
   if (getVerbosity() >= QUDA_VERBOSE) {
-    double nin = norm2(*in);
-    double nout = norm2(*out);
+    double nin = blas::norm2(*in);
+    double nout = blas::norm2(*out);
     printfQuda("Prepared source = %g\n", nin);   
     printfQuda("Prepared solution = %g\n", nout);   
   }
 
   massRescale(param->dslash_type, param->kappa, param->solution_type, param->mass_normalization, *in);
 
-  if (getVerbosity() >= QUDA_VERBOSE) {
-    double nin = norm2(*in);
-    printfQuda("Prepared source post mass rescale = %g\n", nin);   
-  }
-
-  // solution_type specifies *what* system is to be solved.
-  // solve_type specifies *how* the system is to be solved.
-  //
-  // We have the following four cases (plus preconditioned variants):
-  //
-  // solution_type    solve_type    Effect
-  // -------------    ----------    ------
-  // MAT              DIRECT        Solve Ax=b
-  // MATDAG_MAT       DIRECT        Solve A^dag y = b, followed by Ax=y
-  // MAT              NORMOP        Solve (A^dag A) x = (A^dag b)
-  // MATDAG_MAT       NORMOP        Solve (A^dag A) x = b
-  //
-  // We generally require that the solution_type and solve_type
-  // preconditioning match.  As an exception, the unpreconditioned MAT
-  // solution_type may be used with any solve_type, including
-  // DIRECT_PC and NORMOP_PC.  In these cases, preparation of the
-  // preconditioned source and reconstruction of the full solution are
-  // taken care of by Dirac::prepare() and Dirac::reconstruct(),
-  // respectively.
-
-  if (pc_solution && !pc_solve) {
-    errorQuda("Preconditioned (PC) solution_type requires a PC solve_type");
-  }
-
-  if (!mat_solution && !pc_solution && pc_solve) {
-    errorQuda("Unpreconditioned MATDAG_MAT solution_type requires an unpreconditioned solve_type");
-  }
+  // the solvers work on host fields at the host precisions
+  SolverParam hostSolverParam(*param);
+  hostSolverParam.precision = param->cpu_prec;
+  hostSolverParam.precision_sloppy = param->cuda_prec_sloppy;
+  hostSolverParam.precision_precondition = param->cuda_prec_precondition;
 
   if (mat_solution && !direct_solve) { // prepare source: b' = A^dag b
-    cudaColorSpinorField tmp(*in);
+    cpuColorSpinorField tmp(*in);
     dirac.Mdag(*in, tmp);
   } else if (!mat_solution && direct_solve) { // perform the first of two solves: A^dag y = b
     DiracMdag m(dirac), mSloppy(diracSloppy), mPre(diracPre);
-    SolverParam solverParam(*param);
+    SolverParam solverParam(hostSolverParam);
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
-    copyCuda(*in, *out);
+    blas::copy(*in, *out);
     solverParam.updateInvertParam(*param);
     delete solve;
   }
 
   if (direct_solve) {
     DiracM m(dirac), mSloppy(diracSloppy), mPre(diracPre);
-    SolverParam solverParam(*param);
+    SolverParam solverParam(hostSolverParam);
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
     solverParam.updateInvertParam(*param);
     delete solve;
   } else {
     DiracMdagM m(dirac), mSloppy(diracSloppy), mPre(diracPre);
-    SolverParam solverParam(*param);
+    SolverParam solverParam(hostSolverParam);
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
     solverParam.updateInvertParam(*param);
     delete solve;
   }
 
-  if (getVerbosity() >= QUDA_VERBOSE){
-    double nx = norm2(*x);
-    printfQuda("Solution = %g\n",nx);
-  }
   dirac.reconstruct(*x, *b, param->solution_type);
 
   if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
     // rescale the solution
-    axCuda(sqrt(nb), *x);
+    blas::ax(sqrt(nb), *x);
   }
 
   profileInvert.Start(QUDA_PROFILE_D2H);
@@ -1443,9 +1717,8 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
   profileInvert.Stop(QUDA_PROFILE_D2H);
 
   if (getVerbosity() >= QUDA_VERBOSE){
-    double nx = norm2(*x);
-    double nh_x = norm2(*h_x);
-    printfQuda("Reconstructed: CUDA solution = %g, CPU copy = %g\n", nx, nh_x);
+    double nx = blas::norm2(*x);
+    printfQuda("Reconstructed solution = %g\n", nx);
   }
 
   delete h_b;
@@ -1456,17 +1729,686 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
   delete d;
   delete dSloppy;
   delete dPre;
+}
 
-  popVerbosity();
+/*!
+ * The resident chronological bases, one per stream of related solves
+ * (QudaInvertParam::chrono_index).  The basis survives changes of
+ * the gauge field and of the mass parameters, in which case the
+ * products A p are either recomputed (chrono_refresh), costing
+ * chrono_max_dim operator applications, or kept as they are.
+ */
+struct ChronoResident {
+  QudaInvertParam param; // the parameters of the last solve using the basis
+  int generation;        // fieldGeneration at the last solve using the basis
+  int volume;            // the checkerboard volume of the basis vectors
+  ChronoBasis *basis;
+};
 
-  // FIXME: added temporarily so that the cache is written out even if a long benchmarking job gets interrupted
-  saveTuneCache(getVerbosity());
+static ChronoResident chronoResident[QUDA_MAX_CHRONO];
 
-  profileInvert.Stop(QUDA_PROFILE_TOTAL);
+static void flushChrono(int index)
+{
+  if (chronoResident[index].basis) delete chronoResident[index].basis;
+  chronoResident[index].basis = NULL;
+}
+
+static ChronoBasis* chronoBasis(QudaInvertParam *param, const DiracMatrix &m, const cudaColorSpinorField &in)
+{
+  if (param->chrono_index < 0 || param->chrono_index >= QUDA_MAX_CHRONO)
+    errorQuda("chrono_index = %d is not in the range [0, %d)", param->chrono_index, QUDA_MAX_CHRONO);
+  ChronoResident &r = chronoResident[param->chrono_index];
+
+  // the basis vectors must have the layout and precision of the solve
+  const QudaInvertParam &p = r.param;
+  if (r.basis && (param->dslash_type != p.dslash_type || param->solve_type != p.solve_type ||
+		  param->solution_type != p.solution_type || param->matpc_type != p.matpc_type ||
+		  param->cuda_prec != p.cuda_prec || param->Ls != p.Ls ||
+		  param->chrono_max_dim != p.chrono_max_dim || in.VolumeCB() != r.volume)) {
+    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Flushing chronological basis %d\n", param->chrono_index);
+    flushChrono(param->chrono_index);
+  }
+
+  if (!r.basis) {
+    r.basis = new ChronoBasis(param->chrono_max_dim);
+  } else if (r.generation != fieldGeneration || param->kappa != p.kappa || param->mass != p.mass ||
+	     param->mu != p.mu || param->epsilon != p.epsilon || param->m5 != p.m5 ||
+	     param->twist_flavor != p.twist_flavor || param->dagger != p.dagger) {
+    // the operator has changed: with stale products the guess is approximate, but still costs nothing
+    if (param->chrono_refresh) r.basis->refresh(m);
+  }
+
+  r.param = *param;
+  r.generation = fieldGeneration;
+  r.volume = in.VolumeCB();
+
+  return r.basis;
+}
+
+/*!
+ * The state that can be kept between solves with the same operator:
+ * the Dirac operators, the solvers and the device source and
+ * solution fields.  The operators are rebuilt if the resident gauge
+ * or clover fields change.
+ */
+struct InvertContext {
+  QudaInvertParam param; // the parameters the context was created with
+  int generation;        // fieldGeneration when the operators were created
+  int X[4];              // the full lattice dimensions
+
+  Dirac *d;
+  Dirac *dSloppy;
+  Dirac *dPre;
+
+  DiracMatrix *m, *mSloppy, *mPre; // the operator of the main solve
+  DiracMatrix *mdag, *mdagSloppy, *mdagPre; // A^dag, for the first pass of a two-pass solve
+
+  SolverParam *solverParam;
+  Solver *solve;
+  Solver *solveDag;
+
+  cudaColorSpinorField *b;
+  cudaColorSpinorField *x;
+};
+
+static void createInvertOperators(InvertContext &ctx)
+{
+  QudaInvertParam &param = ctx.param;
+
+  bool pc_solve = (param.solve_type == QUDA_DIRECT_PC_SOLVE) ||
+    (param.solve_type == QUDA_NORMOP_PC_SOLVE);
+  bool mat_solution = (param.solution_type == QUDA_MAT_SOLUTION) ||
+    (param.solution_type ==  QUDA_MATPC_SOLUTION);
+  bool direct_solve = (param.solve_type == QUDA_DIRECT_SOLVE) ||
+    (param.solve_type == QUDA_DIRECT_PC_SOLVE);
+
+  // create the dirac operator
+  createDirac(ctx.d, ctx.dSloppy, ctx.dPre, param, pc_solve);
+
+  ctx.solverParam = new SolverParam(param);
+
+  if (direct_solve) {
+    ctx.m = new DiracM(*ctx.d);
+    ctx.mSloppy = new DiracM(*ctx.dSloppy);
+    ctx.mPre = new DiracM(*ctx.dPre);
+  } else {
+    ctx.m = new DiracMdagM(*ctx.d);
+    ctx.mSloppy = new DiracMdagM(*ctx.dSloppy);
+    ctx.mPre = new DiracMdagM(*ctx.dPre);
+  }
+  ctx.solve = Solver::create(*ctx.solverParam, *ctx.m, *ctx.mSloppy, *ctx.mPre, profileInvert);
+
+  ctx.mdag = ctx.mdagSloppy = ctx.mdagPre = NULL;
+  ctx.solveDag = NULL;
+  if (!mat_solution && direct_solve) {
+    ctx.mdag = new DiracMdag(*ctx.d);
+    ctx.mdagSloppy = new DiracMdag(*ctx.dSloppy);
+    ctx.mdagPre = new DiracMdag(*ctx.dPre);
+    ctx.solveDag = Solver::create(*ctx.solverParam, *ctx.mdag, *ctx.mdagSloppy, *ctx.mdagPre, profileInvert);
+  }
+
+  ctx.generation = fieldGeneration;
+}
+
+static void destroyInvertOperators(InvertContext &ctx)
+{
+  if (ctx.solveDag) delete ctx.solveDag;
+  if (ctx.mdagPre) delete ctx.mdagPre;
+  if (ctx.mdagSloppy) delete ctx.mdagSloppy;
+  if (ctx.mdag) delete ctx.mdag;
+
+  delete ctx.solve;
+  delete ctx.mPre;
+  delete ctx.mSloppy;
+  delete ctx.m;
+  delete ctx.solverParam;
+
+  delete ctx.d;
+  delete ctx.dSloppy;
+  delete ctx.dPre;
+}
+
+static InvertContext* createInvertContext(QudaInvertParam *param)
+{
+  // check the gauge fields have been created
+  cudaGaugeField *cudaGauge = checkGauge(param);
+
+  checkInvertParam(param);
+
+  if (param->solver_location == QUDA_CPU_FIELD_LOCATION)
+    errorQuda("Solver contexts are not supported with solver_location = QUDA_CPU_FIELD_LOCATION");
+
+  // It was probably a bad design decision to encode whether the system is even/odd preconditioned (PC) in
+  // solve_type and solution_type, rather than in separate members of QudaInvertParam.  We're stuck with it
+  // for now, though, so here we factorize everything for convenience.
+
+  bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) || 
+    (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+  bool pc_solve = (param->solve_type == QUDA_DIRECT_PC_SOLVE) || 
+    (param->solve_type == QUDA_NORMOP_PC_SOLVE);
+  bool mat_solution = (param->solution_type == QUDA_MAT_SOLUTION) || 
+    (param->solution_type ==  QUDA_MATPC_SOLUTION);
+
+  // solution_type specifies *what* system is to be solved.
+  // solve_type specifies *how* the system is to be solved.
+  //
+  // We have the following four cases (plus preconditioned variants):
+  //
+  // solution_type    solve_type    Effect
+  // -------------    ----------    ------
+  // MAT              DIRECT        Solve Ax=b
+  // MATDAG_MAT       DIRECT        Solve A^dag y = b, followed by Ax=y
+  // MAT              NORMOP        Solve (A^dag A) x = (A^dag b)
+  // MATDAG_MAT       NORMOP        Solve (A^dag A) x = b
+  //
+  // We generally require that the solution_type and solve_type
+  // preconditioning match.  As an exception, the unpreconditioned MAT
+  // solution_type may be used with any solve_type, including
+  // DIRECT_PC and NORMOP_PC.  In these cases, preparation of the
+  // preconditioned source and reconstruction of the full solution are
+  // taken care of by Dirac::prepare() and Dirac::reconstruct(),
+  // respectively.
+
+  if (pc_solution && !pc_solve) {
+    errorQuda("Preconditioned (PC) solution_type requires a PC solve_type");
+  }
+
+  if (!mat_solution && !pc_solution && pc_solve) {
+    errorQuda("Unpreconditioned MATDAG_MAT solution_type requires an unpreconditioned solve_type");
+  }
+
+  param->spinorGiB = cudaGauge->VolumeCB() * spinorSiteSize;
+  if (!pc_solve) param->spinorGiB *= 2;
+  param->spinorGiB *= (param->cuda_prec == QUDA_DOUBLE_PRECISION ? sizeof(double) : sizeof(float));
+  if (param->preserve_source == QUDA_PRESERVE_SOURCE_NO) {
+    param->spinorGiB *= (param->inv_type == QUDA_CG_INVERTER ? 5 : 7)/(double)(1<<30);
+  } else {
+    param->spinorGiB *= (param->inv_type == QUDA_CG_INVERTER ? 8 : 9)/(double)(1<<30);
+  }
+
+  InvertContext *ctx = new InvertContext;
+  ctx->param = *param;
+  for (int d=0; d<4; d++) ctx->X[d] = cudaGauge->X()[d];
+
+  createInvertOperators(*ctx);
+
+  // allocate the device source and solution
+  ColorSpinorParam cpuParam(NULL, *param, ctx->X, pc_solution);
+  ColorSpinorParam cudaParam(cpuParam, *param);
+  cudaParam.create = QUDA_NULL_FIELD_CREATE;
+  ctx->b = new cudaColorSpinorField(cudaParam);
+  ctx->x = new cudaColorSpinorField(cudaParam);
+
+  return ctx;
+}
+
+static void destroyInvertContext(InvertContext *ctx)
+{
+  delete ctx->b;
+  delete ctx->x;
+
+  destroyInvertOperators(*ctx);
+
+  delete ctx;
+}
+
+static void invertContext(InvertContext &ctx, void *hp_x, void *hp_b, QudaInvertParam *param)
+{
+  // the operator, the solver and the field layout are fixed when the context is created
+  const QudaInvertParam &p = ctx.param;
+  if (param->dslash_type != p.dslash_type || param->inv_type != p.inv_type ||
+      param->inv_type_precondition != p.inv_type_precondition ||
+      param->solve_type != p.solve_type || param->solution_type != p.solution_type ||
+      param->matpc_type != p.matpc_type || param->dagger != p.dagger ||
+      param->mass_normalization != p.mass_normalization ||
+      param->kappa != p.kappa || param->mass != p.mass || param->mu != p.mu || param->m5 != p.m5 ||
+      param->Ls != p.Ls || param->twist_flavor != p.twist_flavor ||
+      param->cpu_prec != p.cpu_prec || param->cuda_prec != p.cuda_prec ||
+      param->cuda_prec_sloppy != p.cuda_prec_sloppy ||
+      param->cuda_prec_precondition != p.cuda_prec_precondition ||
+      param->dirac_order != p.dirac_order || param->gamma_basis != p.gamma_basis ||
+      param->sp_pad != p.sp_pad || param->gcrNkrylov != p.gcrNkrylov ||
+      param->precondition_cycle != p.precondition_cycle || param->schwarz_type != p.schwarz_type ||
+      param->tol_precondition != p.tol_precondition || param->maxiter_precondition != p.maxiter_precondition ||
+      param->omega != p.omega)
+    errorQuda("Invert parameters do not match those the solver context was created with");
+
+  bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) || 
+    (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+  bool mat_solution = (param->solution_type == QUDA_MAT_SOLUTION) || 
+    (param->solution_type ==  QUDA_MATPC_SOLUTION);
+  bool direct_solve = (param->solve_type == QUDA_DIRECT_SOLVE) || 
+    (param->solve_type == QUDA_DIRECT_PC_SOLVE);
+
+  // the resident gauge or clover field has changed since the operators were created
+  if (ctx.generation != fieldGeneration) {
+    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Rebuilding the solver context operators\n");
+    checkGauge(param);
+    destroyInvertOperators(ctx);
+    createInvertOperators(ctx);
+  }
+
+  param->secs = 0;
+  param->gflops = 0;
+  param->iter = 0;
+
+  // the tolerances and iteration limits may change between solves
+  *ctx.solverParam = SolverParam(*param);
+
+  Dirac &dirac = *ctx.d;
+  cudaColorSpinorField *b = ctx.b;
+  cudaColorSpinorField *x = ctx.x;
+  cudaColorSpinorField *in = NULL;
+  cudaColorSpinorField *out = NULL;
+
+  profileInvert.Start(QUDA_PROFILE_H2D);
+
+  // wrap CPU host side pointers
+  ColorSpinorParam cpuParam(hp_b, *param, ctx.X, pc_solution);
+  ColorSpinorField *h_b = (param->input_location == QUDA_CPU_FIELD_LOCATION) ?
+    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
+    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
+
+  cpuParam.v = hp_x;
+  ColorSpinorField *h_x = (param->output_location == QUDA_CPU_FIELD_LOCATION) ?
+    static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) : 
+    static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
+
+  // download source
+  *b = *h_b;
+
+  if (param->use_init_guess == QUDA_USE_INIT_GUESS_YES) { // download initial guess
+    // initial guess only supported for single-pass solvers
+    if ((param->solution_type == QUDA_MATDAG_MAT_SOLUTION || param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION) &&
+        (param->solve_type == QUDA_DIRECT_SOLVE || param->solve_type == QUDA_DIRECT_PC_SOLVE)) {
+      errorQuda("Initial guess not supported for two-pass solver");
+    }
+
+    *x = *h_x; // solution
+  } else { // zero initial guess
+    zeroCuda(*x); // solution
+  }
+
+  // the chronological basis minimizes the residual of a Hermitian operator
+  bool chrono = param->chrono_use_resident || param->chrono_make_resident;
+  if (chrono && direct_solve)
+    errorQuda("Chronological initial guess requires a NORMOP or NORMOP_PC solve_type");
+
+  profileInvert.Stop(QUDA_PROFILE_H2D);
+
+  double nb = norm2(*b);
+  if (nb==0.0) errorQuda("Solution has zero norm");
+
+  if (getVerbosity() >= QUDA_VERBOSE) {
+    double nh_b = norm2(*h_b);
+    double nh_x = norm2(*h_x);
+    double nx = norm2(*x);
+    printfQuda("Source: CPU = %g, CUDA copy = %g\n", nh_b, nb);
+    printfQuda("Solution: CPU = %g, CUDA copy = %g\n", nh_x, nx);
+  }
+
+  // rescale the source and solution vectors to help prevent the onset of underflow
+  if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+    axCuda(1.0/sqrt(nb), *b);
+    axCuda(1.0/sqrt(nb), *x);
+  }
+
+  setTuning(param->tune);
+
+  dirac.prepare(in, out, *x, *b, param->solution_type);
+  if (getVerbosity() >= QUDA_VERBOSE) {
+    double nin = norm2(*in);
+    double nout = norm2(*out);
+    printfQuda("Prepared source = %g\n", nin);   
+    printfQuda("Prepared solution = %g\n", nout);   
+  }
+
+  massRescale(param->dslash_type, param->kappa, param->solution_type, param->mass_normalization, *in);
+
+  if (getVerbosity() >= QUDA_VERBOSE) {
+    double nin = norm2(*in);
+    printfQuda("Prepared source post mass rescale = %g\n", nin);   
+  }
+
+  if (mat_solution && !direct_solve) { // prepare source: b' = A^dag b
+    cudaColorSpinorField tmp(*in);
+    dirac.Mdag(*in, tmp);
+  } else if (!mat_solution && direct_solve) { // perform the first of two solves: A^dag y = b
+    (*ctx.solveDag)(*out, *in);
+    copyCuda(*in, *out);
+    ctx.solverParam->updateInvertParam(*param);
+    *ctx.solverParam = SolverParam(*param);
+  }
+
+  ChronoBasis *basis = chrono ? chronoBasis(param, *ctx.m, *in) : NULL;
+  if (param->chrono_use_resident && basis->Dim() > 0) {
+    basis->guess(*out, *in);
+    ctx.solverParam->use_init_guess = QUDA_USE_INIT_GUESS_YES;
+  }
+
+  (*ctx.solve)(*out, *in);
+  ctx.solverParam->updateInvertParam(*param);
+
+  if (param->chrono_make_resident) basis->add(*out, *ctx.m);
+
+  if (getVerbosity() >= QUDA_VERBOSE){
+    double nx = norm2(*x);
+    printfQuda("Solution = %g\n",nx);
+  }
+  dirac.reconstruct(*x, *b, param->solution_type);
+
+  if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+    // rescale the solution
+    axCuda(sqrt(nb), *x);
+  }
+
+  profileInvert.Start(QUDA_PROFILE_D2H);
+  *h_x = *x;
+  profileInvert.Stop(QUDA_PROFILE_D2H);
+
+  if (getVerbosity() >= QUDA_VERBOSE){
+    double nx = norm2(*x);
+    double nh_x = norm2(*h_x);
+    printfQuda("Reconstructed: CUDA solution = %g, CPU copy = %g\n", nx, nh_x);
+  }
+
+  delete h_b;
+  delete h_x;
+}
+
+void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
+{
+
+  if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
+
+  profileInvert.Start(QUDA_PROFILE_TOTAL);
+
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  pushVerbosity(param->verbosity);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(param);
+
+  if (param->solver_location == QUDA_CPU_FIELD_LOCATION) {
+    // check the host gauge fields have been created
+    checkHostGauge(param);
+    checkInvertParam(param);
+
+    invertHostQuda(hp_x, hp_b, param);
+    popVerbosity();
+    profileInvert.Stop(QUDA_PROFILE_TOTAL);
+    return;
+  }
+
+  InvertContext *ctx = createInvertContext(param);
+  invertContext(*ctx, hp_x, hp_b, param);
+  destroyInvertContext(ctx);
+
+  popVerbosity();
+
+  // FIXME: added temporarily so that the cache is written out even if a long benchmarking job gets interrupted
+  saveTuneCache(getVerbosity());
+
+  profileInvert.Stop(QUDA_PROFILE_TOTAL);
+}
+
+void* newInvertContextQuda(QudaInvertParam *param)
+{
+  if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
+
+  profileInvert.Start(QUDA_PROFILE_TOTAL);
+
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  pushVerbosity(param->verbosity);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(param);
+
+  InvertContext *ctx = createInvertContext(param);
+
+  popVerbosity();
+
+  profileInvert.Stop(QUDA_PROFILE_TOTAL);
+
+  return static_cast<void*>(ctx);
+}
+
+void invertContextQuda(void *context, void *hp_x, void *hp_b, QudaInvertParam *param)
+{
+  if (!context) errorQuda("Invalid solver context");
+  if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
+
+  profileInvert.Start(QUDA_PROFILE_TOTAL);
+
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  pushVerbosity(param->verbosity);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(param);
+
+  invertContext(*static_cast<InvertContext*>(context), hp_x, hp_b, param);
+
+  popVerbosity();
+
+  profileInvert.Stop(QUDA_PROFILE_TOTAL);
+}
+
+void destroyInvertContextQuda(void *context)
+{
+  if (!context) errorQuda("Invalid solver context");
+  destroyInvertContext(static_cast<InvertContext*>(context));
+
+  // write out anything tuned while the context was alive
+  saveTuneCache(getVerbosity());
+}
+
+void flushChronoQuda(int index)
+{
+  if (index < -1 || index >= QUDA_MAX_CHRONO)
+    errorQuda("chrono index = %d is not in the range [-1, %d)", index, QUDA_MAX_CHRONO);
+
+  if (index == -1) {
+    for (int i=0; i<QUDA_MAX_CHRONO; i++) flushChrono(i);
+  } else {
+    flushChrono(index);
+  }
+}
+
+
+/*!
+ * Solve for nrhs sources with block CG, sharing the operator
+ * applications and the Krylov space between the sources.  This works
+ * for either host or device fields; fieldParam describes the layout
+ * of the fields the solver works on.
+ */
+template <typename Field, typename DiracType>
+static void invertBlock(void **hp_x, void **hp_b, const int nrhs, QudaInvertParam *param,
+			DiracType &dirac, DiracType &diracSloppy, ColorSpinorParam &fieldParam,
+			SolverParam &solverParam, const int *X, bool pc_solution)
+{
+  bool mat_solution = (param->solution_type == QUDA_MAT_SOLUTION) ||
+    (param->solution_type ==  QUDA_MATPC_SOLUTION);
+
+  std::vector<ColorSpinorField*> h_b(nrhs), h_x(nrhs);
+  std::vector<Field*> b(nrhs), x(nrhs), in(nrhs), out(nrhs);
+  std::vector<double> nb(nrhs);
+
+  profileBlock.Start(QUDA_PROFILE_H2D);
+
+  for (int i=0; i<nrhs; i++) {
+    // wrap the user's pointers
+    ColorSpinorParam cpuParam(hp_b[i], *param, X, pc_solution);
+    h_b[i] = (param->input_location == QUDA_CPU_FIELD_LOCATION) ?
+      static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) :
+      static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
+
+    cpuParam.v = hp_x[i];
+    h_x[i] = (param->output_location == QUDA_CPU_FIELD_LOCATION) ?
+      static_cast<ColorSpinorField*>(new cpuColorSpinorField(cpuParam)) :
+      static_cast<ColorSpinorField*>(new cudaColorSpinorField(cpuParam));
+
+    fieldParam.create = QUDA_COPY_FIELD_CREATE;
+    b[i] = new Field(*h_b[i], fieldParam);
+    if (param->use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+      x[i] = new Field(*h_x[i], fieldParam);
+    } else {
+      fieldParam.create = QUDA_ZERO_FIELD_CREATE;
+      x[i] = new Field(fieldParam);
+    }
+  }
+
+  profileBlock.Stop(QUDA_PROFILE_H2D);
+
+  for (int i=0; i<nrhs; i++) {
+    nb[i] = blas::norm2(*b[i]);
+    if (nb[i]==0.0) errorQuda("Source %d has zero norm", i);
+
+    // rescale the source and solution vectors to help prevent the onset of underflow
+    if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+      blas::ax(1.0/sqrt(nb[i]), *b[i]);
+      blas::ax(1.0/sqrt(nb[i]), *x[i]);
+    }
+
+    dirac.prepare(in[i], out[i], *x[i], *b[i], param->solution_type);
+    massRescale(param->dslash_type, param->kappa, param->solution_type, param->mass_normalization, *in[i]);
+
+    if (mat_solution) { // prepare source: b' = A^dag b
+      Field tmp(*in[i]);
+      dirac.Mdag(*in[i], tmp);
+    }
+  }
+
+  if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Prepared %d sources\n", nrhs);
+
+  DiracMdagM m(dirac), mSloppy(diracSloppy);
+  BlockCG solve(m, mSloppy, solverParam, profileBlock);
+  solve(&out[0], &in[0], nrhs);
+
+  solverParam.num_offset = std::min(nrhs, QUDA_MAX_MULTI_SHIFT);
+  solverParam.updateInvertParam(*param);
+
+  for (int i=0; i<nrhs; i++) {
+    dirac.reconstruct(*x[i], *b[i], param->solution_type);
+
+    if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+      // rescale the solution
+      blas::ax(sqrt(nb[i]), *x[i]);
+    }
+  }
+
+  profileBlock.Start(QUDA_PROFILE_D2H);
+  for (int i=0; i<nrhs; i++) *h_x[i] = *x[i];
+  profileBlock.Stop(QUDA_PROFILE_D2H);
+
+  for (int i=0; i<nrhs; i++) {
+    delete h_b[i];
+    delete h_x[i];
+    delete b[i];
+    delete x[i];
+  }
+}
+
+void invertBlockQuda(void **hp_x, void **hp_b, int nrhs, QudaInvertParam *param)
+{
+  if (param->dslash_type == QUDA_DOMAIN_WALL_DSLASH) setKernelPackT(true);
+
+  profileBlock.Start(QUDA_PROFILE_TOTAL);
+
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  pushVerbosity(param->verbosity);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(param);
+
+  // check the gauge fields have been created
+  if (param->solver_location == QUDA_CPU_FIELD_LOCATION) checkHostGauge(param);
+  else checkGauge(param);
+
+  checkInvertParam(param);
+
+  if (nrhs < 1) errorQuda("Invalid number of right-hand sides %d", nrhs);
+
+  if (param->inv_type != QUDA_CG_INVERTER)
+    errorQuda("Block solver only supports CG, not inv_type %d", param->inv_type);
+
+  if (param->solve_type != QUDA_NORMOP_SOLVE && param->solve_type != QUDA_NORMOP_PC_SOLVE)
+    errorQuda("Block solver requires a NORMOP or NORMOP_PC solve_type, not %d", param->solve_type);
+
+  bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) ||
+    (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+  bool pc_solve = (param->solve_type == QUDA_NORMOP_PC_SOLVE);
+  bool mat_solution = (param->solution_type == QUDA_MAT_SOLUTION) ||
+    (param->solution_type ==  QUDA_MATPC_SOLUTION);
+
+  if (pc_solution && !pc_solve) {
+    errorQuda("Preconditioned (PC) solution_type requires a PC solve_type");
+  }
+
+  if (!mat_solution && !pc_solution && pc_solve) {
+    errorQuda("Unpreconditioned MATDAG_MAT solution_type requires an unpreconditioned solve_type");
+  }
+
+  param->secs = 0;
+  param->gflops = 0;
+  param->iter = 0;
+
+  if (param->solver_location == QUDA_CPU_FIELD_LOCATION) {
+    DiracParam diracParam;
+    DiracParam diracSloppyParam;
+    setDiracParam(diracParam, param, pc_solve);
+    setDiracSloppyParam(diracSloppyParam, param, pc_solve);
+
+    cpuDirac *d = cpuDirac::create(diracParam);
+    cpuDirac *dSloppy = cpuDirac::create(diracSloppyParam);
+
+    const int *X = gaugeHostPrecise->X();
+
+    // the host operators work in space-spin-color order and the DeGrand-Rossi basis
+    ColorSpinorParam hostParam(hp_b[0], *param, X, pc_solution);
+    hostParam.v = 0;
+    hostParam.precision = param->cpu_prec;
+    hostParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    hostParam.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+    hostParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+
+    SolverParam solverParam(*param);
+    solverParam.precision = param->cpu_prec;
+    solverParam.precision_sloppy = param->cuda_prec_sloppy;
+    solverParam.precision_precondition = param->cuda_prec_precondition;
+
+    invertBlock<cpuColorSpinorField>(hp_x, hp_b, nrhs, param, *d, *dSloppy, hostParam, solverParam, X, pc_solution);
+
+    delete d;
+    delete dSloppy;
+  } else {
+    Dirac *d = NULL;
+    Dirac *dSloppy = NULL;
+    Dirac *dPre = NULL;
+
+    // create the dirac operator
+    createDirac(d, dSloppy, dPre, *param, pc_solve);
+
+    const int *X = checkGauge(param)->X();
+
+    ColorSpinorParam cpuParam(hp_b[0], *param, X, pc_solution);
+    ColorSpinorParam cudaParam(cpuParam, *param);
+
+    setTuning(param->tune);
+
+    SolverParam solverParam(*param);
+    invertBlock<cudaColorSpinorField>(hp_x, hp_b, nrhs, param, *d, *dSloppy, cudaParam, solverParam, X, pc_solution);
+
+    delete d;
+    delete dSloppy;
+    delete dPre;
+  }
+
+  popVerbosity();
+
+  // FIXME: added temporarily so that the cache is written out even if a long benchmarking job gets interrupted
+  saveTuneCache(getVerbosity());
+
+  profileBlock.Stop(QUDA_PROFILE_TOTAL);
 }
 
 
-/*! 
+/*!
  * Generic version of the multi-shift solver. Should work for
  * most fermions. Note that offset[0] is not folded into the mass parameter.
  *
@@ -17,10 +17,11 @@ namespace quda {
   // set the required parameters for the inner solver
   void fillInnerSolveParam(SolverParam &inner, const SolverParam &outer);
 
-  double resNorm(const DiracMatrix &mat, cudaColorSpinorField &b, cudaColorSpinorField &x) {  
-    cudaColorSpinorField r(b);
+  template <typename Field>
+  double resNorm(const DiracMatrix &mat, Field &b, Field &x) {  
+    Field r(b);
     mat(r, x);
-    return xmyNormCuda(b, r);
+    return blas::xmyNorm(b, r);
   }
 
 
@@ -31,7 +32,11 @@ namespace quda {
 
   BiCGstab::~BiCGstab() {
     profile.Start(QUDA_PROFILE_FREE);
+    freeFields();
+    profile.Stop(QUDA_PROFILE_FREE);
+  }
 
+  void BiCGstab::freeFields() {
     if(init) {
       delete yp;
       delete rp;
@@ -39,9 +44,8 @@ namespace quda {
       delete vp;
       delete tmpp;
       delete tp;
+      init = false;
     }
-
-    profile.Stop(QUDA_PROFILE_FREE);
   }
 
   int reliable(double &rNorm, double &maxrx, double &maxrr, const double &r2, const double &delta) {
@@ -58,43 +62,47 @@ namespace quda {
     return updateR;
   }
 
-  void BiCGstab::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b) 
+  template <typename Field>
+  void BiCGstab::solve(Field &x, Field &b)
   {
     profile.Start(QUDA_PROFILE_PREAMBLE);
 
+    // the cached fields must reside where the solve is done
+    if (init && yp->Location() != x.Location()) freeFields();
+
     if (!init) {
       ColorSpinorParam csParam(x);
       csParam.create = QUDA_ZERO_FIELD_CREATE;
-      yp = new cudaColorSpinorField(x, csParam);
-      rp = new cudaColorSpinorField(x, csParam); 
-      csParam.setPrecision(param.precision_sloppy);
-      pp = new cudaColorSpinorField(x, csParam);
-      vp = new cudaColorSpinorField(x, csParam);
-      tmpp = new cudaColorSpinorField(x, csParam);
-      tp = new cudaColorSpinorField(x, csParam);
+      yp = new Field(x, csParam);
+      rp = new Field(x, csParam); 
+      csParam.setPrecision(param.precision_sloppy, x.Location());
+      pp = new Field(x, csParam);
+      vp = new Field(x, csParam);
+      tmpp = new Field(x, csParam);
+      tp = new Field(x, csParam);
 
       init = true;
     }
 
-    cudaColorSpinorField &y = *yp;
-    cudaColorSpinorField &r = *rp; 
-    cudaColorSpinorField &p = *pp;
-    cudaColorSpinorField &v = *vp;
-    cudaColorSpinorField &tmp = *tmpp;
-    cudaColorSpinorField &t = *tp;
+    Field &y = static_cast<Field&>(*yp);
+    Field &r = static_cast<Field&>(*rp); 
+    Field &p = static_cast<Field&>(*pp);
+    Field &v = static_cast<Field&>(*vp);
+    Field &tmp = static_cast<Field&>(*tmpp);
+    Field &t = static_cast<Field&>(*tp);
 
-    cudaColorSpinorField *x_sloppy, *r_sloppy, *r_0;
+    Field *x_sloppy, *r_sloppy, *r_0;
 
-    double b2 = normCuda(b); // norm sq of source
+    double b2 = blas::norm2(b); // norm sq of source
     double r2;               // norm sq of residual
 
     // compute initial residual depending on whether we have an initial guess or not
     if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
       mat(r, x, y);
-      r2 = xmyNormCuda(b, r);
-      copyCuda(y, x);
+      r2 = blas::xmyNorm(b, r);
+      blas::copy(y, x);
     } else {
-      copyCuda(r, b);
+      blas::copy(r, b);
       r2 = b2;
     }
 
@@ -113,21 +121,21 @@ namespace quda {
       x_sloppy = &x;
       r_sloppy = &r;
       r_0 = &b;
-      zeroCuda(*x_sloppy);
+      blas::zero(*x_sloppy);
     } else {
       ColorSpinorParam csParam(x);
       csParam.create = QUDA_ZERO_FIELD_CREATE;
-      csParam.setPrecision(param.precision_sloppy);
-      x_sloppy = new cudaColorSpinorField(x, csParam);
+      csParam.setPrecision(param.precision_sloppy, x.Location());
+      x_sloppy = new Field(x, csParam);
       csParam.create = QUDA_COPY_FIELD_CREATE;
-      r_sloppy = new cudaColorSpinorField(r, csParam);
-      r_0 = new cudaColorSpinorField(b, csParam);
+      r_sloppy = new Field(r, csParam);
+      r_0 = new Field(b, csParam);
     }
 
     // Syntatic sugar
-    cudaColorSpinorField &rSloppy = *r_sloppy;
-    cudaColorSpinorField &xSloppy = *x_sloppy;
-    cudaColorSpinorField &r0 = *r_0;
+    Field &rSloppy = *r_sloppy;
+    Field &xSloppy = *x_sloppy;
+    Field &r0 = *r_0;
 
     SolverParam solve_param_inner(param);
     fillInnerSolveParam(solve_param_inner, param);
@@ -136,7 +144,7 @@ namespace quda {
 
     const bool use_heavy_quark_res = 
       (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) ? true : false;
-    double heavy_quark_res = use_heavy_quark_res ? sqrt(HeavyQuarkResidualNormCuda(x,r).z) : 0.0;
+    double heavy_quark_res = use_heavy_quark_res ? sqrt(blas::HeavyQuarkResidualNorm(x,r).z) : 0.0;
     int heavy_quark_check = 10; // how often to check the heavy quark residual
 
     double delta = param.delta;
@@ -168,7 +176,7 @@ namespace quda {
     profile.Start(QUDA_PROFILE_COMPUTE);
     
     rho = r2; // cDotProductCuda(r0, r_sloppy); // BiCRstab
-    copyCuda(p, rSloppy);
+    blas::copy(p, rSloppy);
 
     if (getVerbosity() >= QUDA_DEBUG_VERBOSE) 
       printfQuda("BiCGstab debug: x2=%e, r2=%e, v2=%e, p2=%e, tmp2=%e r0=%e t2=%e\n", 
@@ -181,28 +189,40 @@ namespace quda {
 
       Complex r0v;
       if (param.pipeline) {
-	r0v = cDotProductCuda(r0, v);
-	if (k>0) rho = cDotProductCuda(r0, r);
+	ReduceBatch batch;
+	r0v = blas::cDotProduct(r0, v);
+	batch.add(r0v);
+	if (k>0) {
+	  rho = blas::cDotProduct(r0, rSloppy);
+	  batch.add(rho);
+	}
+	batch.flush();
       } else {
-	r0v = cDotProductCuda(r0, v);
+	r0v = blas::cDotProduct(r0, v);
       }
       if (abs(rho) == 0.0) alpha = 0.0;
       else alpha = rho / r0v;
 
       // r -= alpha*v
-      caxpyCuda(-alpha, v, rSloppy);
+      blas::caxpy(-alpha, v, rSloppy);
 
       matSloppy(t, rSloppy, tmp);
     
       int updateR = 0;
       if (param.pipeline) {
 	// omega = (t, r) / (t, t)
-	omega_t2 = cDotProductNormACuda(t, rSloppy);
+	ReduceBatch batch;
+	omega_t2 = blas::cDotProductNormA(t, rSloppy);
+	double s2 = blas::norm2(rSloppy);
+	Complex r0t = blas::cDotProduct(r0, t);
+	batch.add(omega_t2);
+	batch.add(s2);
+	batch.add(r0t);
+	batch.flush();
+
 	Complex tr = Complex(omega_t2.x, omega_t2.y);
 	double t2 = omega_t2.z;
 	omega = tr / t2;
-	double s2 = norm2(rSloppy);
-	Complex r0t = cDotProductCuda(r0, t);
 	beta = -r0t / r0v;
 	r2 = s2 - real(omega * conj(tr)) ;
 
@@ -210,18 +230,18 @@ namespace quda {
         updateR = reliable(rNorm, maxrx, maxrr, r2, delta);
       } else {
 	// omega = (t, r) / (t, t)
-	omega_t2 = cDotProductNormACuda(t, rSloppy);
+	omega_t2 = blas::cDotProductNormA(t, rSloppy);
 	omega = Complex(omega_t2.x / omega_t2.z, omega_t2.y / omega_t2.z);
       }
 
       if (param.pipeline && !updateR) {
 	//x += alpha*p + omega*r, r -= omega*t, p = r - beta*omega*v + beta*p
-	caxpbypzYmbwCuda(alpha, p, omega, rSloppy, xSloppy, t);
-	cxpaypbzCuda(rSloppy, -beta*omega, v, beta, p);
+	blas::caxpbypzYmbw(alpha, p, omega, rSloppy, xSloppy, t);
+	blas::cxpaypbz(rSloppy, -beta*omega, v, beta, p);
 	//tripleBiCGstabUpdate(alpha, p, omega, rSloppy, xSloppy, t, -beta*omega, v, beta, p
       } else {
 	//x += alpha*p + omega*r, r -= omega*t, r2 = (r,r), rho = (r0, r)
-	rho_r2 = caxpbypzYmbwcDotProductUYNormYCuda(alpha, p, omega, rSloppy, xSloppy, t, r0);
+	rho_r2 = blas::caxpbypzYmbwcDotProductUYNormY(alpha, p, omega, rSloppy, xSloppy, t, r0);
 
 	rho0 = rho;
 	rho = Complex(rho_r2.x, rho_r2.y);
@@ -229,22 +249,22 @@ namespace quda {
       }
 
       if (use_heavy_quark_res && k%heavy_quark_check==0) { 
-	copyCuda(tmp,y);
-	heavy_quark_res = sqrt(xpyHeavyQuarkResidualNormCuda(xSloppy, tmp, rSloppy).z);
+	blas::copy(tmp,y);
+	heavy_quark_res = sqrt(blas::xpyHeavyQuarkResidualNorm(xSloppy, tmp, rSloppy).z);
       }
 
       if (!param.pipeline) updateR = reliable(rNorm, maxrx, maxrr, r2, delta);
 
       if (updateR) {
-	if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
+	if (x.Precision() != xSloppy.Precision()) blas::copy(x, xSloppy);
       
-	xpyCuda(x, y); // swap these around?
+	blas::xpy(x, y); // swap these around?
 
 	mat(r, y, x);
-	r2 = xmyNormCuda(b, r);
+	r2 = blas::xmyNorm(b, r);
 
-	if (x.Precision() != rSloppy.Precision()) copyCuda(rSloppy, r);            
-	zeroCuda(xSloppy);
+	if (x.Precision() != rSloppy.Precision()) blas::copy(rSloppy, r);            
+	blas::zero(xSloppy);
 
 	rNorm = sqrt(r2);
 	maxrr = rNorm;
@@ -264,13 +284,13 @@ namespace quda {
       if (!param.pipeline || updateR) {// need to update if not pipeline or did a reliable update
 	if (abs(rho*alpha) == 0.0) beta = 0.0;
 	else beta = (rho/rho0) * (alpha/omega);      
-	cxpaypbzCuda(rSloppy, -beta*omega, v, beta, p);
+	blas::cxpaypbz(rSloppy, -beta*omega, v, beta, p);
       }
 
     }
 
-    if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
-    xpyCuda(y, x);
+    if (x.Precision() != xSloppy.Precision()) blas::copy(x, xSloppy);
+    blas::xpy(y, x);
 
     profile.Stop(QUDA_PROFILE_COMPUTE);
     profile.Start(QUDA_PROFILE_EPILOGUE);
@@ -289,9 +309,9 @@ namespace quda {
     if (param.inv_type_precondition != QUDA_GCR_INVERTER) { // do not do the below if we this is an inner solver
       // Calculate the true residual
       mat(r, x);
-      param.true_res = sqrt(xmyNormCuda(b, r) / b2);
+      param.true_res = sqrt(blas::xmyNorm(b, r) / b2);
 #if (__COMPUTE_CAPABILITY__ >= 200)
-      param.true_res_hq = sqrt(HeavyQuarkResidualNormCuda(x,r).z);
+      param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
 #else
       param.true_res_hq = 0.0;
 #endif
@@ -318,4 +338,16 @@ namespace quda {
     return;
   }
 
+  void BiCGstab::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "bicgstab");
+    solve(x, b);
+  }
+
+  void BiCGstab::operator()(cpuColorSpinorField &x, cpuColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "bicgstab");
+    solve(x, b);
+  }
+
 } // namespace quda
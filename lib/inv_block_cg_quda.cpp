@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dslash_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+#include <face_quda.h>
+
+#include <vector>
+#include <algorithm>
+
+namespace quda {
+
+  bool cholesky(std::vector<Complex> &L, const std::vector<Complex> &A, const int m)
+  {
+    double maxDiag = 0.0;
+    for (int i=0; i<m; i++) maxDiag = std::max(maxDiag, fabs(real(A[i*m+i])));
+
+    L.assign(m*m, Complex(0.0, 0.0));
+    for (int j=0; j<m; j++) {
+      double d = real(A[j*m+j]);
+      for (int k=0; k<j; k++) d -= norm(L[j*m+k]);
+      if (d <= 1e-14*maxDiag) return false;
+      L[j*m+j] = sqrt(d);
+
+      for (int i=j+1; i<m; i++) {
+	Complex s = A[i*m+j];
+	for (int k=0; k<j; k++) s -= L[i*m+k] * conj(L[j*m+k]);
+	L[i*m+j] = s / real(L[j*m+j]);
+      }
+    }
+    return true;
+  }
+
+  void choleskySolve(std::vector<Complex> &B, const std::vector<Complex> &L, const int m, const int n)
+  {
+    for (int c=0; c<n; c++) {
+      for (int i=0; i<m; i++) { // forward substitution
+	Complex s = B[i*n+c];
+	for (int k=0; k<i; k++) s -= L[i*m+k] * B[k*n+c];
+	B[i*n+c] = s / real(L[i*m+i]);
+      }
+      for (int i=m-1; i>=0; i--) { // back substitution
+	Complex s = B[i*n+c];
+	for (int k=i+1; k<m; k++) s -= conj(L[k*m+i]) * B[k*n+c];
+	B[i*n+c] = s / real(L[i*m+i]);
+      }
+    }
+  }
+
+  BlockCG::BlockCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
+    Solver(param, profile), mat(mat), matSloppy(matSloppy)
+  {
+
+  }
+
+  BlockCG::~BlockCG() {
+
+  }
+
+  template <typename Field>
+  void BlockCG::solve(Field **x, Field **b, const int nRhs)
+  {
+    profile.Start(QUDA_PROFILE_INIT);
+
+    std::vector<double> b2(nRhs), r2(nRhs), stop(nRhs);
+    std::vector<Field*> r(nRhs), p(nRhs), Ap(nRhs);
+    std::vector<int> active; // the right-hand sides that have not yet converged
+
+    ColorSpinorParam csParam(*x[0]);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    for (int i=0; i<nRhs; i++) {
+      r[i] = new Field(*x[i], csParam);
+      p[i] = new Field(*x[i], csParam);
+      Ap[i] = new Field(*x[i], csParam);
+    }
+
+    // r = b - A x
+    mat(&r[0], x, nRhs);
+    for (int i=0; i<nRhs; i++) {
+      b2[i] = blas::norm2(*b[i]);
+      stop[i] = b2[i]*param.tol*param.tol;
+      r2[i] = blas::xmyNorm(*b[i], *r[i]);
+      if (b2[i] == 0.0) {
+	printfQuda("Warning: inverting on zero-field source %d\n", i);
+	blas::zero(*x[i]);
+	r2[i] = 0.0;
+      }
+      if (r2[i] > stop[i]) active.push_back(i);
+    }
+
+    int m = active.size();
+    for (int j=0; j<m; j++) blas::copy(*p[j], *r[active[j]]);
+
+    std::vector<Complex> pAp, L, alpha, beta, a(nRhs);
+
+    profile.Stop(QUDA_PROFILE_INIT);
+    profile.Start(QUDA_PROFILE_COMPUTE);
+    blas_flops = 0;
+
+    int k = 0;
+    bool breakdown = false;
+
+    while (m > 0 && k < param.maxiter) {
+      mat(&Ap[0], &p[0], m);
+
+      // alpha = (p^dagger A p)^-1 p^dagger r, with the inner products
+      // summed over the nodes together
+      pAp.resize(m*m);
+      alpha.resize(m*m);
+      {
+	ReduceBatch batch;
+	for (int i=0; i<m; i++) {
+	  for (int j=0; j<m; j++) {
+	    pAp[i*m+j] = blas::cDotProduct(*p[i], *Ap[j]);
+	    alpha[i*m+j] = blas::cDotProduct(*p[i], *r[active[j]]);
+	    batch.add(pAp[i*m+j]);
+	    batch.add(alpha[i*m+j]);
+	  }
+	}
+	batch.flush();
+      }
+
+      if (!cholesky(L, pAp, m)) {
+	breakdown = true;
+	break;
+      }
+      choleskySolve(alpha, L, m, m);
+
+      // x += p alpha, r -= A p alpha
+      {
+	ReduceBatch batch;
+	for (int j=0; j<m; j++) {
+	  for (int i=0; i<m; i++) a[i] = alpha[i*m+j];
+	  blas::caxpyBlock(&a[0], &p[0], m, *x[active[j]]);
+	  for (int i=0; i<m; i++) a[i] = -alpha[i*m+j];
+	  blas::caxpyBlock(&a[0], &Ap[0], m, *r[active[j]]);
+	  r2[active[j]] = blas::norm2(*r[active[j]]);
+	  batch.add(r2[active[j]]);
+	}
+	batch.flush();
+      }
+
+      k++;
+
+      // drop the converged right-hand sides from the block
+      std::vector<int> remain;
+      double maxRes = 0.0;
+      for (int j=0; j<m; j++) {
+	const int i = active[j];
+	if (r2[i] > stop[i]) remain.push_back(i);
+	maxRes = std::max(maxRes, sqrt(r2[i]/b2[i]));
+      }
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("BlockCG: %d iterations, %d active, max relative residual = %e\n", k, m, maxRes);
+
+      const int mNew = remain.size();
+      if (mNew == 0) {
+	active.clear();
+	m = 0;
+	break;
+      }
+
+      // beta = -(p^dagger A p)^-1 (A p)^dagger r, which makes the new
+      // search directions conjugate to the current ones
+      beta.resize(m*mNew);
+      {
+	ReduceBatch batch;
+	for (int i=0; i<m; i++) {
+	  for (int j=0; j<mNew; j++) {
+	    beta[i*mNew+j] = -blas::cDotProduct(*Ap[i], *r[remain[j]]);
+	    batch.add(beta[i*mNew+j]);
+	  }
+	}
+	batch.flush();
+      }
+      choleskySolve(beta, L, m, mNew);
+
+      // p = r + p beta, built in the Ap fields which are then swapped in
+      for (int j=0; j<mNew; j++) {
+	blas::copy(*Ap[j], *r[remain[j]]);
+	for (int i=0; i<m; i++) a[i] = beta[i*mNew+j];
+	blas::caxpyBlock(&a[0], &p[0], m, *Ap[j]);
+      }
+      std::swap(p, Ap);
+
+      active = remain;
+      m = mNew;
+    }
+
+    profile.Stop(QUDA_PROFILE_COMPUTE);
+    profile.Start(QUDA_PROFILE_EPILOGUE);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (quda::blas_flops + mat.flops() + matSloppy.flops())*1e-9;
+    reduceDouble(gflops);
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (breakdown) {
+      warningQuda("BlockCG: search directions became linearly dependent after %d iterations, "
+		  "finishing %d right-hand sides with CG", k, m);
+      // the unconverged solutions are used as the initial guess
+      CG cg(mat, matSloppy, param, profile);
+      profile.Stop(QUDA_PROFILE_EPILOGUE);
+      for (int j=0; j<m; j++) cg(*x[active[j]], *b[active[j]]);
+      profile.Start(QUDA_PROFILE_EPILOGUE);
+    } else if (k == param.maxiter) {
+      warningQuda("Exceeded maximum iterations %d", param.maxiter);
+    }
+
+    // compute the true residuals
+    mat(&r[0], x, nRhs);
+    param.true_res = 0.0;
+    param.true_res_hq = 0.0;
+    for (int i=0; i<nRhs; i++) {
+      double res = b2[i] > 0.0 ? sqrt(blas::xmyNorm(*b[i], *r[i]) / b2[i]) : 0.0;
+      if (i < QUDA_MAX_MULTI_SHIFT) param.true_res_offset[i] = res;
+      param.true_res = std::max(param.true_res, res);
+    }
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("BlockCG: Converged %d right-hand sides after %d iterations, max relative residual: true = %e\n",
+		 nRhs, k, param.true_res);
+
+    // reset the flops counters
+    quda::blas_flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.Stop(QUDA_PROFILE_EPILOGUE);
+    profile.Start(QUDA_PROFILE_FREE);
+
+    for (int i=0; i<nRhs; i++) {
+      delete Ap[i];
+      delete p[i];
+      delete r[i];
+    }
+
+    profile.Stop(QUDA_PROFILE_FREE);
+  }
+
+  void BlockCG::operator()(cudaColorSpinorField **x, cudaColorSpinorField **b, const int nRhs)
+  {
+    ProfileRegion region(profile, "block cg");
+    solve(x, b, nRhs);
+  }
+
+  void BlockCG::operator()(cpuColorSpinorField **x, cpuColorSpinorField **b, const int nRhs)
+  {
+    ProfileRegion region(profile, "block cg");
+    solve(x, b, nRhs);
+  }
+
+  void BlockCG::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b)
+  {
+    cudaColorSpinorField *xp = &x, *bp = &b;
+    ProfileRegion region(profile, "block cg");
+    solve(&xp, &bp, 1);
+  }
+
+  void BlockCG::operator()(cpuColorSpinorField &x, cpuColorSpinorField &b)
+  {
+    cpuColorSpinorField *xp = &x, *bp = &b;
+    ProfileRegion region(profile, "block cg");
+    solve(&xp, &bp, 1);
+  }
+
+} // namespace quda
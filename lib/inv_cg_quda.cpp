@@ -26,8 +26,14 @@ namespace quda {
 
   }
 
-  void CG::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b) 
+  template <typename Field>
+  void CG::solve(Field &x, Field &b)
   {
+    if (param.pipeline) {
+      solvePipelined(x, b);
+      return;
+    }
+
     profile.Start(QUDA_PROFILE_INIT);
 
     // Check to see that we're not trying to invert on a zero-field source    
@@ -42,49 +48,51 @@ namespace quda {
     }
 
 
-    cudaColorSpinorField r(b);
+    Field r(b);
 
     ColorSpinorParam csParam(x);
     csParam.create = QUDA_ZERO_FIELD_CREATE;
-    cudaColorSpinorField y(b, csParam); 
+    Field y(b, csParam); 
   
     mat(r, x, y);
 //    zeroCuda(y);
 
-    double r2 = xmyNormCuda(b, r);
+    double r2 = blas::xmyNorm(b, r);
   
-    csParam.setPrecision(param.precision_sloppy);
-    cudaColorSpinorField Ap(x, csParam);
-    cudaColorSpinorField tmp(x, csParam);
+    csParam.setPrecision(param.precision_sloppy, x.Location());
+    Field Ap(x, csParam);
+    Field tmp(x, csParam);
 
-    cudaColorSpinorField *tmp2_p = &tmp;
+    Field *tmp2_p = &tmp;
     // tmp only needed for multi-gpu Wilson-like kernels
     if (mat.Type() != typeid(DiracStaggeredPC).name() && 
-	mat.Type() != typeid(DiracStaggered).name()) {
-      tmp2_p = new cudaColorSpinorField(x, csParam);
+	mat.Type() != typeid(DiracStaggered).name() &&
+	mat.Type() != typeid(cpuDiracStaggeredPC).name() &&
+	mat.Type() != typeid(cpuDiracStaggered).name()) {
+      tmp2_p = new Field(x, csParam);
     }
-    cudaColorSpinorField &tmp2 = *tmp2_p;
+    Field &tmp2 = *tmp2_p;
 
-    cudaColorSpinorField *x_sloppy, *r_sloppy;
+    Field *x_sloppy, *r_sloppy;
     if (param.precision_sloppy == x.Precision()) {
       csParam.create = QUDA_REFERENCE_FIELD_CREATE;
       x_sloppy = &x;
       r_sloppy = &r;
     } else {
       csParam.create = QUDA_COPY_FIELD_CREATE;
-      x_sloppy = new cudaColorSpinorField(x, csParam);
-      r_sloppy = new cudaColorSpinorField(r, csParam);
+      x_sloppy = new Field(x, csParam);
+      r_sloppy = new Field(r, csParam);
     }
 
-    cudaColorSpinorField &xSloppy = *x_sloppy;
-    cudaColorSpinorField &rSloppy = *r_sloppy;
-    cudaColorSpinorField p(rSloppy);
+    Field &xSloppy = *x_sloppy;
+    Field &rSloppy = *r_sloppy;
+    Field p(rSloppy);
 
     if(&x != &xSloppy){
-      copyCuda(y,x);
-      zeroCuda(xSloppy);
+      blas::copy(y,x);
+      blas::zero(xSloppy);
     }else{
-      zeroCuda(y);
+      blas::zero(y);
     }
     
     const bool use_heavy_quark_res = 
@@ -97,7 +105,7 @@ namespace quda {
     double stop = b2*param.tol*param.tol; // stopping condition of solver
 
     double heavy_quark_res = 0.0; // heavy quark residual
-    if(use_heavy_quark_res) heavy_quark_res = sqrt(HeavyQuarkResidualNormCuda(x,r).z);
+    if(use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
     int heavy_quark_check = 10; // how often to check the heavy quark residual
 
     double alpha=0.0, beta=0.0;
@@ -131,32 +139,14 @@ namespace quda {
     
       double sigma;
 
-      bool breakdown = false;
-
-      if (param.pipeline) {
-	double3 triplet = tripleCGReductionCuda(rSloppy, Ap, p);
-	r2 = triplet.x; double Ap2 = triplet.y; pAp = triplet.z;
-	r2_old = r2;
-
-	alpha = r2 / pAp;        
-	sigma = alpha*(alpha * Ap2 - pAp);
-	if (sigma < 0.0 || steps_since_reliable==0) { // sigma condition has broken down
-	  r2 = axpyNormCuda(-alpha, Ap, rSloppy);
-	  sigma = r2;
-	  breakdown = true;
-	}
+      r2_old = r2;
+      pAp = blas::reDotProduct(p, Ap);
+      alpha = r2 / pAp;        
 
-	r2 = sigma;
-      } else {
-	r2_old = r2;
-	pAp = reDotProductCuda(p, Ap);
-	alpha = r2 / pAp;        
-
-	// here we are deploying the alternative beta computation 
-	Complex cg_norm = axpyCGNormCuda(-alpha, Ap, rSloppy);
-	r2 = real(cg_norm); // (r_new, r_new)
-	sigma = imag(cg_norm) >= 0.0 ? imag(cg_norm) : r2; // use r2 if (r_k+1, r_k+1-r_k) breaks
-      }
+      // here we are deploying the alternative beta computation 
+      Complex cg_norm = blas::axpyCGNorm(-alpha, Ap, rSloppy);
+      r2 = real(cg_norm); // (r_new, r_new)
+      sigma = imag(cg_norm) >= 0.0 ? imag(cg_norm) : r2; // use r2 if (r_k+1, r_k+1-r_k) breaks
 
       // reliable update conditions
       rNorm = sqrt(r2);
@@ -172,25 +162,24 @@ namespace quda {
 	//beta = r2 / r2_old;
 	beta = sigma / r2_old; // use the alternative beta computation
 
-	if (param.pipeline && !breakdown) tripleCGUpdateCuda(alpha, beta, Ap, rSloppy, xSloppy, p);
-	else axpyZpbxCuda(alpha, p, xSloppy, rSloppy, beta);
+	blas::axpyZpbx(alpha, p, xSloppy, rSloppy, beta);
 
 	if (use_heavy_quark_res && k%heavy_quark_check==0) { 
-	  copyCuda(tmp,y);
-	  heavy_quark_res = sqrt(xpyHeavyQuarkResidualNormCuda(xSloppy, tmp, rSloppy).z);
+	  blas::copy(tmp,y);
+	  heavy_quark_res = sqrt(blas::xpyHeavyQuarkResidualNorm(xSloppy, tmp, rSloppy).z);
 	}
 
 	steps_since_reliable++;
       } else {
-	axpyCuda(alpha, p, xSloppy);
-	if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
+	blas::axpy(alpha, p, xSloppy);
+	if (x.Precision() != xSloppy.Precision()) blas::copy(x, xSloppy);
       
-	xpyCuda(x, y); // swap these around?
+	blas::xpy(x, y); // swap these around?
 	mat(r, y, x); // here we can use x as tmp
-	r2 = xmyNormCuda(b, r);
+	r2 = blas::xmyNorm(b, r);
 
-	if (x.Precision() != rSloppy.Precision()) copyCuda(rSloppy, r);            
-	zeroCuda(xSloppy);
+	if (x.Precision() != rSloppy.Precision()) blas::copy(rSloppy, r);            
+	blas::zero(xSloppy);
 
 	// break-out check if we have reached the limit of the precision
 	static int resIncrease = 0;
@@ -210,25 +199,24 @@ namespace quda {
 	rUpdate++;
 
 	// explicitly restore the orthogonality of the gradient vector
-	double rp = reDotProductCuda(rSloppy, p) / (r2);
-	axpyCuda(-rp, rSloppy, p);
+	double rp = blas::reDotProduct(rSloppy, p) / (r2);
+	blas::axpy(-rp, rSloppy, p);
 
 	beta = r2 / r2_old; 
-	xpayCuda(rSloppy, beta, p);
+	blas::xpay(rSloppy, beta, p);
 
-	if(use_heavy_quark_res) heavy_quark_res = sqrt(HeavyQuarkResidualNormCuda(y,r).z);
+	if(use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(y,r).z);
 	
 	steps_since_reliable = 0;
       }
 
-      breakdown = false;
       k++;
 
       PrintStats("CG", k, r2, b2, heavy_quark_res);
     }
 
-    if (x.Precision() != xSloppy.Precision()) copyCuda(x, xSloppy);
-    xpyCuda(y, x);
+    if (x.Precision() != xSloppy.Precision()) blas::copy(x, xSloppy);
+    blas::xpy(y, x);
 
     profile.Stop(QUDA_PROFILE_COMPUTE);
     profile.Start(QUDA_PROFILE_EPILOGUE);
@@ -247,9 +235,9 @@ namespace quda {
 
     // compute the true residuals
     mat(r, x, y);
-    param.true_res = sqrt(xmyNormCuda(b, r) / b2);
+    param.true_res = sqrt(blas::xmyNorm(b, r) / b2);
 #if (__COMPUTE_CAPABILITY__ >= 200)
-    param.true_res_hq = sqrt(HeavyQuarkResidualNormCuda(x,r).z);
+    param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
 #else
     param.true_res_hq = 0.0;
 #endif      
@@ -276,4 +264,262 @@ namespace quda {
     return;
   }
 
+  /**
+     Pipelined CG (Ghysels and Vanroose, Parallel Computing 40, 224
+     (2014)).  The recurrences carry w = A r, so that the two inner
+     products of an iteration, (r,r) and (w,r), are formed in a single
+     reduction whose global sum is in flight while the next operator
+     application q = A w is computed.  The sloppy residual drifts from
+     the true one faster than in standard CG, so each reliable update
+     also restarts the recurrences from the true residual.
+  */
+  template <typename Field>
+  void CG::solvePipelined(Field &x, Field &b)
+  {
+    profile.Start(QUDA_PROFILE_INIT);
+
+    const double b2 = norm2(b);
+    if(b2 == 0){
+      profile.Stop(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      x=b;
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      return;
+    }
+
+    Field r(b);
+
+    ColorSpinorParam csParam(x);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    Field y(b, csParam); 
+  
+    mat(r, x, y);
+    double r2 = blas::xmyNorm(b, r);
+  
+    csParam.setPrecision(param.precision_sloppy, x.Location());
+    Field w(x, csParam); // A r
+    Field q(x, csParam); // A w
+    Field z(x, csParam); // A s
+    Field s(x, csParam); // A p
+    Field p(x, csParam);
+    Field tmp(x, csParam);
+
+    Field *tmp2_p = &tmp;
+    // tmp only needed for multi-gpu Wilson-like kernels
+    if (mat.Type() != typeid(DiracStaggeredPC).name() && 
+	mat.Type() != typeid(DiracStaggered).name() &&
+	mat.Type() != typeid(cpuDiracStaggeredPC).name() &&
+	mat.Type() != typeid(cpuDiracStaggered).name()) {
+      tmp2_p = new Field(x, csParam);
+    }
+    Field &tmp2 = *tmp2_p;
+
+    Field *x_sloppy, *r_sloppy;
+    if (param.precision_sloppy == x.Precision()) {
+      x_sloppy = &x;
+      r_sloppy = &r;
+    } else {
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      x_sloppy = new Field(x, csParam);
+      r_sloppy = new Field(r, csParam);
+    }
+
+    Field &xSloppy = *x_sloppy;
+    Field &rSloppy = *r_sloppy;
+
+    blas::copy(y, x);
+    blas::zero(xSloppy);
+
+    const bool use_heavy_quark_res = 
+      (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) ? true : false;
+
+    profile.Stop(QUDA_PROFILE_INIT);
+    profile.Start(QUDA_PROFILE_PREAMBLE);
+
+    double stop = b2*param.tol*param.tol; // stopping condition of solver
+
+    double heavy_quark_res = 0.0; // heavy quark residual
+    if(use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
+    int heavy_quark_check = 10; // how often to check the heavy quark residual
+
+    double alpha = 0.0, beta = 0.0, gamma = r2, gamma_old = 0.0, alpha_old = 0.0;
+    int rUpdate = 0;
+
+    double rNorm = sqrt(r2);
+    double r0Norm = rNorm;
+    double maxrx = rNorm;
+    double maxrr = rNorm;
+    double delta = param.delta;
+
+    int maxResIncrease = 0; // 0 means we have no tolerance 
+    int resIncrease = 0;
+
+    matSloppy(w, rSloppy, tmp, tmp2);
+
+    profile.Stop(QUDA_PROFILE_PREAMBLE);
+    profile.Start(QUDA_PROFILE_COMPUTE);
+    blas_flops = 0;
+
+    int k=0;
+    
+    PrintStats("PipeCG", k, r2, b2, heavy_quark_res);
+
+    bool restart = true; // the recurrences start (again) from r
+
+    while (k < param.maxiter) {
+      // local (r,r) and (r,w), summed over all nodes behind q = A w
+      // (reproducible sums must be formed from the site sums, so are not deferred)
+      const bool deferReduce = !reduceReproducible();
+      const bool reduceState = globalReduce;
+      if (deferReduce) globalReduce = false;
+      double3 rw = blas::cDotProductNormA(rSloppy, w);
+      globalReduce = reduceState;
+
+      double sum[2] = { rw.z, rw.x };
+      MsgHandle *mh = deferReduce ? reduceDoubleArrayAsync(sum, 2) : NULL;
+      matSloppy(q, w, tmp, tmp2);
+      reduceDoubleArrayWait(mh);
+
+      gamma = sum[0];
+      const double rAr = sum[1];
+      r2 = gamma;
+
+      // reliable update conditions
+      rNorm = sqrt(r2);
+      if (rNorm > maxrx) maxrx = rNorm;
+      if (rNorm > maxrr) maxrr = rNorm;
+      int updateX = (rNorm < delta*r0Norm && r0Norm <= maxrx) ? 1 : 0;
+      int updateR = ((rNorm < delta*maxrr && r0Norm <= maxrr) || updateX) ? 1 : 0;
+
+      // force a reliable update if we are within target tolerance (only if doing reliable updates)
+      if ( convergence(r2, heavy_quark_res, stop, param.tol_hq) && delta >= param.tol) updateX = 1;
+
+      // the recurrence for the step length has broken down
+      const double denom = restart ? rAr : rAr - gamma*gamma/(gamma_old*alpha_old);
+      if (denom <= 0.0) updateR = 1;
+
+      if (!restart && (updateR || updateX)) {
+	if (x.Precision() != xSloppy.Precision()) blas::copy(x, xSloppy);
+	blas::xpy(x, y);
+	mat(r, y, x); // here we can use x as tmp
+	r2 = blas::xmyNorm(b, r);
+
+	if (x.Precision() != rSloppy.Precision()) blas::copy(rSloppy, r);
+	blas::zero(xSloppy);
+
+	// break-out check if we have reached the limit of the precision
+	if (sqrt(r2) > r0Norm && updateX) { // reuse r0Norm for this
+	  warningQuda("PipeCG: new reliable residual norm %e is greater than previous reliable residual norm %e",
+		      sqrt(r2), r0Norm);
+	  rUpdate++;
+	  if (++resIncrease > maxResIncrease) break; 
+	} else {
+	  resIncrease = 0;
+	}
+
+	rNorm = sqrt(r2);
+	maxrr = rNorm;
+	maxrx = rNorm;
+	r0Norm = rNorm;
+	rUpdate++;
+
+	if(use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(y,r).z);
+	if (convergence(r2, heavy_quark_res, stop, param.tol_hq)) break;
+
+	// restart the recurrences from the true residual
+	matSloppy(w, rSloppy, tmp, tmp2);
+	restart = true;
+	continue;
+      }
+
+      if (convergence(r2, heavy_quark_res, stop, param.tol_hq)) break;
+      if (denom <= 0.0) {
+	warningQuda("PipeCG: breakdown with (r, A r) = %e", denom);
+	break;
+      }
+
+      beta = restart ? 0.0 : gamma / gamma_old;
+      alpha = gamma / denom;
+
+      blas::xpay(q, beta, z);
+      blas::xpay(w, beta, s);
+      blas::xpay(rSloppy, beta, p);
+      blas::axpy(alpha, p, xSloppy);
+      blas::axpy(-alpha, s, rSloppy);
+      blas::axpy(-alpha, z, w);
+
+      gamma_old = gamma;
+      alpha_old = alpha;
+      restart = false;
+
+      k++;
+
+      if (use_heavy_quark_res && k%heavy_quark_check==0) { 
+	blas::copy(tmp,y);
+	heavy_quark_res = sqrt(blas::xpyHeavyQuarkResidualNorm(xSloppy, tmp, rSloppy).z);
+      }
+
+      PrintStats("PipeCG", k, r2, b2, heavy_quark_res);
+    }
+
+    if (x.Precision() != xSloppy.Precision()) blas::copy(x, xSloppy);
+    blas::xpy(y, x);
+
+    profile.Stop(QUDA_PROFILE_COMPUTE);
+    profile.Start(QUDA_PROFILE_EPILOGUE);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (quda::blas_flops + mat.flops() + matSloppy.flops())*1e-9;
+    reduceDouble(gflops);
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (k==param.maxiter) 
+      warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("PipeCG: Reliable updates = %d\n", rUpdate);
+
+    // compute the true residuals
+    mat(r, x, y);
+    param.true_res = sqrt(blas::xmyNorm(b, r) / b2);
+#if (__COMPUTE_CAPABILITY__ >= 200)
+    param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
+#else
+    param.true_res_hq = 0.0;
+#endif      
+
+    PrintSummary("PipeCG", k, r2, b2);
+
+    // reset the flops counters
+    quda::blas_flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.Stop(QUDA_PROFILE_EPILOGUE);
+    profile.Start(QUDA_PROFILE_FREE);
+
+    if (&tmp2 != &tmp) delete tmp2_p;
+
+    if (param.precision_sloppy != x.Precision()) {
+      delete r_sloppy;
+      delete x_sloppy;
+    }
+
+    profile.Stop(QUDA_PROFILE_FREE);
+  }
+
+  void CG::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "cg");
+    solve(x, b);
+  }
+
+  void CG::operator()(cpuColorSpinorField &x, cpuColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "cg");
+    solve(x, b);
+  }
+
 } // namespace quda
@@ -45,51 +45,52 @@ namespace quda {
 
   }
 
-  void orthoDir(Complex **beta, cudaColorSpinorField *Ap[], int k) {
+  template <typename Field>
+  void orthoDir(Complex **beta, Field *Ap[], int k) {
     int type = 1;
 
     switch (type) {
     case 0: // no kernel fusion
       for (int i=0; i<k; i++) { // 5 (k-1) memory transactions here
-	beta[i][k] = cDotProductCuda(*Ap[i], *Ap[k]);
-	caxpyCuda(-beta[i][k], *Ap[i], *Ap[k]);
+	beta[i][k] = blas::cDotProduct(*Ap[i], *Ap[k]);
+	blas::caxpy(-beta[i][k], *Ap[i], *Ap[k]);
       }
       break;
     case 1: // basic kernel fusion
       if (k==0) break;
-      beta[0][k] = cDotProductCuda(*Ap[0], *Ap[k]);
+      beta[0][k] = blas::cDotProduct(*Ap[0], *Ap[k]);
       for (int i=0; i<k-1; i++) { // 4 (k-1) memory transactions here
-	beta[i+1][k] = caxpyDotzyCuda(-beta[i][k], *Ap[i], *Ap[k], *Ap[i+1]);
+	beta[i+1][k] = blas::caxpyDotzy(-beta[i][k], *Ap[i], *Ap[k], *Ap[i+1]);
       }
-      caxpyCuda(-beta[k-1][k], *Ap[k-1], *Ap[k]);
+      blas::caxpy(-beta[k-1][k], *Ap[k-1], *Ap[k]);
       break;
     case 2: // 
       for (int i=0; i<k-2; i+=3) { // 5 (k-1) memory transactions here
-	for (int j=i; j<i+3; j++) beta[j][k] = cDotProductCuda(*Ap[j], *Ap[k]);
-	caxpbypczpwCuda(-beta[i][k], *Ap[i], -beta[i+1][k], *Ap[i+1], -beta[i+2][k], *Ap[i+2], *Ap[k]);
+	for (int j=i; j<i+3; j++) beta[j][k] = blas::cDotProduct(*Ap[j], *Ap[k]);
+	blas::caxpbypczpw(-beta[i][k], *Ap[i], -beta[i+1][k], *Ap[i+1], -beta[i+2][k], *Ap[i+2], *Ap[k]);
       }
     
       if (k%3 != 0) { // need to update the remainder
 	if ((k - 3*(k/3)) % 2 == 0) {
-	  beta[k-2][k] = cDotProductCuda(*Ap[k-2], *Ap[k]);
-	  beta[k-1][k] = cDotProductCuda(*Ap[k-1], *Ap[k]);
-	  caxpbypzCuda(beta[k-2][k], *Ap[k-2], beta[k-1][k], *Ap[k-1], *Ap[k]);
+	  beta[k-2][k] = blas::cDotProduct(*Ap[k-2], *Ap[k]);
+	  beta[k-1][k] = blas::cDotProduct(*Ap[k-1], *Ap[k]);
+	  blas::caxpbypz(beta[k-2][k], *Ap[k-2], beta[k-1][k], *Ap[k-1], *Ap[k]);
 	} else {
-	  beta[k-1][k] = cDotProductCuda(*Ap[k-1], *Ap[k]);
-	  caxpyCuda(beta[k-1][k], *Ap[k-1], *Ap[k]);
+	  beta[k-1][k] = blas::cDotProduct(*Ap[k-1], *Ap[k]);
+	  blas::caxpy(beta[k-1][k], *Ap[k-1], *Ap[k]);
 	}
       }
 
       break;
     case 3:
       for (int i=0; i<k-1; i+=2) {
-	for (int j=i; j<i+2; j++) beta[j][k] = cDotProductCuda(*Ap[j], *Ap[k]);
-	caxpbypzCuda(-beta[i][k], *Ap[i], -beta[i+1][k], *Ap[i+1], *Ap[k]);
+	for (int j=i; j<i+2; j++) beta[j][k] = blas::cDotProduct(*Ap[j], *Ap[k]);
+	blas::caxpbypz(-beta[i][k], *Ap[i], -beta[i+1][k], *Ap[i+1], *Ap[k]);
       }
     
       if (k%2 != 0) { // need to update the remainder
-	beta[k-1][k] = cDotProductCuda(*Ap[k-1], *Ap[k]);
-	caxpyCuda(beta[k-1][k], *Ap[k-1], *Ap[k]);
+	beta[k-1][k] = blas::cDotProduct(*Ap[k-1], *Ap[k]);
+	blas::caxpy(beta[k-1][k], *Ap[k-1], *Ap[k]);
       }
       break;
     default:
@@ -98,6 +99,43 @@ namespace quda {
 
   }   
 
+  /**
+     Classical Gram-Schmidt with one reorthogonalization pass, for
+     when global sums are expensive: the inner products of each pass
+     are summed over all nodes in a single allreduce, rather than one
+     per basis vector as in orthoDir.  The second pass also returns
+     (Ap[k], r) and |Ap[k]|^2, using that r is orthogonal to, and the
+     Ap[i] are orthonormal to, the previous basis vectors.
+  */
+  template <typename Field>
+  double3 orthoDirBatched(Complex **beta, Field *Ap[], int k, Field &r) {
+    Complex *c = new Complex[k+1];
+    double3 Apr;
+
+    for (int pass=(k==0 ? 1 : 0); pass<2; pass++) {
+      ReduceBatch batch;
+      for (int i=0; i<k; i++) {
+	c[i] = blas::cDotProduct(*Ap[i], *Ap[k]);
+	batch.add(c[i]);
+      }
+      if (pass == 1) {
+	Apr = blas::cDotProductNormA(*Ap[k], r);
+	batch.add(Apr);
+      }
+      batch.flush();
+
+      for (int i=0; i<k; i++) {
+	beta[i][k] = (pass == 0) ? c[i] : beta[i][k] + c[i];
+	c[i] = -c[i];
+	if (pass == 1) Apr.z -= norm(c[i]);
+      }
+      if (k > 0) blas::caxpyBlock(c, Ap, k, *Ap[k]);
+    }
+
+    delete []c;
+    return Apr;
+  }
+
   void backSubs(const Complex *alpha, Complex** const beta, const double *gamma, Complex *delta, int n) {
     for (int k=n-1; k>=0;k--) {
       delta[k] = alpha[k];
@@ -108,8 +146,9 @@ namespace quda {
     }
   }
 
-  void updateSolution(cudaColorSpinorField &x, const Complex *alpha, Complex** const beta, 
-		      double *gamma, int k, cudaColorSpinorField *p[]) {
+  template <typename Field>
+  void updateSolution(Field &x, const Complex *alpha, Complex** const beta, 
+		      double *gamma, int k, Field *p[]) {
 
     Complex *delta = new Complex[k];
 
@@ -117,14 +156,7 @@ namespace quda {
     backSubs(alpha, beta, gamma, delta, k);
   
     //for (int i=0; i<k; i++) caxpyCuda(delta[i], *p[i], x);
-  
-    for (int i=0; i<k-2; i+=3) 
-      caxpbypczpwCuda(delta[i], *p[i], delta[i+1], *p[i+1], delta[i+2], *p[i+2], x); 
-  
-    if (k%3 != 0) { // need to update the remainder
-      if ((k - 3*(k/3)) % 2 == 0) caxpbypzCuda(delta[k-2], *p[k-2], delta[k-1], *p[k-1], x);
-      else caxpyCuda(delta[k-1], *p[k-1], x);
-    }
+    blas::caxpyBlock(delta, p, k, x);
 
     delete []delta;
   }
@@ -161,7 +193,8 @@ namespace quda {
     profile.Stop(QUDA_PROFILE_FREE);
   }
 
-  void GCR::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b)
+  template <typename Field>
+  void GCR::solve(Field &x, Field &b)
   {
     profile.Start(QUDA_PROFILE_INIT);
 
@@ -169,70 +202,74 @@ namespace quda {
 
     ColorSpinorParam csParam(x);
     csParam.create = QUDA_ZERO_FIELD_CREATE;
-    cudaColorSpinorField r(x, csParam); 
-    cudaColorSpinorField y(x, csParam); // high precision accumulator
+    Field r(x, csParam); 
+    Field y(x, csParam); // high precision accumulator
 
     // create sloppy fields used for orthogonalization
-    csParam.setPrecision(param.precision_sloppy);
-    cudaColorSpinorField **p = new cudaColorSpinorField*[Nkrylov];
-    cudaColorSpinorField **Ap = new cudaColorSpinorField*[Nkrylov];
+    csParam.setPrecision(param.precision_sloppy, x.Location());
+    Field **p = new Field*[Nkrylov];
+    Field **Ap = new Field*[Nkrylov];
     for (int i=0; i<Nkrylov; i++) {
-      p[i] = new cudaColorSpinorField(x, csParam);
-      Ap[i] = new cudaColorSpinorField(x, csParam);
+      p[i] = new Field(x, csParam);
+      Ap[i] = new Field(x, csParam);
     }
 
-    cudaColorSpinorField tmp(x, csParam); //temporary for sloppy mat-vec
+    Field tmp(x, csParam); //temporary for sloppy mat-vec
 
-    cudaColorSpinorField *x_sloppy, *r_sloppy;
+    Field *x_sloppy, *r_sloppy;
     if (param.precision_sloppy != param.precision) {
-      csParam.setPrecision(param.precision_sloppy);
-      x_sloppy = new cudaColorSpinorField(x, csParam);
-      r_sloppy = new cudaColorSpinorField(x, csParam);
+      csParam.setPrecision(param.precision_sloppy, x.Location());
+      x_sloppy = new Field(x, csParam);
+      r_sloppy = new Field(x, csParam);
     } else {
       x_sloppy = &x;
       r_sloppy = &r;
     }
 
-    cudaColorSpinorField &xSloppy = *x_sloppy;
-    cudaColorSpinorField &rSloppy = *r_sloppy;
+    Field &xSloppy = *x_sloppy;
+    Field &rSloppy = *r_sloppy;
 
     // these low precision fields are used by the inner solver
     bool precMatch = true;
-    cudaColorSpinorField *r_pre, *p_pre;
+    Field *r_pre, *p_pre;
     if (param.precision_precondition != param.precision_sloppy || param.precondition_cycle > 1) {
-      csParam.setPrecision(param.precision_precondition);
-      p_pre = new cudaColorSpinorField(x, csParam);
-      r_pre = new cudaColorSpinorField(x, csParam);
+      csParam.setPrecision(param.precision_precondition, x.Location());
+      p_pre = new Field(x, csParam);
+      r_pre = new Field(x, csParam);
       precMatch = false;
     } else {
       p_pre = NULL;
       r_pre = r_sloppy;
     }
-    cudaColorSpinorField &rPre = *r_pre;
+    Field &rPre = *r_pre;
 
-    cudaColorSpinorField *rM = param.precondition_cycle > 1 ? new cudaColorSpinorField(rSloppy) : 0;
+    Field *rM = param.precondition_cycle > 1 ? new Field(rSloppy) : 0;
 
     Complex *alpha = new Complex[Nkrylov];
     Complex **beta = new Complex*[Nkrylov];
     for (int i=0; i<Nkrylov; i++) beta[i] = new Complex[Nkrylov];
     double *gamma = new double[Nkrylov];
 
+    // batch the orthogonalization reductions when they are global and
+    // there is more than one node (reproducible sums cannot be batched)
+    const bool batchReduce = globalReduce && comm_size() > 1 && !reduceReproducible();
+
     // compute parity of the node
     int parity = 0;
     for (int i=0; i<4; i++) parity += commCoords(i);
     parity = parity % 2;
 
-    double b2 = normCuda(b);  // norm sq of source
+    double b2 = blas::norm2(b);  // norm sq of source
     double r2;                // norm sq of residual
 
     // compute initial residual depending on whether we have an initial guess or not
     if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
       mat(r, x, y);
-      r2 = xmyNormCuda(b, r);
-      copyCuda(y, x);
-      if (&x == &xSloppy) zeroCuda(x); // need to zero x when doing uni-precision solver
+      r2 = blas::xmyNorm(b, r);
+      blas::copy(y, x);
+      if (&x == &xSloppy) blas::zero(x); // need to zero x when doing uni-precision solver
     } else {
-      copyCuda(r, b);
+      blas::copy(r, b);
       r2 = b2;
     }
 
@@ -251,14 +288,14 @@ namespace quda {
     const bool use_heavy_quark_res = 
       (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) ? true : false;
     double heavy_quark_res = 0.0; // heavy quark residual
-    if(use_heavy_quark_res) heavy_quark_res = sqrt(HeavyQuarkResidualNormCuda(x,r).z);
+    if(use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
 
     profile.Stop(QUDA_PROFILE_INIT);
     profile.Start(QUDA_PROFILE_PREAMBLE);
 
     blas_flops = 0;
 
-    copyCuda(rSloppy, r);
+    blas::copy(rSloppy, r);
 
     int total_iter = 0;
     int restart = 0;
@@ -275,24 +312,24 @@ namespace quda {
     
       for (int m=0; m<param.precondition_cycle; m++) {
 	if (param.inv_type_precondition != QUDA_INVALID_INVERTER) {
-	  cudaColorSpinorField &pPre = (precMatch ? *p[k] : *p_pre);
+	  Field &pPre = (precMatch ? *p[k] : *p_pre);
 	
 	  if (m==0) { // residual is just source
-	    copyCuda(rPre, rSloppy);
+	    blas::copy(rPre, rSloppy);
 	  } else { // compute residual
-	    copyCuda(*rM, rSloppy);
-	    axpyCuda(-1.0, *Ap[k], *rM);
-	    copyCuda(rPre, *rM);
+	    blas::copy(*rM, rSloppy);
+	    blas::axpy(-1.0, *Ap[k], *rM);
+	    blas::copy(rPre, *rM);
 	  }
 	
 	  if ((parity+m)%2 == 0 || param.schwarz_type == QUDA_ADDITIVE_SCHWARZ) (*K)(pPre, rPre);
-	  else copyCuda(pPre, rPre);
+	  else blas::copy(pPre, rPre);
 	
 	  // relaxation p = omega*p + (1-omega)*r
 	  //if (param.omega!=1.0) axpbyCuda((1.0-param.omega), rPre, param.omega, pPre);
 	
-	  if (m==0) { copyCuda(*p[k], pPre); }
-	  else { copyCuda(tmp, pPre); xpyCuda(tmp, *p[k]); }
+	  if (m==0) { blas::copy(*p[k], pPre); }
+	  else { blas::copy(tmp, pPre); blas::xpy(tmp, *p[k]); }
 
 	} else { // no preconditioner
 	  *p[k] = rSloppy;
@@ -303,9 +340,13 @@ namespace quda {
 	  printfQuda("GCR debug iter=%d: Ap2=%e, p2=%e, rPre2=%e\n", total_iter, norm2(*Ap[k]), norm2(*p[k]), norm2(rPre));
       }
 
-      orthoDir(beta, Ap, k);
-
-      double3 Apr = cDotProductNormACuda(*Ap[k], rSloppy);
+      double3 Apr;
+      if (batchReduce) {
+	Apr = orthoDirBatched(beta, Ap, k, rSloppy);
+      } else {
+	orthoDir(beta, Ap, k);
+	Apr = blas::cDotProductNormA(*Ap[k], rSloppy);
+      }
 
       if (getVerbosity()>= QUDA_DEBUG_VERBOSE) {
 	printfQuda("GCR debug iter=%d: Apr=(%e,%e,%e)\n", total_iter, Apr.x, Apr.y, Apr.z);
@@ -320,7 +361,7 @@ namespace quda {
       alpha[k] = Complex(Apr.x, Apr.y) / gamma[k]; // alpha = (1/|Ap|) * (Ap, r)
 
       // r -= (1/|Ap|^2) * (Ap, r) r, Ap *= 1/|Ap|
-      r2 = cabxpyAxNormCuda(1.0/gamma[k], -alpha[k], *Ap[k], rSloppy); 
+      r2 = blas::cabxpyAxNorm(1.0/gamma[k], -alpha[k], *Ap[k], rSloppy); 
 
       k++;
       total_iter++;
@@ -335,12 +376,12 @@ namespace quda {
 	updateSolution(xSloppy, alpha, beta, gamma, k, p);
 
 	// recalculate residual in high precision
-	copyCuda(x, xSloppy);
-	xpyCuda(x, y);
+	blas::copy(x, xSloppy);
+	blas::xpy(x, y);
 	mat(r, y, x);
-	r2 = xmyNormCuda(b, r);  
+	r2 = blas::xmyNorm(b, r);  
 
-	if (use_heavy_quark_res) heavy_quark_res = sqrt(HeavyQuarkResidualNormCuda(y, r).z);
+	if (use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(y, r).z);
 
 	k = 0;
 
@@ -348,8 +389,8 @@ namespace quda {
 	  restart++; // restarting if residual is still too great
 
 	  PrintStats("GCR (restart)", restart, r2, b2, heavy_quark_res);
-	  copyCuda(rSloppy, r);
-	  zeroCuda(xSloppy);
+	  blas::copy(rSloppy, r);
+	  blas::zero(xSloppy);
 
 	  r2_old = r2;
 
@@ -361,7 +402,7 @@ namespace quda {
 
     }
 
-    if (total_iter > 0) copyCuda(x, y);
+    if (total_iter > 0) blas::copy(x, y);
 
     profile.Stop(QUDA_PROFILE_COMPUTE);
     profile.Start(QUDA_PROFILE_EPILOGUE);
@@ -378,10 +419,10 @@ namespace quda {
   
     // Calculate the true residual
     mat(r, x);
-    double true_res = xmyNormCuda(b, r);
+    double true_res = blas::xmyNorm(b, r);
     param.true_res = sqrt(true_res / b2);
 #if (__COMPUTE_CAPABILITY__ >= 200)
-    param.true_res_hq = sqrt(HeavyQuarkResidualNormCuda(x,r).z);
+    param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
 #else
     param.true_res_hq = 0.0;
 #endif   
@@ -429,4 +470,16 @@ namespace quda {
     return;
   }
 
+  void GCR::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "gcr");
+    solve(x, b);
+  }
+
+  void GCR::operator()(cpuColorSpinorField &x, cpuColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "gcr");
+    solve(x, b);
+  }
+
 } // namespace quda
@@ -24,45 +24,55 @@ namespace quda {
 
   MR::~MR() {
     if (param.inv_type_precondition != QUDA_GCR_INVERTER) profile.Start(QUDA_PROFILE_FREE);
+    freeFields();
+    if (param.inv_type_precondition != QUDA_GCR_INVERTER) profile.Stop(QUDA_PROFILE_FREE);
+  }
+
+  void MR::freeFields() {
     if (init) {
       if (allocate_r) delete rp;
       delete Arp;
       delete tmpp;
+      allocate_r = false;
+      init = false;
     }
-    if (param.inv_type_precondition != QUDA_GCR_INVERTER) profile.Stop(QUDA_PROFILE_FREE);
   }
 
-  void MR::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b)
+  template <typename Field>
+  void MR::solve(Field &x, Field &b)
   {
 
     globalReduce = false; // use local reductions for DD solver
 
+    // the cached fields must reside where the solve is done
+    if (init && Arp->Location() != x.Location()) freeFields();
+
     if (!init) {
       ColorSpinorParam csParam(x);
       csParam.create = QUDA_ZERO_FIELD_CREATE;
       if (param.preserve_source == QUDA_PRESERVE_SOURCE_YES) {
-	rp = new cudaColorSpinorField(x, csParam); 
+	rp = new Field(x, csParam); 
 	allocate_r = true;
       }
-      Arp = new cudaColorSpinorField(x);
-      tmpp = new cudaColorSpinorField(x, csParam); //temporary for mat-vec
+      Arp = new Field(x);
+      tmpp = new Field(x, csParam); //temporary for mat-vec
 
       init = true;
     }
-    cudaColorSpinorField &r = 
-      (param.preserve_source == QUDA_PRESERVE_SOURCE_YES) ? *rp : b;
-    cudaColorSpinorField &Ar = *Arp;
-    cudaColorSpinorField &tmp = *tmpp;
+    Field &r = 
+      (param.preserve_source == QUDA_PRESERVE_SOURCE_YES) ? static_cast<Field&>(*rp) : b;
+    Field &Ar = static_cast<Field&>(*Arp);
+    Field &tmp = static_cast<Field&>(*tmpp);
 
     // set initial guess to zero and thus the residual is just the source
-    zeroCuda(x);  // can get rid of this for a special first update kernel  
-    double b2 = normCuda(b);
-    if (&r != &b) copyCuda(r, b);
+    blas::zero(x);  // can get rid of this for a special first update kernel  
+    double b2 = blas::norm2(b);
+    if (&r != &b) blas::copy(r, b);
 
     // domain-wise normalization of the initial residual to prevent underflow
     double r2=0.0; // if zero source then we will exit immediately doing no work
     if (b2 > 0.0) {
-      axCuda(1/sqrt(b2), r); // can merge this with the prior copy
+      blas::ax(1/sqrt(b2), r); // can merge this with the prior copy
       r2 = 1.0; // by definition by this is now true
     }
 
@@ -76,7 +86,7 @@ namespace quda {
     int k = 0;
     if (getVerbosity() >= QUDA_DEBUG_VERBOSE) {
       double x2 = norm2(x);
-      double3 Ar3 = cDotProductNormBCuda(Ar, r);
+      double3 Ar3 = blas::cDotProductNormB(Ar, r);
       printfQuda("MR: %d iterations, r2 = %e, <r|A|r> = (%e, %e), x2 = %e\n", 
 		 k, Ar3.z, Ar3.x, Ar3.y, x2);
     }
@@ -85,12 +95,12 @@ namespace quda {
     
       mat(Ar, r, tmp);
 
-      double3 Ar3 = cDotProductNormACuda(Ar, r);
+      double3 Ar3 = blas::cDotProductNormA(Ar, r);
       Complex alpha = Complex(Ar3.x, Ar3.y) / Ar3.z;
 
       // x += omega*alpha*r, r -= omega*alpha*Ar, r2 = norm2(r)
       //r2 = caxpyXmazNormXCuda(omega*alpha, r, x, Ar);
-      caxpyXmazCuda(omega*alpha, r, x, Ar);
+      blas::caxpyXmaz(omega*alpha, r, x, Ar);
 
       if (getVerbosity() >= QUDA_DEBUG_VERBOSE) {
 	double x2 = norm2(x);
@@ -106,12 +116,12 @@ namespace quda {
   
     if (getVerbosity() >= QUDA_VERBOSE) {
       mat(Ar, r, tmp);    
-      Complex Ar2 = cDotProductCuda(Ar, r);
+      Complex Ar2 = blas::cDotProduct(Ar, r);
       printfQuda("MR: %d iterations, <r|A|r> = (%e, %e)\n", k, real(Ar2), imag(Ar2));
     }
 
     // Obtain global solution by rescaling
-    if (b2 > 0.0) axCuda(sqrt(b2), x);
+    if (b2 > 0.0) blas::ax(sqrt(b2), x);
 
     if (param.inv_type_precondition != QUDA_GCR_INVERTER) {
         profile.Stop(QUDA_PROFILE_COMPUTE);
@@ -127,7 +137,7 @@ namespace quda {
 	// Calculate the true residual
 	r2 = norm2(r);
 	mat(r, x);
-	double true_res = xmyNormCuda(b, r);
+	double true_res = blas::xmyNorm(b, r);
 	param.true_res = sqrt(true_res / b2);
 
 	if (getVerbosity() >= QUDA_SUMMARIZE) {
@@ -146,4 +156,16 @@ namespace quda {
     return;
   }
 
+  void MR::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "mr");
+    solve(x, b);
+  }
+
+  void MR::operator()(cpuColorSpinorField &x, cpuColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "mr");
+    solve(x, b);
+  }
+
 } // namespace quda
@@ -1,8 +1,42 @@
 #include <invert_quda.h>
 #include <blas_quda.h>
+#include <util_quda.h>
 
 namespace quda {
 
+  // solve G alpha = beta using Gaussian elimination with partial pivoting
+  static void solveGram(std::vector<Complex> &alpha, std::vector< std::vector<Complex> > G,
+			std::vector<Complex> beta)
+  {
+    const int N = beta.size();
+
+    for (int i=0; i<N; i++) {
+
+      // Perform partial pivoting
+      int k = i;
+      for (int j=i+1; j<N; j++) if (abs(G[j][j]) > abs(G[k][k])) k = j;
+      if (k != i) {
+	std::swap<Complex>(beta[k], beta[i]);
+	std::swap(G[k], G[i]);
+      }
+
+      // Convert matrix to upper triangular form
+      for (int j=i+1; j<N; j++) {
+	Complex xp = G[j][i]/G[i][i];
+	beta[j] -= xp * beta[i];
+	for (int k=0; k<N; k++) G[j][k] -= xp * G[i][k];
+      }
+    }
+
+    // back substitution
+    alpha.resize(N);
+    for (int i=N-1; i>=0; i--) {
+      alpha[i] = 0.0;
+      for (int j=i+1; j<N; j++) alpha[i] += G[i][j] * alpha[j];
+      alpha[i] = (beta[i]-alpha[i])/G[i][i];
+    }
+  }
+
   MinResExt::MinResExt(DiracMatrix &mat, TimeProfile &profile) 
     : mat(mat), profile(profile){
 
@@ -36,12 +70,11 @@ namespace quda {
     double b2 = norm2(b);
 
     // Array to hold the matrix elements
-    Complex **G = new Complex*[N];
-    for (int i=0; i<N; i++) G[i] = new Complex[N];
+    std::vector< std::vector<Complex> > G(N, std::vector<Complex>(N));
     
     // Solution and source vectors
-    Complex *alpha = new Complex[N];
-    Complex *beta = new Complex[N];
+    std::vector<Complex> alpha(N);
+    std::vector<Complex> beta(N);
 
     // Orthonormalise the vector basis
     for (int i=0; i<N; i++) {
@@ -68,31 +101,11 @@ namespace quda {
       }
     }
 
-    // Gauss-Jordan elimination with partial pivoting
-    for (int i=0; i<N; i++) {
+    solveGram(alpha, G, beta);
 
-      // Perform partial pivoting
-      int k = i;
-      for (int j=i+1; j<N; j++) if (abs(G[j][j]) > abs(G[k][k])) k = j;
-      if (k != i) {
-	std::swap<Complex>(beta[k], beta[i]);
-	for (int j=0; j<N; j++) std::swap<Complex>(G[k][j], G[i][j]);
-      }
-
-      // Convert matrix to upper triangular form
-      for (int j=i+1; j<N; j++) {
-	Complex xp = G[j][i]/G[i][i];
-	beta[j] -= xp * beta[i];
-	for (int k=0; k<N; k++) G[j][k] -= xp * G[i][k];
-      }
-    }
-
-    // Use Gaussian Elimination to solve equations and calculate initial guess
+    // Calculate initial guess
     zeroCuda(x);
     for (int i=N-1; i>=0; i--) {
-      alpha[i] = 0.0;
-      for (int j=i+1; j<N; j++) alpha[i] += G[i][j] * alpha[j];
-      alpha[i] = (beta[i]-alpha[i])/G[i][i];
       caxpyCuda(alpha[i], *p[i], x);
       caxpyCuda(-alpha[i], *q[i], b);
       //printfQuda("%d %e %e\n", i, real(alpha[i]), imag(alpha[i]));
@@ -100,12 +113,100 @@ namespace quda {
 
     double rsd = sqrt(norm2(b) / b2 );
     printfQuda("MinResExt: N = %d, |res| / |src| = %e\n", N, rsd);
-    
-    for (int j=0; j<N; j++) delete [] G[j];
+  }
+
+  ChronoBasis::ChronoBasis(int maxDim) : maxDim(maxDim) {
+
+  }
+
+  ChronoBasis::~ChronoBasis() {
+    for (unsigned int i=0; i<p.size(); i++) {
+      delete q[i];
+      delete p[i];
+    }
+  }
+
+  void ChronoBasis::refresh(const DiracMatrix &mat) {
+    const int N = p.size();
+
+    for (int i=0; i<N; i++) mat(*q[i], *p[i]);
+
+    for (int j=0; j<N; j++) {
+      G[j][j] = reDotProductCuda(*p[j], *q[j]);
+      for (int k=j+1; k<N; k++) {
+	G[j][k] = cDotProductCuda(*p[j], *q[k]);
+	G[k][j] = conj(G[j][k]);
+      }
+    }
+  }
+
+  void ChronoBasis::guess(cudaColorSpinorField &x, cudaColorSpinorField &b) {
+    const int N = p.size();
+
+    zeroCuda(x);
+    if (N == 0) return;
+
+    std::vector<Complex> alpha(N);
+    std::vector<Complex> beta(N);
+    for (int i=0; i<N; i++) beta[i] = cDotProductCuda(*p[i], b);
+
+    solveGram(alpha, G, beta);
+
+    for (int i=0; i<N; i++) caxpyCuda(alpha[i], *p[i], x);
+
+    if (getVerbosity() >= QUDA_VERBOSE) {
+      cudaColorSpinorField r(b);
+      for (int i=0; i<N; i++) caxpyCuda(-alpha[i], *q[i], r);
+      printfQuda("ChronoBasis: N = %d, |res| / |src| = %e\n", N, sqrt(norm2(r) / norm2(b)));
+    }
+  }
+
+  void ChronoBasis::add(cudaColorSpinorField &x, const DiracMatrix &mat) {
+    if (maxDim <= 0) return;
+
+    double x2 = norm2(x);
+    if (x2 == 0.0) return;
+
+    // make room by discarding the oldest basis vector
+    if ((int)p.size() == maxDim) {
+      delete p[0];
+      delete q[0];
+      p.erase(p.begin());
+      q.erase(q.begin());
+      G.erase(G.begin());
+      for (unsigned int i=0; i<G.size(); i++) G[i].erase(G[i].begin());
+    }
+
+    // Gram-Schmidt, twice to keep the basis orthonormal to working precision
+    cudaColorSpinorField *v = new cudaColorSpinorField(x);
+    for (int pass=0; pass<2; pass++) {
+      for (unsigned int i=0; i<p.size(); i++) {
+	Complex xp = cDotProductCuda(*p[i], *v);
+	caxpyCuda(-xp, *p[i], *v);
+      }
+    }
+
+    // x lies (numerically) in the span of the basis
+    double v2 = norm2(*v);
+    if (v2 < 1e-12 * x2) {
+      delete v;
+      return;
+    }
+    axCuda(1 / sqrt(v2), *v);
+
+    ColorSpinorParam csParam(x);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    cudaColorSpinorField *Av = new cudaColorSpinorField(x, csParam);
+    mat(*Av, *v);
+
+    const int N = p.size();
+    for (int i=0; i<N; i++) G[i].push_back(cDotProductCuda(*p[i], *Av));
+    G.push_back(std::vector<Complex>(N+1));
+    for (int i=0; i<N; i++) G[N][i] = conj(G[i][N]);
+    G[N][N] = reDotProductCuda(*v, *Av);
 
-    delete [] G;
-    delete [] alpha;
-    delete [] beta;
+    p.push_back(v);
+    q.push_back(Av);
   }
 
 } // namespace quda
@@ -0,0 +1,357 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dslash_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+#include <face_quda.h>
+
+#include <vector>
+#include <algorithm>
+
+namespace quda {
+
+  SStepCG::SStepCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
+    Solver(param, profile), mat(mat), matSloppy(matSloppy)
+  {
+
+  }
+
+  SStepCG::~SStepCG() {
+
+  }
+
+  /**
+     With V_j = A^j r / sigma^j the Krylov vectors of a step and P, AP
+     the search directions of the previous step, a step needs
+
+       mu_m = (V_i, V_j), m = i + j = 0 ... 2s-1 (these depend only on i + j)
+       C = (AP)^dagger V
+
+     which are formed in one batched reduction.  The new directions
+     P' = V - P B, with B = (P^dagger A P)^-1 C, are A-conjugate to P,
+     and since r is orthogonal to P
+
+       P'^dagger A P' = sigma mu_{i+j+1} - C^dagger B
+       P'^dagger r = mu_i
+
+     give the step x += P' alpha, r -= A P' alpha without further
+     global sums.  The scale sigma, an estimate of |A| from the
+     previous step, keeps the powers of A in range.
+  */
+  template <typename Field>
+  void SStepCG::solve(Field &x, Field &b)
+  {
+    const int s = param.Nkrylov;
+    if (s < 1) errorQuda("Invalid s-step block size %d", s);
+
+    profile.Start(QUDA_PROFILE_INIT);
+
+    const double b2 = blas::norm2(b);
+    if (b2 == 0) {
+      profile.Stop(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      x = b;
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      return;
+    }
+
+    Field r(b);
+
+    ColorSpinorParam csParam(x);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    Field y(b, csParam);
+
+    mat(r, x, y);
+    double r2 = blas::xmyNorm(b, r);
+
+    csParam.setPrecision(param.precision_sloppy, x.Location());
+    Field tmp(x, csParam);
+
+    Field *tmp2_p = &tmp;
+    // tmp only needed for multi-gpu Wilson-like kernels
+    if (mat.Type() != typeid(DiracStaggeredPC).name() &&
+	mat.Type() != typeid(DiracStaggered).name() &&
+	mat.Type() != typeid(cpuDiracStaggeredPC).name() &&
+	mat.Type() != typeid(cpuDiracStaggered).name()) {
+      tmp2_p = new Field(x, csParam);
+    }
+    Field &tmp2 = *tmp2_p;
+
+    Field *x_sloppy;
+    if (param.precision_sloppy == x.Precision()) {
+      x_sloppy = &x;
+    } else {
+      x_sloppy = new Field(x, csParam);
+    }
+    Field &xSloppy = *x_sloppy;
+
+    // V[0] is the sloppy residual
+    std::vector<Field*> V(s+1), P(s), AP(s), P_old(s), AP_old(s);
+    csParam.create = QUDA_COPY_FIELD_CREATE;
+    V[0] = new Field(r, csParam);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    for (int j=0; j<s; j++) {
+      V[j+1] = new Field(x, csParam);
+      P[j] = new Field(x, csParam);
+      AP[j] = new Field(x, csParam);
+      P_old[j] = new Field(x, csParam);
+      AP_old[j] = new Field(x, csParam);
+    }
+    Field &rSloppy = *V[0];
+
+    blas::copy(y, x);
+    blas::zero(xSloppy);
+
+    const bool use_heavy_quark_res =
+      (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) ? true : false;
+
+    profile.Stop(QUDA_PROFILE_INIT);
+    profile.Start(QUDA_PROFILE_PREAMBLE);
+
+    double stop = b2*param.tol*param.tol; // stopping condition of solver
+
+    double heavy_quark_res = 0.0; // heavy quark residual
+    if(use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
+
+    std::vector<Complex> mu(2*s), C(s*s), W(s*s), B, L, L_old, alpha;
+    double sigma = 1.0;  // scale of the matrix powers
+    bool scaled = false; // whether sigma has been estimated yet
+    int rUpdate = 0;
+
+    double rNorm = sqrt(r2);
+    double r0Norm = rNorm;
+    double maxrx = rNorm;
+    double maxrr = rNorm;
+    double delta = param.delta;
+
+    int maxResIncrease = 0; // 0 means we have no tolerance
+    int resIncrease = 0;
+
+    profile.Stop(QUDA_PROFILE_PREAMBLE);
+    profile.Start(QUDA_PROFILE_COMPUTE);
+    blas_flops = 0;
+
+    int k=0;
+
+    PrintStats("SStepCG", k, r2, b2, heavy_quark_res);
+
+    bool restart = true; // no previous block to be conjugate to
+    bool breakdown = false;
+
+    while (k < param.maxiter) {
+      // matrix powers
+      for (int j=0; j<s; j++) {
+	matSloppy(*V[j+1], *V[j], tmp, tmp2);
+	if (sigma != 1.0) blas::ax(1.0/sigma, *V[j+1]);
+      }
+
+      { // the Gram matrix reduction
+	ReduceBatch batch;
+	for (int m=0; m<2*s; m++) {
+	  mu[m] = blas::cDotProduct(*V[m/2], *V[m - m/2]);
+	  batch.add(mu[m]);
+	}
+	if (!restart) {
+	  for (int i=0; i<s; i++) {
+	    for (int j=0; j<s; j++) {
+	      C[i*s+j] = blas::cDotProduct(*AP_old[i], *V[j]);
+	      batch.add(C[i*s+j]);
+	    }
+	  }
+	}
+	batch.flush();
+      }
+
+      r2 = real(mu[0]);
+      const double sigmaNew = sigma * real(mu[1]) / real(mu[0]); // Rayleigh quotient
+
+      // the projected operator of the new directions
+      for (int i=0; i<s; i++)
+	for (int j=0; j<s; j++) W[i*s+j] = sigma * mu[i+j+1];
+      if (!restart) {
+	B = C;
+	choleskySolve(B, L_old, s, s);
+	for (int i=0; i<s; i++)
+	  for (int j=0; j<s; j++)
+	    for (int l=0; l<s; l++) W[i*s+j] -= conj(C[l*s+i]) * B[l*s+j];
+      }
+      bool spd = cholesky(L, W, s);
+
+      // the first step may fail for want of a scale
+      if (!spd && !scaled) {
+	sigma = sigmaNew;
+	scaled = true;
+	continue;
+      }
+
+      // reliable update conditions
+      rNorm = sqrt(r2);
+      if (rNorm > maxrx) maxrx = rNorm;
+      if (rNorm > maxrr) maxrr = rNorm;
+      int updateX = (rNorm < delta*r0Norm && r0Norm <= maxrx) ? 1 : 0;
+      int updateR = ((rNorm < delta*maxrr && r0Norm <= maxrr) || updateX) ? 1 : 0;
+
+      // force a reliable update if we are within target tolerance (only if doing reliable updates)
+      if ( convergence(r2, heavy_quark_res, stop, param.tol_hq) && delta >= param.tol) updateX = 1;
+
+      // the basis has lost rank, so restart from the true residual
+      if (!spd) updateR = 1;
+
+      if (!restart && (updateR || updateX)) {
+	if (x.Precision() != xSloppy.Precision()) blas::copy(x, xSloppy);
+	blas::xpy(x, y);
+	mat(r, y, x); // here we can use x as tmp
+	r2 = blas::xmyNorm(b, r);
+
+	blas::copy(rSloppy, r);
+	blas::zero(xSloppy);
+
+	// break-out check if we have reached the limit of the precision
+	if (sqrt(r2) > r0Norm && updateX) { // reuse r0Norm for this
+	  warningQuda("SStepCG: new reliable residual norm %e is greater than previous reliable residual norm %e",
+		      sqrt(r2), r0Norm);
+	  rUpdate++;
+	  if (++resIncrease > maxResIncrease) break;
+	} else {
+	  resIncrease = 0;
+	}
+
+	rNorm = sqrt(r2);
+	maxrr = rNorm;
+	maxrx = rNorm;
+	r0Norm = rNorm;
+	rUpdate++;
+
+	if(use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(y,r).z);
+	if (convergence(r2, heavy_quark_res, stop, param.tol_hq)) break;
+
+	restart = true;
+	continue;
+      }
+
+      if (convergence(r2, heavy_quark_res, stop, param.tol_hq)) break;
+
+      if (!spd) {
+	breakdown = true;
+	break;
+      }
+
+      // P = V - P_old B, AP = A V - AP_old B
+      for (int j=0; j<s; j++) {
+	blas::copy(*P[j], *V[j]);
+	blas::copy(*AP[j], *V[j+1]);
+	blas::ax(sigma, *AP[j]);
+	if (!restart) {
+	  for (int i=0; i<s; i++) {
+	    blas::caxpy(-B[i*s+j], *P_old[i], *P[j]);
+	    blas::caxpy(-B[i*s+j], *AP_old[i], *AP[j]);
+	  }
+	}
+      }
+
+      // alpha = (P^dagger A P)^-1 P^dagger r
+      alpha.assign(mu.begin(), mu.begin()+s);
+      choleskySolve(alpha, L, s, 1);
+
+      for (int j=0; j<s; j++) {
+	blas::caxpy(alpha[j], *P[j], xSloppy);
+	blas::caxpy(-alpha[j], *AP[j], rSloppy);
+      }
+
+      std::swap(P, P_old);
+      std::swap(AP, AP_old);
+      std::swap(L, L_old);
+      sigma = sigmaNew;
+      scaled = true;
+      restart = false;
+
+      k += s;
+
+      if (use_heavy_quark_res) {
+	blas::copy(tmp,y);
+	heavy_quark_res = sqrt(blas::xpyHeavyQuarkResidualNorm(xSloppy, tmp, rSloppy).z);
+      }
+
+      PrintStats("SStepCG", k, r2, b2, heavy_quark_res);
+    }
+
+    if (x.Precision() != xSloppy.Precision()) blas::copy(x, xSloppy);
+    blas::xpy(y, x);
+
+    profile.Stop(QUDA_PROFILE_COMPUTE);
+    profile.Start(QUDA_PROFILE_EPILOGUE);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (quda::blas_flops + mat.flops() + matSloppy.flops())*1e-9;
+    reduceDouble(gflops);
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (breakdown) {
+      warningQuda("SStepCG: the s = %d Krylov basis is numerically rank deficient after %d iterations, "
+		  "finishing with CG", s, k);
+      // the current solution is used as the initial guess
+      CG cg(const_cast<DiracMatrix&>(mat), const_cast<DiracMatrix&>(matSloppy), param, profile);
+      profile.Stop(QUDA_PROFILE_EPILOGUE);
+      cg(x, b);
+      profile.Start(QUDA_PROFILE_EPILOGUE);
+    } else if (k >= param.maxiter) {
+      warningQuda("Exceeded maximum iterations %d", param.maxiter);
+    }
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("SStepCG: Reliable updates = %d\n", rUpdate);
+
+    // compute the true residuals
+    mat(r, x, y);
+    param.true_res = sqrt(blas::xmyNorm(b, r) / b2);
+#if (__COMPUTE_CAPABILITY__ >= 200)
+    param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x,r).z);
+#else
+    param.true_res_hq = 0.0;
+#endif
+
+    if (!breakdown) PrintSummary("SStepCG", k, r2, b2);
+
+    // reset the flops counters
+    quda::blas_flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.Stop(QUDA_PROFILE_EPILOGUE);
+    profile.Start(QUDA_PROFILE_FREE);
+
+    for (int j=0; j<s; j++) {
+      delete AP_old[j];
+      delete P_old[j];
+      delete AP[j];
+      delete P[j];
+      delete V[j+1];
+    }
+    delete V[0];
+
+    if (&tmp2 != &tmp) delete tmp2_p;
+    if (param.precision_sloppy != x.Precision()) delete x_sloppy;
+
+    profile.Stop(QUDA_PROFILE_FREE);
+  }
+
+  void SStepCG::operator()(cudaColorSpinorField &x, cudaColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "sstep cg");
+    solve(x, b);
+  }
+
+  void SStepCG::operator()(cpuColorSpinorField &x, cpuColorSpinorField &b)
+  {
+    ProfileRegion region(profile, "sstep cg");
+    solve(x, b);
+  }
+
+} // namespace quda
@@ -0,0 +1,131 @@
+#include <vector>
+
+#include <quda_internal.h>
+#include <lattice_geometry.h>
+
+namespace quda {
+
+  static std::vector<LatticeGeometry*> geometryCache;
+
+  LatticeGeometry::LatticeGeometry(const int *X, const int nFace, const int *ghostDim_)
+    : volume(1), nFace(nFace)
+  {
+    if (nFace < 1) errorQuda("Invalid nFace %d", nFace);
+    for (int d=0; d<4; d++) {
+      x[d] = X[d];
+      volume *= X[d];
+      ghostDim[d] = ghostDim_ ? (ghostDim_[d] ? 1 : 0) : 0;
+    }
+    if (x[0] % 2) errorQuda("X dimension %d must be even", x[0]);
+    volumeCB = volume / 2;
+    for (int d=0; d<4; d++) {
+      faceVolumeCB[d] = volumeCB / x[d];
+      if (ghostDim[d] && x[d] < nFace)
+	errorQuda("Dimension %d of length %d is smaller than nFace=%d", d, x[d], nFace);
+    }
+
+    table[0] = (int*)safe_malloc(2*8*volumeCB*sizeof(int));
+    computeTable(table[0], 1);
+    if (nFace > 1) {
+      table[1] = (int*)safe_malloc(2*8*volumeCB*sizeof(int));
+      computeTable(table[1], nFace);
+    } else {
+      table[1] = table[0];
+    }
+
+    computeFaceSites();
+  }
+
+  LatticeGeometry::~LatticeGeometry()
+  {
+    for (int parity=0; parity<2; parity++)
+      for (int mu=0; mu<4; mu++) if (faceSites[parity][mu]) host_free(faceSites[parity][mu]);
+    if (table[1] != table[0]) host_free(table[1]);
+    host_free(table[0]);
+  }
+
+  void LatticeGeometry::Coords(int *coord, int cb, int parity) const
+  {
+    const int za = cb / (x[0]/2);
+    const int zb = za / x[1];
+    coord[1] = za - zb*x[1];
+    coord[3] = zb / x[2];
+    coord[2] = zb - coord[3]*x[2];
+    coord[0] = 2*cb - za*x[0] + ((coord[1] + coord[2] + coord[3] + parity) & 1);
+  }
+
+  void LatticeGeometry::computeTable(int *t, int distance)
+  {
+    for (int parity=0; parity<2; parity++) {
+#pragma omp parallel for
+      for (int cb=0; cb<volumeCB; cb++) {
+	int c[4];
+	Coords(c, cb, parity);
+
+	for (int dir=0; dir<8; dir++) {
+	  const int mu = dir/2;
+	  int y[4] = {c[0], c[1], c[2], c[3]};
+	  y[mu] += (dir % 2 == 0) ? distance : -distance;
+
+	  int n;
+	  if (ghostDim[mu] && (y[mu] < 0 || y[mu] >= x[mu])) {
+	    int face = 0;
+	    for (int nu=3; nu>=0; nu--) if (nu != mu) face = face*x[nu] + c[nu];
+	    const int depth = (y[mu] < 0) ? -y[mu] - 1 : y[mu] - x[mu];
+	    n = -(depth*faceVolumeCB[mu] + face/2) - 1;
+	  } else {
+	    y[mu] = ((y[mu] % x[mu]) + x[mu]) % x[mu];
+	    n = (((y[3]*x[2] + y[2])*x[1] + y[1])*x[0] + y[0]) / 2;
+	  }
+	  t[(parity*8 + dir)*volumeCB + cb] = n;
+	}
+      }
+    }
+  }
+
+  void LatticeGeometry::computeFaceSites()
+  {
+    for (int parity=0; parity<2; parity++) {
+      for (int mu=0; mu<4; mu++) {
+	faceSites[parity][mu] = 0;
+	nFaceSites[parity][mu] = 0;
+	if (!ghostDim[mu]) continue;
+
+	std::vector<int> sites;
+	for (int cb=0; cb<volumeCB; cb++) {
+	  int c[4];
+	  Coords(c, cb, parity);
+	  if (c[mu] < nFace || c[mu] >= x[mu] - nFace) sites.push_back(cb);
+	}
+
+	nFaceSites[parity][mu] = sites.size();
+	faceSites[parity][mu] = (int*)safe_malloc(sites.size()*sizeof(int));
+	for (unsigned int i=0; i<sites.size(); i++) faceSites[parity][mu][i] = sites[i];
+      }
+    }
+  }
+
+  const LatticeGeometry& LatticeGeometry::Get(const int *X, const int nFace, const int *ghostDim)
+  {
+    for (unsigned int i=0; i<geometryCache.size(); i++) {
+      const LatticeGeometry &g = *geometryCache[i];
+      bool match = (g.nFace == nFace);
+      for (int d=0; d<4; d++) {
+	int ghost = ghostDim ? (ghostDim[d] ? 1 : 0) : 0;
+	if (g.x[d] != X[d] || g.ghostDim[d] != ghost) match = false;
+      }
+      if (match) return g;
+    }
+
+    LatticeGeometry *g = new LatticeGeometry(X, nFace, ghostDim);
+    geometryCache.push_back(g);
+    return *g;
+  }
+
+  void LatticeGeometry::freeCache()
+  {
+    for (unsigned int i=0; i<geometryCache.size(); i++) delete geometryCache[i];
+    geometryCache.clear();
+  }
+
+} // namespace quda
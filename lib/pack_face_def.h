@@ -1269,7 +1269,7 @@ class PackFace : public Tunable {
     vol << in->X()[2] << "x";
     vol << in->X()[3];    
     aux << "threads=" <<threads() << ",stride=" << in->Stride() << ",prec=" << sizeof(((FloatN*)0)->x);
-    return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+    return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
   }  
   
   virtual void apply(const cudaStream_t &stream) = 0;
@@ -452,7 +452,7 @@ public:
     vol << blasConstants.x[2] << "x";
     vol << blasConstants.x[3];    
     aux << "stride=" << blasConstants.stride << ",prec=" << arg.X.Precision();
-    return TuneKey(vol.str(), typeid(arg.r).name(), aux.str());
+    return TuneKey(vol.str(), typeid(arg.r).name(), aux.str(), QUDA_SOURCE_HASH);
   }  
 
   void apply(const cudaStream_t &stream) {
@@ -31,6 +31,10 @@ namespace quda {
       report("MR");
       solver = new MR(mat, param, profile);
       break;
+    case QUDA_SSTEP_CG_INVERTER:
+      report("SStepCG");
+      solver = new SStepCG(mat, matSloppy, param, profile);
+      break;
     default:
       errorQuda("Invalid solver type");
     }
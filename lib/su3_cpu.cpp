@@ -0,0 +1,277 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <quda_internal.h>
+#include <su3_cpu.h>
+
+// The kernels are written as plain loops over the sites of a block,
+// which the compiler vectorizes.  On x86 with GCC-compatible
+// compilers each kernel is additionally instantiated inside AVX2 and
+// AVX-512 target functions, so that the same source is vectorized for
+// the wider instruction sets without requiring them at compile time.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+  (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define HOST_SIMD_DISPATCH
+#endif
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+namespace quda {
+
+  namespace su3_cpu {
+
+    // Component c of the block at site i
+#define S(field, c) field[(c)*stride + i]
+
+    template <typename Float>
+    static ALWAYS_INLINE void matVec(Float * __restrict__ out, const Float * __restrict__ U,
+				     const Float * __restrict__ v, int n, int stride) {
+      for (int a=0; a<3; a++) {
+	const Float * __restrict__ u = U + 6*a*stride;
+	for (int i=0; i<n; i++) {
+	  S(out,2*a+0) =
+	    S(u,0)*S(v,0) - S(u,1)*S(v,1) +
+	    S(u,2)*S(v,2) - S(u,3)*S(v,3) +
+	    S(u,4)*S(v,4) - S(u,5)*S(v,5);
+	  S(out,2*a+1) =
+	    S(u,0)*S(v,1) + S(u,1)*S(v,0) +
+	    S(u,2)*S(v,3) + S(u,3)*S(v,2) +
+	    S(u,4)*S(v,5) + S(u,5)*S(v,4);
+	}
+      }
+    }
+
+    template <typename Float>
+    static ALWAYS_INLINE void matDagVec(Float * __restrict__ out, const Float * __restrict__ U,
+					const Float * __restrict__ v, int n, int stride) {
+      for (int a=0; a<3; a++) {
+	const Float * __restrict__ u = U + 2*a*stride; // column a
+	for (int i=0; i<n; i++) {
+	  S(out,2*a+0) =
+	    S(u, 0)*S(v,0) + S(u, 1)*S(v,1) +
+	    S(u, 6)*S(v,2) + S(u, 7)*S(v,3) +
+	    S(u,12)*S(v,4) + S(u,13)*S(v,5);
+	  S(out,2*a+1) =
+	    S(u, 0)*S(v,1) - S(u, 1)*S(v,0) +
+	    S(u, 6)*S(v,3) - S(u, 7)*S(v,2) +
+	    S(u,12)*S(v,5) - S(u,13)*S(v,4);
+	}
+      }
+    }
+
+    template <typename Float>
+    static ALWAYS_INLINE void matMat(Float * __restrict__ out, const Float * __restrict__ A,
+				     const Float * __restrict__ B, int n, int stride) {
+      for (int a=0; a<3; a++) {
+	for (int b=0; b<3; b++) {
+	  const Float * __restrict__ x = A + 6*a*stride; // row a
+	  const Float * __restrict__ y = B + 2*b*stride; // column b
+	  for (int i=0; i<n; i++) {
+	    S(out,6*a+2*b+0) =
+	      S(x,0)*S(y, 0) - S(x,1)*S(y, 1) +
+	      S(x,2)*S(y, 6) - S(x,3)*S(y, 7) +
+	      S(x,4)*S(y,12) - S(x,5)*S(y,13);
+	    S(out,6*a+2*b+1) =
+	      S(x,0)*S(y, 1) + S(x,1)*S(y, 0) +
+	      S(x,2)*S(y, 7) + S(x,3)*S(y, 6) +
+	      S(x,4)*S(y,13) + S(x,5)*S(y,12);
+	  }
+	}
+      }
+    }
+
+    // The eight spin projectors (1 -/+ gamma_mu) in the DeGrand-Rossi
+    // basis are rank two.  For projector p, the upper half spinor is
+    //   h_s = psi_s + proj[p][s].c * psi_{proj[p][s].k}, s = 0,1
+    // and the lower components of the result are recovered from
+    //   r_s = recon[p][s-2].c * h_{recon[p][s-2].k}, s = 2,3
+    // where c is one of +/-1, +/-i.
+    struct SpinCoeff { int k; int re; int im; };
+
+    static const SpinCoeff proj[8][2] = {
+      { {3, 0,-1}, {2, 0,-1} }, { {3, 0, 1}, {2, 0, 1} },
+      { {3, 1, 0}, {2,-1, 0} }, { {3,-1, 0}, {2, 1, 0} },
+      { {2, 0,-1}, {3, 0, 1} }, { {2, 0, 1}, {3, 0,-1} },
+      { {2,-1, 0}, {3,-1, 0} }, { {2, 1, 0}, {3, 1, 0} }
+    };
+
+    static const SpinCoeff recon[8][2] = {
+      { {1, 0, 1}, {0, 0, 1} }, { {1, 0,-1}, {0, 0,-1} },
+      { {1,-1, 0}, {0, 1, 0} }, { {1, 1, 0}, {0,-1, 0} },
+      { {0, 0, 1}, {1, 0,-1} }, { {0, 0,-1}, {1, 0, 1} },
+      { {0,-1, 0}, {1,-1, 0} }, { {0, 1, 0}, {1, 1, 0} }
+    };
+
+    template <typename Float>
+    static ALWAYS_INLINE void spinProject(Float * __restrict__ h, const Float * __restrict__ psi,
+					  int p, int n, int stride) {
+      for (int s=0; s<2; s++) {
+	const Float c_re = proj[p][s].re, c_im = proj[p][s].im;
+	const Float * __restrict__ x = psi + 6*s*stride;
+	const Float * __restrict__ y = psi + 6*proj[p][s].k*stride;
+	Float * __restrict__ z = h + 6*s*stride;
+	for (int c=0; c<3; c++) {
+	  for (int i=0; i<n; i++) {
+	    S(z,2*c+0) = S(x,2*c+0) + c_re*S(y,2*c+0) - c_im*S(y,2*c+1);
+	    S(z,2*c+1) = S(x,2*c+1) + c_re*S(y,2*c+1) + c_im*S(y,2*c+0);
+	  }
+	}
+      }
+    }
+
+    template <typename Float>
+    static ALWAYS_INLINE void spinReconstruct(Float * __restrict__ out, const Float * __restrict__ h,
+					      int p, int n, int stride) {
+      for (int c=0; c<12; c++) {
+	for (int i=0; i<n; i++) S(out,c) += S(h,c);
+      }
+      for (int s=2; s<4; s++) {
+	const Float c_re = recon[p][s-2].re, c_im = recon[p][s-2].im;
+	const Float * __restrict__ y = h + 6*recon[p][s-2].k*stride;
+	Float * __restrict__ z = out + 6*s*stride;
+	for (int c=0; c<3; c++) {
+	  for (int i=0; i<n; i++) {
+	    S(z,2*c+0) += c_re*S(y,2*c+0) - c_im*S(y,2*c+1);
+	    S(z,2*c+1) += c_re*S(y,2*c+1) + c_im*S(y,2*c+0);
+	  }
+	}
+      }
+    }
+
+#undef S
+
+    // Instantiate each kernel for every instruction set as
+    // name_scalar, name_avx2 and name_avx512.
+#ifdef HOST_SIMD_DISPATCH
+#define INSTANTIATE(name, params, args)					\
+    template <typename Float> static void name##_scalar params { name args; } \
+    template <typename Float> __attribute__((target("avx2,fma")))	\
+    static void name##_avx2 params { name args; }			\
+    template <typename Float> __attribute__((target("avx512f")))	\
+    static void name##_avx512 params { name args; }
+#else
+#define INSTANTIATE(name, params, args)					\
+    template <typename Float> static void name##_scalar params { name args; }
+#endif
+
+    INSTANTIATE(matVec, (Float *out, const Float *U, const Float *v, int n, int stride),
+		(out, U, v, n, stride))
+    INSTANTIATE(matDagVec, (Float *out, const Float *U, const Float *v, int n, int stride),
+		(out, U, v, n, stride))
+    INSTANTIATE(matMat, (Float *out, const Float *A, const Float *B, int n, int stride),
+		(out, A, B, n, stride))
+    INSTANTIATE(spinProject, (Float *h, const Float *psi, int p, int n, int stride),
+		(h, psi, p, n, stride))
+    INSTANTIATE(spinReconstruct, (Float *out, const Float *h, int p, int n, int stride),
+		(out, h, p, n, stride))
+
+#undef INSTANTIATE
+
+    static HostSimdType supportedType() {
+#ifdef HOST_SIMD_DISPATCH
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f")) return HOST_SIMD_AVX512;
+      if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return HOST_SIMD_AVX2;
+#endif
+      return HOST_SIMD_SCALAR;
+    }
+
+    static int simdType = -1;
+
+    static void initSimdType() {
+      HostSimdType type = supportedType();
+      char *env = getenv("QUDA_HOST_SIMD");
+      if (env) {
+	HostSimdType request;
+	if (strcmp(env, "scalar") == 0) request = HOST_SIMD_SCALAR;
+	else if (strcmp(env, "avx2") == 0) request = HOST_SIMD_AVX2;
+	else if (strcmp(env, "avx512") == 0) request = HOST_SIMD_AVX512;
+	else errorQuda("Unknown QUDA_HOST_SIMD value %s", env);
+
+	if (request > type) warningQuda("QUDA_HOST_SIMD=%s is not supported by this CPU, using %s",
+					env, hostSimdString(type));
+	else type = request;
+      }
+      simdType = type;
+    }
+
+  } // namespace su3_cpu
+
+  HostSimdType hostSimdType() {
+    if (su3_cpu::simdType < 0) su3_cpu::initSimdType();
+    return (HostSimdType)su3_cpu::simdType;
+  }
+
+  void setHostSimdType(HostSimdType type) {
+    HostSimdType supported = su3_cpu::supportedType();
+    if (type > supported) {
+      warningQuda("%s is not supported by this CPU, using %s", hostSimdString(type), hostSimdString(supported));
+      type = supported;
+    }
+    su3_cpu::simdType = type;
+  }
+
+  const char *hostSimdString(HostSimdType type) {
+    switch (type) {
+    case HOST_SIMD_SCALAR: return "scalar";
+    case HOST_SIMD_AVX2: return "avx2";
+    case HOST_SIMD_AVX512: return "avx512";
+    default: return "unknown";
+    }
+  }
+
+#ifdef HOST_SIMD_DISPATCH
+#define DISPATCH(name, Float, args)					\
+  switch (hostSimdType()) {						\
+  case HOST_SIMD_AVX512: su3_cpu::name##_avx512<Float> args; break;	\
+  case HOST_SIMD_AVX2: su3_cpu::name##_avx2<Float> args; break;	\
+  default: su3_cpu::name##_scalar<Float> args; break;			\
+  }
+#else
+#define DISPATCH(name, Float, args) su3_cpu::name##_scalar<Float> args;
+#endif
+
+  void su3MatVecCpu(double *out, const double *U, const double *v, int n, int stride) {
+    DISPATCH(matVec, double, (out, U, v, n, stride));
+  }
+
+  void su3MatVecCpu(float *out, const float *U, const float *v, int n, int stride) {
+    DISPATCH(matVec, float, (out, U, v, n, stride));
+  }
+
+  void su3MatDagVecCpu(double *out, const double *U, const double *v, int n, int stride) {
+    DISPATCH(matDagVec, double, (out, U, v, n, stride));
+  }
+
+  void su3MatDagVecCpu(float *out, const float *U, const float *v, int n, int stride) {
+    DISPATCH(matDagVec, float, (out, U, v, n, stride));
+  }
+
+  void su3MatMatCpu(double *out, const double *A, const double *B, int n, int stride) {
+    DISPATCH(matMat, double, (out, A, B, n, stride));
+  }
+
+  void su3MatMatCpu(float *out, const float *A, const float *B, int n, int stride) {
+    DISPATCH(matMat, float, (out, A, B, n, stride));
+  }
+
+  void spinProjectCpu(double *h, const double *psi, int proj, int n, int stride) {
+    DISPATCH(spinProject, double, (h, psi, proj, n, stride));
+  }
+
+  void spinProjectCpu(float *h, const float *psi, int proj, int n, int stride) {
+    DISPATCH(spinProject, float, (h, psi, proj, n, stride));
+  }
+
+  void spinReconstructCpu(double *out, const double *h, int proj, int n, int stride) {
+    DISPATCH(spinReconstruct, double, (out, h, proj, n, stride));
+  }
+
+  void spinReconstructCpu(float *out, const float *h, int proj, int n, int stride) {
+    DISPATCH(spinReconstruct, float, (out, h, proj, n, stride));
+  }
+
+#undef DISPATCH
+
+} // namespace quda
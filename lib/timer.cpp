@@ -1,7 +1,185 @@
+#include <stdlib.h>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
 #include <quda_internal.h>
+#include <comm_quda.h>
 
 namespace quda {
 
+  bool TimeProfile::tracing = getenv("QUDA_PROFILE_OUTPUT") != NULL;
+
+  // bound on the number of intervals traced by each profile
+  static const size_t maxTraceEvents = 1 << 20;
+
+  // never destroyed, since profiles with static storage may outlive them
+  static std::vector<TimeProfile*>& liveProfiles() {
+    static std::vector<TimeProfile*> *live = new std::vector<TimeProfile*>;
+    return *live;
+  }
+
+  // what is left of the profiles that have been destroyed, e.g., those of Dirac operators
+  static std::map<std::string, TimeProfile*>& retiredProfiles() {
+    static std::map<std::string, TimeProfile*> *retired = new std::map<std::string, TimeProfile*>;
+    return *retired;
+  }
+
+  TimeProfile::Region::Region(const std::string &name, int parent) : name(name), parent(parent) {
+    for (int i=0; i<QUDA_PROFILE_COUNT; i++) {
+      time[i] = 0.0;
+      count[i] = 0;
+    }
+  }
+
+  TimeProfile::TimeProfile(std::string fname) 
+    : fname(fname), switchOff(false), current(-1), registered(true) {
+    liveProfiles().push_back(this);
+  }
+
+  TimeProfile::TimeProfile(const std::string &fname, bool registered) 
+    : fname(fname), switchOff(false), current(-1), registered(registered) {
+    if (registered) liveProfiles().push_back(this);
+  }
+
+  TimeProfile::TimeProfile(const TimeProfile &p) 
+    : fname(p.fname), switchOff(p.switchOff), region(p.region), child(p.child), current(p.current), 
+      trace(p.trace), registered(true) {
+    for (int i=0; i<QUDA_PROFILE_COUNT; i++) profile[i] = p.profile[i];
+    liveProfiles().push_back(this);
+  }
+
+  TimeProfile& TimeProfile::operator=(const TimeProfile &p) {
+    if (&p != this) {
+      fname = p.fname;
+      for (int i=0; i<QUDA_PROFILE_COUNT; i++) profile[i] = p.profile[i];
+      switchOff = p.switchOff;
+      region = p.region;
+      child = p.child;
+      current = p.current;
+      trace = p.trace;
+    }
+    return *this;
+  }
+
+  TimeProfile::~TimeProfile() {
+    if (!registered) return;
+
+    std::vector<TimeProfile*> &live = liveProfiles();
+    for (unsigned int i=0; i<live.size(); i++) {
+      if (live[i] == this) { live.erase(live.begin() + i); break; }
+    }
+
+    if (profile[QUDA_PROFILE_TOTAL].count > 0 || region.size() > 0) {
+      std::map<std::string, TimeProfile*> &retired = retiredProfiles();
+      if (!retired.count(fname)) retired[fname] = new TimeProfile(fname, false);
+      retired[fname]->Merge(*this);
+    }
+  }
+
+  double TimeProfile::Now() {
+    timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + 0.000001*now.tv_usec;
+  }
+
+  void TimeProfile::Trace(const std::string &name, double start, double duration, bool nested) {
+    if (trace.size() >= maxTraceEvents) {
+      static bool warned = false;
+      if (!warned) {
+	warningQuda("Trace of %s is full, further intervals are dropped", fname.c_str());
+	warned = true;
+      }
+      return;
+    }
+
+    Event event;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.nested = nested;
+    trace.push_back(event);
+  }
+
+  void TimeProfile::Record(QudaProfileType idx) {
+    const Timer &t = profile[idx];
+    for (int r=current; r>=0; r=region[r].parent) {
+      region[r].time[idx] += t.last;
+      region[r].count[idx]++;
+    }
+    if (tracing) Trace(pname[idx], t.start.tv_sec + 0.000001*t.start.tv_usec, t.last, true);
+  }
+
+  int TimeProfile::Child(int parent, const std::string &name) {
+    const std::pair<int, std::string> key(parent, name);
+    std::map<std::pair<int, std::string>, int>::const_iterator it = child.find(key);
+    if (it != child.end()) return it->second;
+    region.push_back(Region(name, parent));
+    return child[key] = region.size() - 1;
+  }
+
+  void TimeProfile::StartRegion(const std::string &name) {
+    const int r = Child(current, name);
+    region[r].timer.Start();
+    current = r;
+  }
+
+  void TimeProfile::StopRegion(const std::string &name) {
+    if (current < 0 || region[current].name != name) {
+      errorQuda("Cannot stop region %s of %s, since the innermost open region is %s", 
+		name.c_str(), fname.c_str(), current < 0 ? "none" : region[current].name.c_str());
+    }
+
+    Timer &t = region[current].timer;
+    t.Stop();
+    if (tracing) Trace(name, t.start.tv_sec + 0.000001*t.start.tv_usec, t.last, true);
+    current = region[current].parent;
+  }
+
+  void TimeProfile::Interval(const std::string &name, double start, double stop) {
+    Timer &t = region[Child(current, name)].timer;
+    t.last = stop - start;
+    t.time += t.last;
+    t.count++;
+    if (tracing) Trace(name, start, t.last, false);
+  }
+
+  void TimeProfile::Merge(const TimeProfile &p) {
+    for (int i=0; i<QUDA_PROFILE_COUNT; i++) {
+      profile[i].time += p.profile[i].time;
+      profile[i].count += p.profile[i].count;
+    }
+
+    // regions are always added after their parent
+    std::vector<int> index(p.region.size());
+    for (unsigned int i=0; i<p.region.size(); i++) {
+      const Region &from = p.region[i];
+      index[i] = Child(from.parent < 0 ? -1 : index[from.parent], from.name);
+      Region &to = region[index[i]];
+      to.timer.time += from.timer.time;
+      to.timer.count += from.timer.count;
+      for (int j=0; j<QUDA_PROFILE_COUNT; j++) {
+	to.time[j] += from.time[j];
+	to.count[j] += from.count[j];
+      }
+    }
+
+    for (unsigned int i=0; i<p.trace.size(); i++) {
+      const Event &e = p.trace[i];
+      Trace(e.name, e.start, e.duration, e.nested);
+    }
+  }
+
+  void TimeProfile::PrintRegions(int parent, int depth) {
+    for (unsigned int i=0; i<region.size(); i++) {
+      if (region[i].parent != parent) continue;
+      printfQuda("     %*s%-*s = %f secs, with %8d calls\n", 2*depth, "", 22-2*depth, 
+		 region[i].name.c_str(), region[i].timer.time, region[i].timer.count);
+      PrintRegions(i, depth+1);
+    }
+  }
+
   /**< Print out the profile information */
   void TimeProfile::Print() {
     if (profile[QUDA_PROFILE_TOTAL].time > 0.0) {
@@ -31,7 +209,11 @@ namespace quda {
       warningQuda("Accounted time %f secs in %s is greater than total time %f secs\n", 
 		  accounted, (const char*)&fname[0], profile[QUDA_PROFILE_TOTAL].time);
     }
-    
+
+    if (region.size() > 0) {
+      printfQuda("     regions:\n");
+      PrintRegions(-1, 0);
+    }
   }
 
   std::string TimeProfile::pname[] = { "download",  "upload", "init", "preamble", "compute", 
@@ -41,5 +223,219 @@ namespace quda {
 				       "comms", "comms start", "comms query", "constant", 
 				       "total" };
   
+
+  /**< Statistics of a timer across ranks */
+  struct ProfileStats {
+    double calls; // mean number of calls
+    double mean;
+    double min;
+    double max;
+  };
+
+  static std::string jsonString(const std::string &str) {
+    std::string quoted = "\"";
+    for (unsigned int i=0; i<str.size(); i++) {
+      if (str[i] == '"' || str[i] == '\\') quoted += '\\';
+      quoted += str[i];
+    }
+    return quoted + "\"";
+  }
+
+  // the key of each timer of a profile: the function, the path of
+  // the enclosing regions, and the category, if any
+  static std::string regionKey(const TimeProfile &p, int r) {
+    return r < 0 ? p.fname : regionKey(p, p.region[r].parent) + "/" + p.region[r].name;
+  }
+
+  static void collectTimers(const TimeProfile &p, std::map<std::string, std::pair<double,int> > &timers) {
+    for (int i=0; i<QUDA_PROFILE_COUNT; i++) {
+      if (p.profile[i].count > 0) 
+	timers[p.fname + ":" + p.pname[i]] = std::make_pair(p.profile[i].time, p.profile[i].count);
+    }
+    for (unsigned int r=0; r<p.region.size(); r++) {
+      const TimeProfile::Region &region = p.region[r];
+      const std::string key = regionKey(p, r);
+      timers[key] = std::make_pair(region.timer.time, region.timer.count);
+      for (int i=0; i<QUDA_PROFILE_COUNT; i++) {
+	if (region.count[i] > 0) timers[key + ":" + p.pname[i]] = std::make_pair(region.time[i], region.count[i]);
+      }
+    }
+  }
+
+  static void writeStats(std::ostream &out, const ProfileStats &s) {
+    out << "\"calls\": " << s.calls << ", \"mean\": " << s.mean 
+	<< ", \"min\": " << s.min << ", \"max\": " << s.max;
+  }
+
+  static void writeCategories(std::ostream &out, const std::string &key, const std::string &indent,
+			      std::map<std::string, ProfileStats> &stats) {
+    out << indent << "\"categories\": {";
+    bool first = true;
+    for (int i=0; i<QUDA_PROFILE_COUNT; i++) {
+      std::map<std::string, ProfileStats>::iterator s = stats.find(key + ":" + TimeProfile::pname[i]);
+      if (s == stats.end()) continue;
+      out << (first ? "\n" : ",\n") << indent << "  " << jsonString(TimeProfile::pname[i]) << ": {";
+      writeStats(out, s->second);
+      out << "}";
+      first = false;
+    }
+    out << (first ? "}" : "\n" + indent + "}");
+  }
+
+  static void writeRegions(std::ostream &out, const TimeProfile &p, int parent, const std::string &indent,
+			   std::map<std::string, ProfileStats> &stats) {
+    out << indent << "\"regions\": [";
+    bool first = true;
+    for (unsigned int r=0; r<p.region.size(); r++) {
+      if (p.region[r].parent != parent) continue;
+      const std::string key = regionKey(p, r);
+      out << (first ? "\n" : ",\n") << indent << "  {\"name\": " << jsonString(p.region[r].name) << ", ";
+      writeStats(out, stats[key]);
+      out << ",\n";
+      writeCategories(out, key, indent + "   ", stats);
+      out << ",\n";
+      writeRegions(out, p, r, indent + "   ", stats);
+      out << "}";
+      first = false;
+    }
+    out << (first ? "]" : "\n" + indent + "]");
+  }
+
+  void TimeProfile::Save() {
+    const char *prefix = getenv("QUDA_PROFILE_OUTPUT");
+    if (!prefix) return;
+
+    // profiles of the same function, e.g., of each Dirac operator, are reported together
+    std::vector<TimeProfile*> all(liveProfiles());
+    std::map<std::string, TimeProfile*> &retired = retiredProfiles();
+    for (std::map<std::string, TimeProfile*>::iterator it = retired.begin(); it != retired.end(); it++) 
+      all.push_back(it->second);
+
+    std::map<std::string, TimeProfile*> combined;
+    for (unsigned int i=0; i<all.size(); i++) {
+      if (!combined.count(all[i]->fname)) combined[all[i]->fname] = new TimeProfile(all[i]->fname, false);
+      combined[all[i]->fname]->Merge(*all[i]);
+    }
+
+    std::map<std::string, std::pair<double,int> > timers;
+    for (std::map<std::string, TimeProfile*>::iterator it = combined.begin(); it != combined.end(); it++) 
+      collectTimers(*it->second, timers);
+
+    // reduce the timers of rank 0, each rank taking zero for those it has not seen
+    std::string keys;
+    if (comm_rank() == 0) {
+      for (std::map<std::string, std::pair<double,int> >::iterator t = timers.begin(); t != timers.end(); t++)
+	keys += t->first + "\n";
+    }
+    size_t size = keys.size();
+    comm_broadcast(&size, sizeof(size_t));
+    if (comm_rank() != 0) {
+      char *buf = new char[size+1];
+      comm_broadcast(buf, size);
+      buf[size] = '\0';
+      keys = buf;
+      delete[] buf;
+    } else if (size > 0) {
+      comm_broadcast(const_cast<char*>(keys.c_str()), size);
+    }
+
+    std::vector<std::string> key;
+    std::istringstream lines(keys);
+    for (std::string line; std::getline(lines, line); ) key.push_back(line);
+
+    const int n = key.size();
+    const int ranks = comm_size();
+    std::vector<double> sum(2*n+1, 0.0);
+    for (int i=0; i<n; i++) {
+      if (!timers.count(key[i])) continue;
+      sum[2*i+0] = timers[key[i]].first;
+      sum[2*i+1] = timers[key[i]].second;
+    }
+    if (n > 0) comm_allreduce_array(&sum[0], 2*n);
+
+    std::map<std::string, ProfileStats> stats;
+    // the maxima of the times and of their negatives, i.e., minus the minima
+    std::vector<double> max(2*n+1, 0.0);
+    for (int i=0; i<n; i++) {
+      const double time = timers.count(key[i]) ? timers[key[i]].first : 0.0;
+      max[i] = time;
+      max[n+i] = -time;
+    }
+    if (n > 0) comm_allreduce_max_array(&max[0], 2*n);
+
+    for (int i=0; i<n; i++) {
+      ProfileStats &s = stats[key[i]];
+      s.calls = sum[2*i+1] / ranks;
+      s.mean = sum[2*i+0] / ranks;
+      s.min = -max[n+i];
+      s.max = max[i];
+    }
+
+    if (comm_rank() == 0) {
+      const std::string filename = std::string(prefix) + ".json";
+      std::ofstream out(filename.c_str());
+      if (!out) {
+	warningQuda("Cannot open %s for writing", filename.c_str());
+      } else {
+	out << std::setprecision(9);
+	out << "{\n  \"ranks\": " << ranks << ",\n  \"profiles\": [";
+	bool first = true;
+	for (std::map<std::string, TimeProfile*>::iterator it = combined.begin(); it != combined.end(); it++) {
+	  const TimeProfile &p = *it->second;
+	  out << (first ? "\n" : ",\n") << "    {\"name\": " << jsonString(p.fname) << ",\n";
+	  writeCategories(out, p.fname, "     ", stats);
+	  out << ",\n";
+	  writeRegions(out, p, -1, "     ", stats);
+	  out << "}";
+	  first = false;
+	}
+	out << "\n  ]\n}\n";
+	if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Wrote profile to %s\n", filename.c_str());
+      }
+    }
+
+    // every rank is a process of the trace, and every function one of its threads
+    std::ostringstream filename;
+    filename << prefix << "." << comm_rank() << ".trace.json";
+    std::ofstream out(filename.str().c_str());
+    if (!out) {
+      warningQuda("Cannot open %s for writing", filename.str().c_str());
+    } else {
+      const int pid = comm_rank();
+      out << std::fixed << std::setprecision(3);
+      out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+      out << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << pid 
+	  << ", \"args\": {\"name\": \"rank " << pid << "\"}}";
+
+      int tid = 0, id = 0;
+      for (std::map<std::string, TimeProfile*>::iterator it = combined.begin(); it != combined.end(); it++, tid++) {
+	const TimeProfile &p = *it->second;
+	const std::string cat = jsonString(p.fname);
+	out << ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << pid << ", \"tid\": " << tid
+	    << ", \"args\": {\"name\": " << cat << "}}";
+
+	for (unsigned int i=0; i<p.trace.size(); i++) {
+	  const Event &e = p.trace[i];
+	  const std::string common = "{\"name\": " + jsonString(e.name) + ", \"cat\": " + cat + ", ";
+	  if (e.nested) {
+	    out << ",\n  " << common << "\"ph\": \"X\", \"ts\": " << 1e6*e.start << ", \"dur\": " << 1e6*e.duration
+		<< ", \"pid\": " << pid << ", \"tid\": " << tid << "}";
+	  } else {
+	    // intervals that overlap the others are async events
+	    out << ",\n  " << common << "\"ph\": \"b\", \"id\": " << id << ", \"ts\": " << 1e6*e.start
+		<< ", \"pid\": " << pid << ", \"tid\": " << tid << "}";
+	    out << ",\n  " << common << "\"ph\": \"e\", \"id\": " << id << ", \"ts\": " << 1e6*(e.start + e.duration)
+		<< ", \"pid\": " << pid << ", \"tid\": " << tid << "}";
+	    id++;
+	  }
+	}
+      }
+      out << "\n]}\n";
+    }
+
+    for (std::map<std::string, TimeProfile*>::iterator it = combined.begin(); it != combined.end(); it++) 
+      delete it->second;
+  }
+
 }
 
@@ -1,4 +1,5 @@
 #include <tune_quda.h>
+#include <su3_cpu.h> // for the instruction set of host kernels
 #include <comm_quda.h>
 #include <quda.h> // for QUDA_VERSION_STRING
 #include <sys/stat.h> // for stat()
@@ -9,13 +10,35 @@
 #include <typeinfo>
 #include <map>
 #include <unistd.h>
+#include <sys/file.h> // for flock()
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm> // for std::swap, std::sort
+#include <sys/time.h> // for gettimeofday()
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace quda {
 
 static const std::string quda_hash = QUDA_HASH; // defined in lib/Makefile
+static const int cache_format = 5; // layout of the cache file: 1 has no source hashes, 2 no host parameters, 3 no times, 4 no instruction set
 static std::string resource_path;
 static std::map<TuneKey, TuneParam> tunecache;
-static size_t initial_cache_size = 0;
+static std::map<TuneKey, TuneParam> tuned; // entries tuned since the cache was last saved
+
+/** Launches of a kernel, for the launch report */
+struct LaunchRecord {
+  long long calls;
+  long long flops; // per launch
+  long long bytes; // per launch
+  float time; // seconds per launch at the tuned parameters, or zero if unknown
+  bool host;
+  LaunchRecord() : calls(0), flops(0), bytes(0), time(0.0), host(false) { }
+};
+static std::map<TuneKey, LaunchRecord> launches;
 
 #define STR_(x) #x
 #define STR(x) STR_(x)
@@ -23,10 +46,216 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
 #undef STR
 #undef STR_
 
+  /**
+   * Whether we are pretuning, set by the environment variable QUDA_TUNE_PRETUNE.  Kernels whose launch parameters are not
+   * cached are then tuned even if tuning is disabled, so that a short offline run can fill the cache for production runs.
+   */
+  static bool pretuning()
+  {
+    static bool init = false;
+    static bool pretune = false;
+    if (!init) {
+      char *pretune_env = getenv("QUDA_TUNE_PRETUNE");
+      pretune = (pretune_env && strcmp(pretune_env, "0"));
+      init = true;
+    }
+    return pretune;
+  }
+
+
+  /**
+   * The strategy used to search the launch parameters, set by the environment variable QUDA_TUNE_STRATEGY:
+   * - exhaustive: time every candidate (the default)
+   * - coarse: time evenly spaced candidates, then every candidate around the fastest of these
+   * - random: time a random sample of the candidates, seeded by the kernel's key so that all processes agree
+   * - model: as coarse, but stop once the kernel comes close to the memory bandwidth of the device, as estimated by
+   *   Tunable::bytes()
+   */
+  enum TuneStrategy { TUNE_EXHAUSTIVE, TUNE_COARSE, TUNE_RANDOM, TUNE_MODEL };
+
+  static const char *strategy_name[] = { "exhaustive", "coarse", "random", "model" };
+
+  static TuneStrategy tuneStrategy()
+  {
+    static bool init = false;
+    static TuneStrategy strategy = TUNE_EXHAUSTIVE;
+    if (!init) {
+      char *strategy_env = getenv("QUDA_TUNE_STRATEGY");
+      if (strategy_env) {
+	int i;
+	for (i=0; i<4 && strcmp(strategy_env, strategy_name[i]); i++);
+	if (i < 4) strategy = static_cast<TuneStrategy>(i);
+	else warningQuda("Unknown tuning strategy %s, using exhaustive search", strategy_env);
+      }
+      init = true;
+    }
+    return strategy;
+  }
+
+  /**
+   * The time in seconds that may be spent tuning each kernel, set by the environment variable QUDA_TUNE_BUDGET.  Once
+   * it has been spent, the fastest candidate timed so far is taken.  Zero (the default) means no limit.
+   */
+  static double tuneBudget()
+  {
+    static bool init = false;
+    static double budget = 0.0;
+    if (!init) {
+      char *budget_env = getenv("QUDA_TUNE_BUDGET");
+      if (budget_env) budget = atof(budget_env);
+      if (budget < 0.0) budget = 0.0;
+      init = true;
+    }
+    return budget;
+  }
+
+  // the model strategy stops when a kernel achieves this fraction of the peak memory bandwidth
+  static const double model_fraction = 0.8;
+
+  /**
+   * The peak memory bandwidth in bytes per second, set in GB/s by the environment variable QUDA_PEAK_BANDWIDTH, or
+   * otherwise the theoretical bandwidth of the device.
+   */
+  static double peakBandwidth()
+  {
+    static bool init = false;
+    static double bandwidth = 0.0;
+    if (!init) {
+      char *bandwidth_env = getenv("QUDA_PEAK_BANDWIDTH");
+      if (bandwidth_env) bandwidth = 1e9 * atof(bandwidth_env);
+      else bandwidth = 2.0 * 1e3 * deviceProp.memoryClockRate * (deviceProp.memoryBusWidth / 8);
+      init = true;
+    }
+    return bandwidth;
+  }
+
+  /**
+   * The peak floating-point rate in flops per second, set in Gflop/s by the environment variable QUDA_PEAK_GFLOPS, or
+   * zero if unknown, in which case the roofline is the bandwidth bound alone.
+   */
+  static double peakFlops()
+  {
+    static bool init = false;
+    static double flops = 0.0;
+    if (!init) {
+      char *flops_env = getenv("QUDA_PEAK_GFLOPS");
+      if (flops_env) flops = 1e9 * atof(flops_env);
+      init = true;
+    }
+    return flops;
+  }
+
+  // the resolution of the host and CUDA event timers, below which measured times are clamped, so that a kernel too
+  // fast to measure cannot appear infinitely fast to the model stop rule and to hopeless()
+  static const double timer_resolution = 1e-6;
+
+  static double wallTime()
+  {
+    timeval now;
+    gettimeofday(&now, NULL);
+    return now.tv_sec + 0.000001*now.tv_usec;
+  }
+
+  /**
+   * Whether a candidate that has taken elapsed seconds for done of its iter timed launches can be abandoned: either it
+   * can no longer beat the best time, or, after a quarter of the launches, it is running at less than half the speed.
+   */
+  static bool hopeless(double elapsed, int done, int iter, double best_time)
+  {
+    if (best_time == FLT_MAX) return false;
+    return elapsed > best_time * iter || (4*done >= iter && elapsed > 2.0 * best_time * done);
+  }
+
+
+  /**
+   * Chooses the order in which the candidate launch parameters, numbered as enumerated by Tunable::advanceTuneParam(),
+   * are timed.  The first candidate is the one given by Tunable::initTuneParam(), which is always valid.
+   */
+  class TuneSearch {
+
+  protected:
+    const int n; // number of candidates
+
+  public:
+    TuneSearch(int n) : n(n) { }
+    virtual ~TuneSearch() { }
+
+    /**
+     * @param best The fastest candidate so far, or -1 if none has run successfully
+     * @return The next candidate to time, or -1 if the search is done
+     */
+    virtual int next(int best) = 0;
+  };
+
+  class ExhaustiveSearch : public TuneSearch {
+    int i;
+  public:
+    ExhaustiveSearch(int n) : TuneSearch(n), i(0) { }
+    int next(int best) { return i < n ? i++ : -1; }
+  };
+
+  /**
+   * Time every stride-th candidate, and the last, then every candidate within a stride of the fastest of these.
+   * Neighboring candidates differ in one launch parameter by one step, so the timings vary smoothly along the order.
+   */
+  class CoarseSearch : public TuneSearch {
+    const int stride;
+    int i;
+    int center; // the fastest candidate of the coarse pass, or -1 during it
+    std::vector<bool> timed;
+  public:
+    CoarseSearch(int n) : TuneSearch(n), stride(n > 1 ? (int)sqrt((double)n) : 1), i(0), center(-1), timed(n, false) { }
+
+    int next(int best) {
+      if (center < 0) {
+	if (i < n) {
+	  const int c = i;
+	  i = (i + stride < n || i == n-1) ? i + stride : n-1;
+	  timed[c] = true;
+	  return c;
+	}
+	if (best < 0) return -1;
+	center = best;
+	i = center - stride + 1 > 0 ? center - stride + 1 : 0;
+      }
+      const int end = center + stride < n ? center + stride : n;
+      while (i < end && timed[i]) i++;
+      if (i == end) return -1;
+      timed[i] = true;
+      return i++;
+    }
+  };
+
+  /**
+   * Time the first candidate and a random sample of the others, twice the square root of their number.
+   */
+  class RandomSearch : public TuneSearch {
+    std::vector<int> order;
+    unsigned int i;
+  public:
+    RandomSearch(int n, const TuneKey &key) : TuneSearch(n), order(n), i(0) {
+      const std::string s = key.volume + key.name + key.aux;
+      unsigned long long state = 14695981039346656037ull; // FNV-1a hash of the key
+      for (unsigned int j=0; j<s.length(); j++) state = (state ^ (unsigned char)s[j]) * 1099511628211ull;
+
+      int samples = 2*(int)sqrt((double)n);
+      if (samples > n) samples = n;
+      for (int j=0; j<n; j++) order[j] = j;
+      for (int j=1; j<samples; j++) { // partial Fisher-Yates shuffle, keeping the first candidate in place
+	state = state * 6364136223846793005ull + 1442695040888963407ull;
+	const int k = j + (int)((state >> 33) % (unsigned long long)(n - j));
+	std::swap(order[j], order[k]);
+      }
+      order.resize(samples);
+    }
+    int next(int best) { return i < order.size() ? order[i++] : -1; }
+  };
+
+
   /**
    * Deserialize tunecache from an istream, useful for reading a file or receiving from other nodes.
    */
-  static void deserializeTuneCache(std::istream &in)
+  static void deserializeTuneCache(std::istream &in, std::map<TuneKey, TuneParam> &cache, int format=cache_format)
   {
     std::string line;
     std::stringstream ls;
@@ -38,12 +267,25 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
       if (!line.length()) continue; // skip blank lines (e.g., at end of file)
       ls.clear();
       ls.str(line);
-      ls >> key.volume >> key.name >> key.aux >> param.block.x >> param.block.y >> param.block.z;
+      ls >> key.volume >> key.name >> key.aux;
+      key.hash.clear(); // format 1 caches record no source hash, which matches any
+      if (format >= 2) {
+	ls >> key.hash;
+	if (key.hash == "-") key.hash.clear();
+      }
+      ls >> param.block.x >> param.block.y >> param.block.z;
       ls >> param.grid.x >> param.grid.y >> param.grid.z >> param.shared_bytes;
+      param.threads = param.chunk = 0;
+      if (format >= 3) ls >> param.threads >> param.chunk;
+      param.simd = -1;
+      if (format >= 5) ls >> param.simd;
+      param.time = 0.0;
+      if (format >= 4) ls >> param.time;
       ls.ignore(1); // throw away tab before comment
       getline(ls, param.comment); // assume anything remaining on the line is a comment
       param.comment += "\n"; // our convention is to include the newline, since ctime() likes to do this
-      tunecache[key] = param;
+      cache.erase(key); // so that the key with the new hash is stored
+      cache[key] = param;
     }
   }
 
@@ -51,18 +293,21 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
   /**
    * Serialize tunecache to an ostream, useful for writing to a file or sending to other nodes.
    */
-  static void serializeTuneCache(std::ostream &out)
+  static void serializeTuneCache(std::ostream &out, const std::map<TuneKey, TuneParam> &cache)
   {
-    std::map<TuneKey, TuneParam>::iterator entry;
+    std::map<TuneKey, TuneParam>::const_iterator entry;
 
-    for (entry = tunecache.begin(); entry != tunecache.end(); entry++) {
-      TuneKey key = entry->first;
-      TuneParam param = entry->second;
+    for (entry = cache.begin(); entry != cache.end(); entry++) {
+      const TuneKey &key = entry->first;
+      const TuneParam &param = entry->second;
 
       out << key.volume << "\t" << key.name << "\t" << key.aux << "\t";
+      out << (key.hash.empty() ? "-" : key.hash) << "\t";
       out << param.block.x << "\t" << param.block.y << "\t" << param.block.z << "\t";
       out << param.grid.x << "\t" << param.grid.y << "\t" << param.grid.z << "\t";
-      out << param.shared_bytes << "\t" << param.comment; // param.comment ends with a newline
+      out << param.shared_bytes << "\t" << param.threads << "\t" << param.chunk << "\t" << param.simd << "\t";
+      out << param.time << "\t";
+      out << param.comment; // param.comment ends with a newline
     }
   }
 
@@ -78,7 +323,7 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
     size_t size;
 
     if (comm_rank() == 0) {
-      serializeTuneCache(serialized);
+      serializeTuneCache(serialized, tunecache);
       size = serialized.str().length();
     }
     comm_broadcast(&size, sizeof(size_t));
@@ -91,7 +336,7 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
 	comm_broadcast(serstr, size);
 	serstr[size] ='\0'; // null-terminate
 	serialized.str(serstr);
-	deserializeTuneCache(serialized);
+	deserializeTuneCache(serialized, tunecache);
 	delete[] serstr;
       }
     }
@@ -99,6 +344,160 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
   }
 
 
+#ifdef MULTI_GPU
+  /**
+   * The displacement in the process grid from this node to the given one.
+   */
+  static void displacementTo(int rank, int *disp)
+  {
+    Topology *topo = comm_default_topology();
+    const int *to = comm_coords_from_rank(topo, rank);
+    const int *from = comm_coords(topo);
+    for (int d=0; d<comm_ndim(topo); d++) disp[d] = to[d] - from[d];
+  }
+#endif
+
+
+  /**
+   * Collect on node 0 the parameters that other nodes have tuned and node 0 has not, which happens if the nodes have
+   * different subvolumes.  To keep the traffic down, node 0 first announces what it has tuned itself.
+   */
+  static void gatherTuneCache()
+  {
+#ifdef MULTI_GPU
+    if (comm_size() == 1) return;
+
+    std::stringstream serialized;
+    size_t size = 0;
+
+    if (comm_rank() == 0) {
+      serializeTuneCache(serialized, tuned);
+      size = serialized.str().length();
+    }
+    comm_broadcast(&size, sizeof(size_t));
+
+    std::map<TuneKey, TuneParam> extra;
+    if (comm_rank() != 0) {
+      std::map<TuneKey, TuneParam> root_tuned;
+      if (size > 0) {
+	char *serstr = new char[size+1];
+	comm_broadcast(serstr, size);
+	serstr[size] = '\0';
+	serialized.str(serstr);
+	deserializeTuneCache(serialized, root_tuned);
+	delete[] serstr;
+      }
+      std::map<TuneKey, TuneParam>::iterator entry;
+      for (entry = tuned.begin(); entry != tuned.end(); entry++)
+	if (!root_tuned.count(entry->first)) extra.insert(*entry);
+    } else if (size > 0) {
+      comm_broadcast(const_cast<char *>(serialized.str().c_str()), size);
+    }
+
+    std::stringstream extra_serialized;
+    serializeTuneCache(extra_serialized, extra);
+    const std::string mine = extra_serialized.str();
+
+    int total = mine.length();
+    comm_allreduce_int(&total);
+    if (total == 0) return;
+
+    // each node sends the length of its entries and then the entries themselves to node 0, which receives them in
+    // turn
+    if (comm_rank() == 0) {
+      std::string gathered;
+      for (int r=1; r<comm_size(); r++) {
+	int disp[QUDA_MAX_DIM];
+	displacementTo(r, disp);
+
+	size_t length = 0;
+	MsgHandle *mh = comm_declare_receive_displaced(&length, disp, sizeof(size_t));
+	comm_start(mh);
+	comm_wait(mh);
+	comm_free(mh);
+	if (length == 0) continue;
+
+	std::vector<char> buf(length);
+	mh = comm_declare_receive_displaced(&buf[0], disp, length);
+	comm_start(mh);
+	comm_wait(mh);
+	comm_free(mh);
+	gathered.append(&buf[0], length);
+      }
+
+      std::stringstream in(gathered);
+      std::map<TuneKey, TuneParam> received;
+      deserializeTuneCache(in, received);
+
+      std::map<TuneKey, TuneParam>::iterator entry;
+      for (entry = received.begin(); entry != received.end(); entry++) {
+	if (tuned.count(entry->first)) continue; // the first node to report a key wins
+	tuned.insert(*entry);
+	tunecache.erase(entry->first);
+	tunecache.insert(*entry);
+      }
+    } else {
+      int disp[QUDA_MAX_DIM];
+      displacementTo(0, disp);
+
+      size_t length = mine.length();
+      MsgHandle *mh = comm_declare_send_displaced(&length, disp, sizeof(size_t));
+      comm_start(mh);
+      comm_wait(mh);
+      comm_free(mh);
+
+      if (length > 0) {
+	mh = comm_declare_send_displaced(const_cast<char *>(mine.c_str()), disp, length);
+	comm_start(mh);
+	comm_wait(mh);
+	comm_free(mh);
+      }
+    }
+#endif
+  }
+
+
+  /**
+   * Read a cache file into cache.
+   * @return Whether the file exists
+   */
+  static bool readTuneCacheFile(const std::string &cache_path, std::map<TuneKey, TuneParam> &cache)
+  {
+    std::ifstream cache_file;
+    std::string line, token, version, hash;
+    std::stringstream ls;
+    int format = 1;
+
+    cache_file.open(cache_path.c_str());
+    if (!cache_file) return false;
+
+    if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
+    getline(cache_file, line);
+    ls.str(line);
+    ls >> token;
+    if (token.compare("tunecache")) errorQuda("Bad format in %s", cache_path.c_str());
+    ls >> version >> hash >> token;
+    if (!token.compare(0, 7, "format=")) format = atoi(token.c_str() + 7);
+    if (format > cache_format) errorQuda("Cache file %s has unsupported format %d", cache_path.c_str(), format);
+
+    if (format == 1) {
+      if (version.compare(quda_version)) errorQuda("Cache file %s does not match current QUDA version", cache_path.c_str());
+      if (hash.compare(quda_hash)) warningQuda("Cache file %s does not match current QUDA build", cache_path.c_str());
+    }
+    // later formats record the source hash of each kernel, so stale entries are discarded as they are looked up
+
+    if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
+    getline(cache_file, line); // eat the blank line
+
+    if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
+    getline(cache_file, line); // eat the description line
+
+    deserializeTuneCache(cache_file, cache, format);
+    cache_file.close();
+    return true;
+  }
+
+
   /*
    * Read tunecache from disk.
    */
@@ -106,9 +505,7 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
   {
     char *path;
     struct stat pstat;
-    std::string cache_path, line, token;
-    std::ifstream cache_file;
-    std::stringstream ls;
+    std::string cache_path;
 
     path = getenv("QUDA_RESOURCE_PATH");
     if (!path) {
@@ -129,34 +526,11 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
 
       cache_path = resource_path;
       cache_path += "/tunecache.tsv";
-      cache_file.open(cache_path.c_str());
-
-      if (cache_file) {
-
-	if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
-	getline(cache_file, line);
-	ls.str(line);
-	ls >> token;
-	if (token.compare("tunecache")) errorQuda("Bad format in %s", cache_path.c_str());
-	ls >> token;
-	if (token.compare(quda_version)) errorQuda("Cache file %s does not match current QUDA version", cache_path.c_str());
-	ls >> token;
-	if (token.compare(quda_hash)) warningQuda("Cache file %s does not match current QUDA build", cache_path.c_str());
-      
-	if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
-	getline(cache_file, line); // eat the blank line
-      
-	if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
-	getline(cache_file, line); // eat the description line
-      
-	deserializeTuneCache(cache_file);
-	cache_file.close();      
-	initial_cache_size = tunecache.size();
 
+      if (readTuneCacheFile(cache_path, tunecache)) {
 	if (verbosity >= QUDA_SUMMARIZE) {
-	  printfQuda("Loaded %d sets of cached parameters from %s\n", static_cast<int>(initial_cache_size), cache_path.c_str());
+	  printfQuda("Loaded %d sets of cached parameters from %s\n", static_cast<int>(tunecache.size()), cache_path.c_str());
 	}
-      
       } else {
 	warningQuda("Cache file not found.  All kernels will be re-tuned (if tuning is enabled).");
       }
@@ -170,66 +544,159 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
 
 
   /**
-   * Write tunecache to disk.
+   * Write tunecache to disk.  The cache file may be shared by many jobs: we merge our newly tuned entries into the
+   * current file under a lock, and replace the file atomically, so that readers never see a partially written cache.
    */
   void saveTuneCache(QudaVerbosity verbosity)
   {
     time_t now;
     int lock_handle;
-    std::string lock_path, cache_path;
+    std::string lock_path, cache_path, tmp_path;
     std::ofstream cache_file;
 
     if (resource_path.empty()) return;
 
-    //FIXME: We should really check to see if any nodes have tuned a kernel that was not also tuned on node 0, since as things
-    //       stand, the corresponding launch parameters would never get cached to disk in this situation.  This will come up if we
-    //       ever support different subvolumes per GPU (as might be convenient for lattice volumes that don't divide evenly).
+    gatherTuneCache();
 
 #ifdef MULTI_GPU
     if (comm_rank() == 0) {
 #endif
 
-      if (tunecache.size() == initial_cache_size) return;
+      if (tuned.empty()) return;
 
-      // Acquire lock.  Note that this is only robust if the filesystem supports flock() semantics, which is true for
-      // NFS on recent versions of linux but not Lustre by default (unless the filesystem was mounted with "-o flock").
+      // Acquire lock, waiting for any other job that is saving.  Note that this is only robust if the filesystem supports
+      // flock() semantics, which is true for NFS on recent versions of linux but not Lustre by default (unless the
+      // filesystem was mounted with "-o flock").
       lock_path = resource_path + "/tunecache.lock";
-      lock_handle = open(lock_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
-      if (lock_handle == -1) {
-	warningQuda("Unable to lock cache file.  Tuned launch parameters will not be cached to disk.  "
-		    "If you are certain that no other instances of QUDA are accessing this filesystem, "
-		    "please manually remove %s", lock_path.c_str());
+      lock_handle = open(lock_path.c_str(), O_WRONLY | O_CREAT, 0666);
+      if (lock_handle == -1 || flock(lock_handle, LOCK_EX)) {
+	warningQuda("Unable to lock cache file %s.  Tuned launch parameters will not be cached to disk.", lock_path.c_str());
+	if (lock_handle != -1) close(lock_handle);
 	return;
       }
-      char msg[] = "If no instances of applications using QUDA are running,\n"
-	"this lock file shouldn't be here and is safe to delete.";
-      int stat = write(lock_handle, msg, sizeof(msg)); // check status to avoid compiler warning
-      if (stat == -1) warningQuda("Unable to write to lock file for some bizarre reason");
 
+      // pick up what other jobs have saved since we loaded the cache, keeping what we have tuned ourselves
       cache_path = resource_path + "/tunecache.tsv";
-      cache_file.open(cache_path.c_str());
-    
+      std::map<TuneKey, TuneParam> merged;
+      readTuneCacheFile(cache_path, merged);
+      std::map<TuneKey, TuneParam>::iterator entry;
+      for (entry = tunecache.begin(); entry != tunecache.end(); entry++) merged.insert(*entry);
+      for (entry = tuned.begin(); entry != tuned.end(); entry++) {
+	merged.erase(entry->first);
+	merged.insert(*entry);
+      }
+      tunecache = merged;
+
       if (verbosity >= QUDA_SUMMARIZE) {
 	printfQuda("Saving %d sets of cached parameters to %s\n", static_cast<int>(tunecache.size()), cache_path.c_str());
       }
-    
+
+      tmp_path = cache_path + ".tmp";
+      cache_file.open(tmp_path.c_str());
       time(&now);
-      cache_file << "tunecache\t" << quda_version << "\t" << quda_hash << "\t# Last updated " << ctime(&now) << std::endl;
-      cache_file << "volume\tname\taux\tblock.x\tblock.y\tblock.z\tgrid.x\tgrid.y\tgrid.z\tshared_bytes\tcomment" << std::endl;
-      serializeTuneCache(cache_file);
+      cache_file << "tunecache\t" << quda_version << "\t" << quda_hash << "\tformat=" << cache_format;
+      cache_file << "\t# Last updated " << ctime(&now) << std::endl;
+      cache_file << "volume\tname\taux\thash\tblock.x\tblock.y\tblock.z\tgrid.x\tgrid.y\tgrid.z\tshared_bytes\tthreads\tchunk\tsimd\ttime\tcomment" << std::endl;
+      serializeTuneCache(cache_file, tunecache);
       cache_file.close();
 
+      if (cache_file.fail() || rename(tmp_path.c_str(), cache_path.c_str())) {
+	warningQuda("Unable to write cache file %s", cache_path.c_str());
+	remove(tmp_path.c_str());
+      }
+
       // Release lock.
       close(lock_handle);
-      remove(lock_path.c_str());
-
-      initial_cache_size = tunecache.size();
 
 #ifdef MULTI_GPU
     }
 #endif
+
+    tuned.clear();
+  }
+
+
+  void printLaunchReport(QudaVerbosity verbosity)
+  {
+    if (launches.empty() || verbosity < QUDA_SUMMARIZE) return;
+
+    // list the kernels by the time spent in them
+    std::vector<std::pair<double, TuneKey> > order;
+    std::map<TuneKey, LaunchRecord>::const_iterator entry;
+    for (entry = launches.begin(); entry != launches.end(); entry++)
+      order.push_back(std::make_pair(-entry->second.calls * (double)entry->second.time, entry->first));
+    std::sort(order.begin(), order.end());
+
+    printfQuda("\nKernel launches on this process, with the performance at the tuned launch parameters\n");
+    printfQuda("against a roofline of %.1f GB/s", 1e-9 * peakBandwidth());
+    if (peakFlops() > 0.0) printfQuda(" and %.1f Gflop/s", 1e-9 * peakFlops());
+    printfQuda(" (host kernels are not compared)\n");
+    printfQuda("%10s %10s %9s %9s %8s %6s  %s\n", "launches", "time (s)", "Gflop/s", "GB/s", "flop/B", "roof", "kernel");
+
+    for (unsigned int i=0; i<order.size(); i++) {
+      const TuneKey &key = order[i].second;
+      const LaunchRecord &record = launches[key];
+      const std::string kernel = key.name + " " + key.aux + " vol=" + key.volume;
+
+      if (record.time <= 0.0) { // not tuned
+	printfQuda("%10lld %10s %9s %9s %8s %6s  %s\n", record.calls, "-", "-", "-", "-", "-", kernel.c_str());
+	continue;
+      }
+
+      const double gflops = 1e-9 * record.flops / record.time;
+      const double gbytes = 1e-9 * record.bytes / record.time;
+      char intensity[16] = "-", roof[16] = "-";
+      if (record.bytes > 0) sprintf(intensity, "%.2f", (double)record.flops / record.bytes);
+
+      // the fraction of the roofline is the time the kernel would take at the roofline over its actual time
+      double bound = peakBandwidth() > 0.0 ? record.bytes / peakBandwidth() : 0.0;
+      if (peakFlops() > 0.0 && record.flops / peakFlops() > bound) bound = record.flops / peakFlops();
+      if (!record.host && bound > 0.0) sprintf(roof, "%.0f%%", 100.0 * bound / record.time);
+
+      printfQuda("%10lld %10.3g %9.2f %9.2f %8s %6s  %s\n", record.calls, record.calls * (double)record.time,
+		 gflops, gbytes, intensity, roof, kernel.c_str());
+    }
+    printfQuda("\n");
+  }
+
+  int hostMaxThreads()
+  {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
+
+  HostLaunch::HostLaunch(const TuneParam &param) : threads(1), kind(0), chunk(0), simd(-1)
+  {
+    if (param.simd >= 0) {
+      simd = hostSimdType();
+      setHostSimdType(static_cast<HostSimdType>(param.simd));
+    }
+
+#ifdef _OPENMP
+    omp_sched_t sched;
+    omp_get_schedule(&sched, &chunk);
+    kind = sched;
+    threads = omp_get_max_threads();
+    if (param.threads > 0 && param.threads < threads) omp_set_num_threads(param.threads);
+    omp_set_schedule(param.chunk ? omp_sched_dynamic : omp_sched_static, param.chunk);
+#endif
   }
 
+
+  HostLaunch::~HostLaunch()
+  {
+    if (simd >= 0) setHostSimdType(static_cast<HostSimdType>(simd));
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+    omp_set_schedule(static_cast<omp_sched_t>(kind), chunk);
+#endif
+  }
+
+
   /**
    * Return the optimal launch parameters for a given kernel, either by retrieving them from tunecache or autotuning
    * on the spot.
@@ -252,11 +719,24 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
 
     const TuneKey key = tunable.tuneKey();
 
-    if (enabled == QUDA_TUNE_NO) {
+    // discard parameters tuned for a different source of the kernel
+    std::map<TuneKey, TuneParam>::iterator entry = tunecache.find(key);
+    if (entry != tunecache.end() && !key.current(entry->first)) {
+      if (verbosity >= QUDA_DEBUG_VERBOSE) printfQuda("Discarding stale parameters for %s\n", key.name.c_str());
+      tunecache.erase(entry);
+      entry = tunecache.end();
+    }
+
+    if (enabled == QUDA_TUNE_NO && !pretuning()) {
       tunable.defaultTuneParam(param);
       tunable.checkLaunchParam(param);
-    } else if (tunecache.count(key)) {
-      param = tunecache[key];
+    } else if (entry != tunecache.end()) {
+      param = entry->second;
+      if (entry->first.hash.empty() && !key.hash.empty()) { // record the source hash of an entry that had none
+	tunecache.erase(entry);
+	tunecache[key] = param;
+	tuned[key] = param;
+      }
       tunable.checkLaunchParam(param);
     } else if (!tuning) {
 
@@ -267,40 +747,109 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
       if (verbosity >= QUDA_DEBUG_VERBOSE) printfQuda("PreTune %s\n", key.name.c_str());
       tunable.preTune();
 
-      cudaEventCreate(&start);
-      cudaEventCreate(&end);
+      const bool host = tunable.hostTunable();
+      if (!host) {
+	cudaEventCreate(&start);
+	cudaEventCreate(&end);
+      }
 
       if (verbosity >= QUDA_DEBUG_VERBOSE) {
 	printfQuda("Tuning %s with %s at vol=%s\n", key.name.c_str(), key.aux.c_str(), key.volume.c_str());
       }
 
+      // enumerate the candidates, then time them in the order chosen by the search strategy
+      std::vector<TuneParam> candidates;
       tunable.initTuneParam(param);
-      while (tuning) {
-	cudaDeviceSynchronize();
-	cudaGetLastError(); // clear error counter
+      do candidates.push_back(param); while (tunable.advanceTuneParam(param));
+      const int n = candidates.size();
+
+      const TuneStrategy strategy = tuneStrategy();
+      TuneSearch *search;
+      switch (strategy) {
+      case TUNE_COARSE:
+      case TUNE_MODEL: search = new CoarseSearch(n); break;
+      case TUNE_RANDOM: search = new RandomSearch(n, key); break;
+      default: search = new ExhaustiveSearch(n);
+      }
+
+      // the model strategy is done once the kernel is within model_fraction of the device's memory bandwidth
+      double bound_time = 0.0;
+      if (strategy == TUNE_MODEL && !host && tunable.bytes() > 0 && peakBandwidth() > 0.0) {
+	bound_time = tunable.bytes() / (model_fraction * peakBandwidth());
+      }
+
+      const double budget = tuneBudget();
+      const double search_start = wallTime();
+      const int iter = tunable.tuningIter();
+      int best = -1, timed = 0, aborted = 0;
+      bool truncated = false;
+
+      for (int c = search->next(best); c >= 0; c = search->next(best)) {
+	param = candidates[c];
 	tunable.checkLaunchParam(param);
-	cudaEventRecord(start, 0);
-	for (int i=0; i<tunable.tuningIter(); i++) {
-	  tunable.apply(0);  // calls tuneLaunch() again, which simply returns the currently active param
+
+	// launch in batches of doubling size, so that candidates that are clearly too slow can be abandoned early
+	int done = 0;
+	bool abort = false;
+	if (host) { // host kernels are timed on the host
+	  const double launch_start = wallTime();
+	  for (int batch=1; done<iter && !abort; batch*=2) {
+	    for (int i=0; i<batch && done<iter; i++, done++) tunable.apply(0);
+	    elapsed_time = wallTime() - launch_start;
+	    if (elapsed_time < timer_resolution) elapsed_time = timer_resolution;
+	    abort = done < iter && hopeless(elapsed_time, done, iter, best_time);
+	  }
+	  error = cudaSuccess;
+	} else {
+	  cudaDeviceSynchronize();
+	  cudaGetLastError(); // clear error counter
+	  cudaEventRecord(start, 0);
+	  for (int batch=1; done<iter && !abort; batch*=2) {
+	    for (int i=0; i<batch && done<iter; i++, done++) {
+	      tunable.apply(0);  // calls tuneLaunch() again, which simply returns the currently active param
+	    }
+	    cudaEventRecord(end, 0);
+	    cudaEventSynchronize(end);
+	    cudaEventElapsedTime(&elapsed_time, start, end);
+	    elapsed_time /= 1e3;
+	    if (elapsed_time < timer_resolution) elapsed_time = timer_resolution;
+	    abort = done < iter && hopeless(elapsed_time, done, iter, best_time);
+	  }
+	  cudaDeviceSynchronize();
+	  error = cudaGetLastError();
 	}
-	cudaEventRecord(end, 0);
-	cudaEventSynchronize(end);
-	cudaEventElapsedTime(&elapsed_time, start, end);
-	cudaDeviceSynchronize();
-	error = cudaGetLastError();
-	elapsed_time /= (1e3 * tunable.tuningIter());
-	if ((elapsed_time < best_time) && (error == cudaSuccess)) {
+	elapsed_time /= done;
+	timed++;
+
+	if (abort) {
+	  aborted++;
+	} else if ((elapsed_time < best_time) && (error == cudaSuccess)) {
 	  best_time = elapsed_time;
 	  best_param = param;
+	  best = c;
 	}
 	if ((verbosity >= QUDA_DEBUG_VERBOSE)) {
-	  if (error == cudaSuccess)
-	    printfQuda("    %s gives %s\n", tunable.paramString(param).c_str(), 
-		       tunable.perfString(elapsed_time).c_str());
-	  else 
+	  if (error != cudaSuccess)
 	    printfQuda("    %s gives %s\n", tunable.paramString(param).c_str(), cudaGetErrorString(error));
+	  else if (abort)
+	    printfQuda("    %s abandoned after %d of %d launches\n", tunable.paramString(param).c_str(), done, iter);
+	  else
+	    printfQuda("    %s gives %s\n", tunable.paramString(param).c_str(),
+		       tunable.perfString(elapsed_time).c_str());
+	}
+
+	if (best >= 0 && best_time <= bound_time) break;
+	if (best >= 0 && budget > 0.0 && wallTime() - search_start > budget) {
+	  truncated = true;
+	  break;
 	}
-	tuning = tunable.advanceTuneParam(param);
+      }
+      delete search;
+      tuning = false;
+
+      if (verbosity >= QUDA_DEBUG_VERBOSE) {
+	printfQuda("Timed %d of %d candidates with %s search, %d abandoned%s\n", timed, n,
+		   strategy_name[strategy], aborted, truncated ? ", stopped by the time budget" : "");
       }
 
       if (best_time == FLT_MAX) {
@@ -310,22 +859,42 @@ static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VER
 	printfQuda("Tuned %s giving %s for %s with %s\n", tunable.paramString(best_param).c_str(),
 		   tunable.perfString(best_time).c_str(), key.name.c_str(), key.aux.c_str());
       }
+      best_param.time = best_time;
       time(&now);
-      best_param.comment = "# " + tunable.perfString(best_time) + ", tuned ";
+      best_param.comment = "# " + tunable.perfString(best_time) + ", ";
+      if (strategy != TUNE_EXHAUSTIVE || truncated) {
+	std::stringstream search_note;
+	search_note << strategy_name[strategy] << " search of " << timed << "/" << n << ", ";
+	best_param.comment += search_note.str();
+      }
+      best_param.comment += "tuned ";
       best_param.comment += ctime(&now); // includes a newline
 
-      cudaEventDestroy(start);
-      cudaEventDestroy(end);
+      if (!host) {
+	cudaEventDestroy(start);
+	cudaEventDestroy(end);
+      }
 
       if (verbosity >= QUDA_DEBUG_VERBOSE) printfQuda("PostTune %s\n", key.name.c_str());
       tunable.postTune();
       param = best_param;
       tunecache[key] = best_param;
+      tuned[key] = best_param;
 
     } else if (&tunable != active_tunable) {
       errorQuda("Unexpected call to tuneLaunch() in %s::apply()", typeid(tunable).name());
     }
 
+    if (!tuning) { // not a launch made while tuning
+      LaunchRecord &record = launches[key];
+      if (record.calls++ == 0) {
+	record.flops = tunable.flops();
+	record.bytes = tunable.bytes();
+	record.host = tunable.hostTunable();
+      }
+      record.time = param.time;
+    }
+
     // restore the original reduction state
     globalReduce = reduceState;
 
@@ -629,6 +629,11 @@ static double HOST_REUNIT_SVD_ABS_ERROR;
       void postTune() { cudaMemset(fails, 0, sizeof(int)); } // reset fails counter
       
       long long flops() const { return 0; } // FIXME: add flops counter
+      // each site loads the link and old force and stores the new force in each direction
+      long long bytes() const {
+	return 4ll*gauge.Volume()*(gauge.Reconstruct()*gauge.Precision() + oldForce.Reconstruct()*oldForce.Precision() +
+				   newForce.Reconstruct()*newForce.Precision());
+      }
       
       TuneKey tuneKey() const {
 	std::stringstream vol, aux;
@@ -638,7 +643,7 @@ static double HOST_REUNIT_SVD_ABS_ERROR;
 	vol << gauge.X()[3] << "x";
 	aux << "threads=" << gauge.Volume() << ",prec=" << gauge.Precision();
 	aux << "stride=" << gauge.Stride();
-	return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+	return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
       }  
     }; // UnitarizeForceCuda
 
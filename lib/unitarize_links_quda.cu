@@ -431,6 +431,10 @@ namespace quda{
     void postTune() { cudaMemset(fails, 0, sizeof(int)); } // reset fails counter
     
     long long flops() const { return 0; } // FIXME: add flops counter
+    // each site loads and stores the link in each direction
+    long long bytes() const {
+      return 4ll*inField.Volume()*(inField.Reconstruct()*inField.Precision() + outField.Reconstruct()*outField.Precision());
+    }
 
     TuneKey tuneKey() const {
       std::stringstream vol, aux;
@@ -440,7 +444,7 @@ namespace quda{
       vol << inField.X()[3] << "x";
       aux << "threads=" << inField.Volume() << ",prec=" << inField.Precision();
       aux << "stride=" << inField.Stride();
-      return TuneKey(vol.str(), typeid(*this).name(), aux.str());
+      return TuneKey(vol.str(), typeid(*this).name(), aux.str(), QUDA_SOURCE_HASH);
     }  
   }; // UnitarizeLinksCuda
     
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <quda_internal.h>
 #include <color_spinor_field.h>
@@ -34,6 +35,8 @@ const int Nkernels = 31;
 
 using namespace quda;
 
+bool repro_check = false; // whether to check that reproducible host reductions ignore the site order
+
 cpuColorSpinorField *xH, *yH, *zH, *wH, *vH, *hH, *lH;
 cudaColorSpinorField *xD, *yD, *zD, *wD, *vD, *hD, *lD;
 int Nspin;
@@ -629,12 +632,81 @@ double test(int kernel) {
   return error;
 }
 
+// copy the sites of a host field in a different order: reversed
+// (order 0) or rotated by a third of the volume (order 1)
+void permuteSites(cpuColorSpinorField &dst, const cpuColorSpinorField &src, int order)
+{
+  const int volume = src.Volume();
+  const size_t siteBytes = 2*src.Ncolor()*src.Nspin()*src.Precision();
+  for (int i=0; i<volume; i++) {
+    int j = (order == 0) ? volume-1-i : (i + volume/3) % volume;
+    memcpy((char*)dst.V() + j*siteBytes, (const char*)src.V() + i*siteBytes, siteBytes);
+  }
+}
+
+void hostReductions(double *r, cpuColorSpinorField &x, cpuColorSpinorField &y)
+{
+  r[0] = normCpu(x);
+  r[1] = reDotProductCpu(x, y);
+  quda::Complex dot = cDotProductCpu(x, y);
+  r[2] = real(dot);
+  r[3] = imag(dot);
+  double3 dn = cDotProductNormBCpu(x, y);
+  r[4] = dn.x; r[5] = dn.y; r[6] = dn.z;
+  double3 hq = HeavyQuarkResidualNormCpu(x, y);
+  r[7] = hq.x; r[8] = hq.y; r[9] = hq.z;
+}
+
+/**
+   With QUDA_REPRODUCIBLE_REDUCE set, the host reductions are summed
+   exactly, so that permuting the sites must leave every bit of the
+   results unchanged.
+*/
+int testReproducible()
+{
+  if (!reduceReproducible()) errorQuda("Reproducible reductions are not enabled");
+
+  ColorSpinorParam param(*xH);
+  param.create = QUDA_NULL_FIELD_CREATE;
+  cpuColorSpinorField xP(param), yP(param);
+
+  const char *order_str[] = {"reversed", "rotated"};
+  const int Nreduce = 10;
+  double ref[Nreduce], perm[Nreduce];
+  hostReductions(ref, *xH, *yH);
+
+  int fail = 0;
+  for (int order = 0; order < 2; order++) {
+    permuteSites(xP, *xH, order);
+    permuteSites(yP, *yH, order);
+    hostReductions(perm, xP, yP);
+    bool same = memcmp(ref, perm, sizeof(ref)) == 0;
+    printfQuda("Reproducible host reductions with %s sites: %s\n", order_str[order], same ? "identical" : "DIFFERENT");
+    if (!same) fail = 1;
+  }
+
+  return fail;
+}
+
+void usage_extra(char** argv )
+{
+  printfQuda("Extra options:\n");
+  printfQuda("    --repro_check                             # Enable reproducible reductions and check that the host\n"
+             "                                                reductions are bitwise independent of the site order\n");
+  return ;
+}
+
 int main(int argc, char** argv)
 {
   for (int i = 1; i < argc; i++){
     if(process_command_line_option(argc, argv, &i) == 0){
       continue;
     } 
+
+    if( strcmp(argv[i], "--repro_check") == 0){
+      repro_check = true;
+      continue;
+    }
     printfQuda("ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
   }
@@ -642,6 +714,9 @@ int main(int argc, char** argv)
   setSpinorSiteSize(24);
   initComms(argc, argv, gridsize_from_cmdline);
   display_test_info();
+
+  // read by initQuda
+  if (repro_check) setenv("QUDA_REPRODUCIBLE_REDUCE", "1", 1);
   initQuda(device);
 
   char *names[] = {
@@ -735,7 +810,17 @@ int main(int argc, char** argv)
     freeFields();
   }
 
+  int fail = 0;
+  if (repro_check) {
+    printfQuda("\nTesting reproducible reductions...\n\n");
+    initFields(Nprec-1);
+    fail = testReproducible();
+    freeFields();
+  }
+
   endQuda();
 
   finalizeComms();
+
+  return fail;
 }
@@ -15,359 +15,48 @@
 
 using namespace quda;
 
-// i represents a "half index" into an even or odd "half lattice".
-// when oddBit={0,1} the half lattice is {even,odd}.
-// 
-// the displacements, such as dx, refer to the full lattice coordinates. 
-//
-// neighborIndex() takes a "half index", displaces it, and returns the
-// new "half index", which can be an index into either the even or odd lattices.
-// displacements of magnitude one always interchange odd and even lattices.
-//
-//
-int neighborIndex_5d(int i, int oddBit, int dxs, int dx4, int dx3, int dx2, int dx1) {
-  // fullLatticeIndex was modified for fullLatticeIndex_4d.  It is in util_quda.cpp.
-  // This code bit may not properly perform 5dPC.
-  int X = fullLatticeIndex_5d(i, oddBit);
-  // Checked that this matches code in dslash_core_ante.h.
-  int xs = X/(Z[3]*Z[2]*Z[1]*Z[0]);
-  int x4 = (X/(Z[2]*Z[1]*Z[0])) % Z[3];
-  int x3 = (X/(Z[1]*Z[0])) % Z[2];
-  int x2 = (X/Z[0]) % Z[1];
-  int x1 = X % Z[0];
-  // Displace and project back into domain 0,...,Ls-1.
-  // Note that we add Ls to avoid the negative problem
-  // of the C % operator.
-  xs = (xs+dxs+Ls) % Ls;
-  // Etc.
-  x4 = (x4+dx4+Z[3]) % Z[3];
-  x3 = (x3+dx3+Z[2]) % Z[2];
-  x2 = (x2+dx2+Z[1]) % Z[1];
-  x1 = (x1+dx1+Z[0]) % Z[0];
-  // Return linear half index.  Remember that integer division
-  // rounds down.
-  return (xs*(Z[3]*Z[2]*Z[1]*Z[0]) + x4*(Z[2]*Z[1]*Z[0]) + x3*(Z[1]*Z[0]) + x2*(Z[0]) + x1) / 2;
-}
-
-// i represents a "half index" into an even or odd "half lattice".
-// when oddBit={0,1} the half lattice is {even,odd}.
-// 
-// the displacements, such as dx, refer to the full lattice coordinates. 
-//
-// neighborIndex() takes a "half index", displaces it, and returns the
-// new "half index", which can be an index into either the even or odd lattices.
-// displacements of magnitude one always interchange odd and even lattices.
-//
-//
-int neighborIndex_4d(int i, int oddBit, int dx4, int dx3, int dx2, int dx1) {
-  // On input i should be in the range [0 , ... , Z[0]*Z[1]*Z[2]*Z[3]/2-1].
-  if (i < 0 || i >= (Z[0]*Z[1]*Z[2]*Z[3]/2)) 
-    { printf("i out of range in neighborIndex_4d\n"); exit(-1); }
-  // Compute the linear index.  Then dissect.
-  // fullLatticeIndex_4d is in util_quda.cpp.
-  // The gauge fields live on a 4d sublattice.  
-  int X = fullLatticeIndex_4d(i, oddBit);
-  int x4 = X/(Z[2]*Z[1]*Z[0]);
-  int x3 = (X/(Z[1]*Z[0])) % Z[2];
-  int x2 = (X/Z[0]) % Z[1];
-  int x1 = X % Z[0];
-  
-  x4 = (x4+dx4+Z[3]) % Z[3];
-  x3 = (x3+dx3+Z[2]) % Z[2];
-  x2 = (x2+dx2+Z[1]) % Z[1];
-  x1 = (x1+dx1+Z[0]) % Z[0];
-  
-  return (x4*(Z[2]*Z[1]*Z[0]) + x3*(Z[1]*Z[0]) + x2*(Z[0]) + x1) / 2;
-}
-
-//BEGIN NEW
-//#ifdef MULTI_GPU
-int
-neighborIndex_5d_mgpu(int i, int oddBit, int dxs, int dx4, int dx3, int dx2, int dx1)
-{
-  int ret;
-  
-  int Y = fullLatticeIndex_5d(i, oddBit);
-  
-  int xs = Y/(Z[3]*Z[2]*Z[1]*Z[0]);
-  int x4 = (Y/(Z[2]*Z[1]*Z[0])) % Z[3];
-  int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-  int x2 = (Y/Z[0]) % Z[1];
-  int x1 = Y % Z[0];
-  
-  int ghost_x4 = x4+ dx4;
-  
-  xs = (xs+dxs+Ls) % Ls;
-  x4 = (x4+dx4+Z[3]) % Z[3];
-  x3 = (x3+dx3+Z[2]) % Z[2];
-  x2 = (x2+dx2+Z[1]) % Z[1];
-  x1 = (x1+dx1+Z[0]) % Z[0];
-  
-  if ( ghost_x4 >= 0 && ghost_x4 < Z[3]){
-    ret = (xs*Z[3]*Z[2]*Z[1]*Z[0] + x4*Z[2]*Z[1]*Z[0] + x3*Z[1]*Z[0] + x2*Z[0] + x1) >> 1;
-  }else{
-    ret = (xs*Z[2]*Z[1]*Z[0] + x3*Z[1]*Z[0] + x2*Z[0] + x1) >> 1;    
-  }
-
-  
-  return ret;
-}
-
-int
-x4_5d_mgpu(int i, int oddBit)
-{
-  int Y = fullLatticeIndex_5d(i, oddBit);
-  return (Y/(Z[2]*Z[1]*Z[0])) % Z[3];
-}
-
-//#endif
-
-//END NEW
-
-//#ifndef MULTI_GPU
-// This is just a copy of gaugeLink() from the quda code, except
-// that neighborIndex() is replaced by the renamed version
-// neighborIndex_4d().
-//ok
+// i represents a "half index" into an even or odd 5d "half lattice",
+// i = xs*Vh + i4, where i4 is the 4d checkerboard index.  The 4d
+// parity of the site is oddBit^(xs&1), and the 4d neighbors are read
+// from the LatticeGeometry tables.  Directions 8 and 9 are the forward
+// and backward hops in the fifth dimension, which is periodic here
+// (the boundary terms are applied by the caller).
 template <typename Float>
-Float *gaugeLink_sgpu(int i, int dir, int oddBit, Float **gaugeEven,
-                Float **gaugeOdd) {
-  Float **gaugeField;
+Float *spinorNeighbor_5d(const quda::LatticeGeometry &geom, int i, int dir, int oddBit, Float *spinorField) {
+  int xs = i/Vh;
+  int i4 = i - xs*Vh;
   int j;
-  
-  // If going forward, just grab link at site, U_\mu(x).
-  if (dir % 2 == 0) {
-    j = i;
-    // j will get used in the return statement below.
-    gaugeField = (oddBit ? gaugeOdd : gaugeEven);
-  } else {
-    // If going backward, a shift must occur, U_\mu(x-\muhat)^\dagger;
-    // dagger happens elsewhere, here we're just doing index gymnastics.
-    switch (dir) {
-    case 1: j = neighborIndex_4d(i, oddBit, 0, 0, 0, -1); break;
-    case 3: j = neighborIndex_4d(i, oddBit, 0, 0, -1, 0); break;
-    case 5: j = neighborIndex_4d(i, oddBit, 0, -1, 0, 0); break;
-    case 7: j = neighborIndex_4d(i, oddBit, -1, 0, 0, 0); break;
-    default: j = -1; break;
-    }
-    gaugeField = (oddBit ? gaugeEven : gaugeOdd);
+  switch (dir) {
+  case 8: j = ((xs+1) % Ls)*Vh + i4; break;
+  case 9: j = ((xs-1+Ls) % Ls)*Vh + i4; break;
+  default: j = xs*Vh + geom.Neighbor((oddBit+xs) & 1, dir)[i4]; break;
   }
   
-  return &gaugeField[dir/2][j*(3*3*2)];
-}
-
-
-//#else
-
-//Standard 4d version (nothing to change)
-template <typename Float>
-Float *gaugeLink_mgpu(int i, int dir, int oddBit, Float **gaugeEven, Float **gaugeOdd, Float** ghostGaugeEven, Float** ghostGaugeOdd, int n_ghost_faces, int nbr_distance) {
-  Float **gaugeField;
-  int j;
-  int d = nbr_distance;
-  if (dir % 2 == 0) {
-    j = i;
-    gaugeField = (oddBit ? gaugeOdd : gaugeEven);
-  }
-  else {
-
-    int Y = fullLatticeIndex(i, oddBit);
-    int x4 = Y/(Z[2]*Z[1]*Z[0]);
-    int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-    int x2 = (Y/Z[0]) % Z[1];
-    int x1 = Y % Z[0];
-    int X1= Z[0];
-    int X2= Z[1];
-    int X3= Z[2];
-    int X4= Z[3];
-    Float* ghostGaugeField;
-
-    switch (dir) {
-    case 1:
-      { //-X direction
-        int new_x1 = (x1 - d + X1 )% X1;
-        if (x1 -d < 0){
-	  ghostGaugeField = (oddBit?ghostGaugeEven[0]: ghostGaugeOdd[0]);
-	  int offset = (n_ghost_faces + x1 -d)*X4*X3*X2/2 + (x4*X3*X2 + x3*X2+x2)/2;
-	  return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) / 2;
-        break;
-      }
-    case 3:
-      { //-Y direction
-        int new_x2 = (x2 - d + X2 )% X2;
-        if (x2 -d < 0){
-          ghostGaugeField = (oddBit?ghostGaugeEven[1]: ghostGaugeOdd[1]);
-          int offset = (n_ghost_faces + x2 -d)*X4*X3*X1/2 + (x4*X3*X1 + x3*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) / 2;
-        break;
-
-      }
-    case 5:
-      { //-Z direction
-        int new_x3 = (x3 - d + X3 )% X3;
-        if (x3 -d < 0){
-          ghostGaugeField = (oddBit?ghostGaugeEven[2]: ghostGaugeOdd[2]);
-          int offset = (n_ghost_faces + x3 -d)*X4*X2*X1/2 + (x4*X2*X1 + x2*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) / 2;
-        break;
-      }
-    case 7:
-      { //-T direction
-        int new_x4 = (x4 - d + X4)% X4;
-        if (x4 -d < 0){
-          ghostGaugeField = (oddBit?ghostGaugeEven[3]: ghostGaugeOdd[3]);
-          int offset = (n_ghost_faces + x4 -d)*X1*X2*X3/2 + (x3*X2*X1 + x2*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (new_x4*(X3*X2*X1) + x3*(X2*X1) + x2*(X1) + x1) / 2;
-        break;
-      }//7
-
-    default: j = -1; printf("ERROR: wrong dir \n"); exit(1);
-    }
-    gaugeField = (oddBit ? gaugeEven : gaugeOdd);
-
-  }
-
-  return &gaugeField[dir/2][j*(3*3*2)];
+  return &spinorField[j*(4*3*2)];
 }
 
 //A.S.: this is valid for DW dslash wiht space-time decomposition.
+// The ghost zones are ordered (layer, xs, face).
 template <typename Float>
-Float *spinorNeighbor_5d_mgpu(int i, int dir, int oddBit, Float *spinorField, Float** fwd_nbr_spinor, Float** back_nbr_spinor, int neighbor_distance, int nFace)
+Float *spinorNeighbor_5d_mgpu(const quda::LatticeGeometry &geom, int i, int dir, int oddBit, Float *spinorField,
+			      Float** fwd_nbr_spinor, Float** back_nbr_spinor, int neighbor_distance, int nFace)
 {
-  int j;
-  int nb = neighbor_distance;
-  int Y = fullLatticeIndex_5d(i, oddBit);
- 
   int mySpinorSiteSize = 24;
  
-  int xs = Y/(Z[3]*Z[2]*Z[1]*Z[0]);
-  int x4 = (Y/(Z[2]*Z[1]*Z[0])) % Z[3];
-  int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-  int x2 = (Y/Z[0]) % Z[1];
-  int x1 = Y % Z[0];
-  
-  int X1= Z[0];
-  int X2= Z[1];
-  int X3= Z[2];
-  int X4= Z[3];
-  switch (dir) {
-  case 0://+X
-    {
-      int new_x1 = (x1 + nb)% X1;
-      if(x1+nb >=X1){
-        int offset = ((x1 + nb -X1)*Ls*X4*X3*X2+xs*X4*X3*X2+x4*X3*X2 + x3*X2+x2) >> 1;
-        return fwd_nbr_spinor[0] + offset*mySpinorSiteSize;
-      }
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) >> 1;
-      break;
-
-    }
-  case 1://-X
-    {
-      int new_x1 = (x1 - nb + X1)% X1;
-      if(x1 - nb < 0){ 
-        int offset = (( x1+nFace- nb)*Ls*X4*X3*X2 + xs*X4*X3*X2 + x4*X3*X2 + x3*X2 + x2) >> 1;
-        return back_nbr_spinor[0] + offset*mySpinorSiteSize;
-      } 
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) >> 1;
-      break;
-    }
-  case 2://+Y
-    {
-      int new_x2 = (x2 + nb)% X2;
-      if(x2+nb >=X2){
-        int offset = (( x2 + nb -X2)*Ls*X4*X3*X1+xs*X4*X3*X1+x4*X3*X1 + x3*X1+x1) >> 1;
-        return fwd_nbr_spinor[1] + offset*mySpinorSiteSize;
-      } 
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) >> 1;
-      break;
-    }
-  case 3:// -Y
-    {
-      int new_x2 = (x2 - nb + X2)% X2;
-      if(x2 - nb < 0){ 
-        int offset = (( x2 + nFace -nb)*Ls*X4*X3*X1+xs*X4*X3*X1+ x4*X3*X1 + x3*X1+x1) >> 1;
-        return back_nbr_spinor[1] + offset*mySpinorSiteSize;
-      } 
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) >> 1;
-      break;
-    }
-  case 4://+Z
-    {
-      int new_x3 = (x3 + nb)% X3;
-      if(x3+nb >=X3){
-        int offset = (( x3 + nb -X3)*Ls*X4*X2*X1+xs*X4*X2*X1+x4*X2*X1 + x2*X1+x1) >> 1;
-        return fwd_nbr_spinor[2] + offset*mySpinorSiteSize;
-      } 
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) >> 1;
-      break;
-    }
-  case 5://-Z
-    {
-      int new_x3 = (x3 - nb + X3)% X3;
-      if(x3 - nb < 0){ 
-        int offset = (( x3 + nFace -nb)*Ls*X4*X2*X1+xs*X4*X2*X1+x4*X2*X1+x2*X1+x1) >> 1;
-        return back_nbr_spinor[2] + offset*mySpinorSiteSize;
-      }
-      j = (xs*X4*X3*X2*X1 + x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) >> 1;
-      break;
-    }
-  case 6://+T 
-    {
-      j = neighborIndex_5d_mgpu(i, oddBit, 0, +nb, 0, 0, 0);
-      int x4 = x4_5d_mgpu(i, oddBit);
-      if ( (x4 + nb) >= Z[3])
-      {
-        int offset = (x4+nb - Z[3])*Vsh_t;//?
-        return &fwd_nbr_spinor[3][(offset+j)*mySpinorSiteSize];
-      }
-      break;
-    }
-  case 7://-T 
-    {
-      j = neighborIndex_5d_mgpu(i, oddBit, 0, -nb, 0, 0, 0);
-      int x4 = x4_5d_mgpu(i, oddBit);
-      if ( (x4 - nb) < 0){
-        int offset = ( x4 - nb +nFace)*Vsh_t;//?
-        return &back_nbr_spinor[3][(offset+j)*mySpinorSiteSize];
-      }
-      break;
-    }
-  default: j = -1; printf("ERROR: wrong dir\n"); exit(1);
+  int xs = i/Vh;
+  int i4 = i - xs*Vh;
+  int j = geom.Neighbor((oddBit+xs) & 1, dir, neighbor_distance)[i4];
+  if (quda::LatticeGeometry::isGhost(j)) {
+    int mu = dir/2;
+    int faceVolumeCB = geom.FaceVolumeCB(mu);
+    int g = geom.Ghost(j, dir, nFace);
+    int layer = g / faceVolumeCB;
+    int offset = (layer*Ls + xs)*faceVolumeCB + g % faceVolumeCB;
+    Float *ghost = (dir % 2 == 0) ? fwd_nbr_spinor[mu] : back_nbr_spinor[mu];
+    return ghost + offset*mySpinorSiteSize;
   }
 
-  return &spinorField[j*(mySpinorSiteSize)];
-}
-
-//#endif
-
-
-template <typename Float>
-Float *spinorNeighbor_5d(int i, int dir, int oddBit, Float *spinorField) {
-  int j;
-  switch (dir) {
-  case 0: j = neighborIndex_5d(i, oddBit, 0, 0, 0, 0, +1); break;
-  case 1: j = neighborIndex_5d(i, oddBit, 0, 0, 0, 0, -1); break;
-  case 2: j = neighborIndex_5d(i, oddBit, 0, 0, 0, +1, 0); break;
-  case 3: j = neighborIndex_5d(i, oddBit, 0, 0, 0, -1, 0); break;
-  case 4: j = neighborIndex_5d(i, oddBit, 0, 0, +1, 0, 0); break;
-  case 5: j = neighborIndex_5d(i, oddBit, 0, 0, -1, 0, 0); break;
-  case 6: j = neighborIndex_5d(i, oddBit, 0, +1, 0, 0, 0); break;
-  case 7: j = neighborIndex_5d(i, oddBit, 0, -1, 0, 0, 0); break;
-  case 8: j = neighborIndex_5d(i, oddBit, +1, 0, 0, 0, 0); break;
-  case 9: j = neighborIndex_5d(i, oddBit, -1, 0, 0, 0, 0); break;
-  default: j = -1; break;
-  }
-  
-  return &spinorField[j*(4*3*2)];
+  return &spinorField[(xs*Vh + j)*(mySpinorSiteSize)];
 }
 
 
@@ -493,23 +182,23 @@ void dslashReference_4d_sgpu(sFloat *res, gFloat **gaugeFull, sFloat *spinorFiel
     // are 4-dim'l.
     gaugeOdd[dir]  = gaugeFull[dir]+Vh*gaugeSiteSize;
   }
+  const quda::LatticeGeometry &geom = getLatticeGeometry(1);
+
   int sp_idx,oddBit_gge;
   for (int xs=0;xs<Ls;xs++) {
     for (int gge_idx = 0; gge_idx < Vh; gge_idx++) {
       for (int dir = 0; dir < 8; dir++) {
         sp_idx=gge_idx+Vh*xs;
-        // Here is a function call to study.  It is defined near
-        // Line 90 of this file.
         // Here we have to switch oddBit depending on the value of xs.  E.g., suppose
         // xs=1.  Then the odd spinor site x1=x2=x3=x4=0 wants the even gauge array
         // element 0, so that we get U_\mu(0).
         if ((xs % 2) == 0) oddBit_gge=oddBit;
         else oddBit_gge= (oddBit+1) % 2;
-        gFloat *gauge = gaugeLink_sgpu(gge_idx, dir, oddBit_gge, gaugeEven, gaugeOdd);
+        gFloat *gauge = gaugeLink(geom, gge_idx, dir, oddBit_gge, gaugeEven, gaugeOdd, 1);
         
         // Even though we're doing the 4d part of the dslash, we need
         // to use a 5d neighbor function, to get the offsets right.
-        sFloat *spinor = spinorNeighbor_5d(sp_idx, dir, oddBit, spinorField);
+        sFloat *spinor = spinorNeighbor_5d(geom, sp_idx, dir, oddBit, spinorField);
         sFloat projectedSpinor[4*3*2], gaugedSpinor[4*3*2];
         int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
         multiplySpinorByDiracProjector5(projectedSpinor, projIdx, spinor);
@@ -552,6 +241,9 @@ void dslashReference_4d_mgpu(sFloat *res, gFloat **gaugeFull, gFloat **ghostGaug
     ghostGaugeEven[dir] = ghostGauge[dir];
     ghostGaugeOdd[dir] = ghostGauge[dir] + (faceVolume[dir]/2)*gaugeSiteSize;
   }
+
+  const quda::LatticeGeometry &geom = getLatticeGeometry(1, true);
+
   for (int xs=0;xs<Ls;xs++) 
   {  
     int sp_idx;
@@ -565,8 +257,8 @@ void dslashReference_4d_mgpu(sFloat *res, gFloat **gaugeFull, gFloat **ghostGaug
 	if ((xs % 2) == 0) oddBit_gge=oddBit;
         else oddBit_gge= (oddBit+1) % 2;
 	
-	gFloat *gauge = gaugeLink_mgpu(i, dir, oddBit_gge, gaugeEven, gaugeOdd, ghostGaugeEven, ghostGaugeOdd, 1, 1);//this is unchanged from MPi version
-	sFloat *spinor = spinorNeighbor_5d_mgpu(sp_idx, dir, oddBit, spinorField, fwdSpinor, backSpinor, 1, 1);
+	gFloat *gauge = gaugeLink_mg4dir(geom, i, dir, oddBit_gge, gaugeEven, gaugeOdd, ghostGaugeEven, ghostGaugeOdd, 1, 1);
+	sFloat *spinor = spinorNeighbor_5d_mgpu(geom, sp_idx, dir, oddBit, spinorField, fwdSpinor, backSpinor, 1, 1);
 	
 	sFloat projectedSpinor[mySpinorSiteSize], gaugedSpinor[mySpinorSiteSize];
 	int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
@@ -588,18 +280,19 @@ void dslashReference_4d_mgpu(sFloat *res, gFloat **gaugeFull, gFloat **ghostGaug
 template <typename sFloat>
 void dslashReference_5th(sFloat *res, sFloat *spinorField, 
                 int oddBit, int daggerBit, sFloat mferm) {
+  const quda::LatticeGeometry &geom = getLatticeGeometry(1);
+
   for (int i = 0; i < V5h; i++) {
     for (int dir = 8; dir < 10; dir++) {
       // Calls for an extension of the original function.
       // 8 is forward hop, which wants P_+, 9 is backward hop,
       // which wants P_-.  Dagger reverses these.
-      sFloat *spinor = spinorNeighbor_5d(i, dir, oddBit, spinorField);
+      sFloat *spinor = spinorNeighbor_5d(geom, i, dir, oddBit, spinorField);
       sFloat projectedSpinor[4*3*2];
       int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
       multiplySpinorByDiracProjector5(projectedSpinor, projIdx, spinor);
       //J  Need a conditional here for s=0 and s=Ls-1.
-      int X = fullLatticeIndex_5d(i, oddBit);
-      int xs = X/(Z[3]*Z[2]*Z[1]*Z[0]);
+      int xs = i/Vh;
 
       if ( (xs == 0 && dir == 9) || (xs == Ls-1 && dir == 8) ) {
         ax(projectedSpinor,(sFloat)(-mferm),projectedSpinor,4*3*2);
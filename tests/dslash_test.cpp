@@ -63,6 +63,13 @@ extern QudaDagType dagger;
 extern int niter;
 extern char latfile[];
 
+// Also check the threaded host operators from the library against the reference?
+bool host_dslash = false;
+cpuDirac *hostDirac = 0;
+cpuColorSpinorField *spinorHost = 0;
+
+QudaMatPCType matpc_type = QUDA_MATPC_EVEN_EVEN_ASYMMETRIC;
+
 void init(int argc, char **argv) {
 
   cuda_prec = prec;
@@ -114,9 +121,20 @@ void init(int argc, char **argv) {
     kappa5 = 0.5/(5 + inv_param.m5);
   }
 
+  if (host_dslash) {
+    // the host operators only support a single flavor of twist
+    if (dslash_type == QUDA_TWISTED_MASS_DSLASH) inv_param.twist_flavor = QUDA_TWIST_MINUS;
+
+    // keep host copies of the gauge and clover fields for the host operators
+    gauge_param.location = QUDA_CPU_FIELD_LOCATION;
+    gauge_param.solver_location = QUDA_CPU_FIELD_LOCATION;
+    inv_param.clover_location = QUDA_CPU_FIELD_LOCATION;
+    inv_param.solver_location = QUDA_CPU_FIELD_LOCATION;
+  }
+
   inv_param.Ls = (inv_param.twist_flavor != QUDA_TWIST_NONDEG_DOUBLET) ? Ls : 1;
   
-  inv_param.matpc_type = QUDA_MATPC_EVEN_EVEN_ASYMMETRIC;
+  inv_param.matpc_type = matpc_type;
   inv_param.dagger = dagger;
 
   inv_param.cpu_prec = cpu_prec;
@@ -229,6 +247,7 @@ void init(int argc, char **argv) {
   spinorOut = new cpuColorSpinorField(csParam);
   spinorRef = new cpuColorSpinorField(csParam);
   spinorTmp = new cpuColorSpinorField(csParam);
+  if (host_dslash) spinorHost = new cpuColorSpinorField(csParam);
 
   csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
   csParam.x[0] = gauge_param.X[0];
@@ -313,6 +332,12 @@ void init(int argc, char **argv) {
     double cpu_norm = norm2(*spinor);
     printfQuda("Source: CPU = %e\n", cpu_norm);
   }
+
+  if (host_dslash) {
+    DiracParam hostParam;
+    setDiracParam(hostParam, &inv_param, test_type != 2 && test_type != 4);
+    hostDirac = cpuDirac::create(hostParam);
+  }
     
 }
 
@@ -330,6 +355,10 @@ void end() {
   delete spinorOut;
   delete spinorRef;
   delete spinorTmp;
+  if (host_dslash) {
+    delete hostDirac;
+    delete spinorHost;
+  }
 
   for (int dir = 0; dir < 4; dir++) free(hostGauge[dir]);
   if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
@@ -393,6 +422,31 @@ double dslashCUDA(int niter) {
   return secs;
 }
 
+// applies the operator under test with the threaded library host operator
+void dslashHost() {
+
+  printfQuda("Applying the host operator...");
+  fflush(stdout);
+
+  switch (test_type) {
+  case 0:
+    hostDirac->Dslash(*spinorHost, *spinor, parity);
+    break;
+  case 1:
+  case 2:
+    hostDirac->M(*spinorHost, *spinor);
+    break;
+  case 3:
+  case 4:
+    hostDirac->MdagM(*spinorHost, *spinor);
+    break;
+  default:
+    errorQuda("Test type %d not defined", test_type);
+  }
+
+  printfQuda("done.\n");
+}
+
 void dslashRef() {
 
   // compare to dslash reference implementation
@@ -558,6 +612,14 @@ void display_test_info()
 
 extern void usage(char**);
 
+void usage_extra(char** argv )
+{
+  printfQuda("Extra options:\n");
+  printfQuda("    --host_dslash                             # Also compare the threaded library host operator with the reference\n");
+  printfQuda("                                                (twisted mass is then run with a single flavor)\n");
+  printfQuda("    --matpc <even-even/odd-odd/even-even-asym/odd-odd-asym> # Preconditioning type (default even-even-asym)\n");
+  return ;
+}
 
 int main(int argc, char **argv)
 {
@@ -566,6 +628,25 @@ int main(int argc, char **argv)
     if(process_command_line_option(argc, argv, &i) == 0){
       continue;
     }  
+
+    if( strcmp(argv[i], "--host_dslash") == 0){
+      host_dslash = true;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--matpc") == 0){
+      if (i+1 >= argc) usage(argv);
+      if (strcmp(argv[i+1], "even-even") == 0) matpc_type = QUDA_MATPC_EVEN_EVEN;
+      else if (strcmp(argv[i+1], "odd-odd") == 0) matpc_type = QUDA_MATPC_ODD_ODD;
+      else if (strcmp(argv[i+1], "even-even-asym") == 0) matpc_type = QUDA_MATPC_EVEN_EVEN_ASYMMETRIC;
+      else if (strcmp(argv[i+1], "odd-odd-asym") == 0) matpc_type = QUDA_MATPC_ODD_ODD_ASYMMETRIC;
+      else {
+	fprintf(stderr, "ERROR: invalid matpc type %s\n", argv[i+1]);
+	usage(argv);
+      }
+      i++;
+      continue;
+    }
     
     fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
@@ -625,6 +706,12 @@ int main(int argc, char **argv)
     }
     
     cpuColorSpinorField::Compare(*spinorRef, *spinorOut);
+
+    if (host_dslash) {
+      dslashHost();
+      printfQuda("Results: CPU = %f, host = %f\n", norm2(*spinorRef), norm2(*spinorHost));
+      cpuColorSpinorField::Compare(*spinorRef, *spinorHost);
+    }
   }    
   end();
 
@@ -2,6 +2,7 @@
 #define _DSLASH_UTIL_H
 
 #include <test_util.h>
+#include <lattice_geometry.h>
 
 template <typename Float>
 static inline void sum(Float *dst, Float *a, Float *b, int cnt) {
@@ -84,31 +85,24 @@ static inline void su3Tmul(sFloat *res, gFloat *mat, sFloat *vec) {
 // i represents a "half index" into an even or odd "half lattice".
 // when oddBit={0,1} the half lattice is {even,odd}.
 // 
-// the displacements, such as dx, refer to the full lattice coordinates. 
-//
-// neighborIndex() takes a "half index", displaces it, and returns the
-// new "half index", which can be an index into either the even or odd lattices.
-// displacements of magnitude one always interchange odd and even lattices.
+// the neighbor lookups below read the precomputed tables of a
+// LatticeGeometry (see getLatticeGeometry()), which must have been
+// built with nFace equal to the largest neighbor distance used.
+// displacements of odd magnitude always interchange odd and even lattices.
 //
 
 
 template <typename Float>
-static inline Float *gaugeLink(int i, int dir, int oddBit, Float **gaugeEven, Float **gaugeOdd, int nbr_distance) {
+static inline Float *gaugeLink(const quda::LatticeGeometry &geom, int i, int dir, int oddBit,
+			       Float **gaugeEven, Float **gaugeOdd, int nbr_distance) {
   Float **gaugeField;
   int j;
-  int d = nbr_distance;
   if (dir % 2 == 0) {
     j = i;
     gaugeField = (oddBit ? gaugeOdd : gaugeEven);
   }
   else {
-    switch (dir) {
-    case 1: j = neighborIndex(i, oddBit, 0, 0, 0, -d); break;
-    case 3: j = neighborIndex(i, oddBit, 0, 0, -d, 0); break;
-    case 5: j = neighborIndex(i, oddBit, 0, -d, 0, 0); break;
-    case 7: j = neighborIndex(i, oddBit, -d, 0, 0, 0); break;
-    default: j = -1; break;
-    }
+    j = geom.Neighbor(oddBit, dir, nbr_distance)[i];
     gaugeField = (oddBit ? gaugeEven : gaugeOdd);
   }
   
@@ -116,219 +110,53 @@ static inline Float *gaugeLink(int i, int dir, int oddBit, Float **gaugeEven, Fl
 }
 
 template <typename Float>
-static inline Float *spinorNeighbor(int i, int dir, int oddBit, Float *spinorField, int neighbor_distance) 
+static inline Float *spinorNeighbor(const quda::LatticeGeometry &geom, int i, int dir, int oddBit,
+				    Float *spinorField, int neighbor_distance) 
 {
-  int j;
-  int nb = neighbor_distance;
-  switch (dir) {
-  case 0: j = neighborIndex(i, oddBit, 0, 0, 0, +nb); break;
-  case 1: j = neighborIndex(i, oddBit, 0, 0, 0, -nb); break;
-  case 2: j = neighborIndex(i, oddBit, 0, 0, +nb, 0); break;
-  case 3: j = neighborIndex(i, oddBit, 0, 0, -nb, 0); break;
-  case 4: j = neighborIndex(i, oddBit, 0, +nb, 0, 0); break;
-  case 5: j = neighborIndex(i, oddBit, 0, -nb, 0, 0); break;
-  case 6: j = neighborIndex(i, oddBit, +nb, 0, 0, 0); break;
-  case 7: j = neighborIndex(i, oddBit, -nb, 0, 0, 0); break;
-  default: j = -1; break;
-  }
-    
+  int j = geom.Neighbor(oddBit, dir, neighbor_distance)[i];
   return &spinorField[j*(mySpinorSiteSize)];
 }
 
 
-#ifdef MULTI_GPU
-
-static inline int
-x4_mg(int i, int oddBit)
-{
-  int Y = fullLatticeIndex(i, oddBit);
-  int x4 = Y/(Z[2]*Z[1]*Z[0]);
-  return x4;
-}
+// As above, but for hops that leave the local lattice (geom must have
+// been built with ghost zones) the links and spinors are read from the
+// ghost buffers, which hold n_ghost_faces (gauge) and nFace (spinor)
+// layers respectively.
 
 template <typename Float>
-static inline Float *gaugeLink_mg4dir(int i, int dir, int oddBit, Float **gaugeEven, Float **gaugeOdd,
-			Float** ghostGaugeEven, Float** ghostGaugeOdd, int n_ghost_faces, int nbr_distance) {
+static inline Float *gaugeLink_mg4dir(const quda::LatticeGeometry &geom, int i, int dir, int oddBit,
+				      Float **gaugeEven, Float **gaugeOdd, Float** ghostGaugeEven, 
+				      Float** ghostGaugeOdd, int n_ghost_faces, int nbr_distance) {
   Float **gaugeField;
   int j;
-  int d = nbr_distance;
   if (dir % 2 == 0) {
     j = i;
     gaugeField = (oddBit ? gaugeOdd : gaugeEven);
   }
   else {
-
-    int Y = fullLatticeIndex(i, oddBit);
-    int x4 = Y/(Z[2]*Z[1]*Z[0]);
-    int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-    int x2 = (Y/Z[0]) % Z[1];
-    int x1 = Y % Z[0];
-    int X1= Z[0];
-    int X2= Z[1];
-    int X3= Z[2];
-    int X4= Z[3];
-    Float* ghostGaugeField;
-
-    switch (dir) {
-    case 1:
-      { //-X direction
-        int new_x1 = (x1 - d + X1 )% X1;
-        if (x1 -d < 0){
-	  ghostGaugeField = (oddBit?ghostGaugeEven[0]: ghostGaugeOdd[0]);
-	  int offset = (n_ghost_faces + x1 -d)*X4*X3*X2/2 + (x4*X3*X2 + x3*X2+x2)/2;
-	  return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) / 2;
-        break;
-      }
-    case 3:
-      { //-Y direction
-        int new_x2 = (x2 - d + X2 )% X2;
-        if (x2 -d < 0){
-          ghostGaugeField = (oddBit?ghostGaugeEven[1]: ghostGaugeOdd[1]);
-          int offset = (n_ghost_faces + x2 -d)*X4*X3*X1/2 + (x4*X3*X1 + x3*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) / 2;
-        break;
-
-      }
-    case 5:
-      { //-Z direction
-        int new_x3 = (x3 - d + X3 )% X3;
-        if (x3 -d < 0){
-          ghostGaugeField = (oddBit?ghostGaugeEven[2]: ghostGaugeOdd[2]);
-          int offset = (n_ghost_faces + x3 -d)*X4*X2*X1/2 + (x4*X2*X1 + x2*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) / 2;
-        break;
-      }
-    case 7:
-      { //-T direction
-        int new_x4 = (x4 - d + X4)% X4;
-        if (x4 -d < 0){
-          ghostGaugeField = (oddBit?ghostGaugeEven[3]: ghostGaugeOdd[3]);
-          int offset = (n_ghost_faces + x4 -d)*X1*X2*X3/2 + (x3*X2*X1 + x2*X1+x1)/2;
-          return &ghostGaugeField[offset*(3*3*2)];
-        }
-        j = (new_x4*(X3*X2*X1) + x3*(X2*X1) + x2*(X1) + x1) / 2;
-        break;
-      }//7
-
-    default: j = -1; printf("ERROR: wrong dir \n"); exit(1);
+    j = geom.Neighbor(oddBit, dir, nbr_distance)[i];
+    if (quda::LatticeGeometry::isGhost(j)) {
+      Float *ghostGaugeField = (oddBit ? ghostGaugeEven[dir/2] : ghostGaugeOdd[dir/2]);
+      return &ghostGaugeField[geom.Ghost(j, dir, n_ghost_faces)*(3*3*2)];
     }
     gaugeField = (oddBit ? gaugeEven : gaugeOdd);
-
   }
 
   return &gaugeField[dir/2][j*(3*3*2)];
 }
 
 template <typename Float>
-static inline Float *spinorNeighbor_mg4dir(int i, int dir, int oddBit, Float *spinorField, Float** fwd_nbr_spinor, 
+static inline Float *spinorNeighbor_mg4dir(const quda::LatticeGeometry &geom, int i, int dir, int oddBit,
+					   Float *spinorField, Float** fwd_nbr_spinor, 
 					   Float** back_nbr_spinor, int neighbor_distance, int nFace)
 {
-  int j;
-  int nb = neighbor_distance;
-  int Y = fullLatticeIndex(i, oddBit);
-  int x4 = Y/(Z[2]*Z[1]*Z[0]);
-  int x3 = (Y/(Z[1]*Z[0])) % Z[2];
-  int x2 = (Y/Z[0]) % Z[1];
-  int x1 = Y % Z[0];
-  int X1= Z[0];
-  int X2= Z[1];
-  int X3= Z[2];
-  int X4= Z[3];
-
-  switch (dir) {
-  case 0://+X
-    {
-      int new_x1 = (x1 + nb)% X1;
-      if(x1+nb >=X1){
-        int offset = ( x1 + nb -X1)*X4*X3*X2/2+(x4*X3*X2 + x3*X2+x2)/2;
-        return fwd_nbr_spinor[0] + offset*mySpinorSiteSize;
-      }
-      j = (x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) / 2;
-      break;
-
-    }
-  case 1://-X
-    {
-      int new_x1 = (x1 - nb + X1)% X1;
-      if(x1 - nb < 0){ 
-        int offset = ( x1+nFace- nb)*X4*X3*X2/2+(x4*X3*X2 + x3*X2+x2)/2;
-        return back_nbr_spinor[0] + offset*mySpinorSiteSize;
-      } 
-      j = (x4*X3*X2*X1 + x3*X2*X1 + x2*X1 + new_x1) / 2;
-      break;
-    }
-  case 2://+Y
-    {
-      int new_x2 = (x2 + nb)% X2;
-      if(x2+nb >=X2){
-        int offset = ( x2 + nb -X2)*X4*X3*X1/2+(x4*X3*X1 + x3*X1+x1)/2;
-        return fwd_nbr_spinor[1] + offset*mySpinorSiteSize;
-      } 
-      j = (x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) / 2;
-      break;
-    }
-  case 3:// -Y
-    {
-      int new_x2 = (x2 - nb + X2)% X2;
-      if(x2 - nb < 0){ 
-        int offset = ( x2 + nFace -nb)*X4*X3*X1/2+(x4*X3*X1 + x3*X1+x1)/2;
-        return back_nbr_spinor[1] + offset*mySpinorSiteSize;
-      } 
-      j = (x4*X3*X2*X1 + x3*X2*X1 + new_x2*X1 + x1) / 2;
-      break;
-    }
-  case 4://+Z
-    {
-      int new_x3 = (x3 + nb)% X3;
-      if(x3+nb >=X3){
-        int offset = ( x3 + nb -X3)*X4*X2*X1/2+(x4*X2*X1 + x2*X1+x1)/2;
-        return fwd_nbr_spinor[2] + offset*mySpinorSiteSize;
-      } 
-      j = (x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) / 2;
-      break;
-    }
-  case 5://-Z
-    {
-      int new_x3 = (x3 - nb + X3)% X3;
-      if(x3 - nb < 0){ 
-        int offset = ( x3 + nFace -nb)*X4*X2*X1/2+(x4*X2*X1 + x2*X1+x1)/2;
-        return back_nbr_spinor[2] + offset*mySpinorSiteSize;
-      }
-      j = (x4*X3*X2*X1 + new_x3*X2*X1 + x2*X1 + x1) / 2;
-      break;
-    }
-  case 6://+T 
-    {
-      j = neighborIndex_mg(i, oddBit, +nb, 0, 0, 0);
-      int x4 = x4_mg(i, oddBit);
-      if ( (x4 + nb) >= Z[3]){
-        int offset = (x4+nb - Z[3])*Vsh_t;
-        return &fwd_nbr_spinor[3][(offset+j)*mySpinorSiteSize];
-      }
-      break;
-    }
-  case 7://-T 
-    {
-      j = neighborIndex_mg(i, oddBit, -nb, 0, 0, 0);
-      int x4 = x4_mg(i, oddBit);
-      if ( (x4 - nb) < 0){
-        int offset = ( x4 - nb +nFace)*Vsh_t;
-        return &back_nbr_spinor[3][(offset+j)*mySpinorSiteSize];
-      }
-      break;
-    }
-  default: j = -1; printf("ERROR: wrong dir\n"); exit(1);
+  int j = geom.Neighbor(oddBit, dir, neighbor_distance)[i];
+  if (quda::LatticeGeometry::isGhost(j)) {
+    Float *ghost = (dir % 2 == 0) ? fwd_nbr_spinor[dir/2] : back_nbr_spinor[dir/2];
+    return ghost + geom.Ghost(j, dir, nFace)*mySpinorSiteSize;
   }
 
   return &spinorField[j*(mySpinorSiteSize)];
 }
 
-#endif // MULTI_GPU
-
 #endif // _DSLASH_UTIL_H
@@ -5,6 +5,7 @@
 
 #include "quda.h"
 #include "test_util.h"
+#include <lattice_geometry.h>
 #include "misc.h"
 #include "gauge_force_reference.h"
 
@@ -279,49 +280,37 @@ compute_path_product(su3_matrix* staple, su3_matrix** sitelink, su3_matrix** sit
 {
   int i, j;
 
+#ifdef MULTI_GPU
+    const quda::LatticeGeometry &geom = quda::LatticeGeometry::Get(E);
+    su3_matrix** link = sitelink_ex_2d;
+#else
+    const quda::LatticeGeometry &geom = getLatticeGeometry();
+    su3_matrix** link = sitelink;
+#endif
+
     su3_matrix prev_matrix, curr_matrix, tmat;
-    int dx[4];
 
     for(i=0;i<V;i++){
-	memset(dx,0, sizeof(dx));
 	memset(&curr_matrix, 0, sizeof(curr_matrix));
 	
 	curr_matrix.e[0][0].real = 1.0;
 	curr_matrix.e[1][1].real = 1.0;
 	curr_matrix.e[2][2].real = 1.0;
 	
-	dx[dir] =1;
+	// the path starts at x+dir; walk it one hop at a time
+	int nbr_idx = geom.FullNeighbor(gf_neighborIndexFullLattice(i, 0, 0, 0, 0), 2*dir);
 	for(j=0; j < len;j++){
-	    int lnkdir;
-
 	    prev_matrix = curr_matrix;
 	    if (GOES_FORWARDS(path[j])){
-		//dx[path[j]] +=1;
-		lnkdir = path[j];
-	    }else{		
-		dx[OPP_DIR(path[j])] -=1;
-		lnkdir=OPP_DIR(path[j]);
-	    }
-	    
-	    int nbr_idx = gf_neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
-#ifdef MULTI_GPU
-	    su3_matrix* lnk = sitelink_ex_2d[lnkdir] + nbr_idx;
-#else	    
-	    su3_matrix* lnk = sitelink[lnkdir]+ nbr_idx;
-#endif
-	    if (GOES_FORWARDS(path[j])){
+		su3_matrix* lnk = link[path[j]] + nbr_idx;
 		mult_su3_nn(&prev_matrix, lnk, &curr_matrix);		
-	    }else{
+		nbr_idx = geom.FullNeighbor(nbr_idx, 2*path[j]);
+	    }else{		
+		int lnkdir = OPP_DIR(path[j]);
+		nbr_idx = geom.FullNeighbor(nbr_idx, 2*lnkdir+1);
+		su3_matrix* lnk = link[lnkdir] + nbr_idx;
 		mult_su3_na(&prev_matrix, lnk, &curr_matrix);		
 	    }
-
-	    if (GOES_FORWARDS(path[j])){
-		dx[path[j]] +=1;
-	    }else{		
-	      //we already substract one in the code above
-	    }	    
-
-	    
 	}//j
 
 	su3_adjoint(&curr_matrix, &tmat );
@@ -3,6 +3,10 @@
 #include <time.h>
 #include <math.h>
 #include <string.h>
+#include <ctype.h>
+
+#include <string>
+#include <vector>
 
 #include <util_quda.h>
 #include <test_util.h>
@@ -30,6 +34,7 @@
 // Wilson, clover-improved Wilson, twisted mass, and domain wall are supported.
 extern QudaDslashType dslash_type;
 extern bool tune;
+extern QudaFieldLocation solver_location;
 extern int device;
 extern int xdim;
 extern int ydim;
@@ -46,6 +51,15 @@ extern char latfile[];
 
 extern void usage(char** );
 
+int chrono_solves = 0; // the number of solves along a sequence of operators sharing a chronological basis
+bool chrono_refresh = true;
+int nrhs = 0; // the number of sources solved together with invertBlockQuda
+char profile_json[256] = ""; // the prefix of the profile written by endQuda, checked after the solves
+QudaInverterType inv_type = QUDA_INVALID_INVERTER; // if not given, chosen to suit the operator
+int sstep = 4; // the block size of the s-step CG solver
+bool context_solves = false; // whether to solve through a solver context across a gauge field reload
+int pipeline = 0; // 1 for the pipelined solver, 2 to run the standard and pipelined solvers in turn
+
 void
 display_test_info()
 {
@@ -68,6 +82,237 @@ display_test_info()
   
 }
 
+void usage_extra(char** argv )
+{
+  printfQuda("Extra options:\n");
+  printfQuda("    --chrono <n>                              # Run n solves with slowly varying mass and a reloaded gauge field,\n"
+             "                                                guessing each from the resident chronological basis (default 0)\n");
+  printfQuda("    --chrono_refresh <true/false>             # Whether to refresh the basis when the operator changes (default true)\n");
+  printfQuda("    --inv_type <cg/bicgstab/gcr/mr/sstep>     # The solver to use (default cg for normal equations, else bicgstab)\n");
+  printfQuda("    --sstep <s>                               # The number of steps per block of the s-step CG solver (default 4)\n");
+  printfQuda("    --pipeline <true/false/both>              # Use the pipelined solver, or solve with and without it (default false)\n");
+  printfQuda("    --context <true/false>                    # Solve repeatedly through one solver context, reloading the gauge\n"
+             "                                                field between solves (default false)\n");
+  printfQuda("    --nrhs <n>                                # Solve n sources at once with block CG, checking each residual (default 0)\n");
+  printfQuda("    --profile_json <prefix>                   # Write the profiles to <prefix>.json and check the nesting of the\n"
+             "                                                solver regions\n");
+  return ;
+}
+
+// apply the operator to the solution on the host, and return the L2
+// relative residual of the solve against the source
+static double host_residual(void *spinorOut, void *spinorIn, void *spinorCheck, void **gauge, double kappa5,
+                            QudaInvertParam &inv_param, QudaGaugeParam &gauge_param)
+{
+  if (inv_param.solution_type == QUDA_MAT_SOLUTION) {
+
+    if (dslash_type == QUDA_TWISTED_MASS_DSLASH) {
+      if(inv_param.twist_flavor == QUDA_TWIST_PLUS || inv_param.twist_flavor == QUDA_TWIST_MINUS)
+        tm_mat(spinorCheck, gauge, spinorOut, inv_param.kappa, inv_param.mu, inv_param.twist_flavor, 0, inv_param.cpu_prec, gauge_param);
+      else
+      {
+        int tm_offset = V*spinorSiteSize; //12*spinorRef->Volume();
+        void *evenOut = spinorCheck;
+        void *oddOut  = inv_param.cpu_prec == sizeof(double) ? (void*)((double*)evenOut + tm_offset): (void*)((float*)evenOut + tm_offset);
+
+        void *evenIn  = spinorOut;
+        void *oddIn   = inv_param.cpu_prec == sizeof(double) ? (void*)((double*)evenIn + tm_offset): (void*)((float*)evenIn + tm_offset);
+
+        tm_ndeg_mat(evenOut, oddOut, gauge, evenIn, oddIn, inv_param.kappa, inv_param.mu, inv_param.epsilon, 0, inv_param.cpu_prec, gauge_param);
+      }
+    } else if (dslash_type == QUDA_WILSON_DSLASH || dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
+      wil_mat(spinorCheck, gauge, spinorOut, inv_param.kappa, 0, inv_param.cpu_prec, gauge_param);
+    } else if (dslash_type == QUDA_DOMAIN_WALL_DSLASH) {
+      dw_mat(spinorCheck, gauge, spinorOut, kappa5, inv_param.dagger, inv_param.cpu_prec, gauge_param, inv_param.mass);
+    } else {
+      printfQuda("Unsupported dslash_type\n");
+      exit(-1);
+    }
+    if (inv_param.mass_normalization == QUDA_MASS_NORMALIZATION) {
+      if (dslash_type == QUDA_DOMAIN_WALL_DSLASH) {
+        ax(0.5/kappa5, spinorCheck, V*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
+      } else {
+        ax(0.5/inv_param.kappa, spinorCheck, V*spinorSiteSize, inv_param.cpu_prec);
+      }
+    }
+
+  } else if(inv_param.solution_type == QUDA_MATPC_SOLUTION) {
+
+    if (dslash_type == QUDA_TWISTED_MASS_DSLASH) {
+      if (inv_param.twist_flavor != QUDA_TWIST_MINUS && inv_param.twist_flavor != QUDA_TWIST_PLUS)
+        errorQuda("Twisted mass solution type not supported");
+      tm_matpc(spinorCheck, gauge, spinorOut, inv_param.kappa, inv_param.mu, inv_param.twist_flavor,
+               inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
+    } else if (dslash_type == QUDA_WILSON_DSLASH || dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
+      wil_matpc(spinorCheck, gauge, spinorOut, inv_param.kappa, inv_param.matpc_type, 0,
+                inv_param.cpu_prec, gauge_param);
+    } else if (dslash_type == QUDA_DOMAIN_WALL_DSLASH) {
+      dw_matpc(spinorCheck, gauge, spinorOut, kappa5, inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param, inv_param.mass);
+    } else {
+      printfQuda("Unsupported dslash_type\n");
+      exit(-1);
+    }
+
+    if (inv_param.mass_normalization == QUDA_MASS_NORMALIZATION) {
+      if (dslash_type == QUDA_DOMAIN_WALL_DSLASH) {
+        ax(0.25/(kappa5*kappa5), spinorCheck, Vh*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
+      } else {
+        ax(0.25/(inv_param.kappa*inv_param.kappa), spinorCheck, Vh*spinorSiteSize, inv_param.cpu_prec);
+      }
+    }
+
+  }
+
+  int vol = inv_param.solution_type == QUDA_MAT_SOLUTION ? V : Vh;
+  mxpy(spinorIn, spinorCheck, vol*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
+  double nrm2 = norm_2(spinorCheck, vol*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
+  double src2 = norm_2(spinorIn, vol*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
+  return sqrt(nrm2 / src2);
+}
+
+// a profile, or a region of one, as written by TimeProfile::Save()
+struct ProfileNode {
+  std::string name;
+  double calls;
+  std::vector<ProfileNode> regions; // the profiles, for the root
+  ProfileNode() : calls(0.0) { }
+};
+
+static void skip_space(const char *&s) { while (isspace(*s)) s++; }
+
+static std::string parse_string(const char *&s)
+{
+  std::string str;
+  for (s++; *s && *s != '"'; s++) {
+    if (*s == '\\' && s[1]) s++;
+    str += *s;
+  }
+  if (*s) s++;
+  return str;
+}
+
+static bool parse_value(const char *&s, ProfileNode *node);
+
+// parse an array, adding the objects in it to list if given
+static bool parse_array(const char *&s, std::vector<ProfileNode> *list)
+{
+  s++;
+  skip_space(s);
+  if (*s == ']') { s++; return true; }
+  while (true) {
+    ProfileNode child;
+    if (!parse_value(s, &child)) return false;
+    if (list) list->push_back(child);
+    skip_space(s);
+    if (*s == ',') { s++; continue; }
+    if (*s != ']') return false;
+    s++;
+    return true;
+  }
+}
+
+// parse a value, keeping the name, calls and regions (or profiles) of an object
+static bool parse_value(const char *&s, ProfileNode *node)
+{
+  skip_space(s);
+  if (*s == '"') {
+    parse_string(s);
+  } else if (*s == '[') {
+    return parse_array(s, NULL);
+  } else if (*s == '{') {
+    s++;
+    skip_space(s);
+    if (*s == '}') { s++; return true; }
+    while (true) {
+      skip_space(s);
+      if (*s != '"') return false;
+      std::string key = parse_string(s);
+      skip_space(s);
+      if (*s++ != ':') return false;
+      skip_space(s);
+      if (key == "name" && *s == '"') node->name = parse_string(s);
+      else if (key == "calls") node->calls = strtod(s, (char**)&s);
+      else if ((key == "regions" || key == "profiles") && *s == '[') { if (!parse_array(s, &node->regions)) return false; }
+      else if (!parse_value(s, NULL)) return false;
+      skip_space(s);
+      if (*s == ',') { s++; continue; }
+      if (*s != '}') return false;
+      s++;
+      return true;
+    }
+  } else {
+    const char *start = s;
+    while (*s && *s != ',' && *s != '}' && *s != ']' && !isspace(*s)) s++;
+    return s != start;
+  }
+  return true;
+}
+
+// a region left open, e.g., by a solver that returns early, would
+// hold the next solve's region of the same name
+static bool nested_in_itself(const ProfileNode &region)
+{
+  for (unsigned int i=0; i<region.regions.size(); i++) {
+    if (region.regions[i].name == region.name || nested_in_itself(region.regions[i])) return true;
+  }
+  return false;
+}
+
+/**
+   Check the profile written by endQuda: the solver's region must be
+   at the top level of the profile of the interface function that
+   was called, and no region may be nested in one of the same name.
+*/
+static int check_profile(const char *prefix, const char *function, const char *solver)
+{
+  std::string filename = std::string(prefix) + ".json";
+  FILE *file = fopen(filename.c_str(), "r");
+  if (!file) {
+    printfQuda("ERROR: cannot open profile %s\n", filename.c_str());
+    return 1;
+  }
+  std::string json;
+  char buf[4096];
+  for (size_t n; (n = fread(buf, 1, sizeof(buf), file)) > 0; ) json.append(buf, n);
+  fclose(file);
+
+  ProfileNode root;
+  const char *s = json.c_str();
+  if (!parse_value(s, &root)) {
+    printfQuda("ERROR: cannot parse profile %s\n", filename.c_str());
+    return 1;
+  }
+
+  int fail = 1;
+  for (unsigned int i=0; i<root.regions.size(); i++) {
+    const ProfileNode &profile = root.regions[i];
+    for (unsigned int r=0; r<profile.regions.size(); r++) {
+      if (nested_in_itself(profile.regions[r])) {
+        printfQuda("ERROR: region %s of %s is nested in itself\n", profile.regions[r].name.c_str(), profile.name.c_str());
+        return 1;
+      }
+      if (profile.name == function && profile.regions[r].name == solver && profile.regions[r].calls >= 1) fail = 0;
+    }
+  }
+
+  if (fail) printfQuda("ERROR: profile %s has no region %s in %s\n", filename.c_str(), solver, function);
+  else printfQuda("Profile %s: region %s of %s is nested correctly\n", filename.c_str(), solver, function);
+  return fail;
+}
+
+// the region a solver times its solves in
+static const char* solver_region(QudaInverterType type)
+{
+  switch (type) {
+  case QUDA_CG_INVERTER: return "cg";
+  case QUDA_BICGSTAB_INVERTER: return "bicgstab";
+  case QUDA_GCR_INVERTER: return "gcr";
+  case QUDA_MR_INVERTER: return "mr";
+  case QUDA_SSTEP_CG_INVERTER: return "sstep cg";
+  default: return "unknown";
+  }
+}
+
 int main(int argc, char **argv)
 {
 
@@ -75,10 +320,99 @@ int main(int argc, char **argv)
     if(process_command_line_option(argc, argv, &i) == 0){
       continue;
     } 
+
+    if( strcmp(argv[i], "--chrono") == 0){
+      if (i+1 >= argc) usage(argv);
+      chrono_solves = atoi(argv[i+1]);
+      if (chrono_solves < 0) {
+        printfQuda("ERROR: invalid number of chronological solves (%d)\n", chrono_solves);
+        usage(argv);
+      }
+      i++;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--chrono_refresh") == 0){
+      if (i+1 >= argc) usage(argv);
+      if (strcmp(argv[i+1], "true") == 0) chrono_refresh = true;
+      else if (strcmp(argv[i+1], "false") == 0) chrono_refresh = false;
+      else {
+        printfQuda("ERROR: invalid chrono_refresh value %s\n", argv[i+1]);
+        usage(argv);
+      }
+      i++;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--inv_type") == 0){
+      if (i+1 >= argc) usage(argv);
+      inv_type = get_solver_type(argv[i+1]);
+      i++;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--sstep") == 0){
+      if (i+1 >= argc) usage(argv);
+      sstep = atoi(argv[i+1]);
+      if (sstep < 1) {
+        printfQuda("ERROR: invalid s-step block size (%d)\n", sstep);
+        usage(argv);
+      }
+      i++;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--pipeline") == 0){
+      if (i+1 >= argc) usage(argv);
+      if (strcmp(argv[i+1], "true") == 0) pipeline = 1;
+      else if (strcmp(argv[i+1], "false") == 0) pipeline = 0;
+      else if (strcmp(argv[i+1], "both") == 0) pipeline = 2;
+      else {
+        printfQuda("ERROR: invalid pipeline value %s\n", argv[i+1]);
+        usage(argv);
+      }
+      i++;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--context") == 0){
+      if (i+1 >= argc) usage(argv);
+      if (strcmp(argv[i+1], "true") == 0) context_solves = true;
+      else if (strcmp(argv[i+1], "false") == 0) context_solves = false;
+      else {
+        printfQuda("ERROR: invalid context value %s\n", argv[i+1]);
+        usage(argv);
+      }
+      i++;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--profile_json") == 0){
+      if (i+1 >= argc) usage(argv);
+      strncpy(profile_json, argv[i+1], sizeof(profile_json)-1);
+      i++;
+      continue;
+    }
+
+    if( strcmp(argv[i], "--nrhs") == 0){
+      if (i+1 >= argc) usage(argv);
+      nrhs = atoi(argv[i+1]);
+      if (nrhs < 0 || nrhs > QUDA_MAX_MULTI_SHIFT) {
+        printfQuda("ERROR: invalid number of sources (%d)\n", nrhs);
+        usage(argv);
+      }
+      i++;
+      continue;
+    }
     printfQuda("ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
   }
 
+  if (context_solves && solver_location != QUDA_CUDA_FIELD_LOCATION) {
+    printfQuda("ERROR: solver contexts require --solver_location cuda\n");
+    usage(argv);
+  }
+
   if (prec_sloppy == QUDA_INVALID_PRECISION){
     prec_sloppy = prec;
   }
@@ -131,6 +465,7 @@ int main(int argc, char **argv)
   gauge_param.type = QUDA_WILSON_LINKS;
   gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
   gauge_param.t_boundary = QUDA_ANTI_PERIODIC_T;
+  gauge_param.solver_location = solver_location;
   
   gauge_param.cpu_prec = cpu_prec;
   gauge_param.cuda_prec = cuda_prec;
@@ -176,17 +511,26 @@ int main(int argc, char **argv)
   inv_param.mass_normalization = QUDA_KAPPA_NORMALIZATION;
   inv_param.solver_normalization = QUDA_DEFAULT_NORMALIZATION;
 
-  if (dslash_type == QUDA_DOMAIN_WALL_DSLASH || dslash_type == QUDA_TWISTED_MASS_DSLASH || multi_shift) {
+  // the chronological basis and block CG require a Hermitian operator
+  if (inv_type == QUDA_INVALID_INVERTER) {
+    if (dslash_type == QUDA_DOMAIN_WALL_DSLASH || dslash_type == QUDA_TWISTED_MASS_DSLASH || multi_shift || chrono_solves || nrhs) {
+      inv_type = QUDA_CG_INVERTER;
+    } else {
+      inv_type = QUDA_BICGSTAB_INVERTER;
+    }
+  }
+  inv_param.inv_type = inv_type;
+
+  // CG and s-step CG solve the normal equations
+  if (inv_type == QUDA_CG_INVERTER || inv_type == QUDA_SSTEP_CG_INVERTER) {
     inv_param.solve_type = QUDA_NORMOP_PC_SOLVE;
-    inv_param.inv_type = QUDA_CG_INVERTER;
   } else {
     inv_param.solve_type = QUDA_DIRECT_PC_SOLVE;
-    inv_param.inv_type = QUDA_BICGSTAB_INVERTER;
   }
 
-  inv_param.pipeline = 0;
+  inv_param.pipeline = (pipeline == 1) ? 1 : 0;
 
-  inv_param.gcrNkrylov = 10;
+  inv_param.gcrNkrylov = (inv_type == QUDA_SSTEP_CG_INVERTER) ? sstep : 10;
   inv_param.tol = 1e-7;
 #if __COMPUTE_CAPABILITY__ >= 200
   // require both L2 relative and heavy quark residual to determine convergence
@@ -223,6 +567,7 @@ int main(int argc, char **argv)
 
   inv_param.input_location = QUDA_CPU_FIELD_LOCATION;
   inv_param.output_location = QUDA_CPU_FIELD_LOCATION;
+  inv_param.solver_location = solver_location;
 
   inv_param.tune = tune ? QUDA_TUNE_YES : QUDA_TUNE_NO;
 
@@ -252,6 +597,14 @@ int main(int argc, char **argv)
 
   inv_param.verbosity = QUDA_VERBOSE;
 
+  if (chrono_solves) {
+    inv_param.chrono_use_resident = 1;
+    inv_param.chrono_make_resident = 1;
+    inv_param.chrono_max_dim = chrono_solves;
+    inv_param.chrono_refresh = chrono_refresh ? 1 : 0;
+    inv_param.chrono_index = 0;
+  }
+
   // declare the dimensions of the communication grid
   initCommsGridQuda(4, gridsize_from_cmdline, NULL, NULL);
 
@@ -345,11 +698,32 @@ int main(int argc, char **argv)
     //for (int i=0; i<inv_param.Ls*V*spinorSiteSize; i++) ((double*)spinorIn)[i] = rand() / (double)RAND_MAX;
   }
 
+  // the block sources are point sources in successive spin-color components
+  void **spinorInBlock = NULL, **spinorOutBlock = NULL;
+  if (nrhs) {
+    spinorInBlock = (void**)malloc(nrhs*sizeof(void *));
+    spinorOutBlock = (void**)malloc(nrhs*sizeof(void *));
+    for (int i=0; i<nrhs; i++) {
+      spinorInBlock[i] = malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+      spinorOutBlock[i] = malloc(V*spinorSiteSize*sSize*inv_param.Ls);
+      memset(spinorInBlock[i], 0, inv_param.Ls*V*spinorSiteSize*sSize);
+      memset(spinorOutBlock[i], 0, inv_param.Ls*V*spinorSiteSize*sSize);
+      if (inv_param.cpu_prec == QUDA_SINGLE_PRECISION) ((float*)spinorInBlock[i])[2*(i%(spinorSiteSize/2))] = 1.0;
+      else ((double*)spinorInBlock[i])[2*(i%(spinorSiteSize/2))] = 1.0;
+    }
+  }
+
+  int ret = 0;
+
+  // read by endQuda
+  if (strcmp(profile_json, "")) setenv("QUDA_PROFILE_OUTPUT", profile_json, 1);
+
   // start the timer
   double time0 = -((double)clock());
 
-  // initialize the QUDA library
-  initQuda(device);
+  // initialize the QUDA library, without a device if only the host solver is used
+  if (solver_location == QUDA_CPU_FIELD_LOCATION && !multi_shift) initQudaHost();
+  else initQuda(device);
 
   // load the gauge field
   loadGaugeQuda((void*)gauge, &gauge_param);
@@ -360,6 +734,60 @@ int main(int argc, char **argv)
   // perform the inversion
   if (multi_shift) {
     invertMultiShiftQuda(spinorOutMulti, spinorIn, &inv_param);
+  } else if (chrono_solves) {
+    // mimic the solves for one pseudofermion along a trajectory: the
+    // gauge field is reloaded and the mass drifts between solves, so
+    // each guess comes from a basis built with a slightly different operator
+    for (int k=0; k<chrono_solves; k++) {
+      if (k > 0) {
+        freeGaugeQuda();
+        loadGaugeQuda((void*)gauge, &gauge_param);
+        if (dslash_type == QUDA_DOMAIN_WALL_DSLASH) inv_param.mass *= 1.0 + 1e-3;
+        else inv_param.kappa *= 1.0 - 1e-4;
+      }
+      invertQuda(spinorOut, spinorIn, &inv_param);
+      printfQuda("Chronological solve %d: %d iter\n", k, inv_param.iter);
+    }
+    flushChronoQuda(-1);
+  } else if (nrhs) {
+    invertBlockQuda(spinorOutBlock, spinorInBlock, nrhs, &inv_param);
+  } else if (context_solves) {
+    // the second solve reuses the operators of the first; the third
+    // follows a reload with a new gauge field, so unless the context
+    // rebuilds its operators it solves the wrong system
+    void *context = newInvertContextQuda(&inv_param);
+    for (int k=0; k<3; k++) {
+      if (k == 2) {
+        construct_gauge_field(gauge, 1, gauge_param.cpu_prec, &gauge_param);
+        freeGaugeQuda();
+        loadGaugeQuda((void*)gauge, &gauge_param);
+      }
+      memset(spinorOut, 0, inv_param.Ls*V*spinorSiteSize*sSize);
+      invertContextQuda(context, spinorOut, spinorIn, &inv_param);
+      double l2r = host_residual(spinorOut, spinorIn, spinorCheck, (void**)gauge, kappa5, inv_param, gauge_param);
+
+      printfQuda("Context solve %d: %i iter, residuals: (L2 relative) tol %g, QUDA = %g, host = %g\n",
+                 k, inv_param.iter, inv_param.tol, inv_param.true_res, l2r);
+
+      // empirical, if the residual is more than an order above the target accuracy, the solve failed
+      if (inv_param.true_res > 10*inv_param.tol || l2r > 10*inv_param.tol) ret = 1;
+    }
+    destroyInvertContextQuda(context);
+  } else if (pipeline == 2) {
+    // solve from the same source without and with pipelining, both of
+    // which must converge; the pipelined solution is checked below
+    for (int p=0; p<2; p++) {
+      memset(spinorOut, 0, inv_param.Ls*V*spinorSiteSize*sSize);
+      inv_param.pipeline = p;
+      invertQuda(spinorOut, spinorIn, &inv_param);
+      double l2r = host_residual(spinorOut, spinorIn, spinorCheck, (void**)gauge, kappa5, inv_param, gauge_param);
+
+      printfQuda("%s solve: %i iter / %g secs, residuals: (L2 relative) tol %g, QUDA = %g, host = %g\n",
+                 p ? "Pipelined" : "Standard", inv_param.iter, inv_param.secs, inv_param.tol, inv_param.true_res, l2r);
+
+      // empirical, if the residual is more than an order above the target accuracy, the solve failed
+      if (inv_param.true_res > 10*inv_param.tol || l2r > 10*inv_param.tol) ret = 1;
+    }
   } else {
     invertQuda(spinorOut, spinorIn, &inv_param);
   }
@@ -371,7 +799,8 @@ int main(int argc, char **argv)
   printfQuda("Device memory used:\n   Spinor: %f GiB\n    Gauge: %f GiB\n", 
 	 inv_param.spinorGiB, gauge_param.gaugeGiB);
   if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) printfQuda("   Clover: %f GiB\n", inv_param.cloverGiB);
-  printfQuda("\nDone: %i iter / %g secs = %g Gflops, total time = %g secs\n", 
+  printfQuda("\nSolver: %s\n", get_solver_str(inv_param.inv_type));
+  printfQuda("Done: %i iter / %g secs = %g Gflops, total time = %g secs\n", 
 	 inv_param.iter, inv_param.secs, inv_param.gflops/inv_param.secs, time0);
 
   if (multi_shift) {
@@ -411,85 +840,53 @@ int main(int argc, char **argv)
     }
     free(spinorTmp);
 
-  } else {
-    
-    if (inv_param.solution_type == QUDA_MAT_SOLUTION) {
-
-      if (dslash_type == QUDA_TWISTED_MASS_DSLASH) {
-	if(inv_param.twist_flavor == QUDA_TWIST_PLUS || inv_param.twist_flavor == QUDA_TWIST_MINUS)      
-	  tm_mat(spinorCheck, gauge, spinorOut, inv_param.kappa, inv_param.mu, inv_param.twist_flavor, 0, inv_param.cpu_prec, gauge_param);
-	else
-	{
-          int tm_offset = V*spinorSiteSize; //12*spinorRef->Volume(); 	  
-	  void *evenOut = spinorCheck;
-	  void *oddOut  = cpu_prec == sizeof(double) ? (void*)((double*)evenOut + tm_offset): (void*)((float*)evenOut + tm_offset);
-    
-	  void *evenIn  = spinorOut;
-	  void *oddIn   = cpu_prec == sizeof(double) ? (void*)((double*)evenIn + tm_offset): (void*)((float*)evenIn + tm_offset);
-    
-	  tm_ndeg_mat(evenOut, oddOut, gauge, evenIn, oddIn, inv_param.kappa, inv_param.mu, inv_param.epsilon, 0, inv_param.cpu_prec, gauge_param);	
-	}
-      } else if (dslash_type == QUDA_WILSON_DSLASH || dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
-        wil_mat(spinorCheck, gauge, spinorOut, inv_param.kappa, 0, inv_param.cpu_prec, gauge_param);
-      } else if (dslash_type == QUDA_DOMAIN_WALL_DSLASH) {
-        dw_mat(spinorCheck, gauge, spinorOut, kappa5, inv_param.dagger, inv_param.cpu_prec, gauge_param, inv_param.mass);
-      } else {
-        printfQuda("Unsupported dslash_type\n");
-        exit(-1);
-      }
-      if (inv_param.mass_normalization == QUDA_MASS_NORMALIZATION) {
-        if (dslash_type == QUDA_DOMAIN_WALL_DSLASH) {
-          ax(0.5/kappa5, spinorCheck, V*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
-        } else {
-          ax(0.5/inv_param.kappa, spinorCheck, V*spinorSiteSize, inv_param.cpu_prec);
-        }
-      }
+  } else if (nrhs) {
 
-    } else if(inv_param.solution_type == QUDA_MATPC_SOLUTION) {
+    printfQuda("Host residuum checks: \n");
+    for (int i=0; i<nrhs; i++) {
+      double l2r = host_residual(spinorOutBlock[i], spinorInBlock[i], spinorCheck, (void**)gauge, kappa5, inv_param, gauge_param);
 
-      if (dslash_type == QUDA_TWISTED_MASS_DSLASH) {
-	if (inv_param.twist_flavor != QUDA_TWIST_MINUS && inv_param.twist_flavor != QUDA_TWIST_PLUS)
-	  errorQuda("Twisted mass solution type not supported");
-        tm_matpc(spinorCheck, gauge, spinorOut, inv_param.kappa, inv_param.mu, inv_param.twist_flavor, 
-                 inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param);
-      } else if (dslash_type == QUDA_WILSON_DSLASH || dslash_type == QUDA_CLOVER_WILSON_DSLASH) {
-        wil_matpc(spinorCheck, gauge, spinorOut, inv_param.kappa, inv_param.matpc_type, 0, 
-                  inv_param.cpu_prec, gauge_param);
-      } else if (dslash_type == QUDA_DOMAIN_WALL_DSLASH) {
-	dw_matpc(spinorCheck, gauge, spinorOut, kappa5, inv_param.matpc_type, 0, inv_param.cpu_prec, gauge_param, inv_param.mass);
-      } else {
-        printfQuda("Unsupported dslash_type\n");
-        exit(-1);
-      }
+      printfQuda("Source %d residuals: (L2 relative) tol %g, QUDA = %g, host = %g\n",
+                 i, inv_param.tol, inv_param.true_res_offset[i], l2r);
 
-      if (inv_param.mass_normalization == QUDA_MASS_NORMALIZATION) {
-        if (dslash_type == QUDA_DOMAIN_WALL_DSLASH) {
-          ax(0.25/(kappa5*kappa5), spinorCheck, Vh*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
-        } else {
-          ax(0.25/(inv_param.kappa*inv_param.kappa), spinorCheck, Vh*spinorSiteSize, inv_param.cpu_prec);
-      
-	}
-      }
+      // empirical, if the residual is more than an order above the target accuracy, the solve failed
+      if (inv_param.true_res_offset[i] > 10*inv_param.tol || l2r > 10*inv_param.tol) ret = 1;
+    }
 
+    for (int i=0; i<nrhs; i++) {
+      free(spinorInBlock[i]);
+      free(spinorOutBlock[i]);
     }
+    free(spinorInBlock);
+    free(spinorOutBlock);
 
-    int vol = inv_param.solution_type == QUDA_MAT_SOLUTION ? V : Vh;
-    mxpy(spinorIn, spinorCheck, vol*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
-    double nrm2 = norm_2(spinorCheck, vol*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
-    double src2 = norm_2(spinorIn, vol*spinorSiteSize*inv_param.Ls, inv_param.cpu_prec);
-    double l2r = sqrt(nrm2 / src2);
+  } else {
+    
+    double l2r = host_residual(spinorOut, spinorIn, spinorCheck, (void**)gauge, kappa5, inv_param, gauge_param);
 
     printfQuda("Residuals: (L2 relative) tol %g, QUDA = %g, host = %g; (heavy-quark) tol %g, QUDA = %g\n",
 	       inv_param.tol, inv_param.true_res, l2r, inv_param.tol_hq, inv_param.true_res_hq);
 
+    // empirical, if the residual is more than an order above the target accuracy, the solve failed
+    if (l2r > 10*inv_param.tol) ret = 1;
+
   }
 
   freeGaugeQuda();
   if (dslash_type == QUDA_CLOVER_WILSON_DSLASH) freeCloverQuda();
 
+  // the profile is written by rank 0
+  int rank = comm_rank();
+
   // finalize the QUDA library
   endQuda();
 
+  if (strcmp(profile_json, "") && rank == 0) {
+    if (multi_shift) ret |= check_profile(profile_json, "invertMultiShiftQuda", "multi-shift cg");
+    else if (nrhs) ret |= check_profile(profile_json, "invertBlockQuda", "block cg");
+    else ret |= check_profile(profile_json, "invertQuda", solver_region(inv_param.inv_type));
+  }
+
   // finalize the communications layer
 #if defined(QMP_COMMS)
   QMP_finalize_msg_passing();
@@ -497,5 +894,5 @@ int main(int argc, char **argv)
   MPI_Finalize();
 #endif
 
-  return 0;
+  return ret;
 }
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include <quda_internal.h>
+#include <lattice_geometry.h>
 #include "face_quda.h"
 
 #define XUP 0
@@ -163,7 +164,7 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
    * It also adds the computed staple to the fatlink[mu] with weight coef.
    */
 
-  int dx[4];
+  const quda::LatticeGeometry &geom = getLatticeGeometry();
 
   /* upper staple */
 
@@ -172,9 +173,7 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
     fat1 = ((su3_matrix*)fatlink[mu]) + i;
     su3_matrix* A = sitelink[nu] + i;
 
-    memset(dx, 0, sizeof(dx));
-    dx[nu] =1;
-    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);
+    int nbr_idx = geom.FullNeighbor(i, 2*nu);
     su3_matrix* B;
     if (use_staple){
       B = mulink + nbr_idx;
@@ -182,9 +181,7 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
       B = mulink + nbr_idx;
     }
 
-    memset(dx, 0, sizeof(dx));
-    dx[mu] =1;
-    nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2],dx[1],dx[0]);
+    nbr_idx = geom.FullNeighbor(i, 2*mu);
     su3_matrix* C = sitelink[nu] + nbr_idx;
 
     llfat_mult_su3_nn( A, B,&tmat1);
@@ -209,13 +206,7 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
   for(i=0;i < V;i++){	    
 
     fat1 = ((su3_matrix*)fatlink[mu]) + i;
-    memset(dx, 0, sizeof(dx));
-    dx[nu] = -1;
-    int nbr_idx = neighborIndexFullLattice(i, dx[3], dx[2], dx[1], dx[0]);	
-    if (nbr_idx >= V || nbr_idx <0){
-      fprintf(stderr, "ERROR: invliad nbr_idx(%d), line=%d\n", nbr_idx, __LINE__);
-      exit(1);
-    }
+    int nbr_idx = geom.FullNeighbor(i, 2*nu+1);
     su3_matrix* A = sitelink[nu] + nbr_idx;
 
     su3_matrix* B;
@@ -225,9 +216,7 @@ llfat_compute_gen_staple_field(su3_matrix *staple, int mu, int nu,
       B = mulink + nbr_idx;
     }
 
-    memset(dx, 0, sizeof(dx));
-    dx[mu] = 1;
-    nbr_idx = neighborIndexFullLattice(nbr_idx, dx[3], dx[2],dx[1],dx[0]);
+    nbr_idx = geom.FullNeighbor(nbr_idx, 2*mu);
     su3_matrix* C = sitelink[nu] + nbr_idx;
 
     llfat_mult_su3_an( A, B,&tmat1);	
@@ -329,18 +318,17 @@ void computeLongLinkCPU(void** longlink, su3_matrix** sitelink,
     Float* act_path_coeff)
 {
 
+  const quda::LatticeGeometry &geom = getLatticeGeometry();
+
   su3_matrix temp;
   for(int dir=XUP; dir<=TUP; ++dir){
-    int dx[4] = {0,0,0,0}; 
     for(int i=0; i<V; ++i){
       // Initialize the longlinks
       su3_matrix* llink = ((su3_matrix*)longlink[dir]) + i;
       llfat_scalar_mult_su3_matrix(sitelink[dir]+i, act_path_coeff[1], llink);
-      dx[dir] = 1;
-      int nbr_idx = neighborIndexFullLattice(Z, i, dx);
+      int nbr_idx = geom.FullNeighbor(i, 2*dir);
       llfat_mult_su3_nn(llink, sitelink[dir]+nbr_idx, &temp);
-      dx[dir] = 2;  
-      nbr_idx = neighborIndexFullLattice(Z, i, dx);
+      nbr_idx = geom.FullNeighbor(nbr_idx, 2*dir);
       llfat_mult_su3_nn(&temp, sitelink[dir]+nbr_idx, llink);
     }
   }
@@ -352,6 +340,7 @@ void computeLongLinkCPU(void** longlink, su3_matrix** sitelinkEx, Float* act_pat
 {
   int E[4];
   for(int dir=0; dir<4; ++dir) E[dir] = Z[dir]+4;
+  const quda::LatticeGeometry &geom = quda::LatticeGeometry::Get(E);
 
 
  const int extended_volume = E[3]*E[2]*E[1]*E[0];
@@ -367,14 +356,11 @@ void computeLongLinkCPU(void** longlink, su3_matrix** sitelinkEx, Float* act_pat
         
       
           for(int dir=XUP; dir<=TUP; ++dir){
-            int dx[4] = {0,0,0,0};
             su3_matrix* llink = ((su3_matrix*)longlink[dir]) + little_index;
             llfat_scalar_mult_su3_matrix(sitelinkEx[dir]+large_index, act_path_coeff[1], llink);
-            dx[dir] = 1;
-            int nbr_index = neighborIndexFullLattice(E, large_index, dx);
+            int nbr_index = geom.FullNeighbor(large_index, 2*dir);
             llfat_mult_su3_nn(llink, sitelinkEx[dir]+nbr_index, &temp);
-            dx[dir] = 2;
-            nbr_index = neighborIndexFullLattice(E, large_index, dx);  
+            nbr_index = geom.FullNeighbor(nbr_index, 2*dir);
             llfat_mult_su3_nn(&temp, sitelinkEx[dir]+nbr_index, llink);
           }
         } // x
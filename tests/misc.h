@@ -21,6 +21,8 @@ extern "C" {
     const char* get_unitarization_str(bool svd_only);
     QudaDslashType get_dslash_type(char* s);
     const char* get_dslash_type_str(QudaDslashType type);
+    QudaInverterType get_solver_type(char* s);
+    const char* get_solver_str(QudaInverterType type);
   const char* get_quda_ver_str();
 #ifdef __cplusplus
 }
@@ -220,6 +220,48 @@ function complete_invert_check {
    
 
 }
+function complete_host_invert_check {
+    echo "Performing complete host invert test:"
+    prog="./invert_test"
+    dslash_types="wilson clover"
+    sloppy_precs="double single half"
+    partitions="0 8 12 14 15"
+
+   $prog --version |grep single >& /dev/null
+   if [ "$?" == "0" ]; then
+	partitions="0" #single GPU version
+   fi
+
+    for dslash_type in $dslash_types; do
+        for sloppy_prec in $sloppy_precs; do
+		for partition in $partitions; do
+		    #half precision host spinors have no ghost norms, so their halo exchange is not supported
+		    if [ $sloppy_prec == "half" ] && [ $partition != "0" ] ; then
+			continue
+		    fi
+                    cmd="$prog --sdim 8 --tdim 16 --dslash_type $dslash_type --prec double --prec_sloppy $sloppy_prec --solver_location cpu --partition $partition"
+                    echo -ne  $cmd  "\t"..."\t"
+                    echo "----------------------------------------------------------" >>$OUTFILE
+                    echo $cmd >> $OUTFILE
+                    $cmd >> $OUTFILE 2>&1|| (echo -e "FAIL\n$prog failed, check $OUTFILE for detail"; echo $fail_msg; exit 1) || exit 1
+                    echo "OK"
+		done
+        done
+    done
+
+    #the staggered host solves are also checked against the device solver
+    prog="./staggered_invert_test"
+    for partition in $partitions; do
+        cmd="$prog --sdim 8 --tdim 16 --prec double --prec_sloppy single --solver_location cpu --partition $partition"
+        echo -ne  $cmd  "\t"..."\t"
+        echo "----------------------------------------------------------" >>$OUTFILE
+        echo $cmd >> $OUTFILE
+        $cmd >> $OUTFILE 2>&1|| (echo -e "FAIL\n$prog failed, check $OUTFILE for detail"; echo $fail_msg; exit 1) || exit 1
+        echo "OK"
+    done
+
+}
+
 #actions based on arguments
 
 if [ $# == "0" ]; then
@@ -237,6 +279,8 @@ for action in $*; do
         complete_dslash_check ;;
     invert )
 	complete_invert_check;;
+    host )
+	complete_host_invert_check;;
     gf )
 	complete_gauge_force_check ;;
     hf )
@@ -245,6 +289,7 @@ for action in $*; do
 	basic_sanity_check
 	complete_dslash_check
 	complete_invert_check
+	complete_host_invert_check
 	complete_fatlink_check
 	complete_gauge_force_check 
 	complete_hisq_force_check
@@ -252,7 +297,7 @@ for action in $*; do
     * )
 	echo "ERROR: invalid option ($action)!"
 	echo "Valid options: "
-	echo "              basic/fat/dslash/invert/gf/hisq/all"
+	echo "              basic/fat/dslash/invert/host/gf/hisq/all"
 	exit
 	;;
   esac
@@ -57,15 +57,17 @@ void dslashReference(sFloat *res, gFloat **fatlink, gFloat** longlink, sFloat *s
     longlinkEven[dir] =longlink[dir];
     longlinkOdd[dir] = longlink[dir] + Vh*gaugeSiteSize;    
   }
+
+  const quda::LatticeGeometry &geom = getLatticeGeometry(3);
   
   for (int i = 0; i < Vh; i++) {
     memset(res + i*mySpinorSiteSize, 0, mySpinorSiteSize*sizeof(sFloat));
     for (int dir = 0; dir < 8; dir++) {
-      gFloat* fatlnk = gaugeLink(i, dir, oddBit, fatlinkEven, fatlinkOdd, 1);
-      gFloat* longlnk = gaugeLink(i, dir, oddBit, longlinkEven, longlinkOdd, 3);
+      gFloat* fatlnk = gaugeLink(geom, i, dir, oddBit, fatlinkEven, fatlinkOdd, 1);
+      gFloat* longlnk = gaugeLink(geom, i, dir, oddBit, longlinkEven, longlinkOdd, 3);
       
-      sFloat *first_neighbor_spinor = spinorNeighbor(i, dir, oddBit, spinorField, 1);
-      sFloat *third_neighbor_spinor = spinorNeighbor(i, dir, oddBit, spinorField, 3);
+      sFloat *first_neighbor_spinor = spinorNeighbor(geom, i, dir, oddBit, spinorField, 1);
+      sFloat *third_neighbor_spinor = spinorNeighbor(geom, i, dir, oddBit, spinorField, 3);
       
       
       sFloat gaugedSpinor[mySpinorSiteSize];
@@ -294,14 +296,16 @@ void dslashReference_mg4dir(sFloat *res, gFloat **fatlink, gFloat** longlink,
     ghostLonglinkOdd[dir] = ghostLonglink[dir] + 3*Vsh[dir]*gaugeSiteSize;
   }
 
+  const quda::LatticeGeometry &geom = getLatticeGeometry(3, true);
+
   for (int i = 0; i < Vh; i++) {
     memset(res + i*mySpinorSiteSize, 0, mySpinorSiteSize*sizeof(sFloat));
     for (int dir = 0; dir < 8; dir++) {
-      gFloat* fatlnk = gaugeLink_mg4dir(i, dir, oddBit, fatlinkEven, fatlinkOdd, ghostFatlinkEven, ghostFatlinkOdd, 1, 1);
-      gFloat* longlnk = gaugeLink_mg4dir(i, dir, oddBit, longlinkEven, longlinkOdd, ghostLonglinkEven, ghostLonglinkOdd, 3, 3);
+      gFloat* fatlnk = gaugeLink_mg4dir(geom, i, dir, oddBit, fatlinkEven, fatlinkOdd, ghostFatlinkEven, ghostFatlinkOdd, 1, 1);
+      gFloat* longlnk = gaugeLink_mg4dir(geom, i, dir, oddBit, longlinkEven, longlinkOdd, ghostLonglinkEven, ghostLonglinkOdd, 3, 3);
 
-      sFloat *first_neighbor_spinor = spinorNeighbor_mg4dir(i, dir, oddBit, spinorField, fwd_nbr_spinor, back_nbr_spinor, 1, 3);
-      sFloat *third_neighbor_spinor = spinorNeighbor_mg4dir(i, dir, oddBit, spinorField, fwd_nbr_spinor, back_nbr_spinor, 3, 3);
+      sFloat *first_neighbor_spinor = spinorNeighbor_mg4dir(geom, i, dir, oddBit, spinorField, fwd_nbr_spinor, back_nbr_spinor, 1, 3);
+      sFloat *third_neighbor_spinor = spinorNeighbor_mg4dir(geom, i, dir, oddBit, spinorField, fwd_nbr_spinor, back_nbr_spinor, 3, 3);
 
       sFloat gaugedSpinor[mySpinorSiteSize];
 
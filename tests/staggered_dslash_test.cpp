@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 
 #include <quda.h>
 #include <quda_internal.h>
@@ -70,6 +71,10 @@ int X[4];
 
 Dirac* dirac;
 
+// Also check the threaded host operators from the library against the reference?
+bool host_dslash = false;
+cpuDirac *hostDirac = 0, *hostDiracFull = 0;
+
 void init()
 {    
 
@@ -102,6 +107,12 @@ void init()
   gaugeParam.gauge_fix = QUDA_GAUGE_FIXED_NO;
   gaugeParam.gaugeGiB = 0;
 
+  if (host_dslash) {
+    // keep host copies of the links for the host operators
+    gaugeParam.location = QUDA_CPU_FIELD_LOCATION;
+    gaugeParam.solver_location = QUDA_CPU_FIELD_LOCATION;
+  }
+
   inv_param.cpu_prec = QUDA_DOUBLE_PRECISION;
   inv_param.cuda_prec = prec;
   inv_param.dirac_order = QUDA_DIRAC_ORDER;
@@ -109,6 +120,7 @@ void init()
   inv_param.dagger = dagger;
   inv_param.matpc_type = QUDA_MATPC_EVEN_EVEN;
   inv_param.dslash_type = QUDA_ASQTAD_DSLASH;
+  inv_param.mass = 0.1; // only used by the host MdagM check
 
   inv_param.input_location = QUDA_CPU_FIELD_LOCATION;
   inv_param.output_location = QUDA_CPU_FIELD_LOCATION;
@@ -272,6 +284,14 @@ void init()
 
     dirac = Dirac::create(diracParam);
 
+    if (host_dslash) {
+      DiracParam hostParam;
+      setDiracParam(hostParam, &inv_param, true);
+      hostDirac = cpuDirac::create(hostParam);
+      setDiracParam(hostParam, &inv_param, false);
+      hostDiracFull = cpuDirac::create(hostParam);
+    }
+
   } else {
     errorQuda("Error not suppported");
   }
@@ -293,6 +313,11 @@ void end(void)
     delete tmp;
   }
 
+  if (host_dslash) {
+    delete hostDirac;
+    delete hostDiracFull;
+  }
+
   delete spinor;
   delete spinorOut;
   delete spinorRef;
@@ -403,6 +428,59 @@ void staggeredDslashRef()
 
 }
 
+// reference for MdagM of the given parity, out = 4 m^2 in - D D in
+static void staggeredMatDagMatRef(cpuColorSpinorField &out, cpuColorSpinorField &in,
+				  cpuColorSpinorField &tmp, QudaParity parity)
+{
+#ifdef MULTI_GPU
+  matdagmat_mg4dir(&out, fatlink, longlink, (void**)ghost_fatlink, (void**)ghost_longlink, &in,
+		   inv_param.mass, dagger, inv_param.cpu_prec, gaugeParam.cpu_prec, &tmp, parity);
+#else
+  matdagmat(out.V(), fatlink, longlink, in.V(), inv_param.mass, dagger,
+	    inv_param.cpu_prec, gaugeParam.cpu_prec, tmp.V(), parity);
+#endif
+}
+
+// compare the threaded library host operators with the reference,
+// returning the lowest accuracy level of the comparisons
+static int hostDslashTest()
+{
+  int accuracy_level;
+
+  printfQuda("Applying the host dslash...");
+  cpuColorSpinorField hostOut(*spinor);
+  hostDirac->Dslash(hostOut, *spinor, parity);
+  printfQuda("done.\n");
+  printfQuda("Results: CPU=%f, host=%f\n", norm2(*spinorRef), norm2(hostOut));
+  accuracy_level = cpuColorSpinorField::Compare(*spinorRef, hostOut);
+
+  // the even-odd preconditioned operator, acting on the parity of the matpc type
+  printfQuda("Applying the host preconditioned MdagM...");
+  cpuColorSpinorField ref(*spinor), tmpRef(*spinor);
+  hostDirac->MdagM(hostOut, *spinor);
+  staggeredMatDagMatRef(ref, *spinor, tmpRef, QUDA_EVEN_PARITY);
+  printfQuda("done.\n");
+  printfQuda("Results: CPU=%f, host=%f\n", norm2(ref), norm2(hostOut));
+  accuracy_level = std::min(accuracy_level, cpuColorSpinorField::Compare(ref, hostOut));
+
+  // the full operator, which is block diagonal in parity
+  printfQuda("Applying the host full MdagM...");
+  ColorSpinorParam csParam(*spinor);
+  csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
+  csParam.x[0] *= 2;
+  csParam.create = QUDA_ZERO_FIELD_CREATE;
+  cpuColorSpinorField in(csParam), out(csParam), refFull(csParam);
+  in.Source(QUDA_RANDOM_SOURCE);
+  hostDiracFull->MdagM(out, in);
+  staggeredMatDagMatRef(refFull.Even(), in.Even(), tmpRef, QUDA_EVEN_PARITY);
+  staggeredMatDagMatRef(refFull.Odd(), in.Odd(), tmpRef, QUDA_ODD_PARITY);
+  printfQuda("done.\n");
+  printfQuda("Results: CPU=%f, host=%f\n", norm2(refFull), norm2(out));
+  accuracy_level = std::min(accuracy_level, cpuColorSpinorField::Compare(refFull, out));
+
+  return accuracy_level;
+}
+
 static int dslashTest() 
 {
   int accuracy_level = 0;
@@ -454,6 +532,8 @@ static int dslashTest()
     }
 
     accuracy_level = cpuColorSpinorField::Compare(*spinorRef, *spinorOut);	
+
+    if (host_dslash) accuracy_level = std::min(accuracy_level, hostDslashTest());
   }
   end();
 
@@ -488,6 +568,7 @@ usage_extra(char** argv )
   printfQuda("    --test <0/1>                             # Test method\n");
   printfQuda("                                                0: Even destination spinor\n");
   printfQuda("                                                1: Odd destination spinor\n");
+  printfQuda("    --host_dslash                             # Also compare the threaded library host operators with the reference\n");
   return ;
 }
 
@@ -501,6 +582,11 @@ int main(int argc, char **argv)
       continue;
     }    
 
+    if( strcmp(argv[i], "--host_dslash") == 0){
+      host_dslash = true;
+      continue;
+    }
+
     fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
   }
@@ -47,6 +47,7 @@ QudaPrecision cpu_prec = QUDA_DOUBLE_PRECISION;
 
 extern QudaReconstructType link_recon_sloppy;
 extern QudaPrecision  prec_sloppy;
+extern QudaFieldLocation solver_location;
 cpuColorSpinorField* in;
 cpuColorSpinorField* out;
 cpuColorSpinorField* ref;
@@ -106,6 +107,7 @@ set_params(QudaGaugeParam* gaugeParam, QudaInvertParam* inv_param,
   gaugeParam->t_boundary = QUDA_ANTI_PERIODIC_T;
   gaugeParam->gauge_order = QUDA_MILC_GAUGE_ORDER;
   gaugeParam->ga_pad = X1*X2*X3/2;
+  gaugeParam->solver_location = solver_location;
 
   inv_param->verbosity = QUDA_VERBOSE;
   inv_param->mass = mass;
@@ -114,7 +116,8 @@ set_params(QudaGaugeParam* gaugeParam, QudaInvertParam* inv_param,
   inv_param->inv_type = QUDA_CG_INVERTER;
   inv_param->tol = tol;
   inv_param->maxiter = 500000;
-  inv_param->reliable_delta = 1e-1;
+  inv_param->reliable_delta = reliable_delta;
+  inv_param->solver_location = solver_location;
 
 #if __COMPUTE_CAPABILITY__ >= 200
   // require both L2 relative and heavy quark residual to determine convergence
@@ -168,7 +171,7 @@ invert_test(void)
   set_params(&gaugeParam, &inv_param,
       xdim, ydim, zdim, tdim,
       cpu_prec, prec, prec_sloppy,
-      link_recon, link_recon_sloppy, mass, tol, 500, 1e-3,
+      link_recon, link_recon_sloppy, mass, tol, 500, 1e-1,
       0.8);
 
   // declare the dimensions of the communication grid
@@ -452,6 +455,26 @@ invert_test(void)
     printfQuda("done: total time = %g secs, compute time = %g secs, %i iter / %g secs = %g gflops, \n", 
         time0, inv_param.secs, inv_param.iter, inv_param.secs,
         inv_param.gflops/inv_param.secs);
+
+    // check the host solver against the device solver, using the device
+    // copies of the links that loadGaugeQuda() keeps alongside the host ones
+    if (solver_location == QUDA_CPU_FIELD_LOCATION) {
+      double host_res = inv_param.true_res;
+
+      cpuColorSpinorField *device_out = new cpuColorSpinorField(csParam);
+      inv_param.solver_location = QUDA_CUDA_FIELD_LOCATION;
+      invertQuda(device_out->V(), in->V(), &inv_param);
+      inv_param.solver_location = solver_location;
+      delete device_out;
+
+      printfQuda("True residuals: (L2 relative) tol %g, host solver = %g, device solver = %g\n",
+          inv_param.tol, host_res, inv_param.true_res);
+
+      //emperical, the host solver must converge to within an order of the target accuracy and the device solver
+      if (l2r > 10*inv_param.tol || host_res > 10*MAX(inv_param.tol, inv_param.true_res)) {
+        ret |= 1;
+      }
+    }
   }
 
   end();
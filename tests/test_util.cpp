@@ -15,6 +15,7 @@
 
 #include <face_quda.h>
 #include <dslash_quda.h>
+#include <lattice_geometry.h>
 #include "misc.h"
 
 using namespace std;
@@ -479,6 +480,13 @@ int neighborIndex(int dim[4], int index, int oddBit, int dx[4]){
   return (((x[3]*dim[2] + x[2])*dim[1] + x[1])*dim[0] + x[0])/2;
 }
 
+const quda::LatticeGeometry& getLatticeGeometry(int nFace, bool ghost)
+{
+  int ghostDim[4];
+  for (int d=0; d<4; d++) ghostDim[d] = ghost ? 1 : 0;
+  return quda::LatticeGeometry::Get(Z, nFace, ghostDim);
+}
+
 int
 neighborIndex_mg(int i, int oddBit, int dx4, int dx3, int dx2, int dx1)
 {
@@ -1511,6 +1519,7 @@ int gridsize_from_cmdline[4] = {1,1,1,1};
 QudaDslashType dslash_type = QUDA_WILSON_DSLASH;
 char latfile[256] = "";
 bool tune = true;
+QudaFieldLocation solver_location = QUDA_CUDA_FIELD_LOCATION;
 int niter = 10;
 int test_type = 0;
 
@@ -1553,6 +1562,7 @@ void usage(char** argv )
   printf("    --load-gauge file                         # Load gauge field \"file\" for the test (requires QIO)\n");
   printf("    --niter <n>                               # The number of iterations to perform (default 10)\n");
   printf("    --tune <true/false>                       # Whether to autotune or not (default true)\n");     
+  printf("    --solver_location <cpu/cuda>              # Where the solver is run (default cuda)\n");
   printf("    --test                                    # Test method (different for each test)\n");
   printf("    --help                                    # Print out this message\n"); 
   usage_extra(argv); 
@@ -1772,6 +1782,25 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if( strcmp(argv[i], "--solver_location") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+
+    if (strcmp(argv[i+1], "cpu") == 0){
+      solver_location = QUDA_CPU_FIELD_LOCATION;
+    }else if (strcmp(argv[i+1], "cuda") == 0){
+      solver_location = QUDA_CUDA_FIELD_LOCATION;
+    }else{
+      fprintf(stderr, "ERROR: invalid solver location\n");
+      exit(1);
+    }
+
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--xgridsize") == 0){
     if (i+1 >= argc){ 
       usage(argv);
@@ -9,6 +9,10 @@
 #define momSiteSize    10 // real numbers per momentum
 #define hwSiteSize    12 // real numbers per half wilson
 
+namespace quda {
+  class LatticeGeometry;
+}
+
 #ifdef __cplusplus
 //extern "C" {
 #endif
@@ -47,6 +51,10 @@
   int neighborIndex_mg(int i, int oddBit, int dx4, int dx3, int dx2, int dx1);
   int neighborIndexFullLattice_mg(int i, int dx4, int dx3, int dx2, int dx1);
 
+  // neighbor tables for the local lattice Z; if ghost is set, hops
+  // across the boundary in any dimension are directed to the ghost zones
+  const quda::LatticeGeometry& getLatticeGeometry(int nFace=1, bool ghost=false);
+
   void printSpinorElement(void *spinor, int X, QudaPrecision precision);
   void printGaugeElement(void *gauge, int X, QudaPrecision precision);
   
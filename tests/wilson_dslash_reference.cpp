@@ -111,11 +111,13 @@ void dslashReference(sFloat *res, gFloat **gaugeFull, sFloat *spinorField, int o
     gaugeEven[dir] = gaugeFull[dir];
     gaugeOdd[dir]  = gaugeFull[dir]+Vh*gaugeSiteSize;
   }
+
+  const quda::LatticeGeometry &geom = getLatticeGeometry(1);
   
   for (int i = 0; i < Vh; i++) {
     for (int dir = 0; dir < 8; dir++) {
-      gFloat *gauge = gaugeLink(i, dir, oddBit, gaugeEven, gaugeOdd, 1);
-      sFloat *spinor = spinorNeighbor(i, dir, oddBit, spinorField, 1);
+      gFloat *gauge = gaugeLink(geom, i, dir, oddBit, gaugeEven, gaugeOdd, 1);
+      sFloat *spinor = spinorNeighbor(geom, i, dir, oddBit, spinorField, 1);
       
       sFloat projectedSpinor[4*3*2], gaugedSpinor[4*3*2];
       int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
@@ -147,12 +149,14 @@ void dslashReference(sFloat *res, gFloat **gaugeFull,  gFloat **ghostGauge, sFlo
     ghostGaugeEven[dir] = ghostGauge[dir];
     ghostGaugeOdd[dir] = ghostGauge[dir] + (faceVolume[dir]/2)*gaugeSiteSize;
   }
+
+  const quda::LatticeGeometry &geom = getLatticeGeometry(1, true);
   
   for (int i = 0; i < Vh; i++) {
 
     for (int dir = 0; dir < 8; dir++) {
-      gFloat *gauge = gaugeLink_mg4dir(i, dir, oddBit, gaugeEven, gaugeOdd, ghostGaugeEven, ghostGaugeOdd, 1, 1);
-      sFloat *spinor = spinorNeighbor_mg4dir(i, dir, oddBit, spinorField, fwdSpinor, backSpinor, 1, 1);
+      gFloat *gauge = gaugeLink_mg4dir(geom, i, dir, oddBit, gaugeEven, gaugeOdd, ghostGaugeEven, ghostGaugeOdd, 1, 1);
+      sFloat *spinor = spinorNeighbor_mg4dir(geom, i, dir, oddBit, spinorField, fwdSpinor, backSpinor, 1, 1);
       
       sFloat projectedSpinor[mySpinorSiteSize], gaugedSpinor[mySpinorSiteSize];
       int projIdx = 2*(dir/2)+(dir+daggerBit)%2;